@@ -4,6 +4,7 @@
 #include "ns3/names.h"
 #include "ns3/uinteger.h"
 #include "ns3/blockchain-miner.h"
+#include "ns3/blockchain-validator.h"
 #include "ns3/log.h"
 #include "ns3/double.h"
 
@@ -61,6 +62,23 @@ namespace ns3 {
                 
                 node->AddApplication(app);
                 
+                return app;
+            }
+            case PBFT_MINER:
+            case RAFT_MINER:
+            case HOTSTUFF_MINER:
+            {
+                Ptr<BlockchainValidator> app = m_factory.Create<BlockchainValidator>();
+                app->SetPeersAddresses(m_peersAddresses);
+                app->SetPeersDownloadSpeeds(m_peersDownloadSpeeds);
+                app->SetPeersUploadSpeeds(m_peersUploadSpeeds);
+                app->SetNodeInternetSpeeds(m_internetSpeeds);
+                app->SetNodeStats(m_nodeStats);
+                app->SetProtocolType(m_protocolType);
+                app->SetCommitterType(m_committerType);
+
+                node->AddApplication(app);
+
                 return app;
             }
         }
@@ -83,14 +101,33 @@ namespace ns3 {
         {
             case NORMAL_MINER:
             {
-                m_factory.SetTypeId("ns3::BlockchainMiner");
+                m_factory.SetTypeId("ns3:BlockchainMiner");
                 SetFactoryAttributes();
                 break;
             }
             case HYPERLEDGER_MINER:
             {
-                m_factory.SetTypeId("ns3::BlockchainMiner");
+                m_factory.SetTypeId("ns3:BlockchainMiner");
                 SetFactoryAttributes();
+                break;
+            }
+            case PBFT_MINER:
+            {
+                m_factory.SetTypeId("ns3::BlockchainPbftMiner");
+                SetFactoryAttributes();
+                break;
+            }
+            case RAFT_MINER:
+            {
+                m_factory.SetTypeId("ns3::BlockchainRaftMiner");
+                SetFactoryAttributes();
+                break;
+            }
+            case HOTSTUFF_MINER:
+            {
+                m_factory.SetTypeId("ns3::BlockchainHotStuffMiner");
+                SetFactoryAttributes();
+                break;
             }
         }
     }
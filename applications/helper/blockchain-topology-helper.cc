@@ -1417,6 +1417,13 @@ BlockchainTopologyHelper::GetNodesInternetSpeeds (void) const
   return m_nodesInternetSpeeds;
 }
 
+
+double
+BlockchainTopologyHelper::GetRegionLatency (enum BlockchainRegion from, enum BlockchainRegion to) const
+{
+  return m_regionLatencies[from][to];
+}
+
 } // namespace ns3
 
 static double GetWallTime()
@@ -134,6 +134,14 @@ public:
 
    std::map<uint32_t, nodeInternetSpeed> GetNodesInternetSpeeds (void) const;
 
+  /**
+   * Get the mean latency of the links between two regions, in ms
+   *
+   * \param from the region of one end of the link
+   * \param to the region of the other end
+   */
+   double GetRegionLatency (enum BlockchainRegion from, enum BlockchainRegion to) const;
+
 private:
 
   void AssignRegion (uint32_t id);
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-chunk-swarm.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainChunkSwarm");
+
+    BlockchainChunkSwarm::BlockchainChunkSwarm(void) : m_chunkSize(100000), m_maxRequestsPerPeer(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainChunkSwarm::~BlockchainChunkSwarm(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainChunkSwarm::SetChunkSize(uint32_t chunkSizeBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(chunkSizeBytes == 0)
+        {
+            NS_FATAL_ERROR("Error : the chunk size must be positive");
+        }
+        m_chunkSize = chunkSizeBytes;
+    }
+
+    void
+    BlockchainChunkSwarm::SetMaxRequestsPerPeer(uint32_t maxRequestsPerPeer)
+    {
+        NS_LOG_FUNCTION(this);
+        m_maxRequestsPerPeer = maxRequestsPerPeer;
+    }
+
+    int
+    BlockchainChunkSwarm::GetChunkCount(int blockSizeBytes) const
+    {
+        if(blockSizeBytes <= 0)
+            return 1;
+
+        return (blockSizeBytes + m_chunkSize - 1) / m_chunkSize;
+    }
+
+    int
+    BlockchainChunkSwarm::GetChunkSizeBytes(int blockSizeBytes, int chunk) const
+    {
+        int chunks = GetChunkCount(blockSizeBytes);
+
+        if(chunk < chunks - 1)
+            return m_chunkSize;
+
+        return std::max(0, blockSizeBytes - static_cast<int>((chunks - 1) * m_chunkSize));
+    }
+
+    bool
+    BlockchainChunkSwarm::AddBlock(const std::string &blockHash, const Block &header)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(HasBlock(blockHash))
+            return false;
+
+        SwarmBlock &block = m_blocks[blockHash];
+
+        block.header = header;
+        block.chunks.assign(GetChunkCount(header.GetBlockSizeBytes()), false);
+        block.receivedChunks = 0;
+
+        return true;
+    }
+
+    bool
+    BlockchainChunkSwarm::HasBlock(const std::string &blockHash) const
+    {
+        return m_blocks.find(blockHash) != m_blocks.end();
+    }
+
+    const Block&
+    BlockchainChunkSwarm::GetHeader(const std::string &blockHash) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+        {
+            NS_FATAL_ERROR("Error : block " << blockHash << " is not being downloaded in chunks");
+        }
+
+        return it->second.header;
+    }
+
+    void
+    BlockchainChunkSwarm::SetTransactions(const std::string &blockHash, const std::vector<Transaction> &transactions)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_blocks.find(blockHash);
+
+        if(it != m_blocks.end())
+            it->second.transactions = transactions;
+    }
+
+    std::vector<Transaction>
+    BlockchainChunkSwarm::GetTransactions(const std::string &blockHash) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+            return std::vector<Transaction>();
+
+        return it->second.transactions;
+    }
+
+    void
+    BlockchainChunkSwarm::AddPeerChunks(const std::string &blockHash, Ipv4Address peer, const Address &address, const std::vector<int> &chunks)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+            return;
+
+        SwarmBlock          &block = it->second;
+        std::vector<bool>   &peerChunks = block.peerChunks[peer];
+
+        peerChunks.resize(block.chunks.size(), false);
+        block.addresses[peer] = address;
+
+        for(auto chunk = chunks.begin(); chunk != chunks.end(); chunk++)
+        {
+            if(*chunk >= 0 && *chunk < static_cast<int>(peerChunks.size()))
+                peerChunks[*chunk] = true;
+        }
+    }
+
+    void
+    BlockchainChunkSwarm::RemovePeer(const std::string &blockHash, Ipv4Address peer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_blocks.find(blockHash);
+
+        if(it != m_blocks.end())
+        {
+            it->second.peerChunks.erase(peer);
+            it->second.addresses.erase(peer);
+        }
+    }
+
+    bool
+    BlockchainChunkSwarm::PeerHasAllChunks(const std::string &blockHash, Ipv4Address peer) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+            return false;
+
+        auto peerChunks = it->second.peerChunks.find(peer);
+
+        if(peerChunks == it->second.peerChunks.end())
+            return false;
+
+        return std::find(peerChunks->second.begin(), peerChunks->second.end(), false) == peerChunks->second.end();
+    }
+
+    int
+    BlockchainChunkSwarm::GetPeerCount(const std::string &blockHash) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+            return 0;
+
+        return it->second.peerChunks.size();
+    }
+
+    Address
+    BlockchainChunkSwarm::GetPeerAddress(const std::string &blockHash, Ipv4Address peer) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end() || it->second.addresses.find(peer) == it->second.addresses.end())
+            return Address();
+
+        return it->second.addresses.find(peer)->second;
+    }
+
+    bool
+    BlockchainChunkSwarm::HasChunk(const std::string &blockHash, int chunk) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end() || chunk < 0 || chunk >= static_cast<int>(it->second.chunks.size()))
+            return false;
+
+        return it->second.chunks[chunk];
+    }
+
+    std::map<Ipv4Address, std::vector<int>>
+    BlockchainChunkSwarm::SelectRequests(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::map<Ipv4Address, std::vector<int>>     requests;
+        std::vector<std::pair<int, int>>            candidates;         // (peers that have the chunk, chunk)
+        auto                                        it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+            return requests;
+
+        SwarmBlock &block = it->second;
+
+        for(unsigned int chunk = 0; chunk < block.chunks.size(); chunk++)
+        {
+            int availability = 0;
+
+            if(block.chunks[chunk] || block.requests.find(chunk) != block.requests.end())
+                continue;
+
+            for(auto peer = block.peerChunks.begin(); peer != block.peerChunks.end(); peer++)
+            {
+                if(peer->second[chunk])
+                    availability++;
+            }
+
+            if(availability > 0)
+                candidates.push_back(std::make_pair(availability, chunk));
+        }
+
+        /*
+         * Rarest first: the chunks few peers have are fetched before they become a bottleneck
+         */
+        std::sort(candidates.begin(), candidates.end());
+
+        for(auto candidate = candidates.begin(); candidate != candidates.end(); candidate++)
+        {
+            int             chunk = candidate->second;
+            bool            found = false;
+            Ipv4Address     selected;
+            uint32_t        selectedRequests = 0;
+
+            for(auto peer = block.peerChunks.begin(); peer != block.peerChunks.end(); peer++)
+            {
+                uint32_t pending = m_peerRequests.find(peer->first) == m_peerRequests.end() ? 0 : m_peerRequests[peer->first];
+
+                if(!peer->second[chunk] || (m_maxRequestsPerPeer > 0 && pending >= m_maxRequestsPerPeer))
+                    continue;
+
+                if(!found || pending < selectedRequests)
+                {
+                    found = true;
+                    selected = peer->first;
+                    selectedRequests = pending;
+                }
+            }
+
+            if(!found)
+                continue;
+
+            block.requests[chunk] = selected;
+            m_peerRequests[selected]++;
+            requests[selected].push_back(chunk);
+        }
+
+        return requests;
+    }
+
+    bool
+    BlockchainChunkSwarm::ChunkReceived(const std::string &blockHash, int chunk, Ipv4Address peer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end() || chunk < 0 || chunk >= static_cast<int>(it->second.chunks.size()))
+            return false;
+
+        SwarmBlock  &block = it->second;
+        auto        request = block.requests.find(chunk);
+
+        if(request != block.requests.end())
+        {
+            if(--m_peerRequests[request->second] == 0)
+                m_peerRequests.erase(request->second);
+            block.requests.erase(request);
+        }
+
+        if(block.peerChunks.find(peer) != block.peerChunks.end())
+            block.peerChunks[peer][chunk] = true;
+
+        if(block.chunks[chunk])
+            return false;
+
+        block.chunks[chunk] = true;
+        block.receivedChunks++;
+        block.sources.insert(peer);
+
+        return true;
+    }
+
+    bool
+    BlockchainChunkSwarm::IsComplete(const std::string &blockHash) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        return it != m_blocks.end() && it->second.receivedChunks == static_cast<int>(it->second.chunks.size());
+    }
+
+    std::map<int, Ipv4Address>
+    BlockchainChunkSwarm::ReleaseRequests(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::map<int, Ipv4Address>  released;
+        auto                        it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+            return released;
+
+        released.swap(it->second.requests);
+
+        for(auto request = released.begin(); request != released.end(); request++)
+        {
+            if(--m_peerRequests[request->second] == 0)
+                m_peerRequests.erase(request->second);
+        }
+
+        return released;
+    }
+
+    int
+    BlockchainChunkSwarm::GetSourceCount(const std::string &blockHash) const
+    {
+        auto it = m_blocks.find(blockHash);
+
+        if(it == m_blocks.end())
+            return 0;
+
+        return it->second.sources.size();
+    }
+
+    void
+    BlockchainChunkSwarm::RemoveBlock(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        ReleaseRequests(blockHash);
+        m_blocks.erase(blockHash);
+    }
+
+    void
+    BlockchainChunkSwarm::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_blocks.clear();
+        m_peerRequests.clear();
+    }
+
+}
@@ -0,0 +1,144 @@
+#ifndef BLOCKCHAIN_CHUNK_SWARM_H
+#define BLOCKCHAIN_CHUNK_SWARM_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * Bookkeeping of the chunked block downloads (blockTorrent).
+     * A block is split into fixed-size chunks. For every block being downloaded the swarm keeps the
+     * chunk bitmap of the node and of each peer that advertised the block, and the chunks requested
+     * from each peer. The missing chunks are requested rarest first from the least loaded peer that
+     * has them, so the chunks of one block come from many peers at once.
+     */
+    class BlockchainChunkSwarm
+    {
+        public:
+            BlockchainChunkSwarm(void);
+            virtual ~BlockchainChunkSwarm(void);
+
+            /*
+             * Sets the size of the chunks in Bytes
+             */
+            void SetChunkSize(uint32_t chunkSizeBytes);
+
+            /*
+             * Sets the maximum number of chunks requested from a peer at the same time (0 : unlimited)
+             */
+            void SetMaxRequestsPerPeer(uint32_t maxRequestsPerPeer);
+
+            /*
+             * return the number of chunks of a block
+             */
+            int GetChunkCount(int blockSizeBytes) const;
+
+            /*
+             * return the size of a chunk of a block, the last chunk holds the remaining bytes
+             */
+            int GetChunkSizeBytes(int blockSizeBytes, int chunk) const;
+
+            /*
+             * Starts the download of a block
+             * param header : the block without its transactions
+             * return false : if the block is already being downloaded
+             */
+            bool AddBlock(const std::string &blockHash, const Block &header);
+
+            bool HasBlock(const std::string &blockHash) const;
+
+            /*
+             * return the headers of a block being downloaded
+             */
+            const Block& GetHeader(const std::string &blockHash) const;
+
+            /*
+             * The transactions of the block travel with its first chunk
+             */
+            void SetTransactions(const std::string &blockHash, const std::vector<Transaction> &transactions);
+
+            std::vector<Transaction> GetTransactions(const std::string &blockHash) const;
+
+            /*
+             * Records the chunks a peer has advertised
+             * param address : the address the chunks are requested from
+             */
+            void AddPeerChunks(const std::string &blockHash, Ipv4Address peer, const Address &address, const std::vector<int> &chunks);
+
+            /*
+             * Forgets the chunks of a peer, e.g. when it did not deliver them in time
+             */
+            void RemovePeer(const std::string &blockHash, Ipv4Address peer);
+
+            /*
+             * return true if the peer has advertised every chunk of the block
+             */
+            bool PeerHasAllChunks(const std::string &blockHash, Ipv4Address peer) const;
+
+            /*
+             * return the number of peers that advertised chunks of the block
+             */
+            int GetPeerCount(const std::string &blockHash) const;
+
+            Address GetPeerAddress(const std::string &blockHash, Ipv4Address peer) const;
+
+            bool HasChunk(const std::string &blockHash, int chunk) const;
+
+            /*
+             * Selects the next chunks to request, rarest first, and marks them as requested
+             * return the chunks to request from each peer
+             */
+            std::map<Ipv4Address, std::vector<int>> SelectRequests(const std::string &blockHash);
+
+            /*
+             * Records a downloaded chunk and releases its request
+             * return true : if the chunk was missing, false : if it is a duplicate
+             */
+            bool ChunkReceived(const std::string &blockHash, int chunk, Ipv4Address peer);
+
+            bool IsComplete(const std::string &blockHash) const;
+
+            /*
+             * Forgets the pending chunk requests of a block
+             * return the peer each released chunk was requested from
+             */
+            std::map<int, Ipv4Address> ReleaseRequests(const std::string &blockHash);
+
+            /*
+             * return the number of peers that delivered at least one chunk of the block
+             */
+            int GetSourceCount(const std::string &blockHash) const;
+
+            void RemoveBlock(const std::string &blockHash);
+
+            void Clear(void);
+
+        protected:
+
+            struct SwarmBlock
+            {
+                Block                                       header;
+                std::vector<Transaction>                    transactions;
+                std::vector<bool>                           chunks;             // the chunk bitmap of the node
+                int                                         receivedChunks;
+                std::map<int, Ipv4Address>                  requests;           // chunk -> peer
+                std::map<Ipv4Address, std::vector<bool>>    peerChunks;         // the chunk bitmaps of the peers
+                std::map<Ipv4Address, Address>              addresses;
+                std::set<Ipv4Address>                       sources;
+            };
+
+            uint32_t                                m_chunkSize;            // Bytes
+            uint32_t                                m_maxRequestsPerPeer;
+            std::map<std::string, SwarmBlock>       m_blocks;
+            std::map<Ipv4Address, uint32_t>         m_peerRequests;         // pending chunk requests of each peer, over all the blocks
+    };
+
+}
+
+#endif
@@ -0,0 +1,153 @@
+#include <map>
+#include "ns3/log.h"
+#include "blockchain-compact-block.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainCompactBlock");
+
+    static inline uint64_t
+    RotateLeft(uint64_t x, int b)
+    {
+        return (x << b) | (x >> (64 - b));
+    }
+
+    static inline void
+    SipRound(uint64_t &v0, uint64_t &v1, uint64_t &v2, uint64_t &v3)
+    {
+        v0 += v1; v1 = RotateLeft(v1, 13); v1 ^= v0; v0 = RotateLeft(v0, 32);
+        v2 += v3; v3 = RotateLeft(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = RotateLeft(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = RotateLeft(v1, 17); v1 ^= v2; v2 = RotateLeft(v2, 32);
+    }
+
+    BlockchainCompactBlock::BlockchainCompactBlock(void) : m_k0(0), m_k1(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainCompactBlock::BlockchainCompactBlock(int height, int minerId, uint64_t nonce)
+    {
+        NS_LOG_FUNCTION(this);
+        SetKey(height, minerId, nonce);
+    }
+
+    BlockchainCompactBlock::~BlockchainCompactBlock(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainCompactBlock::SetKey(int height, int minerId, uint64_t nonce)
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * BIP152 takes the key from SHA256(header || nonce). The block hash of this simulator is its
+         * height and miner, so the key is derived from them and the nonce with two fixed-key SipHashes.
+         */
+        uint64_t words[2];
+
+        words[0] = (static_cast<uint64_t>(static_cast<uint32_t>(height)) << 32) | static_cast<uint32_t>(minerId);
+        words[1] = nonce;
+
+        m_k0 = SipHash(0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, words, 2);
+        m_k1 = SipHash(0x0f0e0d0c0b0a0908ULL, 0x0706050403020100ULL, words, 2);
+    }
+
+    uint64_t
+    BlockchainCompactBlock::GetShortId(int nodeId, int transId) const
+    {
+        uint64_t word = (static_cast<uint64_t>(static_cast<uint32_t>(nodeId)) << 32) | static_cast<uint32_t>(transId);
+
+        return SipHash(m_k0, m_k1, &word, 1) & 0xffffffffffffULL;
+    }
+
+    uint64_t
+    BlockchainCompactBlock::GetShortId(const Transaction &transaction) const
+    {
+        return GetShortId(transaction.GetTransNodeId(), transaction.GetTransId());
+    }
+
+    bool
+    BlockchainCompactBlock::Reconstruct(const std::vector<uint64_t> &shortIds, const std::vector<Transaction> &pool,
+                                        std::vector<Transaction> &transactions, std::vector<int> &missing) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::map<uint64_t, int>     positions;          // short ID -> position in the block
+        std::vector<int>            matches(shortIds.size(), 0);
+
+        transactions.assign(shortIds.size(), Transaction());
+        missing.clear();
+
+        for(unsigned int i = 0; i < shortIds.size(); i++)
+        {
+            if(!positions.insert(std::make_pair(shortIds[i], i)).second)
+            {
+                NS_LOG_INFO("Reconstruct : two transactions of the block have the short ID " << shortIds[i]);
+                return false;
+            }
+        }
+
+        for(auto it = pool.begin(); it != pool.end(); it++)
+        {
+            auto position = positions.find(GetShortId(*it));
+
+            if(position == positions.end())
+                continue;
+
+            /*
+             * The same transaction may be in the pool twice, only different ones are ambiguous
+             */
+            if(matches[position->second] == 0 || !(transactions[position->second] == *it))
+            {
+                transactions[position->second] = *it;
+                matches[position->second]++;
+            }
+        }
+
+        for(unsigned int i = 0; i < shortIds.size(); i++)
+        {
+            if(matches[i] != 1)
+            {
+                transactions[i] = Transaction();
+                missing.push_back(i);
+            }
+        }
+
+        return true;
+    }
+
+    uint64_t
+    BlockchainCompactBlock::SipHash(uint64_t k0, uint64_t k1, const uint64_t *words, int count)
+    {
+        uint64_t v0 = k0 ^ 0x736f6d6570736575ULL;
+        uint64_t v1 = k1 ^ 0x646f72616e646f6dULL;
+        uint64_t v2 = k0 ^ 0x6c7967656e657261ULL;
+        uint64_t v3 = k1 ^ 0x7465646279746573ULL;
+        uint64_t last = static_cast<uint64_t>(count * 8) << 56;
+
+        for(int i = 0; i < count; i++)
+        {
+            v3 ^= words[i];
+            SipRound(v0, v1, v2, v3);
+            SipRound(v0, v1, v2, v3);
+            v0 ^= words[i];
+        }
+
+        v3 ^= last;
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        v0 ^= last;
+
+        v2 ^= 0xff;
+        for(int i = 0; i < 4; i++)
+        {
+            SipRound(v0, v1, v2, v3);
+        }
+
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+
+}
@@ -0,0 +1,80 @@
+#ifndef BLOCKCHAIN_COMPACT_BLOCK_H
+#define BLOCKCHAIN_COMPACT_BLOCK_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/address.h"
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * Short transaction IDs of the compact blocks (BIP152).
+     * A compact block lists its transactions as 6-byte short IDs: SipHash-2-4 of the transaction id,
+     * keyed by the block hash and a nonce chosen by the sender. The key changes with every block and
+     * every sender, so a collision in one compact block does not repeat in the next one. The receiver
+     * matches the IDs against its own transactions and asks the sender only for the missing ones.
+     */
+    class BlockchainCompactBlock
+    {
+        public:
+            BlockchainCompactBlock(void);
+
+            /*
+             * param height, minerId : the block the short IDs belong to
+             * param nonce : the nonce of the compact block
+             */
+            BlockchainCompactBlock(int height, int minerId, uint64_t nonce);
+
+            virtual ~BlockchainCompactBlock(void);
+
+            void SetKey(int height, int minerId, uint64_t nonce);
+
+            /*
+             * return the 48-bit short ID of a transaction
+             */
+            uint64_t GetShortId(int nodeId, int transId) const;
+
+            uint64_t GetShortId(const Transaction &transaction) const;
+
+            /*
+             * Matches the short IDs of a block against a transaction pool
+             * param shortIds : the short IDs, in block order
+             * param pool : the transactions the receiver has
+             * param transactions : filled with one transaction per short ID, the missing ones are left default
+             * param missing : filled with the positions (in shortIds) of the transactions that are not in
+             *                 the pool or match more than one transaction of the pool
+             * return false : if two short IDs of the block are equal, the block must be downloaded in full
+             */
+            bool Reconstruct(const std::vector<uint64_t> &shortIds, const std::vector<Transaction> &pool,
+                            std::vector<Transaction> &transactions, std::vector<int> &missing) const;
+
+            /*
+             * SipHash-2-4 of a message made of 64-bit little-endian words
+             */
+            static uint64_t SipHash(uint64_t k0, uint64_t k1, const uint64_t *words, int count);
+
+            static const int m_shortIdSizeBytes = 6;
+
+        protected:
+
+            uint64_t    m_k0;
+            uint64_t    m_k1;
+    };
+
+    /*
+     * A compact block waiting for the transactions its receiver did not have
+     */
+    struct PartialCompactBlock
+    {
+        Block                       header;             // the block without its transactions
+        std::vector<Transaction>    transactions;
+        std::vector<int>            missing;            // the block indexes requested with GET_BLOCK_TXN
+        Address                     peer;
+        int                         receivedBytes;      // CMPCT_BLOCK or GRAPHENE_BLOCK + BLOCK_TXN
+        bool                        graphene;           // announced with a GRAPHENE_BLOCK
+    };
+
+}
+
+#endif
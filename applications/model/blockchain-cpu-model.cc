@@ -0,0 +1,335 @@
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "blockchain-cpu-model.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainCpuModel");
+
+    BlockchainCpuModel::BlockchainCpuModel(void) : m_hardwareClass(STANDARD_HARDWARE), m_busyUntil(0), m_maxQueueLength(0),
+                                                m_totalQueueDelay(0), m_totalWork(0), m_busyTime(0)
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * Built-in cost table for STANDARD_HARDWARE: rapidjson parsing and handling of the messages,
+         * secp256k1 signature verification per transaction, the legacy block validation
+         * rate of 0.174s per 238263 Bytes and the SSSE3 Reed-Solomon multiply-add rate.
+         * The votes of the consensus engines are signed with the same curve as the transactions, and a share of a
+         * threshold signature is combined with one scalar multiplication.
+         */
+        m_defaultMessageBaseCost = 10e-6;
+        m_defaultMessagePerByteCost = 5e-9;
+        m_transactionValidationCost = 100e-6;
+        m_blockValidationCostPerByte = 0.174 / 238263;
+        m_erasureCodingCostPerByte = 0.2e-9;
+        m_signatureVerificationCost = 100e-6;
+        m_signatureAggregationCost = 80e-6;
+
+        SetMessageCost(INV, 8e-6, 5e-9);
+        SetMessageCost(GET_HEADERS, 8e-6, 5e-9);
+        SetMessageCost(HEADERS, 12e-6, 5e-9);
+        SetMessageCost(GET_DATA, 15e-6, 5e-9);
+        SetMessageCost(BLOCK, 20e-6, 6e-9);
+
+        m_creationTime = Simulator::Now().GetSeconds();
+    }
+
+    BlockchainCpuModel::~BlockchainCpuModel(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    enum HardwareClass
+    BlockchainCpuModel::GetHardwareClass(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_hardwareClass;
+    }
+
+    void
+    BlockchainCpuModel::SetHardwareClass(enum HardwareClass hardwareClass)
+    {
+        NS_LOG_FUNCTION(this);
+        m_hardwareClass = hardwareClass;
+    }
+
+    bool
+    BlockchainCpuModel::LoadCostTable(const std::string &fileName)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::ifstream   costTable(fileName.c_str());
+        std::string     line;
+
+        if(!costTable.is_open())
+        {
+            NS_LOG_WARN("LoadCostTable : cannot open " << fileName);
+            return false;
+        }
+
+        while(std::getline(costTable, line))
+        {
+            std::istringstream  lineStream(line);
+            std::string         key;
+
+            if(!(lineStream >> key) || key[0] == '#')
+                continue;
+
+            if(key == "message")
+            {
+                std::string name;
+                double      baseSeconds;
+                double      perByteSeconds;
+                bool        found = false;
+
+                if(!(lineStream >> name >> baseSeconds >> perByteSeconds))
+                {
+                    NS_LOG_WARN("LoadCostTable : malformed line '" << line << "'");
+                    return false;
+                }
+
+                for(int m = 0; getMessageName(static_cast<enum Messages>(m)) != 0; m++)
+                {
+                    if(name == getMessageName(static_cast<enum Messages>(m)))
+                    {
+                        SetMessageCost(static_cast<enum Messages>(m), baseSeconds, perByteSeconds);
+                        found = true;
+                        break;
+                    }
+                }
+
+                if(!found)
+                {
+                    NS_LOG_WARN("LoadCostTable : unknown message " << name);
+                    return false;
+                }
+            }
+            else if(key == "transactionValidation")
+            {
+                if(!(lineStream >> m_transactionValidationCost))
+                    return false;
+            }
+            else if(key == "blockValidationPerByte")
+            {
+                if(!(lineStream >> m_blockValidationCostPerByte))
+                    return false;
+            }
+            else if(key == "erasureCodingPerByte")
+            {
+                if(!(lineStream >> m_erasureCodingCostPerByte))
+                    return false;
+            }
+            else if(key == "signatureVerification")
+            {
+                if(!(lineStream >> m_signatureVerificationCost))
+                    return false;
+            }
+            else if(key == "signatureAggregation")
+            {
+                if(!(lineStream >> m_signatureAggregationCost))
+                    return false;
+            }
+            else
+            {
+                NS_LOG_WARN("LoadCostTable : unknown key " << key);
+                return false;
+            }
+        }
+
+        NS_LOG_INFO("LoadCostTable : loaded " << fileName);
+        return true;
+    }
+
+    void
+    BlockchainCpuModel::SetMessageCost(enum Messages message, double baseSeconds, double perByteSeconds)
+    {
+        NS_LOG_FUNCTION(this);
+        m_messageBaseCosts[message] = baseSeconds;
+        m_messagePerByteCosts[message] = perByteSeconds;
+    }
+
+    void
+    BlockchainCpuModel::SetTransactionValidationCost(double seconds)
+    {
+        NS_LOG_FUNCTION(this);
+        m_transactionValidationCost = seconds;
+    }
+
+    void
+    BlockchainCpuModel::SetBlockValidationCostPerByte(double seconds)
+    {
+        NS_LOG_FUNCTION(this);
+        m_blockValidationCostPerByte = seconds;
+    }
+
+    void
+    BlockchainCpuModel::SetErasureCodingCostPerByte(double seconds)
+    {
+        NS_LOG_FUNCTION(this);
+        m_erasureCodingCostPerByte = seconds;
+    }
+
+    void
+    BlockchainCpuModel::SetSignatureVerificationCost(double seconds)
+    {
+        NS_LOG_FUNCTION(this);
+        m_signatureVerificationCost = seconds;
+    }
+
+    void
+    BlockchainCpuModel::SetSignatureAggregationCost(double seconds)
+    {
+        NS_LOG_FUNCTION(this);
+        m_signatureAggregationCost = seconds;
+    }
+
+    double
+    BlockchainCpuModel::GetMessageCost(enum Messages message, int sizeBytes, int transactions) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        double baseCost = m_defaultMessageBaseCost;
+        double perByteCost = m_defaultMessagePerByteCost;
+        std::map<int, double>::const_iterator it;
+
+        if((it = m_messageBaseCosts.find(message)) != m_messageBaseCosts.end())
+            baseCost = it->second;
+        if((it = m_messagePerByteCosts.find(message)) != m_messagePerByteCosts.end())
+            perByteCost = it->second;
+
+        return GetHardwareFactor() * (baseCost + perByteCost * sizeBytes + m_transactionValidationCost * transactions);
+    }
+
+    double
+    BlockchainCpuModel::GetBlockValidationCost(int sizeBytes, int transactions) const
+    {
+        NS_LOG_FUNCTION(this);
+        return GetHardwareFactor() * (m_blockValidationCostPerByte * sizeBytes + m_transactionValidationCost * transactions);
+    }
+
+    double
+    BlockchainCpuModel::GetErasureEncodeCost(int sizeBytes, int parityChunks) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * Every parity chunk is a combination of all the data chunks, i.e. of the whole block
+         */
+        return GetHardwareFactor() * m_erasureCodingCostPerByte * sizeBytes * parityChunks;
+    }
+
+    double
+    BlockchainCpuModel::GetErasureDecodeCost(int sizeBytes, int missingChunks) const
+    {
+        NS_LOG_FUNCTION(this);
+        return GetHardwareFactor() * m_erasureCodingCostPerByte * sizeBytes * missingChunks;
+    }
+
+    double
+    BlockchainCpuModel::GetSignatureVerificationCost(int signatures) const
+    {
+        NS_LOG_FUNCTION(this);
+        return GetHardwareFactor() * m_signatureVerificationCost * signatures;
+    }
+
+    double
+    BlockchainCpuModel::GetSignatureAggregationCost(int shares) const
+    {
+        NS_LOG_FUNCTION(this);
+        return GetHardwareFactor() * m_signatureAggregationCost * shares;
+    }
+
+    double
+    BlockchainCpuModel::Reserve(double cost)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+        double start = std::max(now, m_busyUntil);
+
+        RemoveFinishedWork();
+
+        m_busyUntil = start + cost;
+        m_totalQueueDelay += start - now;
+        m_totalWork++;
+        m_busyTime += cost;
+
+        if(cost > 0)
+        {
+            m_pendingWork.push_back(m_busyUntil);
+            m_maxQueueLength = std::max(m_maxQueueLength, static_cast<uint32_t>(m_pendingWork.size()));
+        }
+
+        return m_busyUntil - now;
+    }
+
+    uint32_t
+    BlockchainCpuModel::GetQueueLength(void)
+    {
+        NS_LOG_FUNCTION(this);
+        RemoveFinishedWork();
+        return m_pendingWork.size();
+    }
+
+    uint32_t
+    BlockchainCpuModel::GetMaxQueueLength(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_maxQueueLength;
+    }
+
+    double
+    BlockchainCpuModel::GetMeanQueueDelay(void) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_totalWork == 0)
+            return 0;
+
+        return m_totalQueueDelay / m_totalWork;
+    }
+
+    double
+    BlockchainCpuModel::GetUtilization(void) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+        double elapsed = now - m_creationTime;
+
+        if(elapsed <= 0)
+            return 0;
+
+        return (m_busyTime - std::max(0.0, m_busyUntil - now)) / elapsed;
+    }
+
+    double
+    BlockchainCpuModel::GetHardwareFactor(void) const
+    {
+        switch(m_hardwareClass)
+        {
+            case IDEAL_HARDWARE: return 0;
+            case LOW_END_HARDWARE: return 2;
+            case STANDARD_HARDWARE: return 1;
+            case HIGH_END_HARDWARE: return 0.5;
+        }
+
+        return 1;
+    }
+
+    void
+    BlockchainCpuModel::RemoveFinishedWork(void)
+    {
+        double now = Simulator::Now().GetSeconds();
+
+        while(!m_pendingWork.empty() && m_pendingWork.front() <= now)
+        {
+            m_pendingWork.pop_front();
+        }
+    }
+
+}
@@ -0,0 +1,144 @@
+#ifndef BLOCKCHAIN_CPU_MODEL_H
+#define BLOCKCHAIN_CPU_MODEL_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * Processing cost model of a node's CPU. Incoming messages and block validations are served one
+     * at a time. Each costs the time given by the cost table, scaled by the hardware class of the node.
+     * The built-in cost table corresponds to STANDARD_HARDWARE; scratch/blockchain_cpu_calibration
+     * measures a new one on the host.
+     */
+    class BlockchainCpuModel
+    {
+        public:
+            BlockchainCpuModel(void);
+            virtual ~BlockchainCpuModel(void);
+
+            enum HardwareClass GetHardwareClass(void) const;
+            void SetHardwareClass(enum HardwareClass hardwareClass);
+
+            /*
+             * Loads a cost table. Every line is either
+             *   message <MESSAGE_NAME> <base seconds> <seconds per byte>
+             *   transactionValidation <seconds>
+             *   blockValidationPerByte <seconds>
+             *   erasureCodingPerByte <seconds>
+             *   signatureVerification <seconds>
+             *   signatureAggregation <seconds>
+             * Empty lines and lines starting with '#' are ignored.
+             * param fileName : the cost table file
+             * return false : if the file cannot be read or is malformed
+             */
+            bool LoadCostTable(const std::string &fileName);
+
+            void SetMessageCost(enum Messages message, double baseSeconds, double perByteSeconds);
+
+            void SetTransactionValidationCost(double seconds);
+
+            void SetBlockValidationCostPerByte(double seconds);
+            void SetErasureCodingCostPerByte(double seconds);
+            void SetSignatureVerificationCost(double seconds);
+            void SetSignatureAggregationCost(double seconds);
+
+            /*
+             * The CPU time needed to parse and handle a message
+             * param message : the message type
+             * param sizeBytes : the size of the encoded message
+             * param transactions : the number of signed transactions carried by the message
+             */
+            double GetMessageCost(enum Messages message, int sizeBytes, int transactions) const;
+
+            /*
+             * The CPU time needed to validate a block
+             * param sizeBytes : the block size
+             * param transactions : the number of transactions in the block
+             */
+            double GetBlockValidationCost(int sizeBytes, int transactions) const;
+
+            /*
+             * The CPU time needed to compute the parity chunks of an erasure-coded block
+             * param sizeBytes : the block size
+             * param parityChunks : the number of parity chunks
+             */
+            double GetErasureEncodeCost(int sizeBytes, int parityChunks) const;
+
+            /*
+             * The CPU time needed to rebuild an erasure-coded block
+             * param sizeBytes : the block size
+             * param missingChunks : the number of data chunks rebuilt from the parity chunks
+             */
+            double GetErasureDecodeCost(int sizeBytes, int missingChunks) const;
+
+            /*
+             * The CPU time needed to verify the signatures of a consensus message, its own and the ones of the
+             * certificates it carries
+             * param signatures : the number of signatures
+             */
+            double GetSignatureVerificationCost(int signatures) const;
+
+            /*
+             * The CPU time needed to combine signature shares into a threshold signature, which then verifies as
+             * a single signature
+             * param shares : the number of shares combined
+             */
+            double GetSignatureAggregationCost(int shares) const;
+
+            /*
+             * Queues work on the CPU behind the work already accepted
+             * param cost : the CPU time of the work
+             * return the delay from now until the work is finished
+             */
+            double Reserve(double cost);
+
+            uint32_t GetQueueLength(void);
+
+            uint32_t GetMaxQueueLength(void) const;
+
+            /*
+             * The average time a piece of work waited for the CPU before being served
+             */
+            double GetMeanQueueDelay(void) const;
+
+            /*
+             * Fraction of time the CPU has been busy since the model was created
+             */
+            double GetUtilization(void) const;
+
+        protected:
+
+            double GetHardwareFactor(void) const;
+
+            /*
+             * Removes the finished work from m_pendingWork
+             */
+            void RemoveFinishedWork(void);
+
+            enum HardwareClass              m_hardwareClass;
+            std::map<int, double>           m_messageBaseCosts;             // seconds, indexed by enum Messages
+            std::map<int, double>           m_messagePerByteCosts;          // seconds per byte, indexed by enum Messages
+            double                          m_defaultMessageBaseCost;       // for the messages missing from the table
+            double                          m_defaultMessagePerByteCost;
+            double                          m_transactionValidationCost;    // signature verification of one transaction
+            double                          m_blockValidationCostPerByte;
+            double                          m_erasureCodingCostPerByte;     // GF(2^8) multiply-add of one byte
+            double                          m_signatureVerificationCost;    // verification of one signature of a consensus message
+            double                          m_signatureAggregationCost;     // one share of a threshold signature, times its Lagrange coefficient
+
+            double                          m_busyUntil;                    // the time the accepted work is finished
+            std::deque<double>              m_pendingWork;                  // the finish times of the accepted work
+            uint32_t                        m_maxQueueLength;
+            double                          m_totalQueueDelay;
+            long                            m_totalWork;
+            double                          m_busyTime;
+            double                          m_creationTime;
+    };
+
+}
+
+#endif
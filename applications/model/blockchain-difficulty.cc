@@ -0,0 +1,131 @@
+#include <math.h>
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-difficulty.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainDifficulty");
+
+    BlockchainDifficulty::BlockchainDifficulty(void) : m_adjustment(FIXED_DIFFICULTY), m_targetInterval(15), m_retargetInterval(2016)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainDifficulty::~BlockchainDifficulty(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainDifficulty::SetAdjustment(enum DifficultyAdjustment adjustment)
+    {
+        NS_LOG_FUNCTION(this);
+        m_adjustment = adjustment;
+    }
+
+    enum DifficultyAdjustment
+    BlockchainDifficulty::GetAdjustment(void) const
+    {
+        return m_adjustment;
+    }
+
+    void
+    BlockchainDifficulty::SetTargetInterval(double seconds)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(seconds <= 0)
+            NS_FATAL_ERROR("The target block interval must be positive");
+
+        m_targetInterval = seconds;
+    }
+
+    double
+    BlockchainDifficulty::GetTargetInterval(void) const
+    {
+        return m_targetInterval;
+    }
+
+    void
+    BlockchainDifficulty::SetRetargetInterval(int blocks)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(blocks < 2)
+            NS_FATAL_ERROR("An epoch needs at least 2 blocks to measure an interval");
+
+        m_retargetInterval = blocks;
+    }
+
+    int
+    BlockchainDifficulty::GetRetargetInterval(void) const
+    {
+        return m_retargetInterval;
+    }
+
+    double
+    BlockchainDifficulty::GetNextDifficulty(const Block &parent, Blockchain &blockchain, const std::vector<Block> &privateChain) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_adjustment == EPOCH_RETARGET)
+            return RetargetEpoch(parent, blockchain, privateChain);
+        else if(m_adjustment == PER_BLOCK_ADJUSTMENT)
+            return AdjustPerBlock(parent, blockchain, privateChain);
+
+        return parent.GetDifficulty();
+    }
+
+    double
+    BlockchainDifficulty::RetargetEpoch(const Block &parent, Blockchain &blockchain, const std::vector<Block> &privateChain) const
+    {
+        int height = parent.GetBlockHeight() + 1;
+
+        if(height % m_retargetInterval != 0)
+            return parent.GetDifficulty();
+
+        /*
+         * The epoch goes from the height - RetargetInterval to the parent, that is RetargetInterval - 1 intervals
+         */
+        const Block *first = &parent;
+
+        for(int i = 1; i < m_retargetInterval && first != nullptr; i++)
+            first = GetParent(*first, blockchain, privateChain);
+
+        if(first == nullptr)
+            return parent.GetDifficulty();
+
+        double meanInterval = (parent.GetTimeStamp() - first->GetTimeStamp()) / (m_retargetInterval - 1);
+        double factor = meanInterval > 0 ? m_targetInterval / meanInterval : 4;
+
+        return parent.GetDifficulty() * std::min(std::max(factor, 0.25), 4.0);
+    }
+
+    double
+    BlockchainDifficulty::AdjustPerBlock(const Block &parent, Blockchain &blockchain, const std::vector<Block> &privateChain) const
+    {
+        const Block *grandParent = parent.GetBlockHeight() > 0 ? GetParent(parent, blockchain, privateChain) : nullptr;
+
+        if(grandParent == nullptr)
+            return parent.GetDifficulty();
+
+        double bucket = m_targetInterval * log(2.0);
+        double sigma = std::max(1 - floor((parent.GetTimeStamp() - grandParent->GetTimeStamp()) / bucket), -99.0);
+
+        return parent.GetDifficulty() + parent.GetDifficulty() / 2048 * sigma;
+    }
+
+    const Block*
+    BlockchainDifficulty::GetParent(const Block &block, Blockchain &blockchain, const std::vector<Block> &privateChain) const
+    {
+        for(auto it = privateChain.begin(); it != privateChain.end(); it++)
+        {
+            if(it->GetBlockHeight() == block.GetBlockHeight() - 1 && it->GetMinerId() == block.GetParentBlockMinerId())
+                return &(*it);
+        }
+
+        return blockchain.GetParent(block);
+    }
+
+}
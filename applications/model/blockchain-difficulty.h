@@ -0,0 +1,66 @@
+#ifndef BLOCKCHAIN_DIFFICULTY_H
+#define BLOCKCHAIN_DIFFICULTY_H
+
+#include <vector>
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * The difficulty controller of a miner. The difficulty of a block only depends on its ancestors, so
+     * all the miners on the same chain agree on it, and a miner finds blocks at the rate
+     * hashRate / (target interval * difficulty):
+     *   - EPOCH_RETARGET keeps the difficulty for RetargetInterval blocks, then scales it by the target interval
+     *     over the mean interval of the epoch, by a factor 4 at most (Bitcoin);
+     *   - PER_BLOCK_ADJUSTMENT adds difficulty/2048 * max(1 - floor(interval/bucket), -99) at every block (Ethereum
+     *     Homestead). The interval is the one of the parent, as the miners do not choose the timestamps of their blocks,
+     *     and bucket = target * ln 2 puts the mean of an exponential interval at the target.
+     * The ancestors of a private block are looked up in the private chain of the miner first. The blocks whose
+     * ancestors are missing keep the difficulty of their parent.
+     */
+    class BlockchainDifficulty
+    {
+        public:
+            BlockchainDifficulty(void);
+            virtual ~BlockchainDifficulty(void);
+
+            void SetAdjustment(enum DifficultyAdjustment adjustment);
+            enum DifficultyAdjustment GetAdjustment(void) const;
+
+            /*
+             * param seconds : the mean block interval aimed at
+             */
+            void SetTargetInterval(double seconds);
+            double GetTargetInterval(void) const;
+
+            /*
+             * param blocks : the blocks of an epoch of EPOCH_RETARGET
+             */
+            void SetRetargetInterval(int blocks);
+            int GetRetargetInterval(void) const;
+
+            /*
+             * return the difficulty of a block mined on top of the parent
+             * param privateChain : the unpublished blocks the parent may extend, by increasing height
+             */
+            double GetNextDifficulty(const Block &parent, Blockchain &blockchain,
+                                    const std::vector<Block> &privateChain = std::vector<Block>()) const;
+
+        protected:
+
+            double RetargetEpoch(const Block &parent, Blockchain &blockchain, const std::vector<Block> &privateChain) const;
+            double AdjustPerBlock(const Block &parent, Blockchain &blockchain, const std::vector<Block> &privateChain) const;
+
+            /*
+             * return the parent of a block in the private chain or in the blockchain, nullptr if it is missing
+             */
+            const Block* GetParent(const Block &block, Blockchain &blockchain, const std::vector<Block> &privateChain) const;
+
+            enum DifficultyAdjustment   m_adjustment;
+            double                      m_targetInterval;
+            int                         m_retargetInterval;
+    };
+
+}
+
+#endif
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-download-scheduler.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainDownloadScheduler");
+
+    BlockchainDownloadScheduler::BlockchainDownloadScheduler(void) : m_maxInFlightPerPeer(0), m_maxInFlight(0), m_maxBusyPeers(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainDownloadScheduler::~BlockchainDownloadScheduler(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainDownloadScheduler::SetMaxInFlightPerPeer(uint32_t maxInFlightPerPeer)
+    {
+        NS_LOG_FUNCTION(this);
+        m_maxInFlightPerPeer = maxInFlightPerPeer;
+    }
+
+    int
+    BlockchainDownloadScheduler::SelectPeer(const std::vector<Ipv4Address> &candidates, const std::vector<double> &throughputs, int sizeBytes) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        int     selected = -1;
+        double  bestFinish = 0;
+
+        for(unsigned int i = 0; i < candidates.size(); i++)
+        {
+            if(!HasCapacity(candidates[i]) || throughputs[i] <= 0)
+                continue;
+
+            auto    it = m_loads.find(candidates[i]);
+            double  queuedBytes = (it == m_loads.end()) ? 0 : it->second.bytes;
+            double  finish = (queuedBytes + sizeBytes) / throughputs[i];
+
+            if(selected < 0 || finish < bestFinish)
+            {
+                selected = i;
+                bestFinish = finish;
+            }
+        }
+
+        return selected;
+    }
+
+    bool
+    BlockchainDownloadScheduler::HasCapacity(Ipv4Address peer) const
+    {
+        return m_maxInFlightPerPeer == 0 || GetInFlight(peer) < m_maxInFlightPerPeer;
+    }
+
+    void
+    BlockchainDownloadScheduler::RequestIssued(const std::string &blockHash, Ipv4Address peer, int sizeBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        InFlightRequest request;
+
+        RequestFinished(blockHash);
+
+        request.peer = peer;
+        request.sizeBytes = sizeBytes;
+        m_inFlight[blockHash] = request;
+
+        PeerLoad &load = m_loads[peer];
+        load.requests++;
+        load.bytes += sizeBytes;
+
+        m_maxInFlight = std::max(m_maxInFlight, static_cast<uint32_t>(m_inFlight.size()));
+        m_maxBusyPeers = std::max(m_maxBusyPeers, static_cast<uint32_t>(m_loads.size()));
+    }
+
+    void
+    BlockchainDownloadScheduler::RequestFinished(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_inFlight.find(blockHash);
+
+        if(it != m_inFlight.end())
+        {
+            auto load = m_loads.find(it->second.peer);
+
+            load->second.requests--;
+            load->second.bytes -= it->second.sizeBytes;
+            if(load->second.requests == 0)
+                m_loads.erase(load);
+
+            m_inFlight.erase(it);
+        }
+
+        if(m_pendingBlocks.erase(blockHash) > 0)
+        {
+            m_pending.erase(std::find(m_pending.begin(), m_pending.end(), blockHash));
+        }
+    }
+
+    bool
+    BlockchainDownloadScheduler::IsInFlight(const std::string &blockHash) const
+    {
+        return m_inFlight.find(blockHash) != m_inFlight.end();
+    }
+
+    Ipv4Address
+    BlockchainDownloadScheduler::GetPeer(const std::string &blockHash) const
+    {
+        auto it = m_inFlight.find(blockHash);
+
+        if(it == m_inFlight.end())
+            return Ipv4Address();
+
+        return it->second.peer;
+    }
+
+    uint32_t
+    BlockchainDownloadScheduler::GetInFlight(Ipv4Address peer) const
+    {
+        auto it = m_loads.find(peer);
+
+        if(it == m_loads.end())
+            return 0;
+
+        return it->second.requests;
+    }
+
+    void
+    BlockchainDownloadScheduler::AddPending(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_pendingBlocks.insert(blockHash).second)
+            m_pending.push_back(blockHash);
+    }
+
+    bool
+    BlockchainDownloadScheduler::IsPending(const std::string &blockHash) const
+    {
+        return m_pendingBlocks.find(blockHash) != m_pendingBlocks.end();
+    }
+
+    std::vector<std::string>
+    BlockchainDownloadScheduler::TakePending(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::vector<std::string> pending(m_pending.begin(), m_pending.end());
+
+        m_pending.clear();
+        m_pendingBlocks.clear();
+
+        return pending;
+    }
+
+    void
+    BlockchainDownloadScheduler::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_loads.clear();
+        m_inFlight.clear();
+        m_pending.clear();
+        m_pendingBlocks.clear();
+    }
+
+    uint32_t
+    BlockchainDownloadScheduler::GetMaxInFlight(void) const
+    {
+        return m_maxInFlight;
+    }
+
+    uint32_t
+    BlockchainDownloadScheduler::GetMaxBusyPeers(void) const
+    {
+        return m_maxBusyPeers;
+    }
+
+}
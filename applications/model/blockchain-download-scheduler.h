@@ -0,0 +1,105 @@
+#ifndef BLOCKCHAIN_DOWNLOAD_SCHEDULER_H
+#define BLOCKCHAIN_DOWNLOAD_SCHEDULER_H
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+    /*
+     * Spreads the block requests of a node over the peers that announced the blocks.
+     * Each block goes to the announcer expected to deliver it first: the one with the smallest
+     * (bytes in flight + block size) / measured throughput. A peer never has more than
+     * m_maxInFlightPerPeer requests in flight. The blocks that find no free announcer wait in a
+     * pending queue until a request finishes.
+     */
+    class BlockchainDownloadScheduler
+    {
+        public:
+            BlockchainDownloadScheduler(void);
+            virtual ~BlockchainDownloadScheduler(void);
+
+            /*
+             * param maxInFlightPerPeer : the request limit per peer, 0 : unlimited
+             */
+            void SetMaxInFlightPerPeer(uint32_t maxInFlightPerPeer);
+
+            /*
+             * Selects the peer a block is requested from
+             * param candidates : the peers that announced the block
+             * param throughputs : the throughput of every candidate in Bytes/s
+             * param sizeBytes : the expected size of the block
+             * return the index of the selected candidate, -1 : if every candidate is at its limit
+             */
+            int SelectPeer(const std::vector<Ipv4Address> &candidates, const std::vector<double> &throughputs, int sizeBytes) const;
+
+            bool HasCapacity(Ipv4Address peer) const;
+
+            /*
+             * Records a request. A block already in flight is moved to the new peer.
+             */
+            void RequestIssued(const std::string &blockHash, Ipv4Address peer, int sizeBytes);
+
+            /*
+             * Forgets the request or the pending entry of a block
+             */
+            void RequestFinished(const std::string &blockHash);
+
+            bool IsInFlight(const std::string &blockHash) const;
+
+            /*
+             * return the peer the block is requested from, only meaningful if IsInFlight(blockHash)
+             */
+            Ipv4Address GetPeer(const std::string &blockHash) const;
+
+            uint32_t GetInFlight(Ipv4Address peer) const;
+
+            void AddPending(const std::string &blockHash);
+
+            bool IsPending(const std::string &blockHash) const;
+
+            /*
+             * Empties the pending queue
+             * return the pending blocks, oldest first
+             */
+            std::vector<std::string> TakePending(void);
+
+            void Clear(void);
+
+            uint32_t GetMaxInFlight(void) const;
+
+            /*
+             * return the largest number of peers that were downloading blocks for the node at the same time
+             */
+            uint32_t GetMaxBusyPeers(void) const;
+
+        protected:
+
+            struct PeerLoad
+            {
+                uint32_t    requests;
+                double      bytes;
+            };
+
+            struct InFlightRequest
+            {
+                Ipv4Address peer;
+                int         sizeBytes;
+            };
+
+            uint32_t                                    m_maxInFlightPerPeer;
+            std::map<Ipv4Address, PeerLoad>             m_loads;            // only the peers with requests in flight
+            std::map<std::string, InFlightRequest>      m_inFlight;
+            std::deque<std::string>                     m_pending;
+            std::set<std::string>                       m_pendingBlocks;    // the content of m_pending
+            uint32_t                                    m_maxInFlight;
+            uint32_t                                    m_maxBusyPeers;
+    };
+
+}
+
+#endif
@@ -0,0 +1,461 @@
+#include <string.h>
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-erasure-code.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define BLOCKCHAIN_ERASURE_CODE_X86
+#endif
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainErasureCode");
+
+    /*
+     * Exp, log and product tables of GF(2^8) with the polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11d)
+     */
+    struct GaloisTables
+    {
+        uint8_t exp[512];
+        uint8_t log[256];
+        uint8_t mul[256][256];
+
+        GaloisTables(void)
+        {
+            int x = 1;
+
+            memset(log, 0, sizeof(log));
+            for(int i = 0; i < 255; i++)
+            {
+                exp[i] = x;
+                log[x] = i;
+                x <<= 1;
+                if(x & 0x100)
+                    x ^= 0x11d;
+            }
+            for(int i = 255; i < 512; i++)
+            {
+                exp[i] = exp[i - 255];
+            }
+
+            for(int a = 0; a < 256; a++)
+            {
+                for(int b = 0; b < 256; b++)
+                {
+                    mul[a][b] = (a == 0 || b == 0) ? 0 : exp[log[a] + log[b]];
+                }
+            }
+        }
+    };
+
+    static const GaloisTables&
+    GetGaloisTables(void)
+    {
+        static const GaloisTables tables;
+        return tables;
+    }
+
+    enum ErasureCodeKernel
+    {
+        SCALAR_KERNEL,
+        SSSE3_KERNEL,
+        AVX2_KERNEL
+    };
+
+    static enum ErasureCodeKernel
+    DetectKernel(void)
+    {
+#ifdef BLOCKCHAIN_ERASURE_CODE_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            return AVX2_KERNEL;
+        if(__builtin_cpu_supports("ssse3"))
+            return SSSE3_KERNEL;
+#endif
+        return SCALAR_KERNEL;
+    }
+
+    static enum ErasureCodeKernel
+    GetKernel(void)
+    {
+        static const enum ErasureCodeKernel kernel = DetectKernel();
+        return kernel;
+    }
+
+#ifdef BLOCKCHAIN_ERASURE_CODE_X86
+    /*
+     * c * s = c * (s & 0x0f) ^ c * (s & 0xf0), so the product of 16 (or 32) bytes is two table
+     * lookups by nibble, done with one byte shuffle each.
+     * The kernels are compiled for their instruction set only and chosen at run time.
+     * return the number of bytes processed, the tail is left to the scalar loop
+     */
+    __attribute__((target("ssse3")))
+    static size_t
+    MultiplyAddSsse3(uint8_t *dst, const uint8_t *src, const uint8_t *lowTable, const uint8_t *highTable, size_t length)
+    {
+        const __m128i   low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowTable));
+        const __m128i   high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(highTable));
+        const __m128i   mask = _mm_set1_epi8(0x0f);
+        size_t          i = 0;
+
+        for(; i + 16 <= length; i += 16)
+        {
+            __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i l = _mm_shuffle_epi8(low, _mm_and_si128(s, mask));
+            __m128i h = _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi64(s, 4), mask));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(d, _mm_xor_si128(l, h)));
+        }
+
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static size_t
+    MultiplyAddAvx2(uint8_t *dst, const uint8_t *src, const uint8_t *lowTable, const uint8_t *highTable, size_t length)
+    {
+        const __m256i   low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lowTable)));
+        const __m256i   high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(highTable)));
+        const __m256i   mask = _mm256_set1_epi8(0x0f);
+        size_t          i = 0;
+
+        for(; i + 32 <= length; i += 32)
+        {
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i l = _mm256_shuffle_epi8(low, _mm256_and_si256(s, mask));
+            __m256i h = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi64(s, 4), mask));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(d, _mm256_xor_si256(l, h)));
+        }
+
+        return i;
+    }
+#endif
+
+    BlockchainErasureCode::BlockchainErasureCode(void) : m_dataShards(0), m_parityShards(0)
+    {
+        NS_LOG_FUNCTION(this);
+        SetShards(8, 8);
+    }
+
+    BlockchainErasureCode::~BlockchainErasureCode(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainErasureCode::SetShards(uint32_t dataShards, uint32_t parityShards)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(dataShards == 0 || dataShards + parityShards > 256)
+        {
+            NS_FATAL_ERROR("Error : the erasure code needs 1 to 256 shards, with at least one data shard");
+        }
+
+        m_dataShards = dataShards;
+        m_parityShards = parityShards;
+        m_parityMatrix.assign(parityShards * dataShards, 0);
+
+        /*
+         * Cauchy matrix 1 / (x_i + y_j) with x_i = k + i and y_j = j, all distinct
+         */
+        for(uint32_t i = 0; i < parityShards; i++)
+        {
+            for(uint32_t j = 0; j < dataShards; j++)
+            {
+                m_parityMatrix[i * dataShards + j] = Inverse((dataShards + i) ^ j);
+            }
+        }
+    }
+
+    uint32_t
+    BlockchainErasureCode::GetDataShards(void) const
+    {
+        return m_dataShards;
+    }
+
+    uint32_t
+    BlockchainErasureCode::GetParityShards(void) const
+    {
+        return m_parityShards;
+    }
+
+    uint32_t
+    BlockchainErasureCode::GetTotalShards(void) const
+    {
+        return m_dataShards + m_parityShards;
+    }
+
+    int
+    BlockchainErasureCode::GetShardSizeBytes(int blockSizeBytes) const
+    {
+        if(blockSizeBytes <= 0)
+            return 1;
+
+        return (blockSizeBytes + m_dataShards - 1) / m_dataShards;
+    }
+
+    void
+    BlockchainErasureCode::Encode(std::vector<std::vector<uint8_t>> &shards) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(shards.size() < m_dataShards)
+        {
+            NS_FATAL_ERROR("Error : Encode needs " << m_dataShards << " data shards, got " << shards.size());
+        }
+
+        size_t shardSize = shards[0].size();
+
+        for(uint32_t j = 1; j < m_dataShards; j++)
+        {
+            if(shards[j].size() != shardSize)
+            {
+                NS_FATAL_ERROR("Error : the data shards must have the same size");
+            }
+        }
+
+        shards.resize(GetTotalShards());
+
+        for(uint32_t i = 0; i < m_parityShards; i++)
+        {
+            std::vector<uint8_t> &parity = shards[m_dataShards + i];
+
+            parity.assign(shardSize, 0);
+            for(uint32_t j = 0; j < m_dataShards; j++)
+            {
+                MultiplyAdd(parity.data(), shards[j].data(), m_parityMatrix[i * m_dataShards + j], shardSize);
+            }
+        }
+    }
+
+    bool
+    BlockchainErasureCode::Decode(std::vector<std::vector<uint8_t>> &shards, const std::vector<bool> &present) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        uint32_t                totalShards = GetTotalShards();
+        std::vector<uint32_t>   rows;                   // the k received shards the data is rebuilt from
+        size_t                  shardSize = 0;
+
+        if(shards.size() != totalShards || present.size() != totalShards)
+        {
+            NS_FATAL_ERROR("Error : Decode needs " << totalShards << " shards");
+        }
+
+        /*
+         * The data shards are preferred, their rows of the encoding matrix are unit rows
+         */
+        for(uint32_t i = 0; i < totalShards && rows.size() < m_dataShards; i++)
+        {
+            if(present[i])
+            {
+                rows.push_back(i);
+                shardSize = shards[i].size();
+            }
+        }
+
+        if(rows.size() < m_dataShards)
+        {
+            NS_LOG_INFO("Decode : " << rows.size() << " shards received, " << m_dataShards << " needed");
+            return false;
+        }
+
+        /*
+         * Some data shards are missing: they are rebuilt with the inverse of the rows of the received shards
+         */
+        if(rows.back() >= m_dataShards)
+        {
+            std::vector<uint8_t> matrix(m_dataShards * m_dataShards, 0);
+
+            for(uint32_t r = 0; r < m_dataShards; r++)
+            {
+                if(rows[r] < m_dataShards)
+                    matrix[r * m_dataShards + rows[r]] = 1;
+                else
+                    memcpy(&matrix[r * m_dataShards], &m_parityMatrix[(rows[r] - m_dataShards) * m_dataShards], m_dataShards);
+            }
+
+            if(!InvertMatrix(matrix, m_dataShards))
+            {
+                NS_FATAL_ERROR("Error : singular decoding matrix");
+            }
+
+            for(uint32_t d = 0; d < m_dataShards; d++)
+            {
+                if(present[d])
+                    continue;
+
+                shards[d].assign(shardSize, 0);
+                for(uint32_t r = 0; r < m_dataShards; r++)
+                {
+                    MultiplyAdd(shards[d].data(), shards[rows[r]].data(), matrix[d * m_dataShards + r], shardSize);
+                }
+            }
+        }
+
+        for(uint32_t i = 0; i < m_parityShards; i++)
+        {
+            if(present[m_dataShards + i])
+                continue;
+
+            std::vector<uint8_t> &parity = shards[m_dataShards + i];
+
+            parity.assign(shardSize, 0);
+            for(uint32_t j = 0; j < m_dataShards; j++)
+            {
+                MultiplyAdd(parity.data(), shards[j].data(), m_parityMatrix[i * m_dataShards + j], shardSize);
+            }
+        }
+
+        return true;
+    }
+
+    uint8_t
+    BlockchainErasureCode::Multiply(uint8_t a, uint8_t b)
+    {
+        return GetGaloisTables().mul[a][b];
+    }
+
+    uint8_t
+    BlockchainErasureCode::Inverse(uint8_t a)
+    {
+        const GaloisTables &tables = GetGaloisTables();
+
+        if(a == 0)
+        {
+            NS_FATAL_ERROR("Error : 0 has no inverse in GF(2^8)");
+        }
+
+        return tables.exp[255 - tables.log[a]];
+    }
+
+    void
+    BlockchainErasureCode::MultiplyAdd(uint8_t *dst, const uint8_t *src, uint8_t c, size_t length)
+    {
+        const uint8_t   *row = GetGaloisTables().mul[c];
+        size_t          i = 0;
+
+        if(c == 0)
+            return;
+
+        if(c == 1)
+        {
+            for(; i + 8 <= length; i += 8)
+            {
+                uint64_t d;
+                uint64_t s;
+
+                memcpy(&d, dst + i, 8);
+                memcpy(&s, src + i, 8);
+                d ^= s;
+                memcpy(dst + i, &d, 8);
+            }
+        }
+#ifdef BLOCKCHAIN_ERASURE_CODE_X86
+        else if(GetKernel() != SCALAR_KERNEL)
+        {
+            uint8_t lowTable[16];
+            uint8_t highTable[16];
+
+            for(int n = 0; n < 16; n++)
+            {
+                lowTable[n] = row[n];
+                highTable[n] = row[n << 4];
+            }
+
+            if(GetKernel() == AVX2_KERNEL)
+                i = MultiplyAddAvx2(dst, src, lowTable, highTable, length);
+            else
+                i = MultiplyAddSsse3(dst, src, lowTable, highTable, length);
+        }
+#endif
+        else
+        {
+            for(; i + 4 <= length; i += 4)
+            {
+                dst[i] ^= row[src[i]];
+                dst[i + 1] ^= row[src[i + 1]];
+                dst[i + 2] ^= row[src[i + 2]];
+                dst[i + 3] ^= row[src[i + 3]];
+            }
+        }
+
+        for(; i < length; i++)
+        {
+            dst[i] ^= row[src[i]];
+        }
+    }
+
+    const char*
+    BlockchainErasureCode::GetKernelName(void)
+    {
+        switch(GetKernel())
+        {
+            case AVX2_KERNEL:
+                return "avx2";
+            case SSSE3_KERNEL:
+                return "ssse3";
+            default:
+                return "scalar";
+        }
+    }
+
+    bool
+    BlockchainErasureCode::InvertMatrix(std::vector<uint8_t> &matrix, int size)
+    {
+        std::vector<uint8_t> inverse(size * size, 0);
+
+        for(int i = 0; i < size; i++)
+        {
+            inverse[i * size + i] = 1;
+        }
+
+        for(int col = 0; col < size; col++)
+        {
+            int pivot = col;
+
+            while(pivot < size && matrix[pivot * size + col] == 0)
+                pivot++;
+
+            if(pivot == size)
+                return false;
+
+            if(pivot != col)
+            {
+                for(int k = 0; k < size; k++)
+                {
+                    std::swap(matrix[pivot * size + k], matrix[col * size + k]);
+                    std::swap(inverse[pivot * size + k], inverse[col * size + k]);
+                }
+            }
+
+            uint8_t factor = Inverse(matrix[col * size + col]);
+
+            for(int k = 0; k < size; k++)
+            {
+                matrix[col * size + k] = Multiply(matrix[col * size + k], factor);
+                inverse[col * size + k] = Multiply(inverse[col * size + k], factor);
+            }
+
+            for(int row = 0; row < size; row++)
+            {
+                uint8_t c = matrix[row * size + col];
+
+                if(row == col || c == 0)
+                    continue;
+
+                MultiplyAdd(&matrix[row * size], &matrix[col * size], c, size);
+                MultiplyAdd(&inverse[row * size], &inverse[col * size], c, size);
+            }
+        }
+
+        matrix.swap(inverse);
+        return true;
+    }
+
+}
@@ -0,0 +1,98 @@
+#ifndef BLOCKCHAIN_ERASURE_CODE_H
+#define BLOCKCHAIN_ERASURE_CODE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <set>
+#include <vector>
+#include "ns3/ipv4-address.h"
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * Systematic Reed-Solomon code over GF(2^8) for the erasure-coded block dissemination.
+     * A block is split into k data shards and m parity shards are added. Any k of the k + m shards
+     * rebuild the block. The parity rows form a Cauchy matrix, so every k x k submatrix of the
+     * encoding matrix is invertible.
+     * The multiply-add of a shard by a constant, where all the time goes, uses the SSSE3 or AVX2
+     * nibble-table shuffle when the CPU has it and a 256-entry product table otherwise.
+     */
+    class BlockchainErasureCode
+    {
+        public:
+            BlockchainErasureCode(void);
+            virtual ~BlockchainErasureCode(void);
+
+            /*
+             * param dataShards : k, the number of shards a block is split into
+             * param parityShards : m, the number of parity shards added to them
+             */
+            void SetShards(uint32_t dataShards, uint32_t parityShards);
+
+            uint32_t GetDataShards(void) const;
+            uint32_t GetParityShards(void) const;
+            uint32_t GetTotalShards(void) const;
+
+            /*
+             * return the size of the shards of a block
+             */
+            int GetShardSizeBytes(int blockSizeBytes) const;
+
+            /*
+             * Computes the parity shards
+             * param shards : the k data shards, all of the same size. The m parity shards are appended.
+             */
+            void Encode(std::vector<std::vector<uint8_t>> &shards) const;
+
+            /*
+             * Rebuilds the missing shards
+             * param shards : the k + m shards, the missing ones are overwritten
+             * param present : the shards that were received
+             * return false : if fewer than k shards were received
+             */
+            bool Decode(std::vector<std::vector<uint8_t>> &shards, const std::vector<bool> &present) const;
+
+            static uint8_t Multiply(uint8_t a, uint8_t b);
+            static uint8_t Inverse(uint8_t a);
+
+            /*
+             * dst ^= c * src, byte by byte in GF(2^8)
+             */
+            static void MultiplyAdd(uint8_t *dst, const uint8_t *src, uint8_t c, size_t length);
+
+            /*
+             * return the name of the multiply-add kernel used on this CPU
+             */
+            static const char* GetKernelName(void);
+
+        protected:
+
+            /*
+             * Inverts a square matrix in place with Gauss-Jordan elimination
+             * return false : if the matrix is singular
+             */
+            static bool InvertMatrix(std::vector<uint8_t> &matrix, int size);
+
+            uint32_t                m_dataShards;
+            uint32_t                m_parityShards;
+            std::vector<uint8_t>    m_parityMatrix;         // m x k Cauchy matrix, row major
+    };
+
+    /*
+     * A block whose coded chunks are being collected
+     */
+    struct CodedBlock
+    {
+        Block                       header;             // the block without its transactions
+        std::vector<Transaction>    transactions;
+        std::string                 serializedTransactions;     // the JSON array of the transactions, forwarded with every chunk
+        std::set<int>               chunks;             // the coded chunks received, forwarded once each
+        std::set<Ipv4Address>       sources;            // the peers the chunks came from
+        int                         dataChunks;         // k, the chunks needed to rebuild the block
+        bool                        rebuilt;            // k chunks have arrived
+    };
+
+}
+
+#endif
@@ -0,0 +1,341 @@
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-graphene.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainGraphene");
+
+    /*
+     * splitmix64 finalizer, the keys are short IDs and only need to be spread over the cells
+     */
+    static inline uint64_t
+    Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    BlockchainBloomFilter::BlockchainBloomFilter(void) : m_bits(0), m_hashes(0), m_seed(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainBloomFilter::BlockchainBloomFilter(uint32_t bits, uint32_t hashes, uint64_t seed) : m_bits(bits), m_hashes(hashes), m_seed(seed)
+    {
+        NS_LOG_FUNCTION(this);
+        m_words.assign((bits + 63) / 64, 0);
+    }
+
+    BlockchainBloomFilter::~BlockchainBloomFilter(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainBloomFilter::Insert(uint64_t key)
+    {
+        if(m_bits == 0)
+            return;
+
+        uint64_t h1 = Mix(key ^ m_seed);
+        uint64_t h2 = Mix(h1) | 1;
+
+        for(uint32_t i = 0; i < m_hashes; i++)
+        {
+            uint32_t bit = (h1 + i * h2) % m_bits;
+            m_words[bit / 64] |= 1ULL << (bit % 64);
+        }
+    }
+
+    bool
+    BlockchainBloomFilter::Contains(uint64_t key) const
+    {
+        if(m_bits == 0)
+            return true;
+
+        uint64_t h1 = Mix(key ^ m_seed);
+        uint64_t h2 = Mix(h1) | 1;
+
+        for(uint32_t i = 0; i < m_hashes; i++)
+        {
+            uint32_t bit = (h1 + i * h2) % m_bits;
+
+            if(!(m_words[bit / 64] & (1ULL << (bit % 64))))
+                return false;
+        }
+
+        return true;
+    }
+
+    uint32_t
+    BlockchainBloomFilter::GetBits(void) const
+    {
+        return m_bits;
+    }
+
+    uint32_t
+    BlockchainBloomFilter::GetHashes(void) const
+    {
+        return m_hashes;
+    }
+
+    int
+    BlockchainBloomFilter::GetSizeBytes(void) const
+    {
+        return (m_bits + 7) / 8;
+    }
+
+    const std::vector<uint64_t>&
+    BlockchainBloomFilter::GetWords(void) const
+    {
+        return m_words;
+    }
+
+    void
+    BlockchainBloomFilter::SetWords(const std::vector<uint64_t> &words)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(words.size() != m_words.size())
+        {
+            NS_FATAL_ERROR("Error : a Bloom filter of " << m_bits << " bits has " << m_words.size() << " words, not " << words.size());
+        }
+        m_words = words;
+    }
+
+    uint32_t
+    BlockchainBloomFilter::GetOptimalBits(int n, double fpr)
+    {
+        if(n <= 0 || fpr >= 1)
+            return 0;
+
+        return std::max(8.0, ceil(-n * log(fpr) / (log(2) * log(2))));
+    }
+
+    uint32_t
+    BlockchainBloomFilter::GetOptimalHashes(int n, uint32_t bits)
+    {
+        if(n <= 0 || bits == 0)
+            return 0;
+
+        return std::min(32.0, std::max(1.0, floor(static_cast<double>(bits) / n * log(2) + 0.5)));
+    }
+
+    BlockchainIblt::BlockchainIblt(void) : m_seed(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainIblt::BlockchainIblt(uint32_t cells, uint64_t seed) : m_seed(seed)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Cell empty = {0, 0, 0};
+        m_cells.assign(std::max(3u, (cells + 2) / 3 * 3), empty);
+    }
+
+    BlockchainIblt::~BlockchainIblt(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainIblt::Insert(uint64_t key)
+    {
+        Update(key, 1);
+    }
+
+    void
+    BlockchainIblt::Erase(uint64_t key)
+    {
+        Update(key, -1);
+    }
+
+    void
+    BlockchainIblt::Subtract(const BlockchainIblt &other)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(other.m_cells.size() != m_cells.size() || other.m_seed != m_seed)
+        {
+            NS_FATAL_ERROR("Error : cannot subtract IBLTs of different sizes or seeds");
+        }
+
+        for(unsigned int i = 0; i < m_cells.size(); i++)
+        {
+            m_cells[i].count -= other.m_cells[i].count;
+            m_cells[i].keySum ^= other.m_cells[i].keySum;
+            m_cells[i].hashSum ^= other.m_cells[i].hashSum;
+        }
+    }
+
+    bool
+    BlockchainIblt::Decode(std::vector<uint64_t> &inserted, std::vector<uint64_t> &erased) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        BlockchainIblt          table(*this);
+        std::vector<uint32_t>   pure;
+
+        inserted.clear();
+        erased.clear();
+
+        for(uint32_t i = 0; i < table.m_cells.size(); i++)
+        {
+            pure.push_back(i);
+        }
+
+        while(!pure.empty())
+        {
+            const Cell  &cell = table.m_cells[pure.back()];
+            uint64_t    key = cell.keySum;
+            int32_t     count = cell.count;
+
+            pure.pop_back();
+
+            if((count != 1 && count != -1) || cell.hashSum != table.GetCheck(key))
+                continue;
+
+            if(count == 1)
+                inserted.push_back(key);
+            else
+                erased.push_back(key);
+
+            table.Update(key, -count);
+
+            for(int subtable = 0; subtable < 3; subtable++)
+            {
+                pure.push_back(table.GetIndex(key, subtable));
+            }
+        }
+
+        for(auto it = table.m_cells.begin(); it != table.m_cells.end(); it++)
+        {
+            if(it->count != 0 || it->keySum != 0 || it->hashSum != 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    uint32_t
+    BlockchainIblt::GetCellCount(void) const
+    {
+        return m_cells.size();
+    }
+
+    int
+    BlockchainIblt::GetSizeBytes(void) const
+    {
+        return m_cells.size() * m_cellSizeBytes;
+    }
+
+    const std::vector<BlockchainIblt::Cell>&
+    BlockchainIblt::GetCells(void) const
+    {
+        return m_cells;
+    }
+
+    void
+    BlockchainIblt::SetCells(const std::vector<Cell> &cells)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(cells.size() != m_cells.size())
+        {
+            NS_FATAL_ERROR("Error : an IBLT of " << m_cells.size() << " cells cannot hold " << cells.size());
+        }
+        m_cells = cells;
+    }
+
+    uint32_t
+    BlockchainIblt::GetCellsForDifference(int a)
+    {
+        /*
+         * The difference is bounded by a + 3 sqrt(a) with a high probability. Large tables of 3 subtables
+         * peel with 1.5 cells per key, small ones need more: two keys that share their 3 cells cannot be peeled.
+         */
+        double bound = std::max(1, a) + 3 * sqrt(std::max(1, a)) + 1;
+
+        return std::max(6u, static_cast<uint32_t>(ceil((1.5 * bound + 16) / 3)) * 3);
+    }
+
+    void
+    BlockchainIblt::Update(uint64_t key, int32_t count)
+    {
+        uint32_t check = GetCheck(key);
+
+        for(int subtable = 0; subtable < 3; subtable++)
+        {
+            Cell &cell = m_cells[GetIndex(key, subtable)];
+
+            cell.count += count;
+            cell.keySum ^= key;
+            cell.hashSum ^= check;
+        }
+    }
+
+    uint32_t
+    BlockchainIblt::GetIndex(uint64_t key, int subtable) const
+    {
+        uint32_t subtableSize = m_cells.size() / 3;
+
+        return subtable * subtableSize + Mix(key ^ (m_seed + subtable + 1)) % subtableSize;
+    }
+
+    uint32_t
+    BlockchainIblt::GetCheck(uint64_t key) const
+    {
+        return static_cast<uint32_t>(Mix(key ^ ~m_seed));
+    }
+
+    GrapheneParameters
+    SelectGrapheneParameters(int n, int m)
+    {
+        GrapheneParameters best;
+
+        best.falsePositiveRate = 1;
+        best.bloomBits = 0;
+        best.bloomHashes = 0;
+        best.expectedDifference = std::max(1, std::abs(m - n));
+        best.ibltCells = BlockchainIblt::GetCellsForDifference(best.expectedDifference);
+        best.sizeBytes = best.ibltCells * BlockchainIblt::m_cellSizeBytes;
+
+        /*
+         * Without a Bloom filter every transaction of the pool is a candidate. That is the best
+         * choice when the pool is no larger than the block.
+         */
+        if(n <= 0 || m <= n)
+            return best;
+
+        int maxDifference = std::min(m - n, 4 * n + 100);
+
+        for(int a = 1; a <= maxDifference; a++)
+        {
+            double      fpr = static_cast<double>(a) / (m - n);
+            uint32_t    bits = BlockchainBloomFilter::GetOptimalBits(n, fpr);
+            uint32_t    cells = BlockchainIblt::GetCellsForDifference(a);
+            int         sizeBytes = (bits + 7) / 8 + cells * BlockchainIblt::m_cellSizeBytes;
+
+            if(sizeBytes < best.sizeBytes)
+            {
+                best.falsePositiveRate = fpr;
+                best.bloomBits = bits;
+                best.bloomHashes = BlockchainBloomFilter::GetOptimalHashes(n, bits);
+                best.expectedDifference = a;
+                best.ibltCells = cells;
+                best.sizeBytes = sizeBytes;
+            }
+        }
+
+        return best;
+    }
+
+}
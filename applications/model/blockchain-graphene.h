@@ -0,0 +1,137 @@
+#ifndef BLOCKCHAIN_GRAPHENE_H
+#define BLOCKCHAIN_GRAPHENE_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+    /*
+     * Bloom filter over 64-bit keys (the short IDs of the transactions), with double hashing
+     */
+    class BlockchainBloomFilter
+    {
+        public:
+            BlockchainBloomFilter(void);
+
+            /*
+             * param bits : the size of the filter, 0 for a filter that contains every key
+             * param hashes : the number of hash functions
+             * param seed : changes the hash functions
+             */
+            BlockchainBloomFilter(uint32_t bits, uint32_t hashes, uint64_t seed);
+
+            virtual ~BlockchainBloomFilter(void);
+
+            void Insert(uint64_t key);
+            bool Contains(uint64_t key) const;
+
+            uint32_t GetBits(void) const;
+            uint32_t GetHashes(void) const;
+            int GetSizeBytes(void) const;
+
+            const std::vector<uint64_t>& GetWords(void) const;
+            void SetWords(const std::vector<uint64_t> &words);
+
+            /*
+             * return the size of a filter of n keys with the false positive rate fpr
+             */
+            static uint32_t GetOptimalBits(int n, double fpr);
+            static uint32_t GetOptimalHashes(int n, uint32_t bits);
+
+        protected:
+
+            uint32_t                m_bits;
+            uint32_t                m_hashes;
+            uint64_t                m_seed;
+            std::vector<uint64_t>   m_words;
+    };
+
+    /*
+     * Invertible Bloom lookup table over 64-bit keys. Every key is added to one cell of each of the
+     * three subtables. Subtracting the table of a set from the table of another leaves their
+     * symmetric difference, which is listed by peeling the cells that hold a single key.
+     */
+    class BlockchainIblt
+    {
+        public:
+
+            struct Cell
+            {
+                int32_t     count;
+                uint64_t    keySum;
+                uint32_t    hashSum;
+            };
+
+            BlockchainIblt(void);
+
+            /*
+             * param cells : the number of cells, rounded up to a multiple of 3
+             */
+            BlockchainIblt(uint32_t cells, uint64_t seed);
+
+            virtual ~BlockchainIblt(void);
+
+            void Insert(uint64_t key);
+            void Erase(uint64_t key);
+
+            /*
+             * this -= other, both tables must have the same size and seed
+             */
+            void Subtract(const BlockchainIblt &other);
+
+            /*
+             * Lists the keys of the table
+             * param inserted : the keys with a positive count
+             * param erased : the keys with a negative count
+             * return false : if some cells could not be peeled, the lists are then incomplete
+             */
+            bool Decode(std::vector<uint64_t> &inserted, std::vector<uint64_t> &erased) const;
+
+            uint32_t GetCellCount(void) const;
+            int GetSizeBytes(void) const;
+
+            const std::vector<Cell>& GetCells(void) const;
+            void SetCells(const std::vector<Cell> &cells);
+
+            /*
+             * return the number of cells needed to decode a difference of a keys with a high probability
+             */
+            static uint32_t GetCellsForDifference(int a);
+
+            static const int m_cellSizeBytes = 12;      // 2-byte count, 6-byte key sum, 4-byte hash sum
+
+        protected:
+
+            void Update(uint64_t key, int32_t count);
+            uint32_t GetIndex(uint64_t key, int subtable) const;
+            uint32_t GetCheck(uint64_t key) const;
+
+            uint64_t            m_seed;
+            std::vector<Cell>   m_cells;
+    };
+
+    /*
+     * Parameters of a Graphene block (protocol 1): the Bloom filter lets the receiver pick the candidate
+     * transactions of the block from its pool, and the IBLT corrects the a false positives expected
+     */
+    struct GrapheneParameters
+    {
+        double      falsePositiveRate;
+        uint32_t    bloomBits;
+        uint32_t    bloomHashes;
+        uint32_t    ibltCells;
+        int         expectedDifference;     // a
+        int         sizeBytes;              // Bloom filter + IBLT
+    };
+
+    /*
+     * Chooses the false positive rate a/(m - n) that minimizes the size of the Bloom filter and the IBLT
+     * param n : the transactions of the block
+     * param m : the transactions in the pool of the receiver
+     */
+    GrapheneParameters SelectGrapheneParameters(int n, int m);
+
+}
+
+#endif
@@ -0,0 +1,503 @@
+#include "ns3/address.h"
+#include "ns3/log.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/blockchain-hotstuff-miner.h"
+#include <algorithm>
+#include <set>
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainHotStuffMiner");
+    NS_OBJECT_ENSURE_REGISTERED(BlockchainHotStuffMiner);
+
+    TypeId
+    BlockchainHotStuffMiner::GetTypeId(void)
+    {
+        static TypeId tid = TypeId("ns3::BlockchainHotStuffMiner")
+            .SetParent<BlockchainValidator>()
+            .SetGroupName("Application")
+            .AddConstructor<BlockchainHotStuffMiner>()
+        ;
+        return tid;
+    }
+
+    BlockchainHotStuffMiner::BlockchainHotStuffMiner() : BlockchainValidator(), m_readyView(0), m_readyByQc(false), m_proposedView(0),
+                                                         m_timeoutsInRow(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainHotStuffMiner::~BlockchainHotStuffMiner(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainHotStuffMiner::StartConsensus(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_hotStuff.SetReplicas(m_noMiners, m_validatorId);
+        m_blocks[0] = *m_blockchain.GetCurrentTopBlock();
+
+        AdvanceView(1);
+        SendNewView(1, true);
+        TryPropose();
+    }
+
+    void
+    BlockchainHotStuffMiner::StopConsensus(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Simulator::Cancel(m_viewEvent);
+
+        NS_LOG_WARN("HotStuff : validator " << m_validatorId << " in view " << m_hotStuff.GetView() << ", highest QC = "
+                    << m_hotStuff.GetHighQcView() << ", locked = " << m_hotStuff.GetLockedView() << ", committed = "
+                    << m_hotStuff.GetCommittedView() << ", f = " << m_hotStuff.GetFaults() << ", quorum = " << m_hotStuff.GetQuorum());
+    }
+
+    void
+    BlockchainHotStuffMiner::Propose(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int view = m_hotStuff.GetView();
+
+        if(!m_hotStuff.IsLeader() || m_proposedView != view || m_hotStuff.HasBlock(view))
+        {
+            NS_LOG_INFO("Propose : validator " << m_validatorId << " drops the block " << GetBlockHash(newBlock) << ", it cannot propose it in view " << view);
+            return;
+        }
+
+        /*
+         * MineBlock builds on the committed tip, the block extends the block of the highest QC instead
+         */
+        Proposal            proposal;
+        Block               parent = m_blocks[m_hotStuff.GetHighQcView()];
+        Block               block = newBlock;
+        std::vector<Transaction>            transactions = block.GetTransactions();
+        std::set<std::pair<int, int>>       uncommittedTransactions;
+        rapidjson::Document d;
+        rapidjson::Value    value;
+
+        block.SetBlockHeight(parent.GetBlockHeight() + 1);
+        block.SetParentBlockMinerId(parent.GetMinerId());
+        block.SetNonce(view);
+        block.SetUncles(std::vector<std::pair<int, int>>());
+
+        /*
+         * The transactions of the uncommitted ancestors are still in the mempool
+         */
+        for(int ancestor = m_hotStuff.GetHighQcView(); ancestor > m_hotStuff.GetCommittedView(); ancestor = m_hotStuff.GetParentView(ancestor))
+        {
+            std::vector<Transaction> ancestorTransactions = m_blocks[ancestor].GetTransactions();
+
+            for(auto trans_it = ancestorTransactions.begin(); trans_it < ancestorTransactions.end(); trans_it++)
+                uncommittedTransactions.insert(std::make_pair(trans_it->GetTransNodeId(), trans_it->GetTransId()));
+        }
+
+        if(!uncommittedTransactions.empty())
+        {
+            std::vector<Transaction>    newTransactions;
+            int                         removedBytes = 0;
+
+            for(auto trans_it = transactions.begin(); trans_it < transactions.end(); trans_it++)
+            {
+                if(uncommittedTransactions.count(std::make_pair(trans_it->GetTransNodeId(), trans_it->GetTransId())) > 0)
+                    removedBytes += trans_it->GetTransSizeByte();
+                else
+                    newTransactions.push_back(*trans_it);
+            }
+
+            block.SetTransactions(newTransactions);
+
+            if(m_fixedBlockSize <= 0 && m_mempool.GetMaxSize() > 0)
+                block.SetBlockSizeBytes(block.GetBlockSizeBytes() - removedBytes);
+        }
+
+        proposal.block = block;
+        proposal.parentView = m_hotStuff.GetHighQcView();
+        proposal.qcView = m_hotStuff.GetHighQcView();
+
+        SetConsensusMessage(d, HOTSTUFF_PROPOSAL, m_blockchainMessageHeader + 2*m_consensusFieldBytes + GetQcSize() + m_signatureSize
+                            + block.GetBlockSizeBytes(), 2);
+
+        value = view;
+        d.AddMember("view", value, d.GetAllocator());
+
+        value = proposal.parentView;
+        d.AddMember("parentView", value, d.GetAllocator());
+
+        value = proposal.qcView;
+        d.AddMember("qcView", value, d.GetAllocator());
+
+        AddProposedBlock(d, block);
+        BroadcastConsensusMessage(d);
+
+        NS_LOG_INFO("Propose : validator " << m_validatorId << " proposes the block " << GetBlockHash(block) << " in view " << view
+                    << " with the QC of view " << proposal.qcView);
+
+        ProcessProposal(view, proposal);
+    }
+
+    void
+    BlockchainHotStuffMiner::Committed(const Block &newTip)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_timeoutsInRow = 0;
+
+        /*
+         * The blocks below the committed tip and the proposals at or below its height can no longer be committed
+         */
+        for(auto it = m_blocks.begin(); it != m_blocks.end();)
+        {
+            if(it->second.GetBlockHeight() < newTip.GetBlockHeight())
+                it = m_blocks.erase(it);
+            else
+                it++;
+        }
+
+        for(auto it = m_pendingProposals.begin(); it != m_pendingProposals.end();)
+        {
+            if(it->second.block.GetBlockHeight() <= newTip.GetBlockHeight())
+                it = m_pendingProposals.erase(it);
+            else
+                it++;
+        }
+    }
+
+    void
+    BlockchainHotStuffMiner::ReceivedConsensusMessage(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_crashed)
+            return;
+
+        m_validatorAddresses[d["replica"].GetInt()] = InetSocketAddress::ConvertFrom(from).GetIpv4();
+
+        switch(d["message"].GetInt())
+        {
+            case HOTSTUFF_PROPOSAL:
+            {
+                ReceivedProposal(d, from);
+                break;
+            }
+            case HOTSTUFF_VOTE:
+            {
+                ReceivedVote(d["view"].GetInt(), d["replica"].GetInt());
+                break;
+            }
+            case HOTSTUFF_NEW_VIEW:
+            {
+                ReceivedNewView(d["view"].GetInt(), d["replica"].GetInt(), d["qcView"].GetInt());
+                break;
+            }
+            default:
+            {
+                BlockchainNode::ReceivedConsensusMessage(d, from);
+                break;
+            }
+        }
+    }
+
+    int
+    BlockchainHotStuffMiner::GetQcSize(void) const
+    {
+        return m_digestSizeBytes + m_consensusFieldBytes + m_signatureSize + (m_noMiners + 7) / 8;
+    }
+
+    void
+    BlockchainHotStuffMiner::SendToValidator(rapidjson::Document &d, int validatorId)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_validatorAddresses.find(validatorId);
+
+        if(it == m_validatorAddresses.end())
+        {
+            BroadcastConsensusMessage(d);
+            return;
+        }
+
+        Address to = InetSocketAddress(it->second, m_blockchainPort);
+
+        SendConsensusMessage(d, to);
+    }
+
+    void
+    BlockchainHotStuffMiner::TryPropose(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int view = m_hotStuff.GetView();
+
+        if(m_crashed || !m_hotStuff.IsLeader() || m_readyView != view || m_proposedView >= view)
+            return;
+
+        /*
+         * The QC of the previous view is used once its block is validated
+         */
+        if(m_readyByQc && m_hotStuff.GetHighQcView() < view - 1)
+            return;
+
+        NS_LOG_INFO("TryPropose : validator " << m_validatorId << " leads the view " << view);
+
+        m_proposedView = view;
+        m_lastProposalTime = m_blocks[m_hotStuff.GetHighQcView()].GetTimeStamp();
+        ScheduleProposal();
+    }
+
+    void
+    BlockchainHotStuffMiner::ReceivedProposal(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int         view = d["view"].GetInt();
+        Proposal    proposal;
+
+        proposal.block = ReadProposedBlock(d, from);
+        proposal.parentView = d["parentView"].GetInt();
+        proposal.qcView = d["qcView"].GetInt();
+
+        if(d["replica"].GetInt() != m_hotStuff.GetLeader(view) || view <= m_hotStuff.GetCommittedView() || m_hotStuff.HasBlock(view))
+        {
+            NS_LOG_INFO("ReceivedProposal : validator " << m_validatorId << " ignores the block " << GetBlockHash(proposal.block)
+                        << " of view " << view);
+            return;
+        }
+
+        m_pendingProposals[view] = proposal;
+        ProcessPendingProposals();
+    }
+
+    void
+    BlockchainHotStuffMiner::ProcessPendingProposals(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_pendingProposals.erase(m_pendingProposals.begin(), m_pendingProposals.upper_bound(m_hotStuff.GetCommittedView()));
+
+        for(auto it = m_pendingProposals.begin(); it != m_pendingProposals.end();)
+        {
+            if(!m_hotStuff.HasBlock(it->second.parentView) || !m_hotStuff.HasBlock(it->second.qcView))
+            {
+                it++;
+                continue;
+            }
+
+            int         view = it->first;
+            Proposal    proposal = it->second;
+            Block       &parent = m_blocks[proposal.parentView];
+
+            it = m_pendingProposals.erase(it);
+
+            if(proposal.block.GetBlockHeight() != parent.GetBlockHeight() + 1
+                || proposal.block.GetParentBlockMinerId() != parent.GetMinerId())
+            {
+                NS_LOG_INFO("ProcessPendingProposals : the block " << GetBlockHash(proposal.block) << " of view " << view
+                            << " does not extend the block of view " << proposal.parentView);
+                continue;
+            }
+
+            double validationTime = ReserveBlockValidation(proposal.block);
+
+            Simulator::Schedule(Seconds(validationTime), &BlockchainHotStuffMiner::ProposalValidated, this, view, proposal);
+        }
+    }
+
+    void
+    BlockchainHotStuffMiner::ProposalValidated(int view, Proposal proposal)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_crashed)
+            return;
+
+        ProcessProposal(view, proposal);
+        ProcessPendingProposals();
+    }
+
+    void
+    BlockchainHotStuffMiner::ProcessProposal(int view, const Proposal &proposal)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(!m_hotStuff.AddBlock(view, proposal.parentView, proposal.qcView))
+            return;
+
+        m_blocks[view] = proposal.block;
+
+        std::vector<int> decided = m_hotStuff.Update(view);
+
+        for(auto it = decided.begin(); it != decided.end(); it++)
+        {
+            Block block = m_blocks[*it];
+
+            NS_LOG_INFO("ProcessProposal : validator " << m_validatorId << " commits the block " << GetBlockHash(block) << " of view " << *it);
+            CommitBlock(block);
+        }
+
+        /*
+         * A validator which already left the view of the block does not vote for it anymore
+         */
+        if(view >= m_hotStuff.GetView() && m_hotStuff.Vote(view))
+        {
+            SendVote(view);
+            AdvanceView(view + 1);
+        }
+
+        TryPropose();
+    }
+
+    void
+    BlockchainHotStuffMiner::SendVote(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int leader = m_hotStuff.GetLeader(view + 1);
+
+        if(leader == m_validatorId)
+        {
+            ReceivedVote(view, m_validatorId);
+            return;
+        }
+
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        std::string         digest = GetBlockHash(m_blocks[view]);
+
+        SetConsensusMessage(d, HOTSTUFF_VOTE, GetVoteSize(), 1);
+
+        value = view;
+        d.AddMember("view", value, d.GetAllocator());
+
+        value.SetString(digest.c_str(), digest.size(), d.GetAllocator());
+        d.AddMember("digest", value, d.GetAllocator());
+
+        SendToValidator(d, leader);
+    }
+
+    void
+    BlockchainHotStuffMiner::ReceivedVote(int view, int replica)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_hotStuff.GetLeader(view + 1) != m_validatorId || !m_hotStuff.AddVote(view, replica))
+            return;
+
+        /*
+         * The 2f+1 shares are combined into the threshold signature of the QC
+         */
+        double aggregationTime = m_cpuModel.Reserve(m_cpuModel.GetSignatureAggregationCost(m_hotStuff.GetQuorum()));
+
+        Simulator::Schedule(Seconds(aggregationTime), &BlockchainHotStuffMiner::QcAggregated, this, view);
+    }
+
+    void
+    BlockchainHotStuffMiner::QcAggregated(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_crashed || view + 1 < m_hotStuff.GetView())
+            return;
+
+        NS_LOG_INFO("QcAggregated : validator " << m_validatorId << " has the QC of view " << view);
+
+        m_readyView = view + 1;
+        m_readyByQc = true;
+        AdvanceView(view + 1);
+        TryPropose();
+    }
+
+    void
+    BlockchainHotStuffMiner::AdvanceView(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(!m_hotStuff.AdvanceView(view))
+            return;
+
+        Simulator::Cancel(m_nextMiningEvent);
+        ArmViewTimer();
+    }
+
+    void
+    BlockchainHotStuffMiner::ArmViewTimer(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double timeout = m_viewChangeTimeout * (1 << std::min(m_timeoutsInRow, 10)) + GetBlockInterval();
+
+        Simulator::Cancel(m_viewEvent);
+        m_viewEvent = Simulator::Schedule(Seconds(timeout), &BlockchainHotStuffMiner::ViewTimeoutExpired, this);
+    }
+
+    void
+    BlockchainHotStuffMiner::ViewTimeoutExpired(void)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("ViewTimeoutExpired : validator " << m_validatorId << " got no block in view " << m_hotStuff.GetView());
+
+        int view = m_hotStuff.GetView() + 1;
+
+        m_timeoutsInRow++;
+        m_viewChanges++;
+
+        AdvanceView(view);
+        SendNewView(view, false);
+        TryPropose();
+    }
+
+    void
+    BlockchainHotStuffMiner::SendNewView(int view, bool broadcast)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int leader = m_hotStuff.GetLeader(view);
+
+        if(broadcast || leader != m_validatorId)
+        {
+            rapidjson::Document d;
+            rapidjson::Value    value;
+
+            SetConsensusMessage(d, HOTSTUFF_NEW_VIEW, m_blockchainMessageHeader + m_consensusFieldBytes + GetQcSize() + m_signatureSize, 2);
+
+            value = view;
+            d.AddMember("view", value, d.GetAllocator());
+
+            value = m_hotStuff.GetHighQcView();
+            d.AddMember("qcView", value, d.GetAllocator());
+
+            if(broadcast)
+                BroadcastConsensusMessage(d);
+            else
+                SendToValidator(d, leader);
+        }
+
+        if(leader == m_validatorId)
+            ReceivedNewView(view, m_validatorId, m_hotStuff.GetHighQcView());
+    }
+
+    void
+    BlockchainHotStuffMiner::ReceivedNewView(int view, int replica, int qcView)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_hotStuff.GetLeader(view) != m_validatorId || !m_hotStuff.AddNewView(view, replica, qcView))
+            return;
+
+        NS_LOG_INFO("ReceivedNewView : validator " << m_validatorId << " starts the view " << view << " with the QC of view "
+                    << m_hotStuff.GetHighQcView());
+
+        m_readyView = view;
+        m_readyByQc = false;
+        AdvanceView(view);
+        TryPropose();
+    }
+
+}
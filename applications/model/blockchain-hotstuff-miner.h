@@ -0,0 +1,98 @@
+#ifndef BLOCKCHAIN_HOTSTUFF_MINER_H
+#define BLOCKCHAIN_HOTSTUFF_MINER_H
+
+#include "blockchain-validator.h"
+#include "blockchain-hotstuff.h"
+
+
+namespace ns3 {
+
+    /*
+     * A validator of a chained HotStuff consensus, the linear alternative of BlockchainPbftMiner.
+     * The leader rotates every view. It broadcasts one block extending the block of its highest QC, the validators
+     * validate it and send their vote, a share of a threshold signature, to the leader of the next view only. That leader
+     * combines 2f+1 shares into the QC on the CPU, and its block carries the QC as a single signature, so a block costs
+     * O(n) messages and signature verifications, and commits three views later, once two blocks in a row extend it.
+     * The leader proposes at most one block every block interval after the block it extends.
+     * A validator that sees no block for ViewChangeTimeout plus a block interval sends its highest QC to the next leader
+     * and moves to the next view, and the timeout doubles until the next commit. The next leader proposes with 2f+1 of
+     * those new views. The first view starts the same way, the validators broadcast their new view of view 1, which also
+     * tells everyone the address of every validator.
+     */
+    class BlockchainHotStuffMiner : public BlockchainValidator
+    {
+        public:
+
+            static TypeId GetTypeId(void);
+            BlockchainHotStuffMiner();
+
+            virtual ~BlockchainHotStuffMiner(void);
+
+        protected:
+
+            struct Proposal
+            {
+                Block   block;
+                int     parentView;
+                int     qcView;
+            };
+
+            virtual void StartConsensus(void);
+            virtual void StopConsensus(void);
+            virtual void Propose(const Block &newBlock);
+            virtual void Committed(const Block &newTip);
+
+            virtual void ReceivedConsensusMessage(rapidjson::Document &d, Address &from);
+
+            /*
+             * return the size of a QC : the block digest, the view, the threshold signature and the bitmap of the signers
+             */
+            int GetQcSize(void) const;
+
+            /*
+             * Sends to the validator with the given index, the validators not heard from yet get a broadcast
+             */
+            void SendToValidator(rapidjson::Document &d, int validatorId);
+
+            /*
+             * Proposes in the current view once this validator leads it and has the QC of the previous view or 2f+1 new views
+             */
+            void TryPropose(void);
+
+            void ReceivedProposal(rapidjson::Document &d, Address &from);
+
+            /*
+             * Validates the proposals whose parent is known, the other ones wait for it
+             */
+            void ProcessPendingProposals(void);
+            void ProposalValidated(int view, Proposal proposal);
+
+            /*
+             * Adds the block to the tree, commits the blocks its QC decides and votes for it
+             */
+            void ProcessProposal(int view, const Proposal &proposal);
+
+            void SendVote(int view);
+            void ReceivedVote(int view, int replica);
+            void QcAggregated(int view);
+
+            void AdvanceView(int view);
+            void ArmViewTimer(void);
+            void ViewTimeoutExpired(void);
+            void SendNewView(int view, bool broadcast);
+            void ReceivedNewView(int view, int replica, int qcView);
+
+            BlockchainHotStuff                  m_hotStuff;
+            std::map<int, Block>                m_blocks;               // view -> the block proposed in it, 0 is the starting tip
+            std::map<int, Proposal>             m_pendingProposals;     // view -> the proposals waiting for their parent
+            std::map<int, Ipv4Address>          m_validatorAddresses;   // validator index -> its address
+            int                                 m_readyView;            // the view this validator may propose in
+            bool                                m_readyByQc;            // by the QC of the previous view, not by new views
+            int                                 m_proposedView;
+            EventId                             m_viewEvent;
+            int                                 m_timeoutsInRow;
+    };
+
+}
+
+#endif
@@ -0,0 +1,284 @@
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-hotstuff.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainHotStuff");
+
+    BlockchainHotStuff::BlockchainHotStuff(void) : m_replicas(1), m_replicaId(0), m_view(0), m_highQcView(0), m_lockedView(0),
+                                                   m_committedView(0), m_lastVotedView(0)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Node genesis;
+
+        genesis.parentView = -1;
+        genesis.justifyView = 0;
+        m_blocks[0] = genesis;
+    }
+
+    BlockchainHotStuff::~BlockchainHotStuff(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainHotStuff::SetReplicas(int replicas, int replicaId)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(replicas < 1 || replicaId < 0 || replicaId >= replicas)
+            NS_FATAL_ERROR("Replica " << replicaId << " is not one of the " << replicas << " replicas");
+
+        m_replicas = replicas;
+        m_replicaId = replicaId;
+    }
+
+    int
+    BlockchainHotStuff::GetReplicas(void) const
+    {
+        return m_replicas;
+    }
+
+    int
+    BlockchainHotStuff::GetReplicaId(void) const
+    {
+        return m_replicaId;
+    }
+
+    int
+    BlockchainHotStuff::GetFaults(void) const
+    {
+        return (m_replicas - 1) / 3;
+    }
+
+    int
+    BlockchainHotStuff::GetQuorum(void) const
+    {
+        return 2 * GetFaults() + 1;
+    }
+
+    int
+    BlockchainHotStuff::GetView(void) const
+    {
+        return m_view;
+    }
+
+    int
+    BlockchainHotStuff::GetLeader(int view) const
+    {
+        return view % m_replicas;
+    }
+
+    bool
+    BlockchainHotStuff::IsLeader(void) const
+    {
+        return GetLeader(m_view) == m_replicaId;
+    }
+
+    bool
+    BlockchainHotStuff::AdvanceView(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view <= m_view)
+            return false;
+
+        m_view = view;
+        m_newViews.erase(m_newViews.begin(), m_newViews.lower_bound(view));
+        m_startedViews.erase(m_startedViews.begin(), m_startedViews.lower_bound(view));
+        return true;
+    }
+
+    bool
+    BlockchainHotStuff::AddBlock(int view, int parentView, int justifyView)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view <= m_committedView || HasBlock(view) || !HasBlock(parentView) || parentView >= view)
+            return false;
+
+        Node node;
+
+        node.parentView = parentView;
+        node.justifyView = justifyView;
+        m_blocks[view] = node;
+
+        /*
+         * The votes may have formed the QC of the block before the block itself arrived
+         */
+        if(m_certifiedViews.count(view) > 0)
+            UpdateHighQc(view);
+
+        return true;
+    }
+
+    bool
+    BlockchainHotStuff::HasBlock(int view) const
+    {
+        return m_blocks.find(view) != m_blocks.end();
+    }
+
+    int
+    BlockchainHotStuff::GetParentView(int view) const
+    {
+        auto it = m_blocks.find(view);
+
+        return it == m_blocks.end() ? -1 : it->second.parentView;
+    }
+
+    bool
+    BlockchainHotStuff::Extends(int view, int ancestorView) const
+    {
+        while(view > ancestorView)
+        {
+            auto it = m_blocks.find(view);
+
+            if(it == m_blocks.end())
+                return false;
+
+            view = it->second.parentView;
+        }
+
+        return view == ancestorView;
+    }
+
+    std::vector<int>
+    BlockchainHotStuff::Update(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::vector<int> committed;
+        auto it = m_blocks.find(view);
+
+        if(it == m_blocks.end())
+            return committed;
+
+        /*
+         * b'' is certified by the QC of the block, b' by the QC of b'', b by the QC of b'
+         */
+        int certified = it->second.justifyView;
+
+        if(!HasBlock(certified))
+            return committed;
+
+        UpdateHighQc(certified);
+
+        int locked = m_blocks[certified].justifyView;
+
+        if(!HasBlock(locked))
+            return committed;
+
+        m_lockedView = std::max(m_lockedView, locked);
+
+        int decided = m_blocks[locked].justifyView;
+
+        if(decided <= m_committedView || !HasBlock(decided)
+            || m_blocks[certified].parentView != locked || m_blocks[locked].parentView != decided)
+            return committed;
+
+        for(int ancestor = decided; ancestor > m_committedView; ancestor = GetParentView(ancestor))
+            committed.push_back(ancestor);
+
+        std::reverse(committed.begin(), committed.end());
+        m_committedView = decided;
+
+        /*
+         * The blocks, votes and QCs below the committed block are not needed anymore
+         */
+        m_blocks.erase(m_blocks.begin(), m_blocks.lower_bound(m_committedView));
+        m_votes.erase(m_votes.begin(), m_votes.lower_bound(m_committedView));
+        m_certifiedViews.erase(m_certifiedViews.begin(), m_certifiedViews.lower_bound(m_committedView));
+
+        return committed;
+    }
+
+    bool
+    BlockchainHotStuff::Vote(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_blocks.find(view);
+
+        if(view <= m_lastVotedView || it == m_blocks.end())
+            return false;
+
+        /*
+         * The safety rule keeps the lock, the liveness rule lets a higher QC override it
+         */
+        if(!Extends(view, m_lockedView) && it->second.justifyView <= m_lockedView)
+            return false;
+
+        m_lastVotedView = view;
+        return true;
+    }
+
+    bool
+    BlockchainHotStuff::AddVote(int view, int replica)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view < m_committedView || m_certifiedViews.count(view) > 0)
+            return false;
+
+        std::set<int> &votes = m_votes[view];
+
+        votes.insert(replica);
+
+        if(static_cast<int>(votes.size()) < GetQuorum())
+            return false;
+
+        m_votes.erase(view);
+        m_certifiedViews.insert(view);
+        UpdateHighQc(view);
+        return true;
+    }
+
+    bool
+    BlockchainHotStuff::AddNewView(int view, int replica, int qcView)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view < m_view || m_startedViews.count(view) > 0)
+            return false;
+
+        std::set<int> &newViews = m_newViews[view];
+
+        UpdateHighQc(qcView);
+        newViews.insert(replica);
+
+        if(static_cast<int>(newViews.size()) < GetQuorum())
+            return false;
+
+        m_newViews.erase(view);
+        m_startedViews.insert(view);
+        return true;
+    }
+
+    int
+    BlockchainHotStuff::GetHighQcView(void) const
+    {
+        return m_highQcView;
+    }
+
+    int
+    BlockchainHotStuff::GetLockedView(void) const
+    {
+        return m_lockedView;
+    }
+
+    int
+    BlockchainHotStuff::GetCommittedView(void) const
+    {
+        return m_committedView;
+    }
+
+    void
+    BlockchainHotStuff::UpdateHighQc(int view)
+    {
+        if(view > m_highQcView && HasBlock(view))
+            m_highQcView = view;
+    }
+
+}
@@ -0,0 +1,124 @@
+#ifndef BLOCKCHAIN_HOTSTUFF_H
+#define BLOCKCHAIN_HOTSTUFF_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+
+    /*
+     * The safety rules of a chained HotStuff replica (Yin et al.). Every view has one leader, replica v mod n, which
+     * proposes one block extending the block of the highest quorum certificate (QC) it knows, and the block carries
+     * that QC as its justify. The replicas vote for it and the next leader combines 2f+1 votes into the QC of the block,
+     * so the prepare, pre-commit and commit phases of a block are pipelined over the next three views:
+     *   - a QC on a block b'' raises the highest QC;
+     *   - the block b' certified by the justify of b'' becomes locked;
+     *   - the block b certified by the justify of b' commits, with its ancestors, if b'' extends b' and b' extends b
+     *     directly.
+     * A replica votes once per view, for a block extending its locked block or carrying a higher QC.
+     * The blocks are named by their view, view 0 is the committed tip the replicas start from.
+     */
+    class BlockchainHotStuff
+    {
+        public:
+            BlockchainHotStuff(void);
+            virtual ~BlockchainHotStuff(void);
+
+            /*
+             * param replicas : n, the number of validators
+             * param replicaId : the index of this replica among them
+             */
+            void SetReplicas(int replicas, int replicaId);
+            int GetReplicas(void) const;
+            int GetReplicaId(void) const;
+
+            int GetFaults(void) const;
+            int GetQuorum(void) const;
+
+            int GetView(void) const;
+            int GetLeader(int view) const;
+            bool IsLeader(void) const;
+
+            /*
+             * Moves to a higher view, by a vote, a QC or a timeout
+             * return false if the view is not higher
+             */
+            bool AdvanceView(int view);
+
+            /*
+             * Adds the block proposed in a view to the block tree, its parent must be known
+             * param justifyView : the block certified by the QC the block carries
+             * return false if the block is already known, or older than the committed block
+             */
+            bool AddBlock(int view, int parentView, int justifyView);
+            bool HasBlock(int view) const;
+
+            /*
+             * return the view of the parent of a block, -1 if unknown
+             */
+            int GetParentView(int view) const;
+
+            /*
+             * return true if the block is a descendant of the ancestor, or the ancestor itself
+             */
+            bool Extends(int view, int ancestorView) const;
+
+            /*
+             * Processes the QC carried by a block
+             * return the views of the blocks committed by it, in chain order
+             */
+            std::vector<int> Update(int view);
+
+            /*
+             * return true, and records the vote, if this replica can vote for the block
+             */
+            bool Vote(int view);
+
+            /*
+             * Counts the vote of a replica for a block, at the leader of the next view
+             * return true once, when the block gathers its QC
+             */
+            bool AddVote(int view, int replica);
+
+            /*
+             * Counts the new view of a replica which timed out, at the leader of the view
+             * param qcView : the highest QC of the replica
+             * return true once, when the view gathers 2f+1 new views
+             */
+            bool AddNewView(int view, int replica, int qcView);
+
+            int GetHighQcView(void) const;
+            int GetLockedView(void) const;
+            int GetCommittedView(void) const;
+
+        protected:
+
+            struct Node
+            {
+                int parentView;
+                int justifyView;
+            };
+
+            /*
+             * Raises the highest QC, to a known block
+             */
+            void UpdateHighQc(int view);
+
+            int                                 m_replicas;
+            int                                 m_replicaId;
+            int                                 m_view;
+            int                                 m_highQcView;
+            int                                 m_lockedView;
+            int                                 m_committedView;
+            int                                 m_lastVotedView;
+            std::map<int, Node>                 m_blocks;           // view -> the block proposed in it
+            std::map<int, std::set<int>>        m_votes;            // view -> the replicas which voted for its block
+            std::map<int, std::set<int>>        m_newViews;         // view -> the replicas which moved to it by a timeout
+            std::set<int>                       m_certifiedViews;
+            std::set<int>                       m_startedViews;
+    };
+
+}
+
+#endif
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <sstream>
+#include "ns3/log.h"
+#include "blockchain-mempool.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainMempool");
+
+    BlockchainMempool::BlockchainMempool(void) : m_capacity(0), m_nextSequence(0), m_bytes(0), m_maxSize(0), m_evictions(0), m_rejections(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainMempool::~BlockchainMempool(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainMempool::SetCapacity(uint32_t transactions)
+    {
+        NS_LOG_FUNCTION(this);
+        m_capacity = transactions;
+    }
+
+    uint32_t
+    BlockchainMempool::GetCapacity(void) const
+    {
+        return m_capacity;
+    }
+
+    bool
+    BlockchainMempool::Add(const Transaction &transaction, int sizeBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        TransactionKey key(transaction.GetTransNodeId(), transaction.GetTransId());
+
+        if(m_index.find(key) != m_index.end())
+            return false;
+
+        Entry entry = {transaction.GetFee() / std::max(1, sizeBytes), m_nextSequence++, sizeBytes, nullptr};
+
+        if(m_capacity > 0 && m_entries.size() >= m_capacity)
+        {
+            EntrySet::iterator lowest = --m_entries.end();
+
+            if(!EntryOrder()(entry, *lowest))
+            {
+                NS_LOG_INFO("Add : the mempool is full, transaction " << transaction.GetTransId() << " of node "
+                            << transaction.GetTransNodeId() << " is rejected");
+                m_rejections++;
+                return false;
+            }
+
+            Erase(m_index.find(TransactionKey(lowest->transaction->GetTransNodeId(), lowest->transaction->GetTransId())));
+            m_evictions++;
+        }
+
+        TransactionIndex::iterator indexed = m_index.insert(std::make_pair(key, std::make_pair(transaction, m_entries.end()))).first;
+
+        entry.transaction = &indexed->second.first;
+        indexed->second.second = m_entries.insert(entry).first;
+        m_bytes += sizeBytes;
+        m_sizes[sizeBytes]++;
+        m_maxSize = std::max<uint32_t>(m_maxSize, m_entries.size());
+
+        return true;
+    }
+
+    void
+    BlockchainMempool::Remove(const Transaction &transaction)
+    {
+        auto it = m_index.find(TransactionKey(transaction.GetTransNodeId(), transaction.GetTransId()));
+
+        if(it == m_index.end())
+            return;
+
+        Erase(it);
+    }
+
+    bool
+    BlockchainMempool::Contains(const Transaction &transaction) const
+    {
+        return m_index.find(TransactionKey(transaction.GetTransNodeId(), transaction.GetTransId())) != m_index.end();
+    }
+
+    std::vector<Transaction>
+    BlockchainMempool::BuildTemplate(int maxBytes, uint32_t maxTransactions, int &templateBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::vector<Transaction>    transactions;
+        EntrySet::iterator          it = m_entries.begin();
+
+        templateBytes = 0;
+
+        while(it != m_entries.end() && (maxTransactions == 0 || transactions.size() < maxTransactions))
+        {
+            /*
+             * The block is full once the smallest transaction of the pool no longer fits
+             */
+            if(maxBytes - templateBytes < m_sizes.begin()->first)
+                break;
+
+            /*
+             * A transaction too large for the room left is skipped, the smaller ones after it may still fit
+             */
+            if(templateBytes + it->sizeBytes > maxBytes)
+            {
+                it++;
+                continue;
+            }
+
+            const Transaction   &transaction = *it->transaction;
+
+            transactions.push_back(transaction);
+            templateBytes += it->sizeBytes;
+            it++;
+            Erase(m_index.find(TransactionKey(transaction.GetTransNodeId(), transaction.GetTransId())));
+        }
+
+        return transactions;
+    }
+
+    void
+    BlockchainMempool::Erase(TransactionIndex::iterator indexed)
+    {
+        int sizeBytes = indexed->second.second->sizeBytes;
+
+        if(--m_sizes[sizeBytes] == 0)
+            m_sizes.erase(sizeBytes);
+
+        m_bytes -= sizeBytes;
+        m_entries.erase(indexed->second.second);
+        m_index.erase(indexed);
+    }
+
+    uint32_t
+    BlockchainMempool::GetSize(void) const
+    {
+        return m_entries.size();
+    }
+
+    long
+    BlockchainMempool::GetBytes(void) const
+    {
+        return m_bytes;
+    }
+
+    uint32_t
+    BlockchainMempool::GetMaxSize(void) const
+    {
+        return m_maxSize;
+    }
+
+    long
+    BlockchainMempool::GetEvictions(void) const
+    {
+        return m_evictions;
+    }
+
+    long
+    BlockchainMempool::GetRejections(void) const
+    {
+        return m_rejections;
+    }
+
+    void
+    BlockchainMempool::RecordBacklog(double time)
+    {
+        m_backlog.push_back(std::make_pair(time, static_cast<uint32_t>(m_entries.size())));
+    }
+
+    std::string
+    BlockchainMempool::GetBacklogTrace(void) const
+    {
+        std::ostringstream stringStream;
+
+        for(auto it = m_backlog.begin(); it != m_backlog.end(); it++)
+        {
+            stringStream << (it == m_backlog.begin() ? "" : " ") << it->first << ":" << it->second;
+        }
+
+        return stringStream.str();
+    }
+
+    void
+    BlockchainMempool::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_entries.clear();
+        m_index.clear();
+        m_sizes.clear();
+        m_bytes = 0;
+    }
+
+}
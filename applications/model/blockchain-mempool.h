@@ -0,0 +1,119 @@
+#ifndef BLOCKCHAIN_MEMPOOL_H
+#define BLOCKCHAIN_MEMPOOL_H
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * The transactions waiting for a block, ordered by fee rate (fee per byte) and then by arrival.
+     * The ordered set is a double-ended priority queue: the block templates take from the top, a full
+     * pool evicts from the bottom. Add, Remove and the eviction are O(log n).
+     */
+    class BlockchainMempool
+    {
+        public:
+            BlockchainMempool(void);
+            virtual ~BlockchainMempool(void);
+
+            /*
+             * param transactions : the most transactions held, 0 for unlimited
+             */
+            void SetCapacity(uint32_t transactions);
+            uint32_t GetCapacity(void) const;
+
+            /*
+             * Adds a transaction. A full pool evicts its lowest fee rate to make room, or rejects the
+             * transaction if it pays less than that.
+             * return false : if the transaction was already in the pool or was rejected
+             */
+            bool Add(const Transaction &transaction, int sizeBytes);
+
+            /*
+             * Removes a transaction included in a block
+             */
+            void Remove(const Transaction &transaction);
+
+            bool Contains(const Transaction &transaction) const;
+
+            /*
+             * Takes the transactions of the next block out of the pool, by decreasing fee rate
+             * param maxBytes : the room for transactions in the block
+             * param maxTransactions : the most transactions in the block, 0 for unlimited
+             * param templateBytes : set to the size of the transactions taken
+             */
+            std::vector<Transaction> BuildTemplate(int maxBytes, uint32_t maxTransactions, int &templateBytes);
+
+            uint32_t GetSize(void) const;
+            long GetBytes(void) const;
+            uint32_t GetMaxSize(void) const;
+            long GetEvictions(void) const;
+            long GetRejections(void) const;
+
+            /*
+             * Records the backlog, the number of transactions in the pool, at a given time
+             */
+            void RecordBacklog(double time);
+
+            /*
+             * return the recorded backlog as "time:transactions ..."
+             */
+            std::string GetBacklogTrace(void) const;
+
+            void Clear(void);
+
+        protected:
+
+            /*
+             * The transaction itself is held once, by m_index, and the entry points to it
+             */
+            struct Entry
+            {
+                double              feeRate;
+                long                sequence;
+                int                 sizeBytes;
+                const Transaction   *transaction;
+            };
+
+            /*
+             * Highest fee rate first, the oldest first among equal fee rates
+             */
+            struct EntryOrder
+            {
+                bool operator() (const Entry &a, const Entry &b) const
+                {
+                    if(a.feeRate != b.feeRate)
+                        return a.feeRate > b.feeRate;
+                    return a.sequence < b.sequence;
+                }
+            };
+
+            typedef std::set<Entry, EntryOrder>                                             EntrySet;
+            typedef std::pair<int, int>                                                     TransactionKey;     // nodeId, transId
+            typedef std::map<TransactionKey, std::pair<Transaction, EntrySet::iterator>>    TransactionIndex;
+
+            /*
+             * Takes a transaction out of the pool
+             */
+            void Erase(TransactionIndex::iterator indexed);
+
+            EntrySet                                        m_entries;
+            TransactionIndex                                m_index;
+            std::map<int, uint32_t>                         m_sizes;    // the number of transactions of each size, the smallest first
+            uint32_t                                        m_capacity;
+            long                                            m_nextSequence;
+            long                                            m_bytes;
+            uint32_t                                        m_maxSize;
+            long                                            m_evictions;
+            long                                            m_rejections;
+            std::vector<std::pair<double, uint32_t>>        m_backlog;
+    };
+
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "ns3/tcp-socket-factory.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
 #include "ns3/blockchain-miner.h"
 #include <fstream>
 #include <time.h>
@@ -64,10 +65,191 @@ namespace ns3 {
                             TimeValue(Minutes(2)),
                             MakeTimeAccessor(&BlockchainMiner::m_invTimeoutMinutes),
                             MakeTimeChecker())
+            .AddAttribute("TransferSchedulerPolicy",
+                            "The scheduling policy of the block uploads: FIFO_SCHEDULER, ROUND_ROBIN_SCHEDULER, SMALLEST_FIRST_SCHEDULER",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_transferSchedulerPolicy),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("HardwareClass",
+                            "The CPU of the node: IDEAL_HARDWARE, LOW_END_HARDWARE, STANDARD_HARDWARE, HIGH_END_HARDWARE",
+                            UintegerValue(2),
+                            MakeUintegerAccessor(&BlockchainMiner::m_hardwareClass),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("CpuCostTable",
+                            "The CPU cost table generated by blockchain_cpu_calibration (empty : built-in table)",
+                            StringValue(""),
+                            MakeStringAccessor(&BlockchainMiner::m_cpuCostTable),
+                            MakeStringChecker())
+            .AddAttribute("AdaptiveInvTimeouts",
+                            "Derive the block request timeouts from the measured RTT and throughput of the peers, bounded by InvTimeoutMinutes",
+                            BooleanValue(false),
+                            MakeBooleanAccessor(&BlockchainMiner::m_adaptiveInvTimeouts),
+                            MakeBooleanChecker())
+            .AddAttribute("MaxInFlightPerPeer",
+                            "The maximum number of blocks requested from a peer at the same time (0 : unlimited)",
+                            UintegerValue(16),
+                            MakeUintegerAccessor(&BlockchainMiner::m_maxInFlightPerPeer),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("CompactBlockMode",
+                            "The block relay: COMPACT_BLOCKS_OFF, LOW_BANDWIDTH_COMPACT (compact blocks on request), HIGH_BANDWIDTH_COMPACT (pushed unsolicited), GRAPHENE_BLOCKS (Bloom filter + IBLT on request)",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_compactBlockMode),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("BlockTorrent",
+                            "Relay the blocks in chunks fetched from several peers at once (blockTorrent)",
+                            BooleanValue(false),
+                            MakeBooleanAccessor(&BlockchainMiner::m_blockTorrent),
+                            MakeBooleanChecker())
+            .AddAttribute("ChunkSize",
+                            "The size of the block chunks in Bytes, when BlockTorrent is used",
+                            UintegerValue(100000),
+                            MakeUintegerAccessor(&BlockchainMiner::m_chunkSize),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxChunkRequestsPerPeer",
+                            "The maximum number of chunks requested from a peer at the same time (0 : unlimited)",
+                            UintegerValue(4),
+                            MakeUintegerAccessor(&BlockchainMiner::m_maxChunkRequestsPerPeer),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ErasureCoding",
+                            "Disseminate the new blocks as erasure-coded chunks pushed to different peers and forwarded Kadcast-style",
+                            BooleanValue(false),
+                            MakeBooleanAccessor(&BlockchainMiner::m_erasureCoding),
+                            MakeBooleanChecker())
+            .AddAttribute("ErasureDataChunks",
+                            "The number of data chunks of an erasure-coded block, any that many chunks rebuild it",
+                            UintegerValue(8),
+                            MakeUintegerAccessor(&BlockchainMiner::m_erasureDataChunks),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ErasureParityChunks",
+                            "The number of parity chunks added to an erasure-coded block",
+                            UintegerValue(8),
+                            MakeUintegerAccessor(&BlockchainMiner::m_erasureParityChunks),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ReconciliationInterval",
+                            "The mean time in seconds between two reconciliations of the transactions with a peer, 0 floods them to every peer",
+                            DoubleValue(0),
+                            MakeDoubleAccessor(&BlockchainMiner::m_reconciliationInterval),
+                            MakeDoubleChecker<double>(0))
+            .AddAttribute("TransactionRelayFanout",
+                            "The number of peers the transactions are still flooded to when they are reconciled",
+                            UintegerValue(8),
+                            MakeUintegerAccessor(&BlockchainMiner::m_transactionRelayFanout),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TrickleInterval",
+                            "The mean time in seconds between two announcements to a peer (Poisson trickling), 0 announces at once",
+                            DoubleValue(0),
+                            MakeDoubleAccessor(&BlockchainMiner::m_trickleInterval),
+                            MakeDoubleChecker<double>(0))
+            .AddAttribute("SeenCacheCapacity",
+                            "The number of flooded transaction messages a node remembers to drop their duplicates",
+                            UintegerValue(65536),
+                            MakeUintegerAccessor(&BlockchainMiner::m_seenCacheCapacity),
+                            MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("GossipTtl",
+                            "The hops a transaction message may travel (0 : unlimited)",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_gossipTtl),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("GossipFanout",
+                            "The peers a transaction is gossiped to: GOSSIP_FANOUT_ALL, GOSSIP_FANOUT_SQRT (sqrt(peers) random peers), GOSSIP_FANOUT_FIXED (GossipFanoutPeers random peers)",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_gossipFanout),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("GossipFanoutPeers",
+                            "The number of peers a transaction is gossiped to with GOSSIP_FANOUT_FIXED",
+                            UintegerValue(4),
+                            MakeUintegerAccessor(&BlockchainMiner::m_gossipFanoutPeers),
+                            MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("GossipMode",
+                            "How the transactions are gossiped: GOSSIP_PUSH, GOSSIP_PULL (TRANS_INV then GET_TRANS), GOSSIP_PUSH_PULL (pushed to the fanout, TRANS_INV to the other peers)",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_gossipMode),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ForkChoiceRule",
+                            "The fork choice rule: LONGEST_CHAIN, GHOST (heaviest subtree, Ethereum)",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_forkChoiceRule),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TransactionSizeMean",
+                            "The mean size of the created transactions in Bytes",
+                            DoubleValue(522.4),
+                            MakeDoubleAccessor(&BlockchainMiner::m_averageTransacionSize),
+                            MakeDoubleChecker<double>(1))
+            .AddAttribute("TransactionSizeSigma",
+                            "The sigma of the lognormal size of the created transactions (0 : every transaction is TransactionSizeMean Bytes)",
+                            DoubleValue(0),
+                            MakeDoubleAccessor(&BlockchainMiner::m_transactionSizeSigma),
+                            MakeDoubleChecker<double>(0))
+            .AddAttribute("TransactionSizeTrace",
+                            "A file of transaction sizes in Bytes, one per line, replayed by the clients instead of the lognormal sizes",
+                            StringValue(""),
+                            MakeStringAccessor(&BlockchainMiner::m_transactionSizeTrace),
+                            MakeStringChecker())
+            .AddAttribute("TransactionFeeMean",
+                            "The mean fee of the created transactions (exponentially distributed), 0 for no fee",
+                            DoubleValue(1),
+                            MakeDoubleAccessor(&BlockchainMiner::m_transactionFeeMean),
+                            MakeDoubleChecker<double>(0))
+            .AddAttribute("MempoolCapacity",
+                            "The most transactions waiting in the mempool of a miner, the lowest fee rates are evicted (0 : unlimited)",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_mempoolCapacity),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxBlockSize",
+                            "The most Bytes of a block, header included",
+                            UintegerValue(1000000),
+                            MakeUintegerAccessor(&BlockchainMiner::m_maxBlockSize),
+                            MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxBlockTransactions",
+                            "The most transactions of a block, like the gas limit of Ethereum (0 : unlimited)",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_maxBlockTransactions),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxUncles",
+                            "The most uncles (stale block headers) an Ethereum block references (0 : no uncles)",
+                            UintegerValue(2),
+                            MakeUintegerAccessor(&BlockchainMiner::m_maxUncles),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxUncleDepth",
+                            "The most heights between an Ethereum block and the uncles it references",
+                            UintegerValue(6),
+                            MakeUintegerAccessor(&BlockchainMiner::m_maxUncleDepth),
+                            MakeUintegerChecker<uint32_t>(1, 7))
+            .AddAttribute("MiningStrategy",
+                            "HONEST_MINING, SELFISH_MINING, STUBBORN_MINING, WITHHOLDING_MINING",
+                            UintegerValue(HONEST_MINING),
+                            MakeUintegerAccessor(&BlockchainMiner::m_strategy),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TrailStubbornness",
+                            "The blocks a STUBBORN_MINING miner trails the public chain by before adopting it",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainMiner::m_trailStubbornness),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("WithholdingTime",
+                            "The seconds a WITHHOLDING_MINING miner keeps its blocks, unless the public chain catches up with them",
+                            DoubleValue(10),
+                            MakeDoubleAccessor(&BlockchainMiner::m_withholdingTime),
+                            MakeDoubleChecker<double>(0))
+            .AddAttribute("DifficultyAdjustment",
+                            "FIXED_DIFFICULTY, EPOCH_RETARGET, PER_BLOCK_ADJUSTMENT, the difficulty feeds the rate of the mining oracle",
+                            UintegerValue(FIXED_DIFFICULTY),
+                            MakeUintegerAccessor(&BlockchainMiner::m_difficultyAdjustment),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("RetargetInterval",
+                            "The blocks of an epoch of EPOCH_RETARGET",
+                            UintegerValue(2016),
+                            MakeUintegerAccessor(&BlockchainMiner::m_retargetInterval),
+                            MakeUintegerChecker<uint32_t>(2))
+            .AddAttribute("DifficultyTraceFile",
+                            "A file the height, time stamp and difficulty of the main chain blocks are written to at the end, none if empty",
+                            StringValue(""),
+                            MakeStringAccessor(&BlockchainMiner::m_difficultyTraceFile),
+                            MakeStringChecker())
             .AddAttribute("HashRate",
                             "The hash rate of the miner",
                             DoubleValue(0.2),
-                            MakeDoubleAccessor(&BlockchainMiner::m_hashRate),
+                            MakeDoubleAccessor(&BlockchainMiner::SetHashRate,
+                                               &BlockchainMiner::GetHashRate),
                             MakeDoubleChecker<double>())
             .AddAttribute("BlockGenBinSize",
                             "The block generation bin size",
@@ -98,13 +280,16 @@ namespace ns3 {
     }
 
     BlockchainMiner::BlockchainMiner() : BlockchainNode(), m_realAverageBlockGenIntervalSeconds(15),
-                                        m_timeStart(0), m_timeFinish(0), m_fistToMine(false)
+                                        m_timeStart(0), m_timeFinish(0), m_fistToMine(false), m_useMiningOracle(false),
+                                        m_nextDifficulty(1), m_difficultyChanges(0)
     {
         NS_LOG_FUNCTION(this);
         m_minerAverageBlockGenInterval = 0;
         m_minerGeneratedBlocks = 0;
         m_previousBlockGenerationTime = 0;
         m_meanNumberofTransactions = 0;
+        m_meanBlockFill = 0;
+        m_templateBlocks = 0;
 
         std::random_device rd;
         m_generator.seed(rd());
@@ -176,8 +361,31 @@ namespace ns3 {
 
         m_nodeStats->hashRate = m_hashRate;
         m_nodeStats->miner = 1;
+        m_nodeStats->miningStrategy = m_strategy;
 
-        ScheduleNextMiningEvent();
+        m_miningStrategy.SetStrategy(m_strategy);
+        m_miningStrategy.SetTrailStubbornness(m_trailStubbornness);
+        m_miningStrategy.Reset(*m_blockchain.GetCurrentTopBlock());
+
+        m_difficulty.SetAdjustment(m_difficultyAdjustment);
+        m_difficulty.SetTargetInterval(m_averageBlockGenIntervalSeconds);
+        m_difficulty.SetRetargetInterval(m_retargetInterval);
+        m_nextDifficulty = m_difficulty.GetNextDifficulty(*m_blockchain.GetCurrentTopBlock(), m_blockchain);
+
+        /*
+         * Without a fixed interval the proof-of-work blocks are drawn by the mining oracle of the process,
+         * the hash rates are the shares of the miners in the network
+         */
+        if(m_fixedBlockTimeGeneration == 0 && m_cryptocurrency == ETHEREUM)
+        {
+            m_useMiningOracle = true;
+            BlockchainMiningOracle::Get().AddMiner(this, m_hashRate / (m_averageBlockGenIntervalSeconds * m_nextDifficulty),
+                                                    MakeCallback(&BlockchainMiner::MineBlock, this));
+        }
+        else
+        {
+            ScheduleNextMiningEvent();
+        }
 
     }
 
@@ -189,17 +397,51 @@ namespace ns3 {
         BlockchainNode::StopApplication();
         Simulator::Cancel(m_nextMiningEvent);
 
+        if(m_useMiningOracle)
+        {
+            NS_LOG_WARN("Mining oracle : " << BlockchainMiningOracle::Get().GetMiners() << " miners, total rate = "
+                        << BlockchainMiningOracle::Get().GetTotalRate() << " blocks/s, drawn blocks = " << BlockchainMiningOracle::Get().GetDrawnBlocks()
+                        << ", mean interval = " << BlockchainMiningOracle::Get().GetMeanInterval() << "s");
+            BlockchainMiningOracle::Get().RemoveMiner(this);
+        }
+
         NS_LOG_WARN("The miner " << GetNode()->GetId() << " with hash rate = " << m_hashRate
                     << " generated " << m_minerGeneratedBlocks << " blocks " << " ( " << 100.0*m_minerGeneratedBlocks/(m_blockchain.GetTotalBlocks()-1)
                     << "%) with average block generation time = " << m_minerAverageBlockGenInterval
                     << "s or " << static_cast<int>(m_minerAverageBlockGenInterval)/60 << "min and "
                     << m_minerAverageBlockGenInterval - static_cast<int>(m_minerAverageBlockGenInterval)/60*60 << "s" 
-                    << " and average size " << m_minerAverageBlockSize << " Bytes");
+                    << " and average size " << m_minerAverageBlockSize << " Bytes, "
+                    << m_blockchain.GetMinerIncludedUncles(GetNode()->GetId()) << " of its stale blocks were referenced as uncles (uncle rewards = "
+                    << m_blockchain.GetMinerUncleRewards(GetNode()->GetId()) << " blocks)");
 
         m_nodeStats->minerGeneratedBlocks = m_minerGeneratedBlocks;
         m_nodeStats->minerAverageBlockGenInterval = m_minerAverageBlockGenInterval;
         m_nodeStats->minerAverageBlockSize = m_minerAverageBlockSize;
         m_nodeStats->meanNumberofTransactions = m_meanNumberofTransactions;
+        m_nodeStats->meanBlockFill = m_meanBlockFill;
+        m_nodeStats->minedBlocksInMainChain = m_blockchain.GetMinedBlocksInMainChain(GetNode()->GetId());
+        m_nodeStats->minerIncludedUncles = m_blockchain.GetMinerIncludedUncles(GetNode()->GetId());
+        m_nodeStats->minerUncleRewards = m_blockchain.GetMinerUncleRewards(GetNode()->GetId());
+        m_nodeStats->minerWithheldBlocks = m_miningStrategy.GetWithheldBlocks();
+        m_nodeStats->minerAbandonedBlocks = m_miningStrategy.GetAbandonedBlocks() + m_miningStrategy.GetPrivateBlocks();
+
+        if(m_difficultyAdjustment != FIXED_DIFFICULTY)
+        {
+            NS_LOG_WARN("Difficulty (" << getDifficultyAdjustment(m_difficultyAdjustment) << ") : next block at " << m_nextDifficulty
+                        << ", changes seen = " << m_difficultyChanges << ", target interval = " << m_averageBlockGenIntervalSeconds << "s");
+        }
+
+        if(!m_difficultyTraceFile.empty())
+            WriteDifficultyTrace();
+
+        if(m_strategy != HONEST_MINING)
+        {
+            NS_LOG_WARN("Mining strategy : " << getMiningStrategy(m_strategy) << " withheld " << m_miningStrategy.GetWithheldBlocks()
+                        << " blocks, abandoned " << m_miningStrategy.GetAbandonedBlocks() << ", " << m_miningStrategy.GetPrivateBlocks()
+                        << " still private, races = " << m_miningStrategy.GetRaces() << ", revenue share = "
+                        << 100.0*m_blockchain.GetMinedBlocksInMainChain(GetNode()->GetId())/std::max(1, m_blockchain.GetTotalBlocks() - 1 - m_blockchain.GetBlocksInForks())
+                        << "% for a hash rate of " << 100*m_hashRate << "%");
+        }
 
         if(m_fistToMine)
         {
@@ -212,6 +454,10 @@ namespace ns3 {
     BlockchainMiner::DoDispose(void)
     {
         NS_LOG_FUNCTION(this);
+
+        if(m_useMiningOracle)
+            BlockchainMiningOracle::Get().RemoveMiner(this);
+
         BlockchainNode::DoDispose();
     }
 
@@ -285,6 +531,12 @@ namespace ns3 {
     {
         NS_LOG_FUNCTION(this);
         m_hashRate = hashRate;
+
+        /*
+         * A hash rate changed during the simulation only moves the block rate until the difficulty follows it
+         */
+        if(m_useMiningOracle)
+            BlockchainMiningOracle::Get().SetMinerRate(this, m_hashRate / (m_averageBlockGenIntervalSeconds * m_nextDifficulty));
     }
 
     void
@@ -302,12 +554,8 @@ namespace ns3 {
         else
         {
             /*
-            m_nextBlockTime = m_blockGenTimeDistribution(m_generator)*m_blockGenBinSize*60
-                                *(m_averageBlockGenIntervalSeconds/m_realAverageBlockGenIntervalSeconds)/m_hashRate;
-            //std::cout<< "m_blockGenTimeDistribution(m_generator) : "<<m_blockGenTimeDistribution(m_generator)<<"\n";
-            //std::cout<<"m_nextBlockTime(2) : " << m_nextBlockTime <<"\n";
-            m_nextMiningEvent = Simulator::Schedule(Seconds(m_nextBlockTime), &BlockchainMiner::MineBlock, this);
-            */
+             * The ordering service of Hyperledger cuts a block every 2s, the proof-of-work blocks come from BlockchainMiningOracle
+             */
             m_nextBlockTime = 2;
             m_nextMiningEvent = Simulator::Schedule(Seconds(m_nextBlockTime), &BlockchainMiner::MineBlock, this);
         }
@@ -318,14 +566,21 @@ namespace ns3 {
     {   
         NS_LOG_FUNCTION(this);
         //std::cout<< "Start MineBlock function\n";
-        rapidjson::Document inv;
-        rapidjson::Document block;
+
+        /*
+         * Honest miners extend the public tip, the other strategies their private tip
+         */
+        bool onPublicTip = m_miningStrategy.GetStrategy() == HONEST_MINING;
+        Block parent = onPublicTip ? *m_blockchain.GetCurrentTopBlock() : m_miningStrategy.GetPrivateTip();
+
+        if(!onPublicTip)
+            onPublicTip = parent == *m_blockchain.GetCurrentTopBlock();
 
         std::vector<Transaction>::iterator      trans_it;
-        int height = m_blockchain.GetCurrentTopBlock()->GetBlockHeight() + 1;
+        int height = parent.GetBlockHeight() + 1;
         int minerId = GetNode()->GetId();
         int nonce = 0;
-        int parentBlockMinerId = m_blockchain.GetCurrentTopBlock()->GetMinerId();
+        int parentBlockMinerId = parent.GetMinerId();
         double currentTime = Simulator::Now().GetSeconds();
         std::ostringstream stringStream;
         std::string blockHash;
@@ -333,54 +588,136 @@ namespace ns3 {
         stringStream << height << "/" << minerId;
         blockHash = stringStream.str();
 
-        inv.SetObject();
-        block.SetObject();
-
         if(height == 1)
         {
             m_fistToMine = true;
             m_timeStart = GetWallTime();
         }
 
+        /*
+         * Ethereum blocks reference the recent stale blocks whose parent is in the main chain, their headers
+         * take room in the block. The candidates are only known for a block on the public tip.
+         */
+        std::vector<const Block *> uncles;
+
+        if(m_cryptocurrency == ETHEREUM && m_maxUncles > 0 && onPublicTip)
+            uncles = m_blockchain.GetUncleCandidates(m_maxUncles, m_maxUncleDepth);
+
+        int uncleBytes = uncles.size()*m_headersSizeBytes;
+
+        /*
+         * The block template takes the highest fee rates of the mempool up to the size and transaction limits.
+         * A fixed block size is both the limit and the announced size, the scenarios without transactions keep
+         * the synthetic block sizes.
+         */
+        int maxBlockSize = m_fixedBlockSize > 0 ? m_fixedBlockSize : m_maxBlockSize;
+        int templateBytes;
+        std::vector<Transaction> blockTransactions = m_mempool.BuildTemplate(maxBlockSize - m_headersSizeBytes - uncleBytes,
+                                                                            m_maxBlockTransactions, templateBytes);
+
+        m_mempool.RecordBacklog(currentTime);
+
         if(m_fixedBlockSize > 0)
         {
             m_nextBlockSize = m_fixedBlockSize;
             
         }
+        else if(m_mempool.GetMaxSize() > 0)
+        {
+            m_nextBlockSize = m_headersSizeBytes + uncleBytes + templateBytes;
+        }
         else
         {
             std::normal_distribution<double> dist(23.0, 2.0);
             //m_nextBlockSize = dist(m_generator);
             m_nextBlockSize = (int)(dist(m_generator)*1000);
             //std::cout <<(int)(dist(m_generator)*1000) <<"\n";
+
+            if(m_nextBlockSize < m_averageTransacionSize)
+            {
+                m_nextBlockSize = m_averageTransacionSize + m_headersSizeBytes;
+            }
+            m_nextBlockSize += uncleBytes;
         }
 
-        if(m_nextBlockSize < m_averageTransacionSize)
+        if(m_mempool.GetMaxSize() > 0)
         {
-            m_nextBlockSize = m_averageTransacionSize + m_headersSizeBytes;
+            m_meanBlockFill = (m_meanBlockFill*m_templateBlocks + templateBytes/static_cast<double>(maxBlockSize - m_headersSizeBytes - uncleBytes))/(m_templateBlocks + 1);
+            m_templateBlocks++;
         }
 
         Block newBlock(height, minerId, nonce, parentBlockMinerId, m_nextBlockSize,
                         currentTime, currentTime, Ipv4Address("127.0.0.1"));
+
+        newBlock.SetDifficulty(m_difficulty.GetNextDifficulty(parent, m_blockchain, m_miningStrategy.GetPrivateChain()));
+
+        for(auto uncle = uncles.begin(); uncle != uncles.end(); uncle++)
+        {
+            NS_LOG_INFO("MineBlock : block " << blockHash << " references the uncle " << (*uncle)->GetBlockHeight() << "/" << (*uncle)->GetMinerId());
+            newBlock.AddUncle((*uncle)->GetBlockHeight(), (*uncle)->GetMinerId());
+        }
         
         /*
          * Push transactions to new Blocks
          */
         
-        for(trans_it = m_notValidatedTransaction.begin(); trans_it < m_notValidatedTransaction.end(); trans_it++)
+        for(trans_it = blockTransactions.begin(); trans_it < blockTransactions.end(); trans_it++)
         {
             trans_it->SetValidation();
             m_totalOrdering++;
             m_meanOrderingTime = (m_meanOrderingTime*static_cast<double>(m_totalOrdering-1) + (Simulator::Now().GetSeconds() - trans_it->GetTransTimeStamp()))/static_cast<double>(m_totalOrdering);
 
         }
-        //std::cout<<m_notValidatedTransaction.size()<<"\n";
-        m_meanNumberofTransactions = (m_meanNumberofTransactions*static_cast<double>(m_minerGeneratedBlocks) + m_notValidatedTransaction.size())/static_cast<double>(m_minerGeneratedBlocks+1);
-        newBlock.SetTransactions(m_notValidatedTransaction);
-        m_notValidatedTransaction.clear();
+        //std::cout<<blockTransactions.size()<<"\n";
+        m_meanNumberofTransactions = (m_meanNumberofTransactions*static_cast<double>(m_minerGeneratedBlocks) + blockTransactions.size())/static_cast<double>(m_minerGeneratedBlocks+1);
+        newBlock.SetTransactions(blockTransactions);
 
         //newBlock.PrintAllTransaction();
-        
+
+        m_minerAverageBlockGenInterval = m_minerGeneratedBlocks/static_cast<double>(m_minerGeneratedBlocks+1)*m_minerAverageBlockGenInterval
+                                        + (Simulator::Now().GetSeconds() - m_previousBlockGenerationTime)/(m_minerGeneratedBlocks+1);
+
+        m_minerAverageBlockSize = m_minerGeneratedBlocks/static_cast<double>(m_minerGeneratedBlocks+1)*m_minerAverageBlockSize
+                                + static_cast<double>(m_nextBlockSize)/(m_minerGeneratedBlocks+1);
+        m_previousBlockGenerationTime = Simulator::Now().GetSeconds();
+        m_minerGeneratedBlocks++;
+
+        /*
+         * The mining strategy decides which blocks go public, the withheld ones wait for their release rule
+         */
+        std::vector<Block> published = m_miningStrategy.MinedBlock(newBlock);
+
+        for(auto it = published.begin(); it != published.end(); it++)
+            PublishBlock(*it);
+
+        if(published.empty() && m_miningStrategy.GetStrategy() == WITHHOLDING_MINING)
+            Simulator::Schedule(Seconds(m_withholdingTime), &BlockchainMiner::ReleaseBlock, this, newBlock);
+
+        UpdateDifficulty();
+
+        if(!m_useMiningOracle)
+            ScheduleNextMiningEvent();
+        //std::cout<< "MineBlock function : finish MinBLock\n";
+
+    }
+
+    void
+    BlockchainMiner::PublishBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document inv;
+        rapidjson::Document block;
+        double currentTime = Simulator::Now().GetSeconds();
+        std::ostringstream stringStream;
+        std::string blockHash;
+
+        stringStream << newBlock.GetBlockHeight() << "/" << newBlock.GetMinerId();
+        blockHash = stringStream.str();
+
+        inv.SetObject();
+        block.SetObject();
+
         rapidjson::Value value;
         rapidjson::Value array(rapidjson::kArrayType);
         //rapidjson::Value blockInfor(rapidjson::kObjectType);
@@ -397,6 +734,15 @@ namespace ns3 {
             array.PushBack(value, inv.GetAllocator());
             inv.AddMember("inv", array, inv.GetAllocator());
         }
+        else if(m_protocolType == SENDHEADERS)
+        {
+            value = HEADERS;
+            inv.AddMember("message", value, inv.GetAllocator());
+            inv["type"].SetString("announcement");
+
+            AddBlockHeader(inv, array, newBlock);
+            inv.AddMember("blocks", array, inv.GetAllocator());
+        }
 
         m_meanBlockReceiveTime = (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks())*m_meanBlockReceiveTime
                                 + (currentTime - m_previousBlockReceiveTime)/(m_blockchain.GetTotalBlocks());
@@ -405,7 +751,7 @@ namespace ns3 {
         m_meanBlockPropagationTime = (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks())*m_meanBlockPropagationTime;
 
         m_meanBlockSize = (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks())*m_meanBlockSize     
-                            + (m_nextBlockSize)/static_cast<double>(m_blockchain.GetTotalBlocks());
+                            + (newBlock.GetBlockSizeBytes())/static_cast<double>(m_blockchain.GetTotalBlocks());
         
         m_blockchain.AddBlock(newBlock);
 
@@ -419,35 +765,102 @@ namespace ns3 {
 
         //std::cout<< "MineBlock function : Add a new block in packet\n";
 
-        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
+        if(m_erasureCoding)
+        {
+            /*
+             * The coded chunks of the block are pushed to the peers, the relays announce it once they have it
+             */
+            DisperseCodedBlock(newBlock);
+        }
+        else if(m_blockTorrent || m_compactBlockMode == HIGH_BANDWIDTH_COMPACT)
         {
+            /*
+             * The chunks of the block, or its compact block, are advertised instead of an announcement
+             */
+            AdvertiseNewBlock(newBlock);
+        }
+        else
+        {
+            for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
+            {
             
-            const uint8_t delimiter[] = "#";
+                const uint8_t delimiter[] = "#";
 
-            m_peersSockets[*i]->Send(reinterpret_cast<const uint8_t*>(invInfo.GetString()), invInfo.GetSize(), 0);
-            m_peersSockets[*i]->Send(delimiter, 1, 0);
+                m_peersSockets[*i]->Send(reinterpret_cast<const uint8_t*>(invInfo.GetString()), invInfo.GetSize(), 0);
+                m_peersSockets[*i]->Send(delimiter, 1, 0);
             
-            m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + inv["inv"].Size()*m_inventorySizeBytes;
-            //std::cout<< "Node : " << GetNode()->GetId() <<" complete minning and send packet to " << *i << " \n" ;
-            NS_LOG_INFO("At time " << Simulator::Now().GetSeconds()
-                        << " s blockchain miner " << GetNode()->GetId()
-                        << " sent a packet " << invInfo.GetString()
-                        << " to " << *i);
+                if(m_protocolType == STANDARD_PROTOCOL)
+                {
+                    m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + inv["inv"].Size()*m_inventorySizeBytes;
+                    m_nodeStats->announcementSentBytes += m_blockchainMessageHeader + m_countBytes + inv["inv"].Size()*m_inventorySizeBytes;
+                }
+                else if(m_protocolType == SENDHEADERS)
+                {
+                    m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + inv["blocks"].Size()*m_headersSizeBytes;
+                    m_nodeStats->announcementSentBytes += m_blockchainMessageHeader + m_countBytes + inv["blocks"].Size()*m_headersSizeBytes;
+                }
+                //std::cout<< "Node : " << GetNode()->GetId() <<" complete minning and send packet to " << *i << " \n" ;
+                NS_LOG_INFO("At time " << Simulator::Now().GetSeconds()
+                            << " s blockchain miner " << GetNode()->GetId()
+                            << " sent a packet " << invInfo.GetString()
+                            << " to " << *i);
             
 
+            }
         }
-        
-        m_minerAverageBlockGenInterval = m_minerGeneratedBlocks/static_cast<double>(m_minerGeneratedBlocks+1)*m_minerAverageBlockGenInterval
-                                        + (Simulator::Now().GetSeconds() - m_previousBlockGenerationTime)/(m_minerGeneratedBlocks+1);
+    }
 
-        m_minerAverageBlockSize = m_minerGeneratedBlocks/static_cast<double>(m_minerGeneratedBlocks+1)*m_minerAverageBlockSize
-                                + static_cast<double>(m_nextBlockSize)/(m_minerGeneratedBlocks+1);
-        m_previousBlockGenerationTime = Simulator::Now().GetSeconds();
-        m_minerGeneratedBlocks++;
+    void
+    BlockchainMiner::ReleaseBlock(Block withheldBlock)
+    {
+        NS_LOG_FUNCTION(this);
 
-        ScheduleNextMiningEvent();
-        //std::cout<< "MineBlock function : finish MinBLock\n";
+        std::vector<Block> published = m_miningStrategy.Release(withheldBlock);
+
+        for(auto it = published.begin(); it != published.end(); it++)
+            PublishBlock(*it);
+    }
+
+    void
+    BlockchainMiner::UpdateDifficulty(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        const Block &tip = m_miningStrategy.GetStrategy() == HONEST_MINING ? *m_blockchain.GetCurrentTopBlock()
+                                                                            : m_miningStrategy.GetPrivateTip();
+        double difficulty = m_difficulty.GetNextDifficulty(tip, m_blockchain, m_miningStrategy.GetPrivateChain());
+
+        if(difficulty == m_nextDifficulty)
+            return;
+
+        NS_LOG_INFO("UpdateDifficulty : miner " << GetNode()->GetId() << " moves from the difficulty " << m_nextDifficulty
+                    << " to " << difficulty << " at the height " << tip.GetBlockHeight() + 1);
 
+        m_nextDifficulty = difficulty;
+        m_difficultyChanges++;
+
+        if(m_useMiningOracle)
+            BlockchainMiningOracle::Get().SetMinerRate(this, m_hashRate / (m_averageBlockGenIntervalSeconds * m_nextDifficulty));
+    }
+
+    void
+    BlockchainMiner::WriteDifficultyTrace(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::ofstream file(m_difficultyTraceFile.c_str());
+
+        if(!file.is_open())
+            NS_FATAL_ERROR("Cannot write the difficulty trace " << m_difficultyTraceFile);
+
+        file << "height time difficulty\n";
+        for(int height = 0; height <= m_blockchain.GetCurrentTopBlock()->GetBlockHeight(); height++)
+        {
+            const Block *block = m_blockchain.GetMainChainBlock(height);
+
+            if(block != nullptr)
+                file << height << " " << block->GetTimeStamp() << " " << block->GetDifficulty() << "\n";
+        }
     }
 
     void
@@ -455,6 +868,24 @@ namespace ns3 {
     {
         NS_LOG_FUNCTION(this);
         NS_LOG_WARN("Blockchain miner " << GetNode()->GetId() << " added a new block in the blockchain with higher height");
+
+        /*
+         * The public tip is copied first, publishing the private blocks reallocates the blocks of the blockchain
+         */
+        Block publicTip = newBlock;
+        std::vector<Block> published = m_miningStrategy.PublicTip(publicTip);
+
+        for(auto it = published.begin(); it != published.end(); it++)
+            PublishBlock(*it);
+
+        UpdateDifficulty();
+
+        /*
+         * The time to the next block of the oracle only depends on the tip through the difficulty
+         */
+        if(m_useMiningOracle)
+            return;
+
         Simulator::Cancel(m_nextMiningEvent);
         ScheduleNextMiningEvent();
     }
@@ -2,6 +2,9 @@
 #define BLOCKCHAIN_MINER_H
 
 #include "blockchain-node.h"
+#include "blockchain-mining-oracle.h"
+#include "blockchain-mining-strategy.h"
+#include "blockchain-difficulty.h"
 #include <random>
 #include "../../rapidjson/document.h"
 #include "../../rapidjson/writer.h"
@@ -52,12 +55,32 @@ namespace ns3{
 
             virtual void DoDispose(void);
 
-            void ScheduleNextMiningEvent (void);
+            virtual void ScheduleNextMiningEvent (void);
 
             virtual void MineBlock(void);
 
             virtual void ReceivedHigherBlock(const Block &newBlock);
 
+            /*
+             * Adds a block of the miner to its blockchain and announces it, the validators propose it instead
+             */
+            virtual void PublishBlock(const Block &newBlock);
+
+            /*
+             * The delay of a block of a WITHHOLDING_MINING miner ended
+             */
+            void ReleaseBlock(Block withheldBlock);
+
+            /*
+             * Takes the difficulty of the next block from the tip it extends, the mining oracle gets the new rate
+             */
+            void UpdateDifficulty(void);
+
+            /*
+             * Writes the height, time stamp and difficulty of the main chain blocks to m_difficultyTraceFile
+             */
+            void WriteDifficultyTrace(void);
+
             void SendBlock(std::string packetInfo, Ptr<Socket> socket);
 
             int                         m_noMiners;
@@ -78,7 +101,12 @@ namespace ns3{
             std::geometric_distribution<int>    m_blockGenTimeDistribution;
 
             int                         m_nextBlockSize;
-            int                         m_maxBlockSize;
+            int                         m_maxBlockSize;                 // the size limit of the block templates, in Bytes
+            uint32_t                    m_maxBlockTransactions;         // the transaction limit of the block templates, 0 for unlimited
+            double                      m_meanBlockFill;                // mean share of the room for transactions the templates filled
+            int                         m_maxUncles;                    // the most stale blocks an Ethereum block references
+            int                         m_maxUncleDepth;                // the most heights between a block and its uncles
+            long                        m_templateBlocks;
             double                      m_minerAverageBlockSize;
             //std::piecewise_constant_distribution<double> m_blockSizeDistribution;
             //std::normal_distribution<double>    m_blockSizeDistribution;
@@ -92,6 +120,19 @@ namespace ns3{
             double  m_timeStart;
             double  m_timeFinish;
             bool    m_fistToMine;
+            bool    m_useMiningOracle;      // the blocks come from BlockchainMiningOracle instead of m_nextMiningEvent
+
+            enum MiningStrategy         m_strategy;
+            int                         m_trailStubbornness;
+            double                      m_withholdingTime;
+            BlockchainMiningStrategy    m_miningStrategy;       // the private chain of the withholding strategies
+
+            enum DifficultyAdjustment   m_difficultyAdjustment;
+            int                         m_retargetInterval;
+            std::string                 m_difficultyTraceFile;
+            BlockchainDifficulty        m_difficulty;
+            double                      m_nextDifficulty;       // the difficulty of the block being mined
+            int                         m_difficultyChanges;
 
     };
 
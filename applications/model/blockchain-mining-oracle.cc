@@ -0,0 +1,205 @@
+#include <math.h>
+#include <stdlib.h>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "blockchain-mining-oracle.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainMiningOracle");
+
+    /*
+     * The bound rate is set this much above the total rate. The retargets move the total rate by a few percent
+     * per block, so the time of the next block is seldom drawn again, and at most 1 - 1 / 1.25^2 = 36% of the drawn
+     * blocks are dropped.
+     */
+    static const double g_boundMargin = 1.25;
+
+    BlockchainMiningOracle&
+    BlockchainMiningOracle::Get(void)
+    {
+        static BlockchainMiningOracle oracle;
+
+        return oracle;
+    }
+
+    BlockchainMiningOracle::BlockchainMiningOracle(void) : m_totalRate(0), m_boundRate(0), m_drawnBlocks(0), m_firstBlockTime(0), m_lastBlockTime(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainMiningOracle::~BlockchainMiningOracle(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainMiningOracle::AddMiner(const void *miner, double rate, Callback<void> mine)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(rate <= 0)
+            return;
+
+        RegisteredMiner registered = {miner, rate, mine};
+
+        m_minerIndex[miner] = m_miners.size();
+        m_miners.push_back(registered);
+        m_totalRate += rate;
+        UpdateBound();
+    }
+
+    void
+    BlockchainMiningOracle::RemoveMiner(const void *miner)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto index = m_minerIndex.find(miner);
+
+        if(index == m_minerIndex.end())
+            return;
+
+        /*
+         * The last miner takes the place of the removed one, the order of the miners does not matter for the draw
+         */
+        size_t position = index->second;
+
+        m_totalRate -= m_miners[position].rate;
+        m_miners[position] = m_miners.back();
+        m_minerIndex[m_miners[position].miner] = position;
+        m_miners.pop_back();
+        m_minerIndex.erase(miner);
+        UpdateBound();
+    }
+
+    void
+    BlockchainMiningOracle::SetMinerRate(const void *miner, double rate)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto index = m_minerIndex.find(miner);
+
+        if(index == m_minerIndex.end())
+            return;
+
+        RegisteredMiner &registered = m_miners[index->second];
+
+        m_totalRate += rate - registered.rate;
+        registered.rate = rate;
+        UpdateBound();
+    }
+
+    double
+    BlockchainMiningOracle::GetTotalRate(void) const
+    {
+        return m_totalRate;
+    }
+
+    uint32_t
+    BlockchainMiningOracle::GetMiners(void) const
+    {
+        return m_miners.size();
+    }
+
+    long
+    BlockchainMiningOracle::GetDrawnBlocks(void) const
+    {
+        return m_drawnBlocks;
+    }
+
+    double
+    BlockchainMiningOracle::GetMeanInterval(void) const
+    {
+        return m_drawnBlocks > 1 ? (m_lastBlockTime - m_firstBlockTime) / (m_drawnBlocks - 1) : 0;
+    }
+
+    void
+    BlockchainMiningOracle::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Simulator::Cancel(m_nextBlock);
+        m_miners.clear();
+        m_minerIndex.clear();
+        m_totalRate = 0;
+        m_boundRate = 0;
+        m_drawnBlocks = 0;
+    }
+
+    void
+    BlockchainMiningOracle::Reschedule(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Simulator::Cancel(m_nextBlock);
+
+        /*
+         * The exponential distribution is memoryless, so drawing again after a change of the bound
+         * does not bias the block times
+         */
+        m_boundRate = m_miners.empty() || m_totalRate <= 0 ? 0 : m_totalRate * g_boundMargin;
+        ScheduleNextBlock();
+    }
+
+    void
+    BlockchainMiningOracle::ScheduleNextBlock(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_boundRate <= 0)
+            return;
+
+        double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+        m_nextBlock = Simulator::Schedule(Seconds(-log(u) / m_boundRate), &BlockchainMiningOracle::DrawBlock, this);
+    }
+
+    void
+    BlockchainMiningOracle::UpdateBound(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_totalRate > m_boundRate || m_totalRate * g_boundMargin * g_boundMargin < m_boundRate || m_miners.empty())
+            Reschedule();
+    }
+
+    void
+    BlockchainMiningOracle::DrawBlock(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * The draws of the bound rate thinned with the probability totalRate / boundRate are the blocks of the total rate
+         */
+        if(m_miners.empty() || rand() / (RAND_MAX + 1.0) * m_boundRate >= m_totalRate)
+        {
+            ScheduleNextBlock();
+            return;
+        }
+
+        double  target = rand() / (RAND_MAX + 1.0) * m_totalRate;
+        double  now = Simulator::Now().GetSeconds();
+        auto    winner = m_miners.begin();
+
+        for(; winner + 1 != m_miners.end(); winner++)
+        {
+            target -= winner->rate;
+            if(target < 0)
+                break;
+        }
+
+        if(m_drawnBlocks == 0)
+            m_firstBlockTime = now;
+        m_lastBlockTime = now;
+        m_drawnBlocks++;
+
+        /*
+         * The next block is drawn first: the winner may leave the oracle while it mines
+         */
+        Callback<void> mine = winner->mine;
+
+        ScheduleNextBlock();
+        mine();
+    }
+
+}
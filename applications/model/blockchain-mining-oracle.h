@@ -0,0 +1,102 @@
+#ifndef BLOCKCHAIN_MINING_ORACLE_H
+#define BLOCKCHAIN_MINING_ORACLE_H
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+    /*
+     * Process-wide source of the proof-of-work blocks. Every miner finds blocks as a Poisson process of
+     * rate hashRate / AverageBlockGenIntervalSeconds, and a new tip does not change the time left until
+     * its next block. So the next block of all the miners of this process comes after an exponential
+     * time of the total rate, and it goes to a miner picked in proportion to its hash rate. The winner
+     * mines on its own tip, which gives the forks caused by the propagation delay.
+     * The oracle keeps one pending event per process (MPI rank). The ranks draw independently, and the
+     * superposition of their Poisson processes is again the one of independent miners.
+     * The event is drawn at a bound rate above the total rate, and a drawn block is kept with the probability
+     * totalRate / boundRate. So the retargets of the miners, one per miner and block, only change the rates, and
+     * the event is drawn again only when the total rate leaves the bound.
+     */
+    class BlockchainMiningOracle
+    {
+        public:
+            /*
+             * return the oracle of this process
+             */
+            static BlockchainMiningOracle& Get(void);
+
+            /*
+             * Registers a miner
+             * param miner : identifies the miner
+             * param rate : the blocks per second the miner finds on its own
+             * param mine : mines a block on the tip of the miner
+             */
+            void AddMiner(const void *miner, double rate, Callback<void> mine);
+            void RemoveMiner(const void *miner);
+
+            /*
+             * Changes the rate of a registered miner, after a change of its hash rate or of the difficulty
+             */
+            void SetMinerRate(const void *miner, double rate);
+
+            double GetTotalRate(void) const;
+            uint32_t GetMiners(void) const;
+
+            long GetDrawnBlocks(void) const;
+            double GetMeanInterval(void) const;
+
+            /*
+             * Removes the miners and cancels the pending event
+             */
+            void Clear(void);
+
+        protected:
+
+            struct RegisteredMiner
+            {
+                const void      *miner;
+                double          rate;
+                Callback<void>  mine;
+            };
+
+            BlockchainMiningOracle(void);
+            virtual ~BlockchainMiningOracle(void);
+
+            /*
+             * Sets the bound rate above the total rate and draws the time of the next block, the previous draw is discarded
+             */
+            void Reschedule(void);
+
+            /*
+             * Draws the time of the next block at the bound rate
+             */
+            void ScheduleNextBlock(void);
+
+            /*
+             * Draws again only when the total rate is above the bound, or so far below it that most draws would be dropped
+             */
+            void UpdateBound(void);
+
+            /*
+             * Keeps the block with the probability totalRate / boundRate, gives it to a miner in proportion to the rates
+             * and draws the next one
+             */
+            void DrawBlock(void);
+
+            std::vector<RegisteredMiner>    m_miners;
+            std::map<const void*, size_t>   m_minerIndex;   // the position of each miner in m_miners
+            double                          m_totalRate;
+            double                          m_boundRate;    // the rate of the pending draw, at least m_totalRate
+            EventId                         m_nextBlock;
+            long                            m_drawnBlocks;
+            double                          m_firstBlockTime;
+            double                          m_lastBlockTime;
+    };
+
+}
+
+#endif
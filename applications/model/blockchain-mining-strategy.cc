@@ -0,0 +1,262 @@
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-mining-strategy.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainMiningStrategy");
+
+    BlockchainMiningStrategy::BlockchainMiningStrategy(void) : m_strategy(HONEST_MINING), m_trailStubbornness(0),
+                                                                m_privateTip(0, 0, 0, 0, 0, 0, 0, Ipv4Address("0.0.0.0")),
+                                                                m_publicHeight(0), m_race(false), m_withheldBlocks(0),
+                                                                m_abandonedBlocks(0), m_races(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainMiningStrategy::~BlockchainMiningStrategy(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainMiningStrategy::SetStrategy(enum MiningStrategy strategy)
+    {
+        NS_LOG_FUNCTION(this);
+        m_strategy = strategy;
+    }
+
+    enum MiningStrategy
+    BlockchainMiningStrategy::GetStrategy(void) const
+    {
+        return m_strategy;
+    }
+
+    void
+    BlockchainMiningStrategy::SetTrailStubbornness(int trail)
+    {
+        NS_LOG_FUNCTION(this);
+        m_trailStubbornness = trail;
+    }
+
+    int
+    BlockchainMiningStrategy::GetTrailStubbornness(void) const
+    {
+        return m_trailStubbornness;
+    }
+
+    void
+    BlockchainMiningStrategy::Reset(const Block &publicTip)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_privateTip = publicTip;
+        m_publicHeight = publicTip.GetBlockHeight();
+        m_race = false;
+        m_privateChain.clear();
+    }
+
+    const Block&
+    BlockchainMiningStrategy::GetPrivateTip(void) const
+    {
+        return m_privateTip;
+    }
+
+    const std::vector<Block>&
+    BlockchainMiningStrategy::GetPrivateChain(void) const
+    {
+        return m_privateChain;
+    }
+
+    std::vector<Block>
+    BlockchainMiningStrategy::MinedBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_privateTip = newBlock;
+
+        if(m_strategy == HONEST_MINING)
+        {
+            m_publicHeight = std::max(m_publicHeight, newBlock.GetBlockHeight());
+            return std::vector<Block>(1, newBlock);
+        }
+
+        m_privateChain.push_back(newBlock);
+        m_withheldBlocks++;
+
+        if(m_strategy == SELFISH_MINING && m_race)
+        {
+            /*
+             * The block wins the race for the selfish branch
+             */
+            m_race = false;
+            return Publish(newBlock.GetBlockHeight());
+        }
+        else if(m_strategy == STUBBORN_MINING)
+        {
+            if(m_race)
+            {
+                /*
+                 * Equal-fork stubbornness : the block winning the race stays private
+                 */
+                m_race = false;
+            }
+            else if(GetLead() == 0)
+            {
+                /*
+                 * Trail stubbornness : the private chain caught up with the public chain, it is matched
+                 */
+                m_race = true;
+                m_races++;
+                return Publish(newBlock.GetBlockHeight());
+            }
+        }
+
+        NS_LOG_INFO("MinedBlock : " << getMiningStrategy(m_strategy) << " withholds the block " << newBlock.GetBlockHeight()
+                    << "/" << newBlock.GetMinerId() << ", lead = " << GetLead());
+
+        return std::vector<Block>();
+    }
+
+    std::vector<Block>
+    BlockchainMiningStrategy::PublicTip(const Block &publicTip)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_strategy == HONEST_MINING)
+        {
+            m_privateTip = publicTip;
+            m_publicHeight = publicTip.GetBlockHeight();
+            return std::vector<Block>();
+        }
+
+        /*
+         * Only a longer public chain changes the lead
+         */
+        if(publicTip.GetBlockHeight() <= m_publicHeight)
+            return std::vector<Block>();
+
+        m_publicHeight = publicTip.GetBlockHeight();
+
+        int lead = GetLead();
+
+        if(lead < 0 && (m_strategy != STUBBORN_MINING || lead < -m_trailStubbornness))
+        {
+            Adopt(publicTip);
+            return std::vector<Block>();
+        }
+        else if(lead < 0)
+        {
+            NS_LOG_INFO("PublicTip : " << getMiningStrategy(m_strategy) << " trails the public chain by " << -lead << " blocks");
+            return std::vector<Block>();
+        }
+        else if(lead == 0)
+        {
+            /*
+             * The public chain caught up : the private block is published for a race
+             */
+            if(!m_privateChain.empty())
+            {
+                m_race = true;
+                m_races++;
+            }
+            return Publish(m_publicHeight);
+        }
+        else if(m_strategy == SELFISH_MINING)
+        {
+            /*
+             * With a lead of 1 the whole private chain overrides the public chain, otherwise it is matched
+             */
+            return Publish(lead == 1 ? m_privateTip.GetBlockHeight() : m_publicHeight);
+        }
+        else if(m_strategy == STUBBORN_MINING)
+        {
+            /*
+             * Lead stubbornness : the public chain is only ever matched
+             */
+            return Publish(m_publicHeight);
+        }
+
+        return std::vector<Block>();
+    }
+
+    std::vector<Block>
+    BlockchainMiningStrategy::Release(const Block &block)
+    {
+        NS_LOG_FUNCTION(this);
+
+        for(auto it = m_privateChain.begin(); it != m_privateChain.end(); it++)
+        {
+            if(*it == block && it->GetTimeStamp() == block.GetTimeStamp())
+                return Publish(block.GetBlockHeight());
+        }
+        return std::vector<Block>();
+    }
+
+    int
+    BlockchainMiningStrategy::GetLead(void) const
+    {
+        return m_privateTip.GetBlockHeight() - m_publicHeight;
+    }
+
+    int
+    BlockchainMiningStrategy::GetWithheldBlocks(void) const
+    {
+        return m_withheldBlocks;
+    }
+
+    int
+    BlockchainMiningStrategy::GetAbandonedBlocks(void) const
+    {
+        return m_abandonedBlocks;
+    }
+
+    int
+    BlockchainMiningStrategy::GetPrivateBlocks(void) const
+    {
+        return m_privateChain.size();
+    }
+
+    int
+    BlockchainMiningStrategy::GetRaces(void) const
+    {
+        return m_races;
+    }
+
+    std::vector<Block>
+    BlockchainMiningStrategy::Publish(int height)
+    {
+        std::vector<Block>              published;
+        std::vector<Block>::iterator    it = m_privateChain.begin();
+
+        while(it != m_privateChain.end() && it->GetBlockHeight() <= height)
+        {
+            published.push_back(*it);
+            it++;
+        }
+        m_privateChain.erase(m_privateChain.begin(), it);
+
+        if(!published.empty())
+        {
+            m_publicHeight = std::max(m_publicHeight, published.back().GetBlockHeight());
+
+            NS_LOG_INFO("Publish : " << getMiningStrategy(m_strategy) << " publishes " << published.size() << " blocks up to "
+                        << published.back().GetBlockHeight() << ", " << m_privateChain.size() << " stay private");
+        }
+
+        return published;
+    }
+
+    void
+    BlockchainMiningStrategy::Adopt(const Block &publicTip)
+    {
+        NS_LOG_INFO("Adopt : " << getMiningStrategy(m_strategy) << " abandons " << m_privateChain.size()
+                    << " private blocks for the public tip " << publicTip.GetBlockHeight() << "/" << publicTip.GetMinerId());
+
+        m_abandonedBlocks += m_privateChain.size();
+        m_privateChain.clear();
+        m_privateTip = publicTip;
+        m_race = false;
+    }
+
+}
@@ -0,0 +1,103 @@
+#ifndef BLOCKCHAIN_MINING_STRATEGY_H
+#define BLOCKCHAIN_MINING_STRATEGY_H
+
+#include <vector>
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * The private chain of a miner and the rules releasing it. The blocks of the private chain are kept
+     * out of the blockchain of the miner, which is its view of the public chain, until they are published.
+     *
+     * The lead is the height of the private tip minus the height of the public chain:
+     *   - HONEST_MINING publishes every block and mines on the public tip;
+     *   - SELFISH_MINING keeps its blocks, matches the public chain when it catches up to a lead of 0 (a race),
+     *     overrides it with the whole private chain at a lead of 1, and publishes up to the public height otherwise;
+     *   - STUBBORN_MINING only ever matches the public chain, keeps mining in private after winning a block in a race,
+     *     and keeps its private chain until it trails the public chain by more than the trail stubbornness;
+     *   - WITHHOLDING_MINING publishes every block after a delay, or at once when the public chain catches up with it.
+     * Every strategy but STUBBORN_MINING adopts the public tip as soon as it is ahead of the private tip.
+     */
+    class BlockchainMiningStrategy
+    {
+        public:
+            BlockchainMiningStrategy(void);
+            virtual ~BlockchainMiningStrategy(void);
+
+            void SetStrategy(enum MiningStrategy strategy);
+            enum MiningStrategy GetStrategy(void) const;
+
+            /*
+             * param trail : the blocks a STUBBORN_MINING miner may trail the public chain by before adopting it
+             */
+            void SetTrailStubbornness(int trail);
+            int GetTrailStubbornness(void) const;
+
+            /*
+             * Starts mining on the public tip, with an empty private chain
+             */
+            void Reset(const Block &publicTip);
+
+            /*
+             * return the block the next block of a withholding strategy extends
+             */
+            const Block& GetPrivateTip(void) const;
+
+            /*
+             * return the unpublished blocks, by increasing height
+             */
+            const std::vector<Block>& GetPrivateChain(void) const;
+
+            /*
+             * The miner found a block on the private tip.
+             * return the blocks to publish now, by increasing height
+             */
+            std::vector<Block> MinedBlock(const Block &newBlock);
+
+            /*
+             * The public chain moved to a new tip.
+             * return the blocks to publish now, by increasing height
+             */
+            std::vector<Block> PublicTip(const Block &publicTip);
+
+            /*
+             * The delay of a withheld block ended.
+             * return the private blocks up to it, none if it is no longer withheld
+             */
+            std::vector<Block> Release(const Block &block);
+
+            int GetLead(void) const;
+
+            /*
+             * The blocks mined in private, the ones dropped when the public chain was adopted,
+             * the ones still private, and the races with the public chain
+             */
+            int GetWithheldBlocks(void) const;
+            int GetAbandonedBlocks(void) const;
+            int GetPrivateBlocks(void) const;
+            int GetRaces(void) const;
+
+        protected:
+
+            /*
+             * Takes the private blocks up to a height out of the private chain
+             */
+            std::vector<Block> Publish(int height);
+
+            void Adopt(const Block &publicTip);
+
+            enum MiningStrategy     m_strategy;
+            int                     m_trailStubbornness;
+            Block                   m_privateTip;
+            int                     m_publicHeight;
+            bool                    m_race;                 // both branches of a tie are public
+            std::vector<Block>      m_privateChain;         // the unpublished blocks, by increasing height
+            int                     m_withheldBlocks;
+            int                     m_abandonedBlocks;
+            int                     m_races;
+    };
+
+}
+
+#endif
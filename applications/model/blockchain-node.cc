@@ -4,6 +4,8 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
 #include "ns3/socket.h"
 #include "ns3/udp-socket.h"
 #include "ns3/simulator.h"
@@ -14,6 +16,9 @@
 #include "ns3/tcp-socket-factory.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
+#include <cmath>
+#include <fstream>
 #include "blockchain-node.h"
 
 namespace ns3 {
@@ -43,6 +48,136 @@ namespace ns3 {
                         TimeValue(Minutes(2)),
                         MakeTimeAccessor(&BlockchainNode::m_invTimeoutMinutes),
                         MakeTimeChecker())
+        .AddAttribute("TransferSchedulerPolicy",
+                        "The scheduling policy of the block uploads: FIFO_SCHEDULER, ROUND_ROBIN_SCHEDULER, SMALLEST_FIRST_SCHEDULER",
+                        UintegerValue(0),
+                        MakeUintegerAccessor(&BlockchainNode::m_transferSchedulerPolicy),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("HardwareClass",
+                        "The CPU of the node: IDEAL_HARDWARE, LOW_END_HARDWARE, STANDARD_HARDWARE, HIGH_END_HARDWARE",
+                        UintegerValue(2),
+                        MakeUintegerAccessor(&BlockchainNode::m_hardwareClass),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("CpuCostTable",
+                        "The CPU cost table generated by blockchain_cpu_calibration (empty : built-in table)",
+                        StringValue(""),
+                        MakeStringAccessor(&BlockchainNode::m_cpuCostTable),
+                        MakeStringChecker())
+        .AddAttribute("AdaptiveInvTimeouts",
+                        "Derive the block request timeouts from the measured RTT and throughput of the peers, bounded by InvTimeoutMinutes",
+                        BooleanValue(false),
+                        MakeBooleanAccessor(&BlockchainNode::m_adaptiveInvTimeouts),
+                        MakeBooleanChecker())
+        .AddAttribute("MaxInFlightPerPeer",
+                        "The maximum number of blocks requested from a peer at the same time (0 : unlimited)",
+                        UintegerValue(16),
+                        MakeUintegerAccessor(&BlockchainNode::m_maxInFlightPerPeer),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("CompactBlockMode",
+                        "The block relay: COMPACT_BLOCKS_OFF, LOW_BANDWIDTH_COMPACT (compact blocks on request), HIGH_BANDWIDTH_COMPACT (pushed unsolicited), GRAPHENE_BLOCKS (Bloom filter + IBLT on request)",
+                        UintegerValue(0),
+                        MakeUintegerAccessor(&BlockchainNode::m_compactBlockMode),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("BlockTorrent",
+                        "Relay the blocks in chunks fetched from several peers at once (blockTorrent)",
+                        BooleanValue(false),
+                        MakeBooleanAccessor(&BlockchainNode::m_blockTorrent),
+                        MakeBooleanChecker())
+        .AddAttribute("ChunkSize",
+                        "The size of the block chunks in Bytes, when BlockTorrent is used",
+                        UintegerValue(100000),
+                        MakeUintegerAccessor(&BlockchainNode::m_chunkSize),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("MaxChunkRequestsPerPeer",
+                        "The maximum number of chunks requested from a peer at the same time (0 : unlimited)",
+                        UintegerValue(4),
+                        MakeUintegerAccessor(&BlockchainNode::m_maxChunkRequestsPerPeer),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("ErasureCoding",
+                        "Disseminate the new blocks as erasure-coded chunks pushed to different peers and forwarded Kadcast-style",
+                        BooleanValue(false),
+                        MakeBooleanAccessor(&BlockchainNode::m_erasureCoding),
+                        MakeBooleanChecker())
+        .AddAttribute("ErasureDataChunks",
+                        "The number of data chunks of an erasure-coded block, any that many chunks rebuild it",
+                        UintegerValue(8),
+                        MakeUintegerAccessor(&BlockchainNode::m_erasureDataChunks),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("ErasureParityChunks",
+                        "The number of parity chunks added to an erasure-coded block",
+                        UintegerValue(8),
+                        MakeUintegerAccessor(&BlockchainNode::m_erasureParityChunks),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("ReconciliationInterval",
+                        "The mean time in seconds between two reconciliations of the transactions with a peer, 0 floods them to every peer",
+                        DoubleValue(0),
+                        MakeDoubleAccessor(&BlockchainNode::m_reconciliationInterval),
+                        MakeDoubleChecker<double>(0))
+        .AddAttribute("TransactionRelayFanout",
+                        "The number of peers the transactions are still flooded to when they are reconciled",
+                        UintegerValue(8),
+                        MakeUintegerAccessor(&BlockchainNode::m_transactionRelayFanout),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("TrickleInterval",
+                        "The mean time in seconds between two announcements to a peer (Poisson trickling), 0 announces at once",
+                        DoubleValue(0),
+                        MakeDoubleAccessor(&BlockchainNode::m_trickleInterval),
+                        MakeDoubleChecker<double>(0))
+        .AddAttribute("SeenCacheCapacity",
+                        "The number of flooded transaction messages and coded block chunks a node remembers to drop their duplicates",
+                        UintegerValue(65536),
+                        MakeUintegerAccessor(&BlockchainNode::m_seenCacheCapacity),
+                        MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("GossipTtl",
+                        "The hops a transaction message may travel (0 : unlimited)",
+                        UintegerValue(0),
+                        MakeUintegerAccessor(&BlockchainNode::m_gossipTtl),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("GossipFanout",
+                        "The peers a transaction is gossiped to: GOSSIP_FANOUT_ALL, GOSSIP_FANOUT_SQRT (sqrt(peers) random peers), GOSSIP_FANOUT_FIXED (GossipFanoutPeers random peers)",
+                        UintegerValue(0),
+                        MakeUintegerAccessor(&BlockchainNode::m_gossipFanout),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("GossipFanoutPeers",
+                        "The number of peers a transaction is gossiped to with GOSSIP_FANOUT_FIXED",
+                        UintegerValue(4),
+                        MakeUintegerAccessor(&BlockchainNode::m_gossipFanoutPeers),
+                        MakeUintegerChecker<uint32_t>(1))
+        .AddAttribute("GossipMode",
+                        "How the transactions are gossiped: GOSSIP_PUSH, GOSSIP_PULL (TRANS_INV then GET_TRANS), GOSSIP_PUSH_PULL (pushed to the fanout, TRANS_INV to the other peers)",
+                        UintegerValue(0),
+                        MakeUintegerAccessor(&BlockchainNode::m_gossipMode),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("ForkChoiceRule",
+                        "The fork choice rule: LONGEST_CHAIN, GHOST (heaviest subtree, Ethereum)",
+                        UintegerValue(0),
+                        MakeUintegerAccessor(&BlockchainNode::m_forkChoiceRule),
+                        MakeUintegerChecker<uint32_t>())
+        .AddAttribute("TransactionSizeMean",
+                        "The mean size of the created transactions in Bytes",
+                        DoubleValue(522.4),
+                        MakeDoubleAccessor(&BlockchainNode::m_averageTransacionSize),
+                        MakeDoubleChecker<double>(1))
+        .AddAttribute("TransactionSizeSigma",
+                        "The sigma of the lognormal size of the created transactions (0 : every transaction is TransactionSizeMean Bytes)",
+                        DoubleValue(0),
+                        MakeDoubleAccessor(&BlockchainNode::m_transactionSizeSigma),
+                        MakeDoubleChecker<double>(0))
+        .AddAttribute("TransactionSizeTrace",
+                        "A file of transaction sizes in Bytes, one per line, replayed by the clients instead of the lognormal sizes",
+                        StringValue(""),
+                        MakeStringAccessor(&BlockchainNode::m_transactionSizeTrace),
+                        MakeStringChecker())
+        .AddAttribute("TransactionFeeMean",
+                        "The mean fee of the created transactions (exponentially distributed), 0 for no fee",
+                        DoubleValue(1),
+                        MakeDoubleAccessor(&BlockchainNode::m_transactionFeeMean),
+                        MakeDoubleChecker<double>(0))
+        .AddAttribute("MempoolCapacity",
+                        "The most transactions waiting in the mempool of a miner, the lowest fee rates are evicted (0 : unlimited)",
+                        UintegerValue(0),
+                        MakeUintegerAccessor(&BlockchainNode::m_mempoolCapacity),
+                        MakeUintegerChecker<uint32_t>())
         .AddTraceSource("Rx",
                         "A packet has been received",
                         MakeTraceSourceAccessor(&BlockchainNode::m_rxTrace),
@@ -51,9 +186,9 @@ namespace ns3 {
         return tid;
     }
 
-    BlockchainNode::BlockchainNode (void) : m_isMiner(false), m_averageTransacionSize(522.4), m_transactionIndexSize(2), m_blockchainPort(8333), m_secondsPerMin(60), 
+    BlockchainNode::BlockchainNode (void) : m_isMiner(false), m_transactionIndexSize(2), m_blockchainPort(8333), m_secondsPerMin(60), 
                                             m_countBytes(4), m_blockchainMessageHeader(90), m_inventorySizeBytes(36), m_getHeaderSizeBytes(72),
-                                            m_headersSizeBytes(81), m_blockHeadersSizeBytes (81)
+                                            m_headersSizeBytes(81), m_blockHeadersSizeBytes (81), m_shortIdNonceSizeBytes(8)
     {
         NS_LOG_FUNCTION(this);
         m_socket = 0;
@@ -65,6 +200,12 @@ namespace ns3 {
         m_meanValidationTime = 0;
         m_meanLatency = 0;
         m_meanBlockSize = 0;
+        m_meanAnnounceToBlockTime = 0;
+        m_announcedBlocksReceived = 0;
+        m_meanChunkSources = 0;
+        m_chunkedBlocksReceived = 0;
+        m_reconciliationQ = 0.25;
+        m_nextReconciliationPeer = 0;
         m_numberOfPeers = m_peersAddresses.size();
         m_transactionId = 1;
         m_numberofEndorsers = 10;
@@ -95,6 +236,13 @@ namespace ns3 {
         return m_peersAddresses;
     }
 
+    const Blockchain &
+    BlockchainNode::GetBlockchain(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_blockchain;
+    }
+
     void
     BlockchainNode::SetPeersAddresses (const std::vector<Ipv4Address> &peers)
     {
@@ -159,6 +307,22 @@ namespace ns3 {
     {
         NS_LOG_FUNCTION(this);
         m_socket = 0;
+        m_uploadScheduler.Clear();
+        m_downloadLink.Clear();
+        m_timerWheel.Clear();
+        m_downloadScheduler.Clear();
+        m_partialBlocks.clear();
+        m_chunkSwarm.Clear();
+        m_chunkTimeouts.clear();
+        m_codedBlocks.clear();
+        m_codedBlockTimeouts.clear();
+        m_relayMessages.clear();
+        m_relayMessageExpiries.clear();
+        m_reconciliationSets.clear();
+        m_sketchedTransactions.clear();
+        m_trickleQueue.Clear();
+        m_trickleEvents.clear();
+        m_seenMessages.Clear();
 
         Application::DoDispose();
     }
@@ -173,6 +337,18 @@ namespace ns3 {
         NS_LOG_INFO("Node" << GetNode()->GetId() << ": upload speed = " << m_uploadSpeed << "B/s");
         NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_numberOfPeers = " << m_numberOfPeers);
         NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_protocolType = " << getProtocolType(m_protocolType));
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_transferSchedulerPolicy = " << getTransferSchedulerPolicy(m_transferSchedulerPolicy));
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_hardwareClass = " << getHardwareClass(m_hardwareClass));
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_compactBlockMode = " << getCompactBlockMode(m_compactBlockMode));
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_blockTorrent = " << m_blockTorrent << ", m_chunkSize = " << m_chunkSize);
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_erasureCoding = " << m_erasureCoding << ", k = " << m_erasureDataChunks
+                    << ", m = " << m_erasureParityChunks);
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_reconciliationInterval = " << m_reconciliationInterval
+                    << "s, m_transactionRelayFanout = " << m_transactionRelayFanout);
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_trickleInterval = " << m_trickleInterval << "s");
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_seenCacheCapacity = " << m_seenCacheCapacity);
+        NS_LOG_INFO("Node" << GetNode()->GetId() << ": m_gossipMode = " << getGossipMode(m_gossipMode) << ", m_gossipFanout = "
+                    << getGossipFanout(m_gossipFanout) << " (k = " << m_gossipFanoutPeers << "), m_gossipTtl = " << m_gossipTtl);
 
         NS_LOG_INFO("Node" << GetNode()->GetId() << ": My peers are");
 
@@ -217,6 +393,56 @@ namespace ns3 {
         }
         NS_LOG_DEBUG("Node" << GetNode()->GetId()<<": After creating sockets");
 
+        m_uploadScheduler.SetPolicy(m_transferSchedulerPolicy);
+        m_uploadScheduler.SetLinkRate(m_uploadSpeed);
+        m_uploadScheduler.SetStartCallback(MakeCallback(&BlockchainNode::SendBlock, this));
+        m_downloadLink.SetLinkRate(m_downloadSpeed);
+        m_downloadLink.SetCompleteCallback(MakeCallback(&BlockchainNode::ReceivedBlockMessage, this));
+        m_peerMonitor.SetTimeoutBounds(Seconds(1), m_invTimeoutMinutes);
+        m_downloadScheduler.SetMaxInFlightPerPeer(m_maxInFlightPerPeer);
+        m_chunkSwarm.SetChunkSize(m_chunkSize);
+        m_chunkSwarm.SetMaxRequestsPerPeer(m_maxChunkRequestsPerPeer);
+        m_erasureCode.SetShards(m_erasureDataChunks, m_erasureParityChunks);
+        m_trickleQueue.SetMeanInterval(m_trickleInterval);
+        m_seenMessages.SetCapacity(m_seenCacheCapacity);
+        m_mempool.SetCapacity(m_mempoolCapacity);
+
+        if(m_committerType == CLIENT && !m_transactionSizeTrace.empty())
+        {
+            std::ifstream   sizeTrace(m_transactionSizeTrace.c_str());
+            int             size;
+
+            if(!sizeTrace.is_open())
+            {
+                NS_FATAL_ERROR("Error : cannot open the transaction size trace " << m_transactionSizeTrace);
+            }
+
+            while(sizeTrace >> size)
+            {
+                if(size > 0)
+                    m_transactionSizes.push_back(size);
+            }
+
+            if(m_transactionSizes.empty())
+            {
+                NS_FATAL_ERROR("Error : the transaction size trace " << m_transactionSizeTrace << " has no size");
+            }
+
+            /*
+             * The clients replay the trace from different offsets
+             */
+            m_nextTransactionSize = GetNode()->GetId() % m_transactionSizes.size();
+        }
+
+        m_blockchain.SetForkChoiceRule(m_forkChoiceRule);
+        m_blockchain.SetReorgCallback(MakeCallback(&BlockchainNode::Reorganized, this));
+
+        m_cpuModel.SetHardwareClass(m_hardwareClass);
+        if(!m_cpuCostTable.empty() && !m_cpuModel.LoadCostTable(m_cpuCostTable))
+        {
+            NS_FATAL_ERROR("Error : cannot load the CPU cost table " << m_cpuCostTable);
+        }
+
         m_nodeStats->nodeId = GetNode()->GetId();
         m_nodeStats->meanBlockReceiveTime = 0;
         m_nodeStats->meanBlockPropagationTime = 0;
@@ -239,6 +465,26 @@ namespace ns3 {
         m_nodeStats->blockSentBytes = 0;
         m_nodeStats->longestFork = 0;
         m_nodeStats->blocksInForks = 0;
+        m_nodeStats->minedBlocksInMainChain = 0;
+        m_nodeStats->reorgs = 0;
+        m_nodeStats->maxReorgDepth = 0;
+        m_nodeStats->includedUncles = 0;
+        m_nodeStats->minerIncludedUncles = 0;
+        m_nodeStats->minerUncleRewards = 0;
+        m_nodeStats->miningStrategy = HONEST_MINING;
+        m_nodeStats->minerWithheldBlocks = 0;
+        m_nodeStats->minerAbandonedBlocks = 0;
+        m_nodeStats->difficulty = 1;
+        m_nodeStats->mainChainInterval = 0;
+        m_nodeStats->steadyChainInterval = 0;
+        m_nodeStats->consensusMessagesSent = 0;
+        m_nodeStats->consensusMessagesReceived = 0;
+        m_nodeStats->consensusSentBytes = 0;
+        m_nodeStats->consensusReceivedBytes = 0;
+        m_nodeStats->consensusSignaturesVerified = 0;
+        m_nodeStats->consensusCommittedBlocks = 0;
+        m_nodeStats->meanCommitLatency = 0;
+        m_nodeStats->viewChanges = 0;
         m_nodeStats->connections = m_peersAddresses.size();
         m_nodeStats->blockTimeouts = 0;
         m_nodeStats->nodeGeneratedTransaction = 0;
@@ -246,6 +492,84 @@ namespace ns3 {
         m_nodeStats->meanOrderingTime = 0;
         m_nodeStats->meanValidationTime = 0;
         m_nodeStats->meanLatency = 0;
+        m_nodeStats->uploadMeanQueueDepth = 0;
+        m_nodeStats->uploadMaxQueueDepth = 0;
+        m_nodeStats->uploadUtilization = 0;
+        m_nodeStats->downloadMeanActiveTransfers = 0;
+        m_nodeStats->downloadMaxActiveTransfers = 0;
+        m_nodeStats->downloadUtilization = 0;
+        m_nodeStats->cpuUtilization = 0;
+        m_nodeStats->cpuMeanQueueDelay = 0;
+        m_nodeStats->cpuMaxQueueLength = 0;
+        m_nodeStats->invTimersArmed = 0;
+        m_nodeStats->invTimersFired = 0;
+        m_nodeStats->invTimersCancelled = 0;
+        m_nodeStats->blockRefetches = 0;
+        m_nodeStats->earlyReissues = 0;
+        m_nodeStats->maxInFlightRequests = 0;
+        m_nodeStats->maxParallelDownloadPeers = 0;
+        m_nodeStats->announcementSentBytes = 0;
+        m_nodeStats->announcementReceivedBytes = 0;
+        m_nodeStats->meanAnnounceToBlockTime = 0;
+        m_nodeStats->compactBlockSentBytes = 0;
+        m_nodeStats->compactBlockReceivedBytes = 0;
+        m_nodeStats->compactBlocksReconstructed = 0;
+        m_nodeStats->compactBlockRoundTrips = 0;
+        m_nodeStats->compactBlockFallbacks = 0;
+        m_nodeStats->chunkSentBytes = 0;
+        m_nodeStats->chunkReceivedBytes = 0;
+        m_nodeStats->chunkTimeouts = 0;
+        m_nodeStats->meanChunkSources = 0;
+        m_nodeStats->codedChunkSentBytes = 0;
+        m_nodeStats->codedChunkReceivedBytes = 0;
+        m_nodeStats->codedChunkDuplicates = 0;
+        m_nodeStats->codedBlockFallbacks = 0;
+        m_nodeStats->grapheneSentBytes = 0;
+        m_nodeStats->grapheneReceivedBytes = 0;
+        m_nodeStats->grapheneBlocksDecoded = 0;
+        m_nodeStats->grapheneDecodeFailures = 0;
+        m_nodeStats->grapheneBytesSaved = 0;
+        m_nodeStats->transactionSentBytes = 0;
+        m_nodeStats->reconciliationSentBytes = 0;
+        m_nodeStats->reconciliationRounds = 0;
+        m_nodeStats->reconciliationFailures = 0;
+        m_nodeStats->reconciledTransactions = 0;
+        m_nodeStats->announcementMessages = 0;
+        m_nodeStats->announcementItems = 0;
+        m_nodeStats->meanAnnouncementBatch = 0;
+        m_nodeStats->p90AnnouncementBatch = 0;
+        m_nodeStats->meanTrickleInterval = 0;
+        m_nodeStats->p90TrickleInterval = 0;
+        m_nodeStats->seenCacheHits = 0;
+        m_nodeStats->seenCacheEvictions = 0;
+        m_nodeStats->transactionsCreated = 0;
+        m_nodeStats->transactionsReceived = 0;
+        m_nodeStats->gossipTtlExpired = 0;
+        m_nodeStats->gossipPullSentBytes = 0;
+        m_nodeStats->gossipPulledTransactions = 0;
+        m_nodeStats->mempoolSize = 0;
+        m_nodeStats->mempoolMaxSize = 0;
+        m_nodeStats->mempoolEvictions = 0;
+        m_nodeStats->mempoolRejections = 0;
+        m_nodeStats->meanBlockFill = 0;
+        m_nodeStats->meanTransactionSize = 0;
+
+        /*
+         * Erlay : the transactions are flooded to a few random peers only, the other peers get them
+         * through the reconciliations. Every node starts the reconciliations with its peers in turn,
+         * so a link is reconciled from both of its ends every 2 m_reconciliationInterval.
+         */
+        if(m_reconciliationInterval > 0 && !m_peersAddresses.empty())
+        {
+            double period = 2 * m_reconciliationInterval / m_peersAddresses.size();
+
+            m_floodPeers = m_peersAddresses;
+            std::random_shuffle(m_floodPeers.begin(), m_floodPeers.end());
+            if(m_floodPeers.size() > m_transactionRelayFanout)
+                m_floodPeers.resize(m_transactionRelayFanout);
+
+            m_nextReconciliation = Simulator::Schedule(Seconds(period * (rand() % 1000) / 1000.0), &BlockchainNode::ReconcileTransactions, this);
+        }
 
         if(m_committerType == COMMITTER)
         {
@@ -285,6 +609,12 @@ namespace ns3 {
         }
 
         Simulator::Cancel(m_nextTransaction);
+        Simulator::Cancel(m_nextReconciliation);
+
+        for(auto it = m_trickleEvents.begin(); it != m_trickleEvents.end(); it++)
+        {
+            Simulator::Cancel(it->second);
+        }
 
         NS_LOG_WARN("\n\nBLOCKCHAIN NODE " <<GetNode()->GetId() << ":");
         //NS_LOG_WARN("Current Top Block is \n"<<*(m_blockchain.GetCurrentTopBlock()));
@@ -297,16 +627,118 @@ namespace ns3 {
         NS_LOG_WARN("Mean Block Size = " << m_meanBlockSize << "Bytes");
         NS_LOG_WARN("Total Block = " << m_blockchain.GetTotalBlocks());
         NS_LOG_WARN("Received But Not Validataed size : " << m_receivedNotValidated.size());
-        NS_LOG_WARN("m_sendBlockTime size = " <<m_receiveBlockTimes.size());
+        NS_LOG_WARN("Upload queue : mean depth = " << m_uploadScheduler.GetMeanQueueDepth()
+                    << ", max depth = " << m_uploadScheduler.GetMaxQueueDepth()
+                    << ", utilization = " << m_uploadScheduler.GetUtilization());
+        NS_LOG_WARN("Download link : mean active transfers = " << m_downloadLink.GetMeanActiveTransfers()
+                    << ", max active transfers = " << m_downloadLink.GetMaxActiveTransfers()
+                    << ", utilization = " << m_downloadLink.GetUtilization());
+        NS_LOG_WARN("CPU : mean queue delay = " << m_cpuModel.GetMeanQueueDelay()
+                    << "s, max queue length = " << m_cpuModel.GetMaxQueueLength()
+                    << ", utilization = " << m_cpuModel.GetUtilization());
+        NS_LOG_WARN("Inv timers : armed = " << m_timerWheel.GetArmedTimers()
+                    << ", fired = " << m_timerWheel.GetFiredTimers()
+                    << ", cancelled = " << m_timerWheel.GetCancelledTimers());
+        NS_LOG_WARN("Block timeouts = " << m_nodeStats->blockTimeouts << ", refetches = " << m_nodeStats->blockRefetches
+                    << ", early reissues = " << m_nodeStats->earlyReissues);
+        NS_LOG_WARN("Block downloads : max in flight = " << m_downloadScheduler.GetMaxInFlight()
+                    << ", max parallel peers = " << m_downloadScheduler.GetMaxBusyPeers());
+        NS_LOG_WARN("Announcements (" << getProtocolType(m_protocolType) << ") : sent = " << m_nodeStats->announcementSentBytes
+                    << "Bytes, received = " << m_nodeStats->announcementReceivedBytes << "Bytes, mean announcement to block time = "
+                    << m_meanAnnounceToBlockTime << "s");
+        NS_LOG_WARN("Compact blocks (" << getCompactBlockMode(m_compactBlockMode) << ") : sent = " << m_nodeStats->compactBlockSentBytes
+                    << "Bytes, received = " << m_nodeStats->compactBlockReceivedBytes << "Bytes, rebuilt without round trip = "
+                    << m_nodeStats->compactBlocksReconstructed << ", with GET_BLOCK_TXN = " << m_nodeStats->compactBlockRoundTrips
+                    << ", full block fallbacks = " << m_nodeStats->compactBlockFallbacks);
+        NS_LOG_WARN("Chunks : sent = " << m_nodeStats->chunkSentBytes << "Bytes, received = " << m_nodeStats->chunkReceivedBytes
+                    << "Bytes, timeouts = " << m_nodeStats->chunkTimeouts << ", mean sources per block = " << m_meanChunkSources);
+        NS_LOG_WARN("Coded chunks : sent = " << m_nodeStats->codedChunkSentBytes << "Bytes, received = " << m_nodeStats->codedChunkReceivedBytes
+                    << "Bytes, duplicates = " << m_nodeStats->codedChunkDuplicates << ", GET_DATA fallbacks = " << m_nodeStats->codedBlockFallbacks);
+        NS_LOG_WARN("Graphene blocks : sent = " << m_nodeStats->grapheneSentBytes << "Bytes, received = " << m_nodeStats->grapheneReceivedBytes
+                    << "Bytes, decoded = " << m_nodeStats->grapheneBlocksDecoded << ", decode failures = " << m_nodeStats->grapheneDecodeFailures
+                    << ", saved = " << m_nodeStats->grapheneBytesSaved << "Bytes");
+        NS_LOG_WARN("Transaction relay : transactions sent = " << m_nodeStats->transactionSentBytes << "Bytes, reconciliations sent = "
+                    << m_nodeStats->reconciliationSentBytes << "Bytes, reconciliations = " << m_nodeStats->reconciliationRounds
+                    << ", failed = " << m_nodeStats->reconciliationFailures << ", transactions sent after a reconciliation = "
+                    << m_nodeStats->reconciledTransactions);
+        NS_LOG_WARN("Trickling : flushes = " << m_trickleQueue.GetFlushes() << ", messages = " << m_trickleQueue.GetMessages()
+                    << ", announcements = " << m_trickleQueue.GetItems() << ", mean batch = " << m_trickleQueue.GetMeanBatchSize()
+                    << ", p90 batch = " << m_trickleQueue.GetBatchSizePercentile(0.9) << ", mean interval = " << m_trickleQueue.GetMeanFlushInterval()
+                    << "s, p90 interval = " << m_trickleQueue.GetIntervalPercentile(0.9) << "s");
+        NS_LOG_WARN("Trickling batch sizes (size:flushes) : " << m_trickleQueue.GetBatchSizeHistogram());
+        NS_LOG_WARN("Seen cache : " << m_seenMessages.GetCapacity() << " entries, duplicates dropped = " << m_seenMessages.GetHits()
+                    << ", evictions = " << m_seenMessages.GetEvictions() << ", lookups answered by the filter = " << m_seenMessages.GetFilterRejects());
+        NS_LOG_WARN("Gossip (" << getGossipMode(m_gossipMode) << ", " << getGossipFanout(m_gossipFanout) << ") : transactions created = "
+                    << m_nodeStats->transactionsCreated << ", received = " << m_nodeStats->transactionsReceived << ", TTL expired = "
+                    << m_nodeStats->gossipTtlExpired << ", pull messages sent = " << m_nodeStats->gossipPullSentBytes
+                    << " Bytes, transactions pulled from us = " << m_nodeStats->gossipPulledTransactions);
+
+        if(m_isMiner)
+        {
+            NS_LOG_WARN("Mempool : " << m_mempool.GetSize() << " transactions (" << m_mempool.GetBytes() << " Bytes) left, max = "
+                        << m_mempool.GetMaxSize() << ", evictions = " << m_mempool.GetEvictions() << ", rejections = " << m_mempool.GetRejections());
+            NS_LOG_WARN("Mempool backlog (time:transactions) : " << m_mempool.GetBacklogTrace());
+        }
+
+        NS_LOG_WARN("Forks : blocks in forks = " << m_blockchain.GetBlocksInForks() << " (stale rate = "
+                    << (m_blockchain.GetTotalBlocks() > 1 ? 100.0*m_blockchain.GetBlocksInForks()/(m_blockchain.GetTotalBlocks() - 1) : 0)
+                    << "%), longest fork = " << m_blockchain.GetLongestForkSize() << ", forked heights = " << m_blockchain.GetForkedHeights()
+                    << ", reorganizations (" << getForkChoiceRule(m_forkChoiceRule) << ") = " << m_blockchain.GetReorgs()
+                    << ", deepest = " << m_blockchain.GetMaxReorgDepth() << ", uncles in the main chain = " << m_blockchain.GetIncludedUncles());
+
+        /*
+         * The first half of the main chain is left out of the steady interval, the difficulty converges during it
+         */
+        int tipHeight = m_blockchain.GetCurrentTopBlock()->GetBlockHeight();
+
+        NS_LOG_WARN("Difficulty : tip = " << m_blockchain.GetCurrentTopBlock()->GetDifficulty() << ", main chain interval = "
+                    << m_blockchain.GetMainChainInterval(1) << "s, steady interval = " << m_blockchain.GetMainChainInterval(std::max(1, tipHeight/2)) << "s");
+        NS_LOG_WARN("Difficulty trajectory (height:time:difficulty) : " << m_blockchain.GetDifficultyTrace(1));
 
         m_nodeStats->meanBlockReceiveTime = m_meanBlockReceiveTime;
         m_nodeStats->meanBlockPropagationTime = m_meanBlockPropagationTime;
         m_nodeStats->meanBlockSize = m_meanBlockSize;
         m_nodeStats->totalBlocks = m_blockchain.GetTotalBlocks();
+        m_nodeStats->longestFork = m_blockchain.GetLongestForkSize();
+        m_nodeStats->blocksInForks = m_blockchain.GetBlocksInForks();
+        m_nodeStats->reorgs = m_blockchain.GetReorgs();
+        m_nodeStats->maxReorgDepth = m_blockchain.GetMaxReorgDepth();
+        m_nodeStats->includedUncles = m_blockchain.GetIncludedUncles();
+        m_nodeStats->difficulty = m_blockchain.GetCurrentTopBlock()->GetDifficulty();
+        m_nodeStats->mainChainInterval = m_blockchain.GetMainChainInterval(1);
+        m_nodeStats->steadyChainInterval = m_blockchain.GetMainChainInterval(std::max(1, tipHeight/2));
         m_nodeStats->meanEndorsementTime = m_meanEndorsementTime;
         m_nodeStats->meanOrderingTime = m_meanOrderingTime;
         m_nodeStats->meanValidationTime = m_meanValidationTime;
         m_nodeStats->meanLatency = m_meanLatency;
+        m_nodeStats->uploadMeanQueueDepth = m_uploadScheduler.GetMeanQueueDepth();
+        m_nodeStats->uploadMaxQueueDepth = m_uploadScheduler.GetMaxQueueDepth();
+        m_nodeStats->uploadUtilization = m_uploadScheduler.GetUtilization();
+        m_nodeStats->downloadMeanActiveTransfers = m_downloadLink.GetMeanActiveTransfers();
+        m_nodeStats->downloadMaxActiveTransfers = m_downloadLink.GetMaxActiveTransfers();
+        m_nodeStats->downloadUtilization = m_downloadLink.GetUtilization();
+        m_nodeStats->cpuUtilization = m_cpuModel.GetUtilization();
+        m_nodeStats->cpuMeanQueueDelay = m_cpuModel.GetMeanQueueDelay();
+        m_nodeStats->cpuMaxQueueLength = m_cpuModel.GetMaxQueueLength();
+        m_nodeStats->invTimersArmed = m_timerWheel.GetArmedTimers();
+        m_nodeStats->invTimersFired = m_timerWheel.GetFiredTimers();
+        m_nodeStats->invTimersCancelled = m_timerWheel.GetCancelledTimers();
+        m_nodeStats->maxInFlightRequests = m_downloadScheduler.GetMaxInFlight();
+        m_nodeStats->maxParallelDownloadPeers = m_downloadScheduler.GetMaxBusyPeers();
+        m_nodeStats->meanAnnounceToBlockTime = m_meanAnnounceToBlockTime;
+        m_nodeStats->meanChunkSources = m_meanChunkSources;
+        m_nodeStats->announcementMessages = m_trickleQueue.GetMessages();
+        m_nodeStats->announcementItems = m_trickleQueue.GetItems();
+        m_nodeStats->meanAnnouncementBatch = m_trickleQueue.GetMeanBatchSize();
+        m_nodeStats->p90AnnouncementBatch = m_trickleQueue.GetBatchSizePercentile(0.9);
+        m_nodeStats->meanTrickleInterval = m_trickleQueue.GetMeanFlushInterval();
+        m_nodeStats->p90TrickleInterval = m_trickleQueue.GetIntervalPercentile(0.9);
+        m_nodeStats->seenCacheHits = m_seenMessages.GetHits();
+        m_nodeStats->seenCacheEvictions = m_seenMessages.GetEvictions();
+        m_nodeStats->mempoolSize = m_mempool.GetSize();
+        m_nodeStats->mempoolMaxSize = m_mempool.GetMaxSize();
+        m_nodeStats->mempoolEvictions = m_mempool.GetEvictions();
+        m_nodeStats->mempoolRejections = m_mempool.GetRejections();
         
     }
 
@@ -371,1806 +803,5032 @@ namespace ns3 {
                                 << " port " << InetSocketAddress::ConvertFrom(from).GetPort()
                                 << " with info = " << buffer.GetString());
 
-                    switch(d["message"].GetInt())
+                    int transactions = 0;
+                    int signatures = 0;
+                    enum Messages message = static_cast<enum Messages>(d["message"].GetInt());
+
+                    if(d.HasMember("transactions") && d["transactions"].IsArray())
                     {
-                        case INV:
-                        {
-                            NS_LOG_INFO("INV");
+                        transactions = d["transactions"].Size();
+                    }
 
-                            if(m_committerType != CLIENT)
-                            {
-                                unsigned int j;
-                                std::vector<std::string>            requestBlocks;
-                                std::vector<std::string>::iterator  block_it;
+                    /*
+                     * The consensus messages carry their signature and the ones of their certificates
+                     */
+                    if(d.HasMember("signatures"))
+                    {
+                        signatures = d["signatures"].GetInt();
+                        m_nodeStats->consensusSignaturesVerified += signatures;
+                    }
 
-                                m_nodeStats->invReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes; 
-                                
+                    /*
+                     * Messages are handled one at a time by the node's CPU, so a message has to wait
+                     * for the ones received before it
+                     */
+                    double processingDelay = m_cpuModel.Reserve(m_cpuModel.GetMessageCost(message, parsedPacket.size(), transactions)
+                                                                + m_cpuModel.GetSignatureVerificationCost(signatures));
 
-                                for(j = 0; j < d["inv"].Size() ; j++)
-                                {
-                                    std::string invDelimiter = "/";
-                                    std::string parsedInv = d["inv"][j].GetString();
-                                    size_t invPos = parsedInv.find(invDelimiter);
-                                    EventId timeout;
-
-                                    int height = atoi(parsedInv.substr(0, invPos).c_str());
-                                    int minerId = atoi(parsedInv.substr(invPos+1, parsedInv.size()).c_str());
-
-                                    if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId) || ReceivedButNotValidated(parsedInv))
-                                    {
-                                        /*std::cout<<"INV : Blockchain node " << GetNode()->GetId()
-                                                    << " has already received the block with height = "
-                                                    << height << " and minerId = " << minerId << "\n";*/
-                                        NS_LOG_INFO("INV : Blockchain node " << GetNode()->GetId()
-                                                    << " has already received the block with height = "
-                                                    << height << " and minerId = " << minerId);
-                                    }
-                                    else
-                                    {
-                                        /*std::cout<<"INV : Blockchain node " << GetNode()->GetId()
-                                                    << " does not have the block with height = "
-                                                    << height << " and minerId = " << minerId << "\n";*/
-                                        NS_LOG_INFO("INV : Blockchain node " << GetNode()->GetId()
-                                                    << " does not have the block with height = "
-                                                    << height << " and minerId = " << minerId);
-
-                                        /*
-                                        * check if we have already requested the block
-                                        */
-                                        if(m_invTimeouts.find(parsedInv) == m_invTimeouts.end())
-                                        {
-                                            /*std::cout<<"INV: Blockchain node " << GetNode()->GetId()
-                                                        << " has not requested the block yet" << "\n";*/
-                                            NS_LOG_INFO("INV: Blockchain node " << GetNode()->GetId()
-                                                        << " has not requested the block yet");
-                                            requestBlocks.push_back(parsedInv);
-                                            timeout = Simulator::Schedule(m_invTimeoutMinutes, &BlockchainNode::InvTimeoutExpired, this, parsedInv);
-                                            m_invTimeouts[parsedInv] = timeout;
-                                        }
-                                        else
-                                        {
-                                            NS_LOG_INFO("INV : Blockchain node " << GetNode()->GetId()
-                                                        << " has already requested the block");
-                                        }
-
-                                        m_queueInv[parsedInv].push_back(from);
-                                    }
-                                }
+                    if(processingDelay == 0)
+                    {
+                        HandleMessage(d, from);
+                    }
+                    else
+                    {
+                        Simulator::Schedule(Seconds(processingDelay), &BlockchainNode::ProcessMessage, this, parsedPacket, from);
+                    }
 
-                                
-                                if(!requestBlocks.empty())
-                                {
-                                    rapidjson::Value value;
-                                    rapidjson::Value array(rapidjson::kArrayType);
-                                    d.RemoveMember("inv");
+                    totalReceivedData.erase(0, pos + delimiter.length());
 
-                                    for(block_it = requestBlocks.begin(); block_it < requestBlocks.end(); block_it++)
-                                    {
-                                        value.SetString(block_it->c_str(), block_it->size(), d.GetAllocator());
-                                        array.PushBack(value, d.GetAllocator());
-                                    }
+                }
 
-                                    d.AddMember("blocks", array, d.GetAllocator());
+                m_bufferedData[from] = totalReceivedData;
+                delete[] packetInfo;
 
-                                    SendMessage(INV, GET_HEADERS, d, from );
-                                    SendMessage(INV, GET_DATA, d, from );
-                                }
-                            }
-                            
-                            break;
-                        }
-                        case REQUEST_TRANS:
-                        {
-                            NS_LOG_INFO("REQUEST_TRANS");
-                            //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received request_transaction\n";
-                            
-                            if(m_committerType != CLIENT)
-                            {
-                                unsigned int j;
-                                std::vector<Transaction>            requestTransactions;
-                                std::vector<Transaction>::iterator  trans_it;
+            }
+            else if(InetSocketAddress::IsMatchingType(from))
+            {
+                NS_LOG_INFO("At time " << Simulator::Now().GetSeconds()
+                            << " s blockchain node " << GetNode()->GetId() << " received"
+                            << packet->GetSize() << " bytes from"
+                            << Inet6SocketAddress::ConvertFrom(from).GetIpv6()
+                            << " port" << Inet6SocketAddress::ConvertFrom(from).GetPort());
+            }
+            m_rxTrace(packet, from);
+        }
+        
+    }
 
-                                m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
+    void
+    BlockchainNode::ProcessMessage(std::string packet, Address from)
+    {
+        NS_LOG_FUNCTION(this);
 
-                                for(j = 0; j < d["transactions"].Size(); j++)
-                                {
-                                    int nodeId = d["transactions"][j]["nodeId"].GetInt();
-                                    int transId = d["transactions"][j]["transId"].GetInt();
-                                    double timestamp = d["transactions"][j]["timestamp"].GetDouble();
-                                    bool transValidation = d["transactions"][j]["validation"].GetBool();
-                                    int transExecution = d["transactions"][j]["execution"].GetInt();
-                                
-                                    if(HasTransaction(nodeId, transId))
-                                    {
-                                        NS_LOG_INFO("REQUEST_TRANS: Blockchain node " << GetNode()->GetId()
-                                                    << " has the transaction nodeID: " << nodeId
-                                                    << " and transId = " << transId);
-                                        //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " alread received request transaction\n";
-                                    }
-                                    else
-                                    {
-                                        Transaction newTrans(nodeId, transId, timestamp);
-                                        m_transaction.push_back(newTrans);
-                                        //m_notValidatedTransaction.push_back(newTrans);
-
-                                        if(m_committerType == ENDORSER)
-                                        {
-                                            newTrans.SetExecution(GetNode()->GetId());
-                                            m_totalEndorsement++;
-                                            m_meanEndorsementTime = (m_meanEndorsementTime*static_cast<double>(m_totalEndorsement-1) + (Simulator::Now().GetSeconds() - timestamp))/static_cast<double>(m_totalEndorsement);
-                                            ExecuteTransaction(newTrans, InetSocketAddress::ConvertFrom(from).GetIpv4());
-                                            //std::cout<<"Type: ENDOESER " <<" Node Id: "<< GetNode()->GetId() << " excute transaction\n";
-                                        }
-                                        else
-                                        {
-                                            AdvertiseNewTransaction(newTrans, REQUEST_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4());
-                                            //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() <<" forwarding request transaction\n";
-                                        }
-                                    }
-                                    
-                                }
-                            }
-                            
+        rapidjson::Document d;
+        d.Parse(packet.c_str());
 
-                            break;
-                        }
-                        case REPLY_TRANS:
-                        {
-                            NS_LOG_INFO("REPLY_TRANS");
+        HandleMessage(d, from);
+    }
+
+    void
+    BlockchainNode::HandleMessage(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
 
-                            //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received reply_transaction\n";
+        switch(d["message"].GetInt())
+        {
+            case INV:
+            {
+                NS_LOG_INFO("INV");
 
-                            unsigned int j;
-                            std::vector<Transaction>::iterator  trans_it;
+                if(m_committerType != CLIENT)
+                {
+                    unsigned int j;
+                    std::vector<std::string>            requestBlocks;
 
-                            m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
+                    m_nodeStats->invReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes; 
+                    m_nodeStats->announcementReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes;
+                    
 
-                            for(j = 0; j < d["transactions"].Size(); j++)
-                            {
-                                int nodeId = d["transactions"][j]["nodeId"].GetInt();
-                                int transId = d["transactions"][j]["transId"].GetInt();
-                                double timestamp = d["transactions"][j]["timestamp"].GetDouble();
-                                bool transValidation = d["transactions"][j]["validation"].GetBool();
-                                int transExecution = d["transactions"][j]["execution"].GetInt();
+                    for(j = 0; j < d["inv"].Size() ; j++)
+                    {
+                        std::string invDelimiter = "/";
+                        std::string parsedInv = d["inv"][j].GetString();
+                        size_t invPos = parsedInv.find(invDelimiter);
 
-                            
-                                if(HasReplyTransaction(nodeId, transId, transExecution))
-                                {
-                                    NS_LOG_INFO("REPLY_TRANS: Blockchain node " << GetNode()->GetId()
-                                                << " has the reply_transaction nodeID: " << nodeId
-                                                << " and transId = " << transId);
-                                }
-                                else if(!HasReplyTransaction(nodeId, transId, transExecution) && GetNode()->GetId() != nodeId)
-                                {
-                                    //if node is Committer...
-
-                                    Transaction newTrans(nodeId, transId, timestamp);
-                                    newTrans.SetExecution(transExecution);
-
-                                    if(HasTransaction(nodeId, transId))
-                                    {
-                                        std::vector<Transaction>::iterator it_tran;
-
-                                        for(it_tran = m_transaction.begin(); it_tran < m_transaction.end(); it_tran++)
-                                        {
-                                            if(it_tran->GetTransNodeId() == nodeId && it_tran->GetTransId()==transId)
-                                            {
-                                                it_tran->SetExecution(transExecution);
-                                                break;
-                                            }
-                                        }
-                                        
-                                    }
-                                    else
-                                    {
-                                        m_transaction.push_back(newTrans);
-                                    }
-                                    
-                                    m_replyTransaction.push_back(newTrans);
-                                    AdvertiseNewTransaction(newTrans, REPLY_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4());
+                        int height = atoi(parsedInv.substr(0, invPos).c_str());
+                        int minerId = atoi(parsedInv.substr(invPos+1, parsedInv.size()).c_str());
 
-                                }
-                                else if(!HasReplyTransaction(nodeId, transId, transExecution) && GetNode()->GetId() == nodeId)
-                                {
-                                    
-                                    //if node is Client...
-
-                                    std::vector<Transaction>::iterator it_tran;
-
-                                    for(it_tran = m_transaction.begin(); it_tran < m_transaction.end(); it_tran++)
-                                    {
-                                        if(it_tran->GetTransNodeId() == nodeId && it_tran->GetTransId()==transId)
-                                        {
-                                            it_tran->SetExecution(transExecution);
-                                            break;
-                                        }
-                                    }
-                                    
-                                    Transaction newTrans(nodeId, transId, timestamp);
-                                    newTrans.SetExecution(transExecution);
-
-                                    for(it_tran = m_waitingEndorsers.begin(); it_tran < m_waitingEndorsers.end() ; it_tran++)
-                                    {
-                                        if(it_tran->GetTransNodeId() == nodeId && it_tran->GetTransId() == transId && it_tran->GetExecution() == transExecution )
-                                        {
-                                            NS_LOG_INFO("REPLY_TRANS: Blockchain node " << GetNode()->GetId()
-                                                        << " already received it to endorsers");
-                                            break;
-                                        }
-                                    }
-
-                                    if(it_tran == m_waitingEndorsers.end())
-                                    {
-                                        m_waitingEndorsers.push_back(newTrans);
-                                    }
-
-
-                                    if(m_waitingEndorsers.size() == m_numberofEndorsers)
-                                    {
-                                        AdvertiseNewTransaction(newTrans, MSG_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4());
-                                        m_waitingEndorsers.clear();
-                                    }
-                                }
-                                else
-                                {
-                                    //if node is committer which didn't receive oiginal transaction
-                                    
-                                    Transaction newTrans(nodeId, transId, timestamp);
-                                    newTrans.SetExecution(transExecution);
-                                    m_transaction.push_back(newTrans);
-                                    //m_notValidatedTransaction.push_back(newTrans);
-                                    m_replyTransaction.push_back(newTrans);
-                                    AdvertiseNewTransaction(newTrans, REPLY_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4());
-                                }
-                                
-                            }
-                            break;
+                        if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId) || ReceivedButNotValidated(parsedInv))
+                        {
+                            /*std::cout<<"INV : Blockchain node " << GetNode()->GetId()
+                                        << " has already received the block with height = "
+                                        << height << " and minerId = " << minerId << "\n";*/
+                            NS_LOG_INFO("INV : Blockchain node " << GetNode()->GetId()
+                                        << " has already received the block with height = "
+                                        << height << " and minerId = " << minerId);
                         }
-                        case MSG_TRANS:
+                        else
                         {
-                            NS_LOG_INFO("MSG_TRANS");
-
-                            //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received MSG_transaction\n";
-
-                            if(m_committerType != CLIENT)
+                            /*std::cout<<"INV : Blockchain node " << GetNode()->GetId()
+                                        << " does not have the block with height = "
+                                        << height << " and minerId = " << minerId << "\n";*/
+                            NS_LOG_INFO("INV : Blockchain node " << GetNode()->GetId()
+                                        << " does not have the block with height = "
+                                        << height << " and minerId = " << minerId);
+
+                            /*
+                            * check if we have already requested the block
+                            */
+                            if(m_invTimeouts.find(parsedInv) == m_invTimeouts.end() && !m_downloadScheduler.IsPending(parsedInv)
+                                && !IsCollectingCodedChunks(parsedInv))
                             {
-                                unsigned int j;
-                                std::vector<Transaction>::iterator  trans_it;
+                                /*std::cout<<"INV: Blockchain node " << GetNode()->GetId()
+                                            << " has not requested the block yet" << "\n";*/
+                                NS_LOG_INFO("INV: Blockchain node " << GetNode()->GetId()
+                                            << " has not requested the block yet");
+                                requestBlocks.push_back(parsedInv);
+                                RecordAnnouncement(parsedInv);
+                            }
+                            else
+                            {
+                                NS_LOG_INFO("INV : Blockchain node " << GetNode()->GetId()
+                                            << " has already requested the block");
+                            }
 
-                                m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
+                            m_queueInv[parsedInv].push_back(from);
+                        }
+                    }
 
-                                for(j = 0; j < d["transactions"].Size(); j++)
-                                {
-                                    int nodeId = d["transactions"][j]["nodeId"].GetInt();
-                                    int transId = d["transactions"][j]["transId"].GetInt();
-                                    double timestamp = d["transactions"][j]["timestamp"].GetDouble();
-                                    bool transValidation = d["transactions"][j]["validation"].GetBool();
-                                    int transExecution = d["transactions"][j]["execution"].GetInt();
-
-                                    if(HasMessageTransaction(nodeId, transId))
-                                    {
-                                        NS_LOG_INFO("MSG_TRANS: Blockchain node " << GetNode()->GetId()
-                                                    << " has transaction which is already executed and not validated nodeID: " << nodeId
-                                                    << " and transId = " << transId);
-                                    }
-                                    else
-                                    {
-                                        
-                                        Transaction newTrans(nodeId, transId, timestamp);
-                                        newTrans.SetExecution(transExecution);
-                                        m_msgTransaction.push_back(newTrans);
-                                        
-                                        if(m_isMiner != true)
-                                        {
-                                            AdvertiseNewTransaction(newTrans, MSG_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4());
-                                        }
-                                        else
-                                        {
-                                            m_notValidatedTransaction.push_back(newTrans);
-                                        }
-                                    }
+                    
+                    /*
+                     * The blocks are spread over all the peers that announced them
+                     */
+                    if(!requestBlocks.empty())
+                    {
+                        RequestBlocks(requestBlocks);
+                    }
+                }
+                
+                break;
+            }
+            case REQUEST_TRANS:
+            {
+                NS_LOG_INFO("REQUEST_TRANS");
+                //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received request_transaction\n";
+                
+                if(m_committerType != CLIENT)
+                {
+                    unsigned int j;
+                    std::vector<Transaction>            requestTransactions;
+                    std::vector<Transaction>::iterator  trans_it;
 
+                    m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + GetTransactionPayloadBytes(d["transactions"]);
 
-                                }
-                            }
-                            
-                            break;
+                    for(j = 0; j < d["transactions"].Size(); j++)
+                    {
+                        int nodeId = d["transactions"][j]["nodeId"].GetInt();
+                        int transId = d["transactions"][j]["transId"].GetInt();
+                        double timestamp = d["transactions"][j]["timestamp"].GetDouble();
+                        bool transValidation = d["transactions"][j]["validation"].GetBool();
+                        int transExecution = d["transactions"][j]["execution"].GetInt();
+                        double transFee = d["transactions"][j]["fee"].GetDouble();
+                        int transSize = d["transactions"][j]["size"].GetInt();
+                    
+                        if(!m_seenMessages.Insert(BlockchainSeenCache::MakeKey(REQUEST_TRANS, nodeId, transId, 0)))
+                        {
+                            NS_LOG_INFO("REQUEST_TRANS: Blockchain node " << GetNode()->GetId()
+                                        << " has the transaction nodeID: " << nodeId
+                                        << " and transId = " << transId);
+                            //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " alread received request transaction\n";
                         }
-                        case RESULT_TRANS:
+                        else
                         {
-                            NS_LOG_INFO("RESULT_TRANS");
-                            //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received result_transaction\n";
-                            unsigned int j;
-                            std::vector<Transaction>::iterator  trans_it;
-
-                            m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
-
-                            for(j = 0; j < d["transactions"].Size(); j++)
+                            Transaction newTrans(nodeId, transId, timestamp);
+                            newTrans.SetFee(transFee);
+                            newTrans.SetTransSizeByte(transSize);
+                            m_transaction.push_back(newTrans);
+                            m_nodeStats->transactionsReceived++;
+                            //m_notValidatedTransaction.push_back(newTrans);
+
+                            if(m_committerType == ENDORSER)
                             {
-                                int nodeId = d["transactions"][j]["nodeId"].GetInt();
-                                int transId = d["transactions"][j]["transId"].GetInt();
-                                double timestamp = d["transactions"][j]["timestamp"].GetDouble();
-                                bool transValidation = d["transactions"][j]["validation"].GetBool();
-                                int transExecution = d["transactions"][j]["execution"].GetInt();
-
-                                if(HasResultTransaction(nodeId, transId))
-                                {
-                                    NS_LOG_INFO("RESULT_TRANS: Blockchain node " << GetNode()->GetId()
-                                                << " has result_transaction nodeId: " << nodeId
-                                                << " and transId = " << transId);
-                                }
-                                else
-                                {
-
-                                    Transaction newTrans(nodeId, transId, timestamp);
-                                    m_resultTransaction.push_back(newTrans);
-
-                                    if(GetNode()->GetId() != nodeId)
-                                    {
-                                        AdvertiseNewTransaction(newTrans, RESULT_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4());
-                                    }
-                                    else
-                                    {
-                                        m_totalCreatedTransaction++;
-                                        m_meanLatency = (m_meanLatency*static_cast<double>(m_totalCreatedTransaction-1) + (Simulator::Now().GetSeconds() - timestamp))/static_cast<double>(m_totalCreatedTransaction);
-                                        //Measure received time
-                                        //std::cout<<"latency : "<<Simulator::Now().GetSeconds() - timestamp <<" , CLIENT node "<<GetNode()->GetId()<< " confirmed that transactions had succeeded\n";
-                                    }
-                                }
+                                newTrans.SetExecution(GetNode()->GetId());
+                                m_totalEndorsement++;
+                                m_meanEndorsementTime = (m_meanEndorsementTime*static_cast<double>(m_totalEndorsement-1) + (Simulator::Now().GetSeconds() - timestamp))/static_cast<double>(m_totalEndorsement);
+                                ExecuteTransaction(newTrans, InetSocketAddress::ConvertFrom(from).GetIpv4());
+                                //std::cout<<"Type: ENDOESER " <<" Node Id: "<< GetNode()->GetId() << " excute transaction\n";
                             }
-                            break;
-                        }
-                        case GET_HEADERS:
-                        {
-                            
-                            NS_LOG_INFO("GET_HEADERS");
-
-                            if(m_committerType != CLIENT)
+                            else
                             {
-                                unsigned int j;
-                                std::vector<Block>              requestHeaders;
-                                std::vector<Block>::iterator    block_it;
-
-                                m_nodeStats->getHeadersReceivedBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
-
-                                for(j =0 ; j < d["blocks"].Size(); j++)
-                                {
-                                    std::string invDelimiter = "/";
-                                    std::string blockHash = d["blocks"][j].GetString();
-                                    size_t      invPos = blockHash.find(invDelimiter);
-
-                                    int height = atoi(blockHash.substr(0, invPos).c_str());
-                                    int minerId = atoi(blockHash.substr(invPos+1, blockHash.size()).c_str());
-
-                                    if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId))
-                                    {
-                                        /*std::cout<<"GET_HEADERS: Blockchain node " << GetNode()->GetId()
-                                                    << " has the block with height = " << height
-                                                    << " and minerId = " << minerId << "\n";*/
-                                        
-                                        NS_LOG_INFO("GET_HEADERS: Blockchain node " << GetNode()->GetId()
-                                                    << " has the block with height = " << height
-                                                    << " and minerId = " << minerId);
-                                        Block newBlock(m_blockchain.ReturnBlock(height, minerId));
-                                        requestHeaders.push_back(newBlock);
-
-                                    } 
-                                    else if (ReceivedButNotValidated(blockHash))
-                                    {
-                                        /*std::cout<<"GET_HEADERS: Blockchain node " << GetNode()->GetId()
-                                                    << " has received but not yet validated the block with height = "
-                                                    << height << " and minerId = " << minerId << "\n";*/
-                                        
-                                        NS_LOG_INFO("GET_HEADERS: Blockchain node " << GetNode()->GetId()
-                                                    << " has received but not yet validated the block with height = "
-                                                    << height << " and minerId = " << minerId);
-                                        requestHeaders.push_back(m_receivedNotValidated[blockHash]);
-                                    }
-                                    else
-                                    {
-                                        NS_LOG_INFO("GET_HEADERS: Blockchain node " << GetNode()->GetId()
-                                                    << " does not have the full block with height = "
-                                                    << height << " and minerId = " << minerId);
-                                    }
-                                }
-
-                                if(!requestHeaders.empty())
-                                {
-                                    rapidjson::Value value;
-                                    rapidjson::Value array(rapidjson::kArrayType);
+                                AdvertiseNewTransaction(newTrans, REQUEST_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4(), GetRelayTtl(d["transactions"][j]));
+                                //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() <<" forwarding request transaction\n";
+                            }
+                        }
+                        
+                    }
+                }
+                
 
-                                    d.RemoveMember("blocks");
+                break;
+            }
+            case REPLY_TRANS:
+            {
+                NS_LOG_INFO("REPLY_TRANS");
 
-                                    for(block_it = requestHeaders.begin() ; block_it < requestHeaders.end(); block_it++)
-                                    {
-                                        rapidjson::Value blockInfo(rapidjson::kObjectType);
-                                        //NS_LOG_INFO("In requestHeaders " << *block_it);
+                //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received reply_transaction\n";
 
-                                        value = block_it->GetBlockHeight();
-                                        blockInfo.AddMember("height", value, d.GetAllocator());
-                                        
-                                        value = block_it->GetMinerId();
-                                        blockInfo.AddMember("minerId", value, d.GetAllocator());
+                unsigned int j;
+                std::vector<Transaction>::iterator  trans_it;
 
-                                        value = block_it->GetNonce();
-                                        blockInfo.AddMember("nonce", value, d.GetAllocator());
+                m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + GetTransactionPayloadBytes(d["transactions"]);
 
-                                        value = block_it->GetParentBlockMinerId();
-                                        blockInfo.AddMember("parentBlockMinerId", value, d.GetAllocator());
+                for(j = 0; j < d["transactions"].Size(); j++)
+                {
+                    int nodeId = d["transactions"][j]["nodeId"].GetInt();
+                    int transId = d["transactions"][j]["transId"].GetInt();
+                    double timestamp = d["transactions"][j]["timestamp"].GetDouble();
+                    bool transValidation = d["transactions"][j]["validation"].GetBool();
+                    int transExecution = d["transactions"][j]["execution"].GetInt();
+                    double transFee = d["transactions"][j]["fee"].GetDouble();
+                    int transSize = d["transactions"][j]["size"].GetInt();
 
-                                        value = block_it->GetBlockSizeBytes();
-                                        blockInfo.AddMember("size", value, d.GetAllocator());
+                
+                    if(HasReplyTransaction(nodeId, transId, transExecution))
+                    {
+                        NS_LOG_INFO("REPLY_TRANS: Blockchain node " << GetNode()->GetId()
+                                    << " has the reply_transaction nodeID: " << nodeId
+                                    << " and transId = " << transId);
+                    }
+                    else if(!HasReplyTransaction(nodeId, transId, transExecution) && GetNode()->GetId() != nodeId)
+                    {
+                        //if node is Committer...
 
-                                        value = block_it->GetTimeStamp();
-                                        blockInfo.AddMember("timeStamp", value, d.GetAllocator());
+                        Transaction newTrans(nodeId, transId, timestamp);
+                        newTrans.SetFee(transFee);
+                        newTrans.SetTransSizeByte(transSize);
+                        newTrans.SetExecution(transExecution);
 
-                                        value = block_it->GetTimeReceived();
-                                        blockInfo.AddMember("timeReceived", value, d.GetAllocator());
+                        if(HasTransaction(nodeId, transId))
+                        {
+                            std::vector<Transaction>::iterator it_tran;
 
-                                        array.PushBack(blockInfo, d.GetAllocator());
-                                    
-                                    }
+                            for(it_tran = m_transaction.begin(); it_tran < m_transaction.end(); it_tran++)
+                            {
+                                if(it_tran->GetTransNodeId() == nodeId && it_tran->GetTransId()==transId)
+                                {
+                                    it_tran->SetExecution(transExecution);
+                                    break;
+                                }
+                            }
+                            
+                        }
+                        else
+                        {
+                            m_transaction.push_back(newTrans);
+                            m_seenMessages.Insert(BlockchainSeenCache::MakeKey(REQUEST_TRANS, nodeId, transId, 0));
+                        }
+                        
+                        m_seenMessages.Insert(BlockchainSeenCache::MakeKey(REPLY_TRANS, nodeId, transId, transExecution));
+                        AdvertiseNewTransaction(newTrans, REPLY_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4(), GetRelayTtl(d["transactions"][j]));
 
-                                    d.AddMember("blocks", array, d.GetAllocator());
+                    }
+                    else if(!HasReplyTransaction(nodeId, transId, transExecution) && GetNode()->GetId() == nodeId)
+                    {
+                        
+                        //if node is Client...
 
-                                    SendMessage(GET_HEADERS, HEADERS, d, from);
+                        std::vector<Transaction>::iterator it_tran;
 
-                                }
+                        for(it_tran = m_transaction.begin(); it_tran < m_transaction.end(); it_tran++)
+                        {
+                            if(it_tran->GetTransNodeId() == nodeId && it_tran->GetTransId()==transId)
+                            {
+                                it_tran->SetExecution(transExecution);
+                                break;
                             }
-
-                            break;
                         }
-                        case HEADERS:
-                        {
-                            
-                            NS_LOG_INFO("HEADERS");
+                        
+                        Transaction newTrans(nodeId, transId, timestamp);
+                        newTrans.SetFee(transFee);
+                        newTrans.SetTransSizeByte(transSize);
+                        newTrans.SetExecution(transExecution);
 
-                            if(m_committerType != CLIENT)
+                        for(it_tran = m_waitingEndorsers.begin(); it_tran < m_waitingEndorsers.end() ; it_tran++)
+                        {
+                            if(it_tran->GetTransNodeId() == nodeId && it_tran->GetTransId() == transId && it_tran->GetExecution() == transExecution )
                             {
-                                std::vector<std::string>        requestHeaders;
-                                std::vector<std::string>        requestBlocks;
-                                std::vector<std::string>::iterator  block_it;
-                                unsigned int j;
+                                NS_LOG_INFO("REPLY_TRANS: Blockchain node " << GetNode()->GetId()
+                                            << " already received it to endorsers");
+                                break;
+                            }
+                        }
 
-                                m_nodeStats->headersReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                        if(it_tran == m_waitingEndorsers.end())
+                        {
+                            m_waitingEndorsers.push_back(newTrans);
+                        }
 
-                                for(j = 0; j <d["blocks"].Size(); j++)
-                                {
-                                    int parentHeight = d["blocks"][j]["height"].GetInt() - 1;
-                                    int parentMinerId = d["blocks"][j]["parentBlockMinerId"].GetInt();
-                                    int height = d["blocks"][j]["height"].GetInt();
-                                    int minerId = d["blocks"][j]["minerId"].GetInt();
-
-                                    EventId         timeout;
-                                    std::stringstream   stringStream;
-                                    std::string         blockHash;
-                                    std::string         parentBlockHash;
-
-                                    stringStream << height << "/" << minerId;
-                                    blockHash = stringStream.str();
-                                    Block newBlockHeaders(d["blocks"][j]["height"].GetInt(), d["blocks"][j]["minerId"].GetInt(), d["blocks"][j]["nonce"].GetInt()
-                                                        , d["blocks"][j]["parentBlockMinerId"].GetInt(), d["blocks"][j]["size"].GetInt()
-                                                        , d["blocks"][j]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
-
-                                    m_onlyHeadersReceived[blockHash] = Block(d["blocks"][j]["height"].GetInt(), d["blocks"][j]["minerId"].GetInt(), d["blocks"][j]["nonce"].GetInt()
-                                                                            , d["blocks"][j]["parentBlockMinerId"].GetInt(), d["blocks"][j]["size"].GetInt()
-                                                                            , d["blocks"][j]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
-
-                                    stringStream.clear();
-                                    stringStream.str("");
-
-                                    stringStream << parentHeight << "/" << parentMinerId;
-                                    parentBlockHash = stringStream.str();
-
-                                    if (!m_blockchain.HasBlock(parentHeight, parentMinerId) && !m_blockchain.IsOrphan(parentHeight, parentMinerId) && !ReceivedButNotValidated(parentBlockHash))
-                                    {
-                                        /*std::cout<<"The Block with height  = " << d["blocks"][j]["height"].GetInt()
-                                                    << " and minerID = " << d["blocks"][j]["minerId"].GetInt()
-                                                    << " is an orphan\n" << "\n";*/
-                                        
-                                        NS_LOG_INFO("The Block with height  = " << d["blocks"][j]["height"].GetInt()
-                                                    << " and minerID = " << d["blocks"][j]["minerId"].GetInt()
-                                                    << " is an orphan\n");
-                                        
-                                        if(m_invTimeouts.find(parentBlockHash) == m_invTimeouts.end())
-                                        {
-                                            NS_LOG_INFO("HEADERS : Blockchain node " << GetNode()->GetId()
-                                                        << " has not requested its parent block yet");
-                                            if(!OnlyHeadersReceived(parentBlockHash))
-                                            {
-                                                requestHeaders.push_back(parentBlockHash.c_str());
-                                            }
-                                            timeout = Simulator::Schedule(m_invTimeoutMinutes, &BlockchainNode::InvTimeoutExpired, this, parentBlockHash);
-                                            m_invTimeouts[parentBlockHash] = timeout;
-
-                                        }
-                                        else
-                                        {
-                                            NS_LOG_INFO("HEADERS: Blockchain node " << GetNode()->GetId()
-                                                        << "has already requested the block");
-                                        }
-
-                                        m_queueInv[parentBlockHash].push_back(from);
-
-                                    }
-                                    else
-                                    {
-                                        /*std::cout<<"The Block with height = " << d["blocks"][j]["height"].GetInt()
-                                                    << " and minerId = " << d["blocks"][j]["minerId"].GetInt()
-                                                    << " is NOT an orphan\n";*/
-                                        
-                                        NS_LOG_INFO("The Block with height = " << d["blocks"][j]["height"].GetInt()
-                                                    << " and minerId = " << d["blocks"][j]["minerId"].GetInt()
-                                                    << " is NOT an orphan\n");
-                                    }
-                                }
 
-                                if(!requestHeaders.empty())
-                                {
-                                    rapidjson::Value        value;
-                                    rapidjson::Value        array(rapidjson::kArrayType);
-                                    Time                    timeout;
+                        if(m_waitingEndorsers.size() == m_numberofEndorsers)
+                        {
+                            AdvertiseNewTransaction(newTrans, MSG_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4(), GetGossipTtl());
+                            m_waitingEndorsers.clear();
+                        }
+                    }
+                    else
+                    {
+                        //if node is committer which didn't receive oiginal transaction
+                        
+                        Transaction newTrans(nodeId, transId, timestamp);
+                        newTrans.SetFee(transFee);
+                        newTrans.SetTransSizeByte(transSize);
+                        newTrans.SetExecution(transExecution);
+                        m_transaction.push_back(newTrans);
+                        //m_notValidatedTransaction.push_back(newTrans);
+                        m_seenMessages.Insert(BlockchainSeenCache::MakeKey(REQUEST_TRANS, nodeId, transId, 0));
+                        m_seenMessages.Insert(BlockchainSeenCache::MakeKey(REPLY_TRANS, nodeId, transId, transExecution));
+                        AdvertiseNewTransaction(newTrans, REPLY_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4(), GetRelayTtl(d["transactions"][j]));
+                    }
+                    
+                }
+                break;
+            }
+            case MSG_TRANS:
+            {
+                NS_LOG_INFO("MSG_TRANS");
 
-                                    d.RemoveMember("blocks");
+                //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received MSG_transaction\n";
 
-                                    for(block_it = requestHeaders.begin(); block_it < requestHeaders.end(); block_it++)
-                                    {
-                                        value.SetString(block_it->c_str(), block_it->size(), d.GetAllocator());
-                                        array.PushBack(value, d.GetAllocator());
-                                    }
+                if(m_committerType != CLIENT)
+                {
+                    unsigned int j;
+                    std::vector<Transaction>::iterator  trans_it;
 
-                                    d.AddMember("blocks", array, d.GetAllocator());
+                    m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + GetTransactionPayloadBytes(d["transactions"]);
 
-                                    SendMessage(HEADERS, GET_HEADERS, d, from);
-                                    SendMessage(HEADERS, GET_DATA, d, from);
-                                }
+                    for(j = 0; j < d["transactions"].Size(); j++)
+                    {
+                        int nodeId = d["transactions"][j]["nodeId"].GetInt();
+                        int transId = d["transactions"][j]["transId"].GetInt();
+                        double timestamp = d["transactions"][j]["timestamp"].GetDouble();
+                        bool transValidation = d["transactions"][j]["validation"].GetBool();
+                        int transExecution = d["transactions"][j]["execution"].GetInt();
+                        double transFee = d["transactions"][j]["fee"].GetDouble();
+                        int transSize = d["transactions"][j]["size"].GetInt();
+
+                        if(HasMessageTransaction(nodeId, transId))
+                        {
+                            NS_LOG_INFO("MSG_TRANS: Blockchain node " << GetNode()->GetId()
+                                        << " has transaction which is already executed and not validated nodeID: " << nodeId
+                                        << " and transId = " << transId);
+                        }
+                        else
+                        {
+                            
+                            Transaction newTrans(nodeId, transId, timestamp);
+                            newTrans.SetFee(transFee);
+                            newTrans.SetTransSizeByte(transSize);
+                            newTrans.SetExecution(transExecution);
+                            m_seenMessages.Insert(BlockchainSeenCache::MakeKey(MSG_TRANS, nodeId, transId, 0));
+                            
+                            if(m_isMiner != true)
+                            {
+                                AdvertiseNewTransaction(newTrans, MSG_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4(), GetRelayTtl(d["transactions"][j]));
+                            }
+                            else
+                            {
+                                m_mempool.Add(newTrans, newTrans.GetTransSizeByte());
+                            }
+                        }
 
-                                if(!requestBlocks.empty())
-                                {
-                                    rapidjson::Value        value;
-                                    rapidjson::Value        array(rapidjson::kArrayType);
-                                    Time                    timeout;
 
-                                    d.RemoveMember("blocks");
+                    }
+                }
+                
+                break;
+            }
+            case RESULT_TRANS:
+            {
+                NS_LOG_INFO("RESULT_TRANS");
+                //std::cout<<"Type: " << m_protocolType <<" Node Id: "<< GetNode()->GetId() << " received result_transaction\n";
+                unsigned int j;
+                std::vector<Transaction>::iterator  trans_it;
 
-                                    for(block_it = requestBlocks.begin(); block_it < requestBlocks.end(); block_it++)
-                                    {
-                                        value.SetString(block_it->c_str(), block_it->size(), d.GetAllocator());
-                                        array.PushBack(value, d.GetAllocator());
-                                    }
+                m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
 
-                                    d.AddMember("blocks", array, d.GetAllocator());
+                for(j = 0; j < d["transactions"].Size(); j++)
+                {
+                    int nodeId = d["transactions"][j]["nodeId"].GetInt();
+                    int transId = d["transactions"][j]["transId"].GetInt();
+                    double timestamp = d["transactions"][j]["timestamp"].GetDouble();
+                    bool transValidation = d["transactions"][j]["validation"].GetBool();
+                    int transExecution = d["transactions"][j]["execution"].GetInt();
+                    double transFee = d["transactions"][j]["fee"].GetDouble();
+                    int transSize = d["transactions"][j]["size"].GetInt();
+
+                    if(HasResultTransaction(nodeId, transId))
+                    {
+                        NS_LOG_INFO("RESULT_TRANS: Blockchain node " << GetNode()->GetId()
+                                    << " has result_transaction nodeId: " << nodeId
+                                    << " and transId = " << transId);
+                    }
+                    else
+                    {
 
-                                    SendMessage(HEADERS, GET_DATA, d, from);
-                                }
-                            }
+                        Transaction newTrans(nodeId, transId, timestamp);
+                        newTrans.SetFee(transFee);
+                        newTrans.SetTransSizeByte(transSize);
+                        m_seenMessages.Insert(BlockchainSeenCache::MakeKey(RESULT_TRANS, nodeId, transId, 0));
 
-                            break;
+                        if(GetNode()->GetId() != nodeId)
+                        {
+                            AdvertiseNewTransaction(newTrans, RESULT_TRANS, InetSocketAddress::ConvertFrom(from).GetIpv4(), GetRelayTtl(d["transactions"][j]));
                         }
-                        case GET_DATA:
+                        else
                         {
-                            NS_LOG_INFO("GET_DATA");
-
-                            if(m_committerType != CLIENT)
-                            {
-                                unsigned int j;
-                                int totalBlockMessageSize = 0;
-                                std::vector<Block>                      requestBlocks;
-                                std::vector<Block>::iterator            block_it;
-                                std::vector<Transaction>::iterator      trans_it;
+                            m_totalCreatedTransaction++;
+                            m_meanLatency = (m_meanLatency*static_cast<double>(m_totalCreatedTransaction-1) + (Simulator::Now().GetSeconds() - timestamp))/static_cast<double>(m_totalCreatedTransaction);
+                            //Measure received time
+                            //std::cout<<"latency : "<<Simulator::Now().GetSeconds() - timestamp <<" , CLIENT node "<<GetNode()->GetId()<< " confirmed that transactions had succeeded\n";
+                        }
+                    }
+                }
+                break;
+            }
+            case GET_HEADERS:
+            {
+                
+                NS_LOG_INFO("GET_HEADERS");
 
-                                m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_inventorySizeBytes;
+                if(m_committerType != CLIENT)
+                {
+                    unsigned int j;
+                    std::vector<Block>              requestHeaders;
+                    std::vector<Block>::iterator    block_it;
 
-                                for(j=0; j < d["blocks"].Size(); j++)
-                                {
-                                    std::string     invDelimiter = "/";
-                                    std::string     parsedInv = d["blocks"][j].GetString();
-                                    size_t          invPos = parsedInv.find(invDelimiter);
-
-                                    int height = atoi(parsedInv.substr(0, invPos).c_str());
-                                    int minerId = atoi(parsedInv.substr(invPos+1, parsedInv.size()).c_str());
-
-                                    if(m_blockchain.HasBlock(height, minerId))
-                                    {
-                                        NS_LOG_INFO("GET_DATA : Blockchain node " << GetNode()->GetId()
-                                                    << " has the block with height = " << height
-                                                    << " and minerId = " << minerId);
-                                        Block newBlock(m_blockchain.ReturnBlock(height, minerId));
-                                        requestBlocks.push_back(newBlock);
-                                    }
-                                    else
-                                    {
-                                        NS_LOG_INFO("GET_DATA : Blockchain node " << GetNode()->GetId()
-                                                    << " does not have the block with height = " << height
-                                                    << " and minerId = " << minerId);
-                                    }
+                    m_nodeStats->getHeadersReceivedBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
 
-                                }
+                    for(j =0 ; j < d["blocks"].Size(); j++)
+                    {
+                        std::string invDelimiter = "/";
+                        std::string blockHash = d["blocks"][j].GetString();
+                        size_t      invPos = blockHash.find(invDelimiter);
 
-                                if(!requestBlocks.empty())
-                                {
-                                    rapidjson::Value value;
-                                    rapidjson::Value array(rapidjson::kArrayType);
-                                    rapidjson::Value tranArray(rapidjson::kArrayType);
-                                    std::vector<Transaction> requestTransactions;
-
-                                    d.RemoveMember("blocks");
-
-                                    for(block_it = requestBlocks.begin() ; block_it < requestBlocks.end(); block_it++)
-                                    {
-                                        //block_it->PrintAllTransaction();
-                                        requestTransactions = block_it->GetTransactions();
-                                        rapidjson::Value blockInfo(rapidjson::kObjectType);
-                                        
-                                        value = block_it->GetBlockHeight();
-                                        blockInfo.AddMember("height", value, d.GetAllocator());
-                                        
-                                        value = block_it->GetMinerId();
-                                        blockInfo.AddMember("minerId", value, d.GetAllocator());
-
-                                        value = block_it->GetNonce();
-                                        blockInfo.AddMember("nonce", value, d.GetAllocator());
-
-                                        value = block_it->GetParentBlockMinerId();
-                                        blockInfo.AddMember("parentBlockMinerId", value, d.GetAllocator());
-
-                                        value = block_it->GetBlockSizeBytes();
-                                        blockInfo.AddMember("size", value, d.GetAllocator());
-
-                                        value = block_it->GetTimeStamp();
-                                        blockInfo.AddMember("timeStamp", value, d.GetAllocator());
-
-                                        value = block_it->GetTimeReceived();
-                                        blockInfo.AddMember("timeReceived", value, d.GetAllocator());
-
-                                        for(trans_it = requestTransactions.begin(); trans_it < requestTransactions.end(); trans_it++)
-                                        {
-                                            //std::cout<<"node " << GetNode()->GetId()<<" add transaction\n";
-                                            rapidjson::Value transInfo(rapidjson::kObjectType);
-                                            
-                                            value = trans_it->GetTransNodeId();
-                                            transInfo.AddMember("nodeId", value, d.GetAllocator());
-
-                                            value = trans_it->GetTransId();
-                                            transInfo.AddMember("transId", value, d.GetAllocator());
-
-                                            value = trans_it->GetTransTimeStamp();
-                                            transInfo.AddMember("timestamp", value, d.GetAllocator());
-
-                                            tranArray.PushBack(transInfo, d.GetAllocator());
-
-                                        }
-                                        blockInfo.AddMember("transactions", tranArray, d.GetAllocator());
-
-                                        array.PushBack(blockInfo, d.GetAllocator());
-                                    }
-
-                                    d.AddMember("blocks", array, d.GetAllocator());
-
-                                    double sendTime = totalBlockMessageSize/m_uploadSpeed;
-                                    double eventTime;
-
-                                    if(m_sendBlockTimes.size() == 0 || Simulator::Now().GetSeconds() > m_sendBlockTimes.back())
-                                    {
-                                        eventTime = 0;
-                                    }
-                                    else
-                                    {
-                                        eventTime = m_sendBlockTimes.back() - Simulator::Now().GetSeconds();
-                                    }
-
-                                    m_sendBlockTimes.push_back(Simulator::Now().GetSeconds()+eventTime + sendTime);
-
-                                    NS_LOG_INFO("Node " << GetNode()->GetId() << " will start sending the block to "
-                                                << InetSocketAddress::ConvertFrom(from).GetIpv4()
-                                                << " at " << Simulator::Now().GetSeconds() + eventTime << "\n");
-                                    
-                                    rapidjson::StringBuffer packetInfo;
-                                    rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
-                                    d.Accept(writer);
-                                    std::string packet = packetInfo.GetString();
-                                    NS_LOG_INFO("DEBUG: " << packetInfo.GetString());
-
-                                    Simulator::Schedule (Seconds(eventTime), &BlockchainNode::SendBlock, this, packet, from);
-                                    Simulator::Schedule (Seconds(eventTime + sendTime), &BlockchainNode::RemoveSendTime, this);
-                                }
-                            }
+                        int height = atoi(blockHash.substr(0, invPos).c_str());
+                        int minerId = atoi(blockHash.substr(invPos+1, blockHash.size()).c_str());
 
-                            break;
-                        }            
-                        case BLOCK:
+                        if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId))
                         {
-                            NS_LOG_INFO("BLOCK");
-
-                            if(m_committerType != CLIENT)
+                            /*std::cout<<"GET_HEADERS: Blockchain node " << GetNode()->GetId()
+                                        << " has the block with height = " << height
+                                        << " and minerId = " << minerId << "\n";*/
+                            
+                            NS_LOG_INFO("GET_HEADERS: Blockchain node " << GetNode()->GetId()
+                                        << " has the block with height = " << height
+                                        << " and minerId = " << minerId);
+                            Block newBlock(m_blockchain.ReturnBlock(height, minerId));
+                            requestHeaders.push_back(newBlock);
+
+                        } 
+                        else if (ReceivedButNotValidated(blockHash))
+                        {
+                            /*std::cout<<"GET_HEADERS: Blockchain node " << GetNode()->GetId()
+                                        << " has received but not yet validated the block with height = "
+                                        << height << " and minerId = " << minerId << "\n";*/
+                            
+                            NS_LOG_INFO("GET_HEADERS: Blockchain node " << GetNode()->GetId()
+                                        << " has received but not yet validated the block with height = "
+                                        << height << " and minerId = " << minerId);
+                            requestHeaders.push_back(m_receivedNotValidated[blockHash]);
+                        }
+                        else
+                        {
+                            NS_LOG_INFO("GET_HEADERS: Blockchain node " << GetNode()->GetId()
+                                        << " does not have the full block with height = "
+                                        << height << " and minerId = " << minerId);
+                        }
+                    }
+
+                    if(!requestHeaders.empty())
+                    {
+                        rapidjson::Value value;
+                        rapidjson::Value array(rapidjson::kArrayType);
+
+                        d.RemoveMember("blocks");
+
+                        for(block_it = requestHeaders.begin() ; block_it < requestHeaders.end(); block_it++)
+                        {
+                            AddBlockHeader(d, array, *block_it);
+                        }
+
+                        d.AddMember("blocks", array, d.GetAllocator());
+
+                        SendMessage(GET_HEADERS, HEADERS, d, from);
+
+                    }
+                }
+
+                break;
+            }
+            case HEADERS:
+            {
+                
+                NS_LOG_INFO("HEADERS");
+
+                if(m_committerType != CLIENT)
+                {
+                    std::vector<std::string>        requestHeaders;
+                    std::vector<std::string>        requestBlocks;
+                    std::vector<std::string>        announcedBlocks;
+                    std::vector<std::string>::iterator  block_it;
+                    unsigned int j;
+                    bool                            announcement = d.HasMember("type") && d["type"].IsString()
+                                                                    && std::string(d["type"].GetString()) == "announcement";
+
+                    m_nodeStats->headersReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                    if(announcement)
+                    {
+                        m_nodeStats->announcementReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                    }
+
+                    for(j = 0; j <d["blocks"].Size(); j++)
+                    {
+                        int parentHeight = d["blocks"][j]["height"].GetInt() - 1;
+                        int parentMinerId = d["blocks"][j]["parentBlockMinerId"].GetInt();
+                        int height = d["blocks"][j]["height"].GetInt();
+                        int minerId = d["blocks"][j]["minerId"].GetInt();
+
+                        std::stringstream   stringStream;
+                        std::string         blockHash;
+                        std::string         parentBlockHash;
+
+                        stringStream << height << "/" << minerId;
+                        blockHash = stringStream.str();
+
+                        if(announcement)
+                        {
+                            /*
+                             * SENDHEADERS : the headers announce a new block, which is requested with GET_DATA only
+                             */
+                            if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId) || ReceivedButNotValidated(blockHash))
+                            {
+                                NS_LOG_INFO("HEADERS : Blockchain node " << GetNode()->GetId()
+                                            << " has already received the announced block " << blockHash);
+                                continue;
+                            }
+
+                            if(m_invTimeouts.find(blockHash) == m_invTimeouts.end() && !m_downloadScheduler.IsPending(blockHash)
+                                && !IsCollectingCodedChunks(blockHash))
+                            {
+                                announcedBlocks.push_back(blockHash);
+                                RecordAnnouncement(blockHash);
+                            }
+                            m_queueInv[blockHash].push_back(from);
+                        }
+
+                        Block newBlockHeaders(d["blocks"][j]["height"].GetInt(), d["blocks"][j]["minerId"].GetInt(), d["blocks"][j]["nonce"].GetInt()
+                                            , d["blocks"][j]["parentBlockMinerId"].GetInt(), d["blocks"][j]["size"].GetInt()
+                                            , d["blocks"][j]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
+
+                        ReadHeaderExtensions(d["blocks"][j], newBlockHeaders);
+                        m_onlyHeadersReceived[blockHash] = newBlockHeaders;
+
+                        /*
+                         * The headers answer our request: sample the RTT and re-arm the timeout with the real block size
+                         */
+                        m_peerMonitor.HeadersReceived(blockHash, InetSocketAddress::ConvertFrom(from).GetIpv4());
+                        if(m_invTimeouts.find(blockHash) != m_invTimeouts.end() && m_peerMonitor.HasRequest(blockHash)
+                            && m_peerMonitor.GetRequestPeer(blockHash) == InetSocketAddress::ConvertFrom(from).GetIpv4())
+                        {
+                            ArmInvTimeout(blockHash, InetSocketAddress::ConvertFrom(from).GetIpv4(), d["blocks"][j]["size"].GetInt());
+                        }
+
+                        stringStream.clear();
+                        stringStream.str("");
+
+                        stringStream << parentHeight << "/" << parentMinerId;
+                        parentBlockHash = stringStream.str();
+
+                        if (!m_blockchain.HasBlock(parentHeight, parentMinerId) && !m_blockchain.IsOrphan(parentHeight, parentMinerId) && !ReceivedButNotValidated(parentBlockHash))
+                        {
+                            /*std::cout<<"The Block with height  = " << d["blocks"][j]["height"].GetInt()
+                                        << " and minerID = " << d["blocks"][j]["minerId"].GetInt()
+                                        << " is an orphan\n" << "\n";*/
+                            
+                            NS_LOG_INFO("The Block with height  = " << d["blocks"][j]["height"].GetInt()
+                                        << " and minerID = " << d["blocks"][j]["minerId"].GetInt()
+                                        << " is an orphan\n");
+                            
+                            if(m_invTimeouts.find(parentBlockHash) == m_invTimeouts.end() && !m_downloadScheduler.IsPending(parentBlockHash))
+                            {
+                                NS_LOG_INFO("HEADERS : Blockchain node " << GetNode()->GetId()
+                                            << " has not requested its parent block yet");
+                                if(!OnlyHeadersReceived(parentBlockHash))
+                                {
+                                    requestHeaders.push_back(parentBlockHash.c_str());
+                                }
+                                else
+                                {
+                                    m_peerMonitor.RequestSent(parentBlockHash, InetSocketAddress::ConvertFrom(from).GetIpv4());
+                                    ArmInvTimeout(parentBlockHash, InetSocketAddress::ConvertFrom(from).GetIpv4(), 0);
+                                }
+
+                            }
+                            else
+                            {
+                                NS_LOG_INFO("HEADERS: Blockchain node " << GetNode()->GetId()
+                                            << "has already requested the block");
+                            }
+
+                            m_queueInv[parentBlockHash].push_back(from);
+
+                        }
+                        else
+                        {
+                            /*std::cout<<"The Block with height = " << d["blocks"][j]["height"].GetInt()
+                                        << " and minerId = " << d["blocks"][j]["minerId"].GetInt()
+                                        << " is NOT an orphan\n";*/
+                            
+                            NS_LOG_INFO("The Block with height = " << d["blocks"][j]["height"].GetInt()
+                                        << " and minerId = " << d["blocks"][j]["minerId"].GetInt()
+                                        << " is NOT an orphan\n");
+                        }
+                    }
+
+                    /*
+                     * The missing parents are downloaded in parallel from their announcers
+                     */
+                    if(!requestHeaders.empty())
+                    {
+                        RequestBlocks(requestHeaders);
+                    }
+
+                    if(!announcedBlocks.empty())
+                    {
+                        RequestBlocks(announcedBlocks);
+                    }
+
+                    if(!requestBlocks.empty())
+                    {
+                        rapidjson::Value        value;
+                        rapidjson::Value        array(rapidjson::kArrayType);
+                        Time                    timeout;
+
+                        d.RemoveMember("blocks");
+
+                        for(block_it = requestBlocks.begin(); block_it < requestBlocks.end(); block_it++)
+                        {
+                            value.SetString(block_it->c_str(), block_it->size(), d.GetAllocator());
+                            array.PushBack(value, d.GetAllocator());
+                        }
+
+                        d.AddMember("blocks", array, d.GetAllocator());
+
+                        SendMessage(HEADERS, GET_DATA, d, from);
+                    }
+                }
+
+                break;
+            }
+            case GET_DATA:
+            {
+                NS_LOG_INFO("GET_DATA");
+
+                if(m_committerType != CLIENT)
+                {
+                    unsigned int j;
+                    int totalBlockMessageSize = 0;
+                    std::vector<Block>                      requestBlocks;
+                    std::vector<Block>::iterator            block_it;
+                    std::vector<Transaction>::iterator      trans_it;
+                    bool                                    compact = d.HasMember("type") && d["type"].IsString()
+                                                                    && std::string(d["type"].GetString()) == "compact";
+                    bool                                    graphene = d.HasMember("type") && d["type"].IsString()
+                                                                    && std::string(d["type"].GetString()) == "graphene";
+
+                    m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_inventorySizeBytes;
+
+                    for(j=0; j < d["blocks"].Size(); j++)
+                    {
+                        std::string     invDelimiter = "/";
+                        std::string     parsedInv = d["blocks"][j].GetString();
+                        size_t          invPos = parsedInv.find(invDelimiter);
+
+                        int height = atoi(parsedInv.substr(0, invPos).c_str());
+                        int minerId = atoi(parsedInv.substr(invPos+1, parsedInv.size()).c_str());
+
+                        if(m_blockchain.HasBlock(height, minerId))
+                        {
+                            NS_LOG_INFO("GET_DATA : Blockchain node " << GetNode()->GetId()
+                                        << " has the block with height = " << height
+                                        << " and minerId = " << minerId);
+                            Block newBlock(m_blockchain.ReturnBlock(height, minerId));
+                            requestBlocks.push_back(newBlock);
+                            totalBlockMessageSize += newBlock.GetBlockSizeBytes();
+                        }
+                        else
+                        {
+                            NS_LOG_INFO("GET_DATA : Blockchain node " << GetNode()->GetId()
+                                        << " does not have the block with height = " << height
+                                        << " and minerId = " << minerId);
+                        }
+
+                    }
+
+                    if(compact)
+                    {
+                        /*
+                         * Low-bandwidth compact blocks : one CMPCT_BLOCK per requested block
+                         */
+                        for(block_it = requestBlocks.begin(); block_it < requestBlocks.end(); block_it++)
+                        {
+                            QueueCompactBlock(*block_it, from);
+                        }
+                    }
+                    else if(graphene)
+                    {
+                        /*
+                         * Graphene blocks : one GRAPHENE_BLOCK per requested block, sized for the pool of the requester
+                         */
+                        for(block_it = requestBlocks.begin(); block_it < requestBlocks.end(); block_it++)
+                        {
+                            QueueGrapheneBlock(*block_it, d["poolSize"].GetInt(), from);
+                        }
+                    }
+                    else if(!requestBlocks.empty())
+                    {
+                        rapidjson::Value value;
+                        rapidjson::Value array(rapidjson::kArrayType);
+                        rapidjson::Value tranArray(rapidjson::kArrayType);
+                        std::vector<Transaction> requestTransactions;
+
+                        d["message"].SetInt(BLOCK);
+                        d.RemoveMember("blocks");
+
+                        for(block_it = requestBlocks.begin() ; block_it < requestBlocks.end(); block_it++)
+                        {
+                            //block_it->PrintAllTransaction();
+                            requestTransactions = block_it->GetTransactions();
+                            rapidjson::Value blockInfo(rapidjson::kObjectType);
+                            
+                            value = block_it->GetBlockHeight();
+                            blockInfo.AddMember("height", value, d.GetAllocator());
+                            
+                            value = block_it->GetMinerId();
+                            blockInfo.AddMember("minerId", value, d.GetAllocator());
+
+                            value = block_it->GetNonce();
+                            blockInfo.AddMember("nonce", value, d.GetAllocator());
+
+                            value = block_it->GetParentBlockMinerId();
+                            blockInfo.AddMember("parentBlockMinerId", value, d.GetAllocator());
+
+                            value = block_it->GetBlockSizeBytes();
+                            blockInfo.AddMember("size", value, d.GetAllocator());
+
+                            value = block_it->GetTimeStamp();
+                            blockInfo.AddMember("timeStamp", value, d.GetAllocator());
+
+                            value = block_it->GetTimeReceived();
+                            blockInfo.AddMember("timeReceived", value, d.GetAllocator());
+
+                            AddHeaderExtensions(d, blockInfo, *block_it);
+
+                            for(trans_it = requestTransactions.begin(); trans_it < requestTransactions.end(); trans_it++)
                             {
-                                int blockMessageSize = 0;
-                                double receiveTime;
-                                double eventTime = 0;
-                                double minSpeed = std::min(m_downloadSpeed, m_peersUploadSpeeds[InetSocketAddress::ConvertFrom(from).GetIpv4()]*1000000/8);
+                                //std::cout<<"node " << GetNode()->GetId()<<" add transaction\n";
+                                rapidjson::Value transInfo(rapidjson::kObjectType);
+                                
+                                value = trans_it->GetTransNodeId();
+                                transInfo.AddMember("nodeId", value, d.GetAllocator());
+
+                                value = trans_it->GetTransId();
+                                transInfo.AddMember("transId", value, d.GetAllocator());
+
+                                value = trans_it->GetTransTimeStamp();
+                                transInfo.AddMember("timestamp", value, d.GetAllocator());
+
+                                value = trans_it->GetTransSizeByte();
+                                transInfo.AddMember("size", value, d.GetAllocator());
+
+                                tranArray.PushBack(transInfo, d.GetAllocator());
+
+                            }
+                            blockInfo.AddMember("transactions", tranArray, d.GetAllocator());
+
+                            array.PushBack(blockInfo, d.GetAllocator());
+                        }
+
+                        d.AddMember("blocks", array, d.GetAllocator());
+
+                        totalBlockMessageSize += m_blockchainMessageHeader;
+
+                        NS_LOG_INFO("Node " << GetNode()->GetId() << " queues a block message of " << totalBlockMessageSize
+                                    << " Bytes to " << InetSocketAddress::ConvertFrom(from).GetIpv4()
+                                    << ", upload queue depth = " << m_uploadScheduler.GetQueueDepth());
+                        
+                        rapidjson::StringBuffer packetInfo;
+                        rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+                        d.Accept(writer);
+                        std::string packet = packetInfo.GetString();
+                        NS_LOG_INFO("DEBUG: " << packetInfo.GetString());
+
+                        /*
+                         * The message is put on the socket when the upload link becomes free and
+                         * keeps the link busy for totalBlockMessageSize/m_uploadSpeed
+                         */
+                        m_uploadScheduler.Enqueue(InetSocketAddress::ConvertFrom(from).GetIpv4(), from, packet, totalBlockMessageSize, 0);
+                    }
+                }
+
+                break;
+            }            
+            case BLOCK:
+            {
+                NS_LOG_INFO("BLOCK");
+
+                if(m_committerType != CLIENT)
+                {
+                    int blockMessageSize = 0;
+                    double peerUploadSpeed = m_peersUploadSpeeds[InetSocketAddress::ConvertFrom(from).GetIpv4()]*1000000/8;
+
+                    blockMessageSize += m_blockchainMessageHeader;
+                    
+
+                    for(unsigned int j = 0; j < d["blocks"].Size(); j++)
+                    {
+                        blockMessageSize += d["blocks"][j]["size"].GetInt();
+                    }
+
+            
+                    m_nodeStats->blockReceivedBytes += blockMessageSize;
+
+                    rapidjson::StringBuffer blockInfo;
+                    rapidjson::Writer<rapidjson::StringBuffer> blockWriter(blockInfo);
+                    d.Accept(blockWriter);
+                    /*
+                    if(GetNode()->GetId() == 10)
+                    {
+                        std::cout<<"BLOCK: At time " << Simulator::Now().GetSeconds()
+                                << " Node " << GetNode()->GetId()
+                                << " received a block message " << blockInfo.GetString() << "\n";
+                    }
+                    */
+                    
+                    NS_LOG_INFO("BLOCK: At time " << Simulator::Now().GetSeconds()
+                                << " Node " << GetNode()->GetId()
+                                << " received a block message " << blockInfo.GetString());
+                    NS_LOG_INFO(m_downloadSpeed << " " << peerUploadSpeed);
+
+                    std::string help = blockInfo.GetString();
+
+                    /*
+                     * Concurrent block messages share m_downloadSpeed equally, and none of them
+                     * can arrive faster than the upload speed of its sender
+                     */
+                    m_downloadLink.AddTransfer(InetSocketAddress::ConvertFrom(from).GetIpv4(), from, help, blockMessageSize, peerUploadSpeed);
+                    NS_LOG_INFO("BLOCK: Node " << GetNode()->GetId() << " started downloading the block message, active downloads = "
+                                << m_downloadLink.GetActiveTransfers());
+                }
+                
+
+                break;
+            }
+            case CMPCT_BLOCK:
+            case BLOCK_TXN:
+            case GRAPHENE_BLOCK:
+            {
+                NS_LOG_INFO(getMessageName(static_cast<enum Messages>(d["message"].GetInt())));
+
+                if(m_committerType != CLIENT)
+                {
+                    int     messageSize = d["size"].GetInt();
+                    double  peerUploadSpeed = m_peersUploadSpeeds[InetSocketAddress::ConvertFrom(from).GetIpv4()]*1000000/8;
+
+                    if(d["message"].GetInt() == GRAPHENE_BLOCK)
+                        m_nodeStats->grapheneReceivedBytes += messageSize;
+                    else
+                        m_nodeStats->compactBlockReceivedBytes += messageSize;
+
+                    rapidjson::StringBuffer messageInfo;
+                    rapidjson::Writer<rapidjson::StringBuffer> messageWriter(messageInfo);
+                    d.Accept(messageWriter);
+
+                    /*
+                     * Compact blocks share the download link with the full blocks
+                     */
+                    m_downloadLink.AddTransfer(InetSocketAddress::ConvertFrom(from).GetIpv4(), from, messageInfo.GetString(), messageSize, peerUploadSpeed);
+                }
+
+                break;
+            }
+            case GET_BLOCK_TXN:
+            {
+                NS_LOG_INFO("GET_BLOCK_TXN");
+
+                if(m_committerType != CLIENT)
+                {
+                    std::string                 blockHash = d["blockHash"].GetString();
+                    size_t                      invPos = blockHash.find("/");
+                    int                         height = atoi(blockHash.substr(0, invPos).c_str());
+                    int                         minerId = atoi(blockHash.substr(invPos+1, blockHash.size()).c_str());
+                    std::vector<Transaction>    blockTransactions;
+
+                    m_nodeStats->compactBlockReceivedBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes
+                                                            + d["indexes"].Size()*m_transactionIndexSize;
+
+                    if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId))
+                    {
+                        blockTransactions = m_blockchain.ReturnBlock(height, minerId).GetTransactions();
+                    }
+                    else if(ReceivedButNotValidated(blockHash))
+                    {
+                        blockTransactions = m_receivedNotValidated[blockHash].GetTransactions();
+                    }
+                    else
+                    {
+                        NS_LOG_INFO("GET_BLOCK_TXN : Blockchain node " << GetNode()->GetId() << " does not have the block " << blockHash);
+                        break;
+                    }
+
+                    rapidjson::Value    value;
+                    rapidjson::Value    tranArray(rapidjson::kArrayType);
+                    int                 transactionBytes = 0;
+
+                    for(unsigned int j = 0; j < d["indexes"].Size(); j++)
+                    {
+                        unsigned int index = d["indexes"][j].GetInt();
+
+                        if(index >= blockTransactions.size())
+                        {
+                            NS_LOG_WARN("GET_BLOCK_TXN : block " << blockHash << " has no transaction " << index);
+                            continue;
+                        }
+
+                        rapidjson::Value transInfo(rapidjson::kObjectType);
+
+                        value = index;
+                        transInfo.AddMember("index", value, d.GetAllocator());
+
+                        value = blockTransactions[index].GetTransNodeId();
+                        transInfo.AddMember("nodeId", value, d.GetAllocator());
+
+                        value = blockTransactions[index].GetTransId();
+                        transInfo.AddMember("transId", value, d.GetAllocator());
+
+                        value = blockTransactions[index].GetTransTimeStamp();
+                        transInfo.AddMember("timestamp", value, d.GetAllocator());
+
+                        value = blockTransactions[index].GetTransSizeByte();
+                        transInfo.AddMember("size", value, d.GetAllocator());
+
+                        tranArray.PushBack(transInfo, d.GetAllocator());
+                        transactionBytes += blockTransactions[index].GetTransSizeByte();
+                    }
+
+                    int messageSize = m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes + transactionBytes;
+
+                    d["message"].SetInt(BLOCK_TXN);
+                    d.RemoveMember("indexes");
+                    d.AddMember("transactions", tranArray, d.GetAllocator());
+                    value = messageSize;
+                    d.AddMember("size", value, d.GetAllocator());
+
+                    rapidjson::StringBuffer packetInfo;
+                    rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+                    d.Accept(writer);
+
+                    m_uploadScheduler.Enqueue(InetSocketAddress::ConvertFrom(from).GetIpv4(), from, packetInfo.GetString(), messageSize, 0);
+                }
+
+                break;
+            }
+            case CHUNK_INV:
+            {
+                NS_LOG_INFO("CHUNK_INV");
+
+                if(m_committerType != CLIENT)
+                {
+                    m_nodeStats->announcementReceivedBytes += d["size"].GetInt();
+                    ReceivedChunkInv(d, from);
+                }
+
+                break;
+            }
+            case GET_CHUNK:
+            {
+                NS_LOG_INFO("GET_CHUNK");
+
+                if(m_committerType != CLIENT)
+                {
+                    std::string                 blockHash = d["blockHash"].GetString();
+                    size_t                      invPos = blockHash.find("/");
+                    int                         height = atoi(blockHash.substr(0, invPos).c_str());
+                    int                         minerId = atoi(blockHash.substr(invPos+1, blockHash.size()).c_str());
+                    Block                       block;
+                    std::vector<Transaction>    transactions;
+                    bool                        fullBlock = true;
+
+                    m_nodeStats->getDataReceivedBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes
+                                                        + d["chunks"].Size()*m_countBytes;
+
+                    if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId))
+                    {
+                        block = m_blockchain.ReturnBlock(height, minerId);
+                        transactions = block.GetTransactions();
+                    }
+                    else if(ReceivedButNotValidated(blockHash))
+                    {
+                        block = m_receivedNotValidated[blockHash];
+                        transactions = block.GetTransactions();
+                    }
+                    else if(m_chunkSwarm.HasBlock(blockHash))
+                    {
+                        /*
+                         * The chunks are relayed before the whole block has arrived
+                         */
+                        block = m_chunkSwarm.GetHeader(blockHash);
+                        transactions = m_chunkSwarm.GetTransactions(blockHash);
+                        fullBlock = false;
+                    }
+                    else
+                    {
+                        NS_LOG_INFO("GET_CHUNK : Blockchain node " << GetNode()->GetId() << " does not have the block " << blockHash);
+                        break;
+                    }
+
+                    for(unsigned int j = 0; j < d["chunks"].Size(); j++)
+                    {
+                        int chunk = d["chunks"][j].GetInt();
+
+                        if(chunk < 0 || chunk >= m_chunkSwarm.GetChunkCount(block.GetBlockSizeBytes())
+                            || (!fullBlock && !m_chunkSwarm.HasChunk(blockHash, chunk)))
+                        {
+                            NS_LOG_INFO("GET_CHUNK : Blockchain node " << GetNode()->GetId() << " does not have chunk " << chunk
+                                        << " of block " << blockHash);
+                            continue;
+                        }
+
+                        QueueChunk(block, transactions, chunk, from);
+                    }
+                }
+
+                break;
+            }
+            case CHUNK:
+            {
+                NS_LOG_INFO("CHUNK");
+
+                if(m_committerType != CLIENT)
+                {
+                    int     messageSize = d["size"].GetInt();
+                    double  peerUploadSpeed = m_peersUploadSpeeds[InetSocketAddress::ConvertFrom(from).GetIpv4()]*1000000/8;
+
+                    m_nodeStats->chunkReceivedBytes += messageSize;
+
+                    rapidjson::StringBuffer messageInfo;
+                    rapidjson::Writer<rapidjson::StringBuffer> messageWriter(messageInfo);
+                    d.Accept(messageWriter);
+
+                    /*
+                     * The chunks of different peers are downloaded in parallel on the shared link
+                     */
+                    m_downloadLink.AddTransfer(InetSocketAddress::ConvertFrom(from).GetIpv4(), from, messageInfo.GetString(), messageSize, peerUploadSpeed);
+                }
+
+                break;
+            }
+            case CODED_CHUNK:
+            {
+                NS_LOG_INFO("CODED_CHUNK");
+
+                if(m_committerType != CLIENT)
+                {
+                    int     messageSize = d["size"].GetInt();
+                    double  peerUploadSpeed = m_peersUploadSpeeds[InetSocketAddress::ConvertFrom(from).GetIpv4()]*1000000/8;
+
+                    m_nodeStats->codedChunkReceivedBytes += messageSize;
+
+                    rapidjson::StringBuffer messageInfo;
+                    rapidjson::Writer<rapidjson::StringBuffer> messageWriter(messageInfo);
+                    d.Accept(messageWriter);
+
+                    m_downloadLink.AddTransfer(InetSocketAddress::ConvertFrom(from).GetIpv4(), from, messageInfo.GetString(), messageSize, peerUploadSpeed);
+                }
+
+                break;
+            }
+            case REQ_RECON:
+            {
+                NS_LOG_INFO("REQ_RECON");
+                ReceivedReconciliationRequest(d, from);
+                break;
+            }
+            case SKETCH:
+            {
+                NS_LOG_INFO("SKETCH");
+                ReceivedSketch(d, from);
+                break;
+            }
+            case RECON_DIFF:
+            {
+                NS_LOG_INFO("RECON_DIFF");
+                ReceivedReconciliationDifference(d, from);
+                break;
+            }
+            case TRANS_INV:
+            {
+                NS_LOG_INFO("TRANS_INV");
+                ReceivedTransactionInv(d, from);
+                break;
+            }
+            case GET_TRANS:
+            {
+                NS_LOG_INFO("GET_TRANS");
+                ReceivedTransactionRequest(d, from);
+                break;
+            }
+            case PBFT_PRE_PREPARE:
+            case PBFT_PREPARE:
+            case PBFT_COMMIT:
+            case PBFT_VIEW_CHANGE:
+            case PBFT_NEW_VIEW:
+            case RAFT_APPEND:
+            case RAFT_ACK:
+            case RAFT_VOTE_REQUEST:
+            case RAFT_VOTE:
+            case HOTSTUFF_PROPOSAL:
+            case HOTSTUFF_VOTE:
+            case HOTSTUFF_NEW_VIEW:
+            {
+                NS_LOG_INFO(getMessageName(static_cast<enum Messages>(d["message"].GetInt())));
+
+                m_nodeStats->consensusMessagesReceived++;
+                m_nodeStats->consensusReceivedBytes += d["size"].GetInt();
+
+                /*
+                 * The messages carrying a block share the downlink with the other block messages
+                 */
+                if(d.HasMember("blocks"))
+                {
+                    double  peerUploadSpeed = m_peersUploadSpeeds[InetSocketAddress::ConvertFrom(from).GetIpv4()]*1000000/8;
+
+                    rapidjson::StringBuffer messageInfo;
+                    rapidjson::Writer<rapidjson::StringBuffer> messageWriter(messageInfo);
+                    d.Accept(messageWriter);
+
+                    m_downloadLink.AddTransfer(InetSocketAddress::ConvertFrom(from).GetIpv4(), from, messageInfo.GetString(), d["size"].GetInt(), peerUploadSpeed);
+                }
+                else
+                {
+                    ReceivedConsensusMessage(d, from);
+                }
+
+                break;
+            }
+            default:
+            {
+                NS_LOG_INFO("Default");
+                break;
+            }
+            
+        }
+    }
+
+    void
+    BlockchainNode::HandleAccept(Ptr<Socket> socket, const Address& from)
+    {
+        NS_LOG_FUNCTION(this);
+        socket->SetRecvCallback (MakeCallback(&BlockchainNode::HandleRead, this));
+    }
+
+    void
+    BlockchainNode::HandlePeerClose(Ptr<Socket> socket)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainNode::HandlePeerError(Ptr<Socket> socket)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainNode::ReceivedBlockMessage(std::string blockInfo, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document d;
+        d.Parse(blockInfo.c_str());
+
+        NS_LOG_INFO("ReceivedBlockMessage : At time : " << Simulator::Now().GetSeconds()
+                    << " Node " << GetNode()->GetId() << " received a block message " << blockInfo);
+
+        if(d["message"].GetInt() == CMPCT_BLOCK)
+        {
+            ReceivedCompactBlock(d, from);
+            return;
+        }
+        else if(d["message"].GetInt() == BLOCK_TXN)
+        {
+            ReceivedBlockTransactions(d, from);
+            return;
+        }
+        else if(d["message"].GetInt() == CHUNK)
+        {
+            ReceivedChunk(d, from);
+            return;
+        }
+        else if(d["message"].GetInt() == CODED_CHUNK)
+        {
+            ReceivedCodedChunk(d, from);
+            return;
+        }
+        else if(d["message"].GetInt() == GRAPHENE_BLOCK)
+        {
+            ReceivedGrapheneBlock(d, from);
+            return;
+        }
+        else if(d["message"].GetInt() >= PBFT_PRE_PREPARE && d["message"].GetInt() <= HOTSTUFF_NEW_VIEW)
+        {
+            ReceivedConsensusMessage(d, from);
+            return;
+        }
+
+        std::vector<std::string>    blockHashes;
+        int                         blockMessageSize = m_blockchainMessageHeader;
+
+        for(unsigned int j = 0; j < d["blocks"].Size(); j++)
+        {
+            std::ostringstream  stringStream;
+
+            stringStream << d["blocks"][j]["height"].GetInt() << "/" << d["blocks"][j]["minerId"].GetInt();
+            blockHashes.push_back(stringStream.str());
+            blockMessageSize += d["blocks"][j]["size"].GetInt();
+        }
+        m_peerMonitor.BlocksReceived(blockHashes, InetSocketAddress::ConvertFrom(from).GetIpv4(), blockMessageSize);
+
+        for(unsigned int  j = 0 ; j < d["blocks"].Size(); j++)
+        {
+            std::vector<Transaction> newTransactions;
+            Block newBlock(d["blocks"][j]["height"].GetInt(), d["blocks"][j]["minerId"].GetInt(), d["blocks"][j]["nonce"].GetInt()
+                            , d["blocks"][j]["parentBlockMinerId"].GetInt(), d["blocks"][j]["size"].GetInt()
+                            , d["blocks"][j]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
+            ReadHeaderExtensions(d["blocks"][j], newBlock);
+
+            for(unsigned int i = 0 ; i < d["blocks"][j]["transactions"].Size(); i++)
+            {
+                int transNodeId = d["blocks"][j]["transactions"][i]["nodeId"].GetInt();
+                int transId = d["blocks"][j]["transactions"][i]["transId"].GetInt();
+                double timeStamp = d["blocks"][j]["transactions"][i]["timestamp"].GetDouble();
+                Transaction newTrans(transNodeId, transId, timeStamp);
+                newTrans.SetTransSizeByte(d["blocks"][j]["transactions"][i]["size"].GetInt());
+                newTransactions.push_back(newTrans);
+                //std::cout<<"Node " << GetNode()->GetId() << " confirmed transaction nodeid: " << transNodeId << " transId: " <<  transId << "\n";
+            }
+            newBlock.SetTransactions(newTransactions);
+            ReceivedDownloadedBlock(newBlock);
+        }
+
+        ProcessPendingRequests();
+    }
+
+    void
+    BlockchainNode::ReceivedDownloadedBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int parentHeight = newBlock.GetBlockHeight() - 1;
+        int parentMinerId = newBlock.GetParentBlockMinerId();
+
+        std::ostringstream  stringStream;
+        std::string         blockHash;
+        std::string         parentBlockHash;
+
+        stringStream << newBlock.GetBlockHeight() << "/" << newBlock.GetMinerId();
+        blockHash = stringStream.str();
+
+        if(m_onlyHeadersReceived.find(blockHash) != m_onlyHeadersReceived.end())
+        {
+            m_onlyHeadersReceived.erase(blockHash);
+        }
+
+        /*
+         * The block may have arrived in full while its chunks were still being downloaded
+         */
+        RemoveChunkDownload(blockHash);
+
+        if(m_codedBlocks.find(blockHash) != m_codedBlocks.end())
+        {
+            m_codedBlocks.erase(blockHash);
+            if(m_codedBlockTimeouts.find(blockHash) != m_codedBlockTimeouts.end())
+            {
+                m_timerWheel.Cancel(m_codedBlockTimeouts[blockHash]);
+                m_codedBlockTimeouts.erase(blockHash);
+            }
+        }
+
+        stringStream.clear();
+        stringStream.str("");
+
+        stringStream << parentHeight << "/" << parentMinerId;
+        parentBlockHash = stringStream.str();
+
+        if(!m_blockchain.HasBlock(parentHeight, parentMinerId) && !m_blockchain.IsOrphan(parentHeight, parentMinerId)
+            && !ReceivedButNotValidated(parentBlockHash) && !OnlyHeadersReceived(parentBlockHash))
+        {
+            NS_LOG_INFO("The Block with height = " << newBlock.GetBlockHeight()
+                        << " and minerID = " << newBlock.GetMinerId()
+                        << " is an orphan, so it will be discarded\n");
+            m_queueInv.erase(blockHash);
+            RemoveBlockRequest(blockHash);
+        }
+        else
+        {
+            ReceiveBlock(newBlock);
+        }
+    }
+
+    void
+    BlockchainNode::ReceiveBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("ReceiveBlock: At time " << Simulator::Now().GetSeconds()
+                    << "s blockchain node " << GetNode()->GetId() << " received");
+        std::ostringstream  stringStream;
+        std::string         blockHash = stringStream.str();
+
+        stringStream << newBlock.GetBlockHeight() << "/" << newBlock.GetMinerId();
+        blockHash = stringStream.str();
+
+        if(m_blockchain.HasBlock(newBlock) || m_blockchain.IsOrphan(newBlock) || ReceivedButNotValidated(blockHash))
+        {
+            NS_LOG_INFO("ReceiveBlock: Blockchain node " << GetNode()->GetId()
+                        << " has already added this block in the m_blockchain");
+
+            if (m_invTimeouts.find(blockHash) != m_invTimeouts.end())
+            {
+                m_queueInv.erase(blockHash);
+                RemoveBlockRequest(blockHash);
+            }
+        }
+        else
+        {
+            NS_LOG_INFO("ReceiveBlock: Blockchain node " << GetNode()->GetId()
+                        << " has not added this block in the m_blockchain");
+            
+            m_receivedNotValidated[blockHash] = newBlock;
+
+            if(m_announcementTimes.find(blockHash) != m_announcementTimes.end())
+            {
+                m_announcedBlocksReceived++;
+                m_meanAnnounceToBlockTime = (m_meanAnnounceToBlockTime*static_cast<double>(m_announcedBlocksReceived-1)
+                                            + (Simulator::Now().GetSeconds() - m_announcementTimes[blockHash]))/static_cast<double>(m_announcedBlocksReceived);
+                NS_LOG_INFO("ReceiveBlock : block " << blockHash << " arrived " << Simulator::Now().GetSeconds() - m_announcementTimes[blockHash]
+                            << "s after its announcement");
+            }
+
+            if (m_invTimeouts.find(blockHash) != m_invTimeouts.end())
+            {
+                m_queueInv.erase(blockHash);
+                RemoveBlockRequest(blockHash);
+            }
+
+            ValidateBlock(newBlock);
+        }
+
+        m_announcementTimes.erase(blockHash);
+    }
+
+    void
+    BlockchainNode::SendBlock(std::string packetInfo, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        NS_LOG_INFO("SendBlock: At time "<<  Simulator::Now().GetSeconds()
+                    << "s blockchain node " << GetNode()->GetId() << " sent "
+                    << packetInfo << " to " << InetSocketAddress::ConvertFrom(from).GetIpv4());
+
+        rapidjson::Document d;
+        d.Parse(packetInfo.c_str());
+
+        /*
+         * The upload link carries BLOCK, CMPCT_BLOCK, GRAPHENE_BLOCK, BLOCK_TXN, CHUNK and CODED_CHUNK messages,
+         * the consensus messages carrying a block and the transaction messages. The coded chunks and the consensus
+         * messages are pushed without a request, the transaction messages are counted when they are queued.
+         */
+        enum Messages message = static_cast<enum Messages>(d["message"].GetInt());
+        enum Messages request = GET_DATA;
+
+        if(d.HasMember("type") && std::string(d["type"].GetString()) == "transaction")
+        {
+            SendTransactionPacket(packetInfo, InetSocketAddress::ConvertFrom(from).GetIpv4());
+            return;
+        }
+
+        if(message == BLOCK_TXN)
+            request = GET_BLOCK_TXN;
+        else if(message == CHUNK)
+            request = GET_CHUNK;
+        else if(message == CODED_CHUNK || (message >= PBFT_PRE_PREPARE && message <= HOTSTUFF_NEW_VIEW))
+            request = NO_MESSAGE;
+
+        SendMessage(request, message, packetInfo, from);
+    }
+
+    void
+    BlockchainNode::ReceivedHigherBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("ReceivedHigherBlock: blockchain node : " <<GetNode()->GetId() 
+                    << " added a new block in the m_blockchain with higher height");
+    }
+
+    void
+    BlockchainNode::Reorganized(const Block &newTip, const std::vector<const Block *> &displaced)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("Reorganized : at time " << Simulator::Now().GetSeconds() << "s blockchain node " << GetNode()->GetId()
+                    << " moved its main chain to the block " << newTip.GetBlockHeight() << "/" << newTip.GetMinerId()
+                    << ", " << displaced.size() << " blocks left the main chain");
+
+        if(m_isMiner != true)
+            return;
+
+        /*
+         * The block templates took the transactions out of the mempool, the ones of the displaced blocks go back.
+         * The blocks above the common ancestor that entered the main chain keep theirs.
+         */
+        int ancestorHeight = newTip.GetBlockHeight();
+
+        for(auto it = displaced.begin(); it != displaced.end(); it++)
+        {
+            std::vector<Transaction> transactions = (*it)->GetTransactions();
+
+            ancestorHeight = std::min(ancestorHeight, (*it)->GetBlockHeight() - 1);
+            for(auto trans_it = transactions.begin(); trans_it < transactions.end(); trans_it++)
+                m_mempool.Add(*trans_it, trans_it->GetTransSizeByte());
+        }
+
+        for(const Block *block = &newTip; block != nullptr && block->GetBlockHeight() > ancestorHeight; block = m_blockchain.GetParent(*block))
+        {
+            std::vector<Transaction> transactions = block->GetTransactions();
+
+            for(auto trans_it = transactions.begin(); trans_it < transactions.end(); trans_it++)
+                m_mempool.Remove(*trans_it);
+        }
+    }
+
+    void
+    BlockchainNode::ValidateBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        const Block *parent = m_blockchain.GetParent(newBlock);
+
+        if(parent == nullptr)
+        {
+            NS_LOG_INFO("ValidateBlock : Block is an orphan");
+            m_blockchain.AddOrphan(newBlock);
+            
+        }
+        else
+        {
+            /*
+             * The validation waits for the work already queued on the node's CPU
+             */
+            double validationTime = m_cpuModel.Reserve(m_cpuModel.GetBlockValidationCost(newBlock.GetBlockSizeBytes(), newBlock.GetTransactions().size()));
+            ValidateTransaction(newBlock);
+
+            //std::cout<<"validationTime : " << validationTime << "\n";
+            Simulator::Schedule (Seconds(validationTime), &BlockchainNode::AfterBlockValidation, this, newBlock);
+            NS_LOG_INFO("ValidateBlock : the block will be validated in " << validationTime << "s");
+        }
+
+    }
+
+    void
+    BlockchainNode::ValidateTransaction(const Block &newBlock)
+    {
+        std::vector<Transaction>                requestTransactions;
+        std::vector<Transaction>::iterator      trans_it;
+        std::vector<Transaction>::iterator      notValTrans_it;
+        requestTransactions = newBlock.GetTransactions();
+
+        for(trans_it = requestTransactions.begin(); trans_it < requestTransactions.end(); trans_it++)
+        {
+            /*
+            std::cout<<"Node "<<GetNode()->GetId() << " is validating transaction nodeId : " 
+                    << trans_it->GetTransNodeId() << " transId: " << trans_it->GetTransId() << "\n";
+            */
+            m_mempool.Remove(*trans_it);
+
+            for(notValTrans_it = m_transaction.begin(); notValTrans_it < m_transaction.end(); notValTrans_it++)
+            {
+                if(*notValTrans_it == *trans_it)
+                {
+                    if(notValTrans_it->IsValidated() != true)
+                    {
+                        notValTrans_it->SetValidation();
+                        m_totalValidation++;
+                        m_meanValidationTime = (m_meanValidationTime*static_cast<double>(m_totalValidation-1) + (Simulator::Now().GetSeconds() - notValTrans_it->GetTransTimeStamp()))/static_cast<double>(m_totalValidation);
+                        //Send to Client node
+                        NotifyTransaction(*notValTrans_it);
+                    }
+                    break;
+                }
+            }
+
+            if(notValTrans_it == m_transaction.end())
+            {
+                trans_it->SetValidation();
+                m_transaction.push_back(*trans_it);
+                m_seenMessages.Insert(BlockchainSeenCache::MakeKey(REQUEST_TRANS, trans_it->GetTransNodeId(), trans_it->GetTransId(), 0));
+
+                //m_totalValidation++;
+                //m_meanValidationTime = (m_meanValidationTime*static_cast<double>(m_totalValidation-1) + (Simulator::Now().GetSeconds() - notValTrans_it->GetTransTimeStamp()))/static_cast<double>(m_totalValidation);
+            }
+
+            
+        }
+    }
+
+    void
+    BlockchainNode::AfterBlockValidation(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int height = newBlock.GetBlockHeight();
+        int minerId = newBlock.GetMinerId();
+        std::ostringstream  stringStream;
+        std::string         blockHash = stringStream.str();
+
+        stringStream << height << "/" << minerId;
+        blockHash = stringStream.str();
+
+        RemoveReceivedButNotvalidated(blockHash);
+
+        NS_LOG_INFO("AfterBlockValidation : at time " << Simulator::Now().GetSeconds()
+                    << "s blockchain node " << GetNode()->GetId()
+                    << " validated block ");
+
+        if(m_blockchain.IsOrphan(newBlock))
+        {
+            NS_LOG_INFO("AfterBlockValidation: Block was orphan");
+             m_blockchain.RemoveOrphan(newBlock);
+        }
+
+        m_meanBlockReceiveTime = (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks())*m_meanBlockReceiveTime
+                                + (newBlock.GetTimeReceived() - m_previousBlockReceiveTime)/(m_blockchain.GetTotalBlocks());
+        //std::cout << "m_meanBlockReceiveTime : "<<m_meanBlockReceiveTime <<"\n";
+        m_previousBlockReceiveTime = newBlock.GetTimeReceived();
+        
+        m_meanBlockPropagationTime =  (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks())*m_meanBlockPropagationTime
+                                + (newBlock.GetTimeReceived() -newBlock.GetTimeStamp())/(m_blockchain.GetTotalBlocks());
+        //std::cout << " m_meanBlockPropagationTime : "<< m_meanBlockPropagationTime <<"\n";
+        m_meanBlockSize = (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks()) * m_meanBlockSize
+                            + (newBlock.GetBlockSizeBytes())/static_cast<double>(m_blockchain.GetTotalBlocks());
+        
+        Block previousTop = *m_blockchain.GetCurrentTopBlock();
+
+        m_blockchain.AddBlock(newBlock);
+
+        /*
+         * The fork choice rule may have moved the tip to the new block, or to another branch
+         */
+        if(!(previousTop == *m_blockchain.GetCurrentTopBlock()))
+        {
+            ReceivedHigherBlock(*m_blockchain.GetCurrentTopBlock());
+        }
+
+        AdvertiseNewBlock(newBlock);
+        ValidateOrphanChildren(newBlock);
+        
+
+    }
+
+    void
+    BlockchainNode::ValidateOrphanChildren(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::vector<const Block *> children = m_blockchain.GetOrpharnChildrenPointer(newBlock);
+
+        if(children.size() == 0)
+        {
+            NS_LOG_INFO("ValidateOrphanChildren : Block has no orpharn children\n");
+        }
+        else
+        {
+            NS_LOG_INFO("ValidateOrphanChildren : Block has orpharn children:");
+            std::vector<const Block *>::iterator block_it;
+            for(block_it = children.begin(); block_it < children.end(); block_it++)
+            {
+                ValidateBlock(**block_it);
+            }
+        }
+    }
+
+    void
+    BlockchainNode::AddBlockHeader(rapidjson::Document &d, rapidjson::Value &array, const Block &block)
+    {
+        rapidjson::Value value;
+        rapidjson::Value blockInfo(rapidjson::kObjectType);
+
+        value = block.GetBlockHeight();
+        blockInfo.AddMember("height", value, d.GetAllocator());
+
+        value = block.GetMinerId();
+        blockInfo.AddMember("minerId", value, d.GetAllocator());
+
+        value = block.GetNonce();
+        blockInfo.AddMember("nonce", value, d.GetAllocator());
+
+        value = block.GetParentBlockMinerId();
+        blockInfo.AddMember("parentBlockMinerId", value, d.GetAllocator());
+
+        value = block.GetBlockSizeBytes();
+        blockInfo.AddMember("size", value, d.GetAllocator());
+
+        value = block.GetTimeStamp();
+        blockInfo.AddMember("timeStamp", value, d.GetAllocator());
+
+        value = block.GetTimeReceived();
+        blockInfo.AddMember("timeReceived", value, d.GetAllocator());
+
+        AddHeaderExtensions(d, blockInfo, block);
+
+        array.PushBack(blockInfo, d.GetAllocator());
+    }
+
+    void
+    BlockchainNode::AddHeaderExtensions(rapidjson::Document &d, rapidjson::Value &blockInfo, const Block &block)
+    {
+        std::vector<std::pair<int, int>>    uncles = block.GetUncles();
+        rapidjson::Value                    value;
+        rapidjson::Value                    uncleArray(rapidjson::kArrayType);
+
+        if(block.GetDifficulty() != 1)
+        {
+            value = block.GetDifficulty();
+            blockInfo.AddMember("difficulty", value, d.GetAllocator());
+        }
+
+        if(uncles.empty())
+            return;
+
+        for(auto it = uncles.begin(); it != uncles.end(); it++)
+        {
+            rapidjson::Value uncleInfo(rapidjson::kObjectType);
+
+            value = it->first;
+            uncleInfo.AddMember("height", value, d.GetAllocator());
+
+            value = it->second;
+            uncleInfo.AddMember("minerId", value, d.GetAllocator());
+
+            uncleArray.PushBack(uncleInfo, d.GetAllocator());
+        }
+        blockInfo.AddMember("uncles", uncleArray, d.GetAllocator());
+    }
+
+    void
+    BlockchainNode::ReadHeaderExtensions(const rapidjson::Value &blockInfo, Block &block)
+    {
+        if(blockInfo.HasMember("difficulty"))
+            block.SetDifficulty(blockInfo["difficulty"].GetDouble());
+
+        if(!blockInfo.HasMember("uncles"))
+            return;
+
+        for(unsigned int i = 0; i < blockInfo["uncles"].Size(); i++)
+            block.AddUncle(blockInfo["uncles"][i]["height"].GetInt(), blockInfo["uncles"][i]["minerId"].GetInt());
+    }
+
+    void
+    BlockchainNode::AdvertiseNewBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+        
+        rapidjson::Document d;
+        rapidjson::Value value;
+        rapidjson::Value array(rapidjson::kArrayType);
+        std::ostringstream stringStream;
+        std::string blockHash = stringStream.str();
+        d.SetObject();
+
+        if(m_blockTorrent)
+        {
+            AdvertiseFullBlock(newBlock);
+            return;
+        }
+
+        if(m_compactBlockMode == HIGH_BANDWIDTH_COMPACT)
+        {
+            /*
+             * High-bandwidth mode : the compact block itself announces the block
+             */
+            for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin() ; i != m_peersAddresses.end(); ++i)
+            {
+                if(*i != newBlock.GetReceivedFromIpv4())
+                {
+                    Address peer = InetSocketAddress(*i, m_blockchainPort);
+                    QueueCompactBlock(newBlock, peer);
+                }
+            }
+            return;
+        }
+
+        if(m_trickleInterval > 0 && m_protocolType == STANDARD_PROTOCOL)
+        {
+            /*
+             * The INV leaves with the next trickle of each peer, together with the other pending announcements
+             */
+            stringStream << newBlock.GetBlockHeight() << "/" << newBlock.GetMinerId();
+
+            for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin() ; i != m_peersAddresses.end(); ++i)
+            {
+                if(*i != newBlock.GetReceivedFromIpv4() && m_trickleQueue.AddBlock(*i, stringStream.str()))
+                    ScheduleTrickle(*i);
+            }
+            return;
+        }
+
+        value.SetString("blocks");
+        d.AddMember("type", value, d.GetAllocator());
+
+        if(m_protocolType == STANDARD_PROTOCOL)
+        {
+            value = INV;
+            d.AddMember("message", value, d.GetAllocator());
+
+            stringStream << newBlock.GetBlockHeight() << "/" << newBlock.GetMinerId();
+            blockHash = stringStream.str();
+            value.SetString(blockHash.c_str(), blockHash.size(), d.GetAllocator());
+            array.PushBack(value, d.GetAllocator());
+            d.AddMember("inv", array, d.GetAllocator());
+        }
+        else if(m_protocolType == SENDHEADERS)
+        {
+            /*
+             * The headers are pushed directly, so the peers skip the GET_HEADERS round trip
+             */
+            value = HEADERS;
+            d.AddMember("message", value, d.GetAllocator());
+            d["type"].SetString("announcement");
+
+            AddBlockHeader(d, array, newBlock);
+            d.AddMember("blocks", array, d.GetAllocator());
+        }
+
+        rapidjson::StringBuffer packetInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+        d.Accept(writer);
+
+        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin() ; i != m_peersAddresses.end(); ++i)
+        {
+            if(*i != newBlock.GetReceivedFromIpv4())
+            {
+                const uint8_t delimiter[] = "#";
+                //std::cout<<"node : " <<GetNode()->GetId()<< " Advertise new block\n";
+                m_peersSockets[*i]->Send(reinterpret_cast<const uint8_t*>(packetInfo.GetString()), packetInfo.GetSize(), 0);
+                m_peersSockets[*i]->Send(delimiter, 1, 0);
+
+                if(m_protocolType == STANDARD_PROTOCOL)
+                {
+                    m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes;
+                    m_nodeStats->announcementSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes;
+                }
+                else if(m_protocolType == SENDHEADERS)
+                {
+                    m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                    m_nodeStats->announcementSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                }
+                NS_LOG_INFO("AdvertiseNewBlock: At time " << Simulator::Now().GetSeconds()
+                            << "s blockchain node " << GetNode()->GetId() << " advertised a new block to " << *i);
+
+            }
+        }
+        /*
+        if( GetNode()->GetId() == 5){
+            std::cout<< "AdvertiseNeBlock: At time " << Simulator::Now().GetSeconds()
+                            << "s blockchain node " << GetNode()->GetId() << " advertised a new block(height) :" 
+                            << newBlock.GetBlockHeight() << " minerId : " << newBlock.GetMinerId() <<"\n";
+        }
+        */
+        
+    }
+
+    void
+    BlockchainNode::AdvertiseNewTransaction(const Transaction &newTrans, enum Messages megType, Ipv4Address receivedFromIpv4, int ttl)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(ttl == 0)
+        {
+            NS_LOG_INFO("AdvertiseNewTransaction : the TTL of the " << getMessageName(megType) << " of transaction " << newTrans.GetTransId()
+                        << " from node " << newTrans.GetTransNodeId() << " expired at node " << GetNode()->GetId());
+            m_nodeStats->gossipTtlExpired++;
+            return;
+        }
+
+        rapidjson::Document transD;
+
+        int nodeId = newTrans.GetTransNodeId();
+        int transId = newTrans.GetTransId();
+        double tranTimestamp = newTrans.GetTransTimeStamp();
+
+        transD.SetObject();
+
+        rapidjson::Value value;
+        rapidjson::Value array(rapidjson::kArrayType);
+        rapidjson::Value transInfo(rapidjson::kObjectType);
+
+        value.SetString("transaction");
+        transD.AddMember("type", value, transD.GetAllocator());
+
+        value = megType;
+        transD.AddMember("message", value, transD.GetAllocator());
+
+        value = newTrans.GetTransNodeId();
+        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransId();
+        transInfo.AddMember("transId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransTimeStamp();
+        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+
+        value = newTrans.IsValidated();
+        transInfo.AddMember("validation", value, transD.GetAllocator());
+
+        value = newTrans.GetExecution();
+        transInfo.AddMember("execution", value, transD.GetAllocator());
+
+        value = newTrans.GetFee();
+        transInfo.AddMember("fee", value, transD.GetAllocator());
+
+        value = newTrans.GetTransSizeByte();
+        transInfo.AddMember("size", value, transD.GetAllocator());
+
+        if(ttl > 0)
+        {
+            value = ttl;
+            transInfo.AddMember("ttl", value, transD.GetAllocator());
+        }
+
+        array.PushBack(transInfo, transD.GetAllocator());
+        transD.AddMember("transactions", array, transD.GetAllocator());
+
+        rapidjson::StringBuffer transactionInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
+        transD.Accept(tranWriter);
+
+        //std::cout<<"Type : " << m_committerType << " nodeId : " << GetNode()->GetId() <<" broadcaste " << megType <<"\n";
+
+        if(m_reconciliationInterval > 0)
+        {
+            /*
+             * The peers we do not flood to will learn about the transaction at their next reconciliation with us
+             */
+            uint64_t id = GetReconciliationId(megType, newTrans);
+
+            KeepRelayMessage(id, transactionInfo.GetString(), GetTransactionPayloadBytes(megType, newTrans));
+
+            for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
+            {
+                if(*i == receivedFromIpv4)
+                    continue;
+
+                if(std::find(m_floodPeers.begin(), m_floodPeers.end(), *i) != m_floodPeers.end())
+                    RelayTransaction(transactionInfo.GetString(), megType, newTrans, *i, ttl);
+                else
+                    m_reconciliationSets[*i].insert(id);
+            }
+            return;
+        }
+
+        GossipTransaction(transactionInfo.GetString(), megType, newTrans, receivedFromIpv4, ttl);
+
+    }
+
+    bool
+    BlockchainNode::HasTransaction(int nodeId, int transId)
+    {
+        for(auto const &transaction: m_transaction)
+        {
+            if(transaction.GetTransNodeId() == nodeId && transaction.GetTransId() == transId)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool
+    BlockchainNode::HasReplyTransaction(int nodeId, int transId, int transExecution)
+    {
+        return m_seenMessages.Contains(BlockchainSeenCache::MakeKey(REPLY_TRANS, nodeId, transId, transExecution));
+    }
+
+    bool
+    BlockchainNode::HasMessageTransaction(int nodeId, int transId)
+    {
+        return m_seenMessages.Contains(BlockchainSeenCache::MakeKey(MSG_TRANS, nodeId, transId, 0));
+    }
+
+    bool
+    BlockchainNode::HasResultTransaction(int nodeId, int transId)
+    {
+        return m_seenMessages.Contains(BlockchainSeenCache::MakeKey(RESULT_TRANS, nodeId, transId, 0));
+    }
+
+    bool
+    BlockchainNode::HasTransactionAndValidated(int nodeId, int transId)
+    {
+        for(auto const &transaction: m_transaction)
+        {
+            if(transaction.GetTransNodeId() == nodeId && transaction.GetTransId() == transId && transaction.IsValidated() == true)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void
+    BlockchainNode::CreateTransaction()
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document transD;
+
+        int nodeId = GetNode()->GetId();
+        int transId = m_transactionId;
+        double tranTimestamp = Simulator::Now().GetSeconds();
+        transD.SetObject();
+
+        Transaction newTrans(nodeId, transId, tranTimestamp);
+
+        newTrans.SetTransSizeByte(DrawTransactionSize());
+        m_nodeStats->meanTransactionSize = (m_nodeStats->meanTransactionSize*m_nodeStats->transactionsCreated + newTrans.GetTransSizeByte())
+                                            / (m_nodeStats->transactionsCreated + 1);
+
+        if(m_transactionFeeMean > 0)
+            newTrans.SetFee(-m_transactionFeeMean * std::log((rand() + 1.0) / (RAND_MAX + 2.0)));
+
+        rapidjson::Value value;
+        rapidjson::Value array(rapidjson::kArrayType);
+        rapidjson::Value transInfo(rapidjson::kObjectType);
+
+        value.SetString("transaction");
+        transD.AddMember("type", value, transD.GetAllocator());
+
+        value = REQUEST_TRANS;
+        transD.AddMember("message", value, transD.GetAllocator());
+
+        value = newTrans.GetTransNodeId();
+        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransId();
+        transInfo.AddMember("transId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransTimeStamp();
+        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+
+        value = newTrans.IsValidated();
+        transInfo.AddMember("validation", value, transD.GetAllocator());
+
+        value = newTrans.GetExecution();
+        transInfo.AddMember("execution", value, transD.GetAllocator());
+
+        value = newTrans.GetFee();
+        transInfo.AddMember("fee", value, transD.GetAllocator());
+
+        value = newTrans.GetTransSizeByte();
+        transInfo.AddMember("size", value, transD.GetAllocator());
+
+        int ttl = GetGossipTtl();
+
+        if(ttl > 0)
+        {
+            value = ttl;
+            transInfo.AddMember("ttl", value, transD.GetAllocator());
+        }
+
+        array.PushBack(transInfo, transD.GetAllocator());
+        transD.AddMember("transactions", array, transD.GetAllocator());
+
+        m_transaction.push_back(newTrans);
+        m_seenMessages.Insert(BlockchainSeenCache::MakeKey(REQUEST_TRANS, newTrans.GetTransNodeId(), newTrans.GetTransId(), 0));
+        //m_notValidatedTransaction.push_back(newTrans);
+
+        rapidjson::StringBuffer transactionInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
+        transD.Accept(tranWriter);
+
+        GossipTransaction(transactionInfo.GetString(), REQUEST_TRANS, newTrans, Ipv4Address(), ttl);
+        m_nodeStats->transactionsCreated++;
+        //std::cout<< "time : "<<Simulator::Now().GetSeconds() << ", Node type: "<< m_committerType <<" - NodeId: " <<GetNode()->GetId() << " created and sent transaction\n";
+        m_transactionId++;
+
+        ScheduleNextTransaction();
+
+    }
+
+    void
+    BlockchainNode::ScheduleNextTransaction()
+    {
+        NS_LOG_FUNCTION(this);
+        double tTime = rand()%m_creatingTransactionTime+1;
+        //std::cout<<"crateing time = " << tTime << "\n";
+        m_nextTransaction = Simulator::Schedule(Seconds(tTime), &BlockchainNode::CreateTransaction, this);
+
+    }
+
+    void
+    BlockchainNode::ExecuteTransaction(const Transaction &newTrans, Ipv4Address receivedFromIpv4)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document transD;
+
+        int nodeId = newTrans.GetTransNodeId();
+        int transId = newTrans.GetTransId();
+        double tranTimestamp = newTrans.GetTransTimeStamp();
+
+        //newTrans.SetExecution();
+        transD.SetObject();
+
+        rapidjson::Value value;
+        rapidjson::Value array(rapidjson::kArrayType);
+        rapidjson::Value transInfo(rapidjson::kObjectType);
+
+        value.SetString("transaction");
+        transD.AddMember("type", value, transD.GetAllocator());
+
+        value = REPLY_TRANS;
+        transD.AddMember("message", value, transD.GetAllocator());
+
+        value = newTrans.GetTransNodeId();
+        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransId();
+        transInfo.AddMember("transId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransTimeStamp();
+        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+
+        value = newTrans.IsValidated();
+        transInfo.AddMember("validation", value, transD.GetAllocator());
+        
+        value = newTrans.GetExecution();
+        transInfo.AddMember("execution", value, transD.GetAllocator());
+
+        value = newTrans.GetFee();
+        transInfo.AddMember("fee", value, transD.GetAllocator());
+
+        value = newTrans.GetTransSizeByte();
+        transInfo.AddMember("size", value, transD.GetAllocator());
+
+        int ttl = GetGossipTtl();
+
+        if(ttl > 0)
+        {
+            value = ttl;
+            transInfo.AddMember("ttl", value, transD.GetAllocator());
+        }
+
+        array.PushBack(transInfo, transD.GetAllocator());
+        transD.AddMember("transactions", array, transD.GetAllocator());
+
+        rapidjson::StringBuffer transactionInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
+        transD.Accept(tranWriter);
+
+        SendTransactionMessage(transactionInfo.GetString(), GetTransactionPayloadBytes(REPLY_TRANS, newTrans), receivedFromIpv4);
+
+    }
+
+    void
+    BlockchainNode::NotifyTransaction(const Transaction &newTrans)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document transD;
+
+        int nodeId = newTrans.GetTransNodeId();
+        int transId = newTrans.GetTransId();
+        double tranTimestamp = newTrans.GetTransTimeStamp();
+
+        transD.SetObject();
+
+        rapidjson::Value value;
+        rapidjson::Value array(rapidjson::kArrayType);
+        rapidjson::Value transInfo(rapidjson::kObjectType);
+
+        value.SetString("transaction");
+        transD.AddMember("type", value, transD.GetAllocator());
+
+        value = RESULT_TRANS;
+        transD.AddMember("message", value, transD.GetAllocator());
+
+        value = newTrans.GetTransNodeId();
+        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransId();
+        transInfo.AddMember("transId", value, transD.GetAllocator());
+
+        value = newTrans.GetTransTimeStamp();
+        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+
+        value = newTrans.IsValidated();
+        transInfo.AddMember("validation", value, transD.GetAllocator());
+        
+        value = newTrans.GetExecution();
+        transInfo.AddMember("execution", value, transD.GetAllocator());
+
+        value = newTrans.GetFee();
+        transInfo.AddMember("fee", value, transD.GetAllocator());
+
+        value = newTrans.GetTransSizeByte();
+        transInfo.AddMember("size", value, transD.GetAllocator());
+
+        int ttl = GetGossipTtl();
+
+        if(ttl > 0)
+        {
+            value = ttl;
+            transInfo.AddMember("ttl", value, transD.GetAllocator());
+        }
+
+        array.PushBack(transInfo, transD.GetAllocator());
+        transD.AddMember("transactions", array, transD.GetAllocator());
+
+        rapidjson::StringBuffer transactionInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
+        transD.Accept(tranWriter);
+
+        GossipTransaction(transactionInfo.GetString(), RESULT_TRANS, newTrans, Ipv4Address(), ttl);
+
+    }
+
+
+
+    void
+    BlockchainNode::SendMessage(enum Messages receivedMessage, enum Messages responseMessage, rapidjson::Document &d, Ptr<Socket> outgoingSocket)
+    {
+        NS_LOG_FUNCTION(this);
+
+        const uint8_t delimiter[] = "#";
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        d["message"].SetInt(responseMessage);
+        d.Accept(writer);
+        NS_LOG_INFO("Node " << GetNode()->GetId() << " got a "
+                    << getMessageName(receivedMessage) << " message "
+                    << " and sent a " << getMessageName(responseMessage)
+                    << " message: " << buffer.GetString() );
+        
+        outgoingSocket->Send(reinterpret_cast<const uint8_t*>(buffer.GetString()), buffer.GetSize(), 0);
+        outgoingSocket->Send(delimiter, 1, 0);
+
+        switch(d["message"].GetInt())
+        {
+            case INV:
+            {
+                m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size() * m_inventorySizeBytes;
+                break;
+            }
+            case REQUEST_TRANS:
+            {
+                break;
+            }
+            case GET_HEADERS:
+            {
+                m_nodeStats->getHeadersSentBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
+                break;
+            }
+            case HEADERS:
+            {
+                m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                break;
+            }
+            case GET_DATA:
+            {
+                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size() * m_inventorySizeBytes;
+                break;
+            }
+            case BLOCK:
+            {
+                for(uint16_t k = 0; k < d["blocks"].Size(); k++)
+                {
+                    m_nodeStats->blockSentBytes +=  d["blocks"][k]["size"].GetInt();
+                }
+                m_nodeStats->blockSentBytes += m_blockchainMessageHeader;
+                break;
+            }
+            case CMPCT_BLOCK:
+            case BLOCK_TXN:
+            {
+                m_nodeStats->compactBlockSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GET_BLOCK_TXN:
+            {
+                m_nodeStats->compactBlockSentBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes + d["indexes"].Size()*m_transactionIndexSize;
+                break;
+            }
+            case CHUNK_INV:
+            {
+                m_nodeStats->announcementSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GET_CHUNK:
+            {
+                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes + d["chunks"].Size()*m_countBytes;
+                break;
+            }
+            case CHUNK:
+            {
+                m_nodeStats->chunkSentBytes += d["size"].GetInt();
+                break;
+            }
+            case CODED_CHUNK:
+            {
+                m_nodeStats->codedChunkSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GRAPHENE_BLOCK:
+            {
+                m_nodeStats->grapheneSentBytes += d["size"].GetInt();
+                break;
+            }
+            case REQ_RECON:
+            {
+                m_nodeStats->reconciliationSentBytes += m_blockchainMessageHeader + 2*m_countBytes + m_shortIdNonceSizeBytes;
+                break;
+            }
+            case SKETCH:
+            {
+                m_nodeStats->reconciliationSentBytes += d["size"].GetInt();
+                break;
+            }
+            case RECON_DIFF:
+            {
+                m_nodeStats->reconciliationSentBytes += m_blockchainMessageHeader + m_countBytes + d["ids"].Size()*BlockchainCompactBlock::m_shortIdSizeBytes;
+                break;
+            }
+            case TRANS_INV:
+            {
+                m_nodeStats->gossipPullSentBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
+                break;
+            }
+            case GET_TRANS:
+            {
+                m_nodeStats->gossipPullSentBytes += m_blockchainMessageHeader + m_countBytes + d["ids"].Size()*BlockchainCompactBlock::m_shortIdSizeBytes;
+                break;
+            }
+            case PBFT_PRE_PREPARE:
+            case PBFT_PREPARE:
+            case PBFT_COMMIT:
+            case PBFT_VIEW_CHANGE:
+            case PBFT_NEW_VIEW:
+            case RAFT_APPEND:
+            case RAFT_ACK:
+            case RAFT_VOTE_REQUEST:
+            case RAFT_VOTE:
+            case HOTSTUFF_PROPOSAL:
+            case HOTSTUFF_VOTE:
+            case HOTSTUFF_NEW_VIEW:
+            {
+                m_nodeStats->consensusMessagesSent++;
+                m_nodeStats->consensusSentBytes += d["size"].GetInt();
+                break;
+            }
+        }
+
+    }
+
+    void
+    BlockchainNode::SendMessage(enum Messages receivedMessage, enum Messages responseMessage, rapidjson::Document &d, Address &outgoingAddress)
+    {
+        NS_LOG_FUNCTION(this);
+        
+        const uint8_t delimiter[] = "#";
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        d["message"].SetInt(responseMessage);
+        d.Accept(writer);
+        NS_LOG_INFO("Node " << GetNode()->GetId() << " got a "
+                    << getMessageName(receivedMessage) << " message "
+                    << " and sent a " << getMessageName(responseMessage)
+                    << " message: " << buffer.GetString() );
+        
+        Ipv4Address outgoingIpv4Address = InetSocketAddress::ConvertFrom(outgoingAddress).GetIpv4();
+        std::map<Ipv4Address, Ptr<Socket>>::iterator it = m_peersSockets.find(outgoingIpv4Address);
+
+        if(it == m_peersSockets.end())
+        {
+            m_peersSockets[outgoingIpv4Address] = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+            m_peersSockets[outgoingIpv4Address]->Connect(InetSocketAddress(outgoingIpv4Address, m_blockchainPort));
+        }
+
+        m_peersSockets[outgoingIpv4Address]->Send(reinterpret_cast<const uint8_t*>(buffer.GetString()), buffer.GetSize(), 0);
+        m_peersSockets[outgoingIpv4Address]->Send(delimiter, 1, 0);
+        
+        switch(d["message"].GetInt())
+        {
+            case INV:
+            {
+                m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size() * m_inventorySizeBytes;
+                break;
+            }
+            case REQUEST_TRANS:
+            {
+                break;
+            }
+            case GET_HEADERS:
+            {
+                m_nodeStats->getHeadersSentBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
+                break;
+            }
+            case HEADERS:
+            {
+                m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                break;
+            }
+            case GET_DATA:
+            {
+                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size() * m_inventorySizeBytes;
+                break;
+            }
+            case BLOCK:
+            {
+                //std::cout<<"start add block size"<<"\n";
+                for(int k = 0; k < d["blocks"].Size(); k++)
+                {
+                    m_nodeStats->blockSentBytes +=  d["blocks"][k]["size"].GetInt();
+                }
+                m_nodeStats->blockSentBytes += m_blockchainMessageHeader;
+                //std::cout<<"finish add block size"<<"\n";
+                break;
+            }
+            case CMPCT_BLOCK:
+            case BLOCK_TXN:
+            {
+                m_nodeStats->compactBlockSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GET_BLOCK_TXN:
+            {
+                m_nodeStats->compactBlockSentBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes + d["indexes"].Size()*m_transactionIndexSize;
+                break;
+            }
+            case CHUNK_INV:
+            {
+                m_nodeStats->announcementSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GET_CHUNK:
+            {
+                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes + d["chunks"].Size()*m_countBytes;
+                break;
+            }
+            case CHUNK:
+            {
+                m_nodeStats->chunkSentBytes += d["size"].GetInt();
+                break;
+            }
+            case CODED_CHUNK:
+            {
+                m_nodeStats->codedChunkSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GRAPHENE_BLOCK:
+            {
+                m_nodeStats->grapheneSentBytes += d["size"].GetInt();
+                break;
+            }
+            case REQ_RECON:
+            {
+                m_nodeStats->reconciliationSentBytes += m_blockchainMessageHeader + 2*m_countBytes + m_shortIdNonceSizeBytes;
+                break;
+            }
+            case SKETCH:
+            {
+                m_nodeStats->reconciliationSentBytes += d["size"].GetInt();
+                break;
+            }
+            case RECON_DIFF:
+            {
+                m_nodeStats->reconciliationSentBytes += m_blockchainMessageHeader + m_countBytes + d["ids"].Size()*BlockchainCompactBlock::m_shortIdSizeBytes;
+                break;
+            }
+            case TRANS_INV:
+            {
+                m_nodeStats->gossipPullSentBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
+                break;
+            }
+            case GET_TRANS:
+            {
+                m_nodeStats->gossipPullSentBytes += m_blockchainMessageHeader + m_countBytes + d["ids"].Size()*BlockchainCompactBlock::m_shortIdSizeBytes;
+                break;
+            }
+            case PBFT_PRE_PREPARE:
+            case PBFT_PREPARE:
+            case PBFT_COMMIT:
+            case PBFT_VIEW_CHANGE:
+            case PBFT_NEW_VIEW:
+            case RAFT_APPEND:
+            case RAFT_ACK:
+            case RAFT_VOTE_REQUEST:
+            case RAFT_VOTE:
+            case HOTSTUFF_PROPOSAL:
+            case HOTSTUFF_VOTE:
+            case HOTSTUFF_NEW_VIEW:
+            {
+                m_nodeStats->consensusMessagesSent++;
+                m_nodeStats->consensusSentBytes += d["size"].GetInt();
+                break;
+            }
+        }
+    }
+
+    void
+    BlockchainNode::SendMessage(enum Messages receivedMessage, enum Messages responseMessage, std::string packet, Address &outgoingAddress)
+    {
+        NS_LOG_FUNCTION(this);
+        
+        const uint8_t delimiter[] = "#";
+        rapidjson::Document d;
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        d.Parse(packet.c_str());
+        d["message"].SetInt(responseMessage);
+        d.Accept(writer);
+        NS_LOG_INFO("Node " << GetNode()->GetId() << " got a "
+                    << getMessageName(receivedMessage) << " message "
+                    << " and sent a " << getMessageName(responseMessage)
+                    << " message: " << buffer.GetString() );
+        
+        Ipv4Address outgoingIpv4Address = InetSocketAddress::ConvertFrom(outgoingAddress).GetIpv4();
+        std::map<Ipv4Address, Ptr<Socket>>::iterator it = m_peersSockets.find(outgoingIpv4Address);
+
+        if(it == m_peersSockets.end())
+        {
+            m_peersSockets[outgoingIpv4Address] = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+            m_peersSockets[outgoingIpv4Address]->Connect(InetSocketAddress(outgoingIpv4Address, m_blockchainPort));
+        }
+
+        m_peersSockets[outgoingIpv4Address]->Send(reinterpret_cast<const uint8_t*>(buffer.GetString()), buffer.GetSize(), 0);
+        m_peersSockets[outgoingIpv4Address]->Send(delimiter, 1, 0);
+        
+        switch(d["message"].GetInt())
+        {
+            case INV:
+            {
+                m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size() * m_inventorySizeBytes;
+                break;
+            }
+            case REQUEST_TRANS:
+            {
+                break;
+            }
+            case GET_HEADERS:
+            {
+                m_nodeStats->getHeadersSentBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
+                break;
+            }
+            case HEADERS:
+            {
+                m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                break;
+            }
+            case GET_DATA:
+            {
+                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size() * m_inventorySizeBytes;
+                break;
+            }
+            case BLOCK:
+            {
+                for(uint16_t k = 0; k < d["blocks"].Size(); k++)
+                {
+                    m_nodeStats->blockSentBytes +=  d["blocks"][k]["size"].GetInt();
+                }
+                m_nodeStats->blockSentBytes += m_blockchainMessageHeader;
+                break;
+            }
+            case CMPCT_BLOCK:
+            case BLOCK_TXN:
+            {
+                m_nodeStats->compactBlockSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GET_BLOCK_TXN:
+            {
+                m_nodeStats->compactBlockSentBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes + d["indexes"].Size()*m_transactionIndexSize;
+                break;
+            }
+            case CHUNK_INV:
+            {
+                m_nodeStats->announcementSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GET_CHUNK:
+            {
+                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes + d["chunks"].Size()*m_countBytes;
+                break;
+            }
+            case CHUNK:
+            {
+                m_nodeStats->chunkSentBytes += d["size"].GetInt();
+                break;
+            }
+            case CODED_CHUNK:
+            {
+                m_nodeStats->codedChunkSentBytes += d["size"].GetInt();
+                break;
+            }
+            case GRAPHENE_BLOCK:
+            {
+                m_nodeStats->grapheneSentBytes += d["size"].GetInt();
+                break;
+            }
+            case REQ_RECON:
+            {
+                m_nodeStats->reconciliationSentBytes += m_blockchainMessageHeader + 2*m_countBytes + m_shortIdNonceSizeBytes;
+                break;
+            }
+            case SKETCH:
+            {
+                m_nodeStats->reconciliationSentBytes += d["size"].GetInt();
+                break;
+            }
+            case RECON_DIFF:
+            {
+                m_nodeStats->reconciliationSentBytes += m_blockchainMessageHeader + m_countBytes + d["ids"].Size()*BlockchainCompactBlock::m_shortIdSizeBytes;
+                break;
+            }
+            case TRANS_INV:
+            {
+                m_nodeStats->gossipPullSentBytes += m_blockchainMessageHeader + m_countBytes + d["transactions"].Size()*m_inventorySizeBytes;
+                break;
+            }
+            case GET_TRANS:
+            {
+                m_nodeStats->gossipPullSentBytes += m_blockchainMessageHeader + m_countBytes + d["ids"].Size()*BlockchainCompactBlock::m_shortIdSizeBytes;
+                break;
+            }
+            case PBFT_PRE_PREPARE:
+            case PBFT_PREPARE:
+            case PBFT_COMMIT:
+            case PBFT_VIEW_CHANGE:
+            case PBFT_NEW_VIEW:
+            case RAFT_APPEND:
+            case RAFT_ACK:
+            case RAFT_VOTE_REQUEST:
+            case RAFT_VOTE:
+            case HOTSTUFF_PROPOSAL:
+            case HOTSTUFF_VOTE:
+            case HOTSTUFF_NEW_VIEW:
+            {
+                m_nodeStats->consensusMessagesSent++;
+                m_nodeStats->consensusSentBytes += d["size"].GetInt();
+                break;
+            }
+        }
+
+    }
+
+    void
+    BlockchainNode::InvTimeoutExpired(std::string blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+        
+        std::string     invDelimiter = "/";
+        size_t          invPos = blockHash.find(invDelimiter);
+
+        int height = atoi(blockHash.substr(0, invPos).c_str());
+        int minerId = atoi(blockHash.substr(invPos+1, blockHash.size()).c_str());
+
+        NS_LOG_INFO("Node " << GetNode()->GetId() << " : At time " << Simulator::Now().GetSeconds()
+                    << " the timeour for block " << blockHash << " expired");
+
+        /*
+        std::cout<<"Node " << GetNode()->GetId() << " : At time " << Simulator::Now().GetSeconds()
+                    << " the timeour for block " << blockHash << " expired\n"; */           
+
+        m_nodeStats->blockTimeouts++;
+        m_peerMonitor.RequestTimedOut(blockHash);
+        RemoveBlockRequest(blockHash);
+
+        m_queueInv[blockHash].erase(m_queueInv[blockHash].begin());
+
+        if(!m_queueInv[blockHash].empty() && !m_blockchain.HasBlock(height, minerId)
+            && !m_blockchain.IsOrphan(height, minerId) && !ReceivedButNotValidated(blockHash))
+        {
+            m_nodeStats->blockRefetches++;
+            RequestBlocks(std::vector<std::string>(1, blockHash));
+        }
+        else
+        {
+            m_queueInv.erase(blockHash);
+            m_announcementTimes.erase(blockHash);
+        }
+
+        ProcessPendingRequests();
+    }
+
+    void
+    BlockchainNode::StallTimeoutExpired(std::string blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_stallTimeouts.erase(blockHash);
+
+        if(!m_downloadScheduler.IsInFlight(blockHash) || m_queueInv.find(blockHash) == m_queueInv.end())
+            return;
+
+        Ipv4Address                 stalledPeer = m_downloadScheduler.GetPeer(blockHash);
+        double                      stalledThroughput = m_peerMonitor.GetThroughput(stalledPeer, GetPriorThroughput(stalledPeer));
+        std::vector<Address>        &announcers = m_queueInv[blockHash];
+        std::vector<Ipv4Address>    candidates;
+        std::vector<double>         throughputs;
+        std::vector<int>            positions;
+        int                         blockSize = OnlyHeadersReceived(blockHash) ? m_onlyHeadersReceived[blockHash].GetBlockSizeBytes() : 0;
+        int                         expectedSize = GetExpectedBlockSize(blockHash);
+
+        /*
+         * Only the announcers faster than the stalled peer are worth a second request
+         */
+        for(unsigned int i = 0; i < announcers.size(); i++)
+        {
+            Ipv4Address peer = InetSocketAddress::ConvertFrom(announcers[i]).GetIpv4();
+            double      throughput = m_peerMonitor.GetThroughput(peer, GetPriorThroughput(peer));
+
+            if(peer != stalledPeer && throughput > stalledThroughput)
+            {
+                candidates.push_back(peer);
+                throughputs.push_back(throughput);
+                positions.push_back(i);
+            }
+        }
+
+        int selected = m_downloadScheduler.SelectPeer(candidates, throughputs, expectedSize);
+
+        if(selected < 0)
+        {
+            NS_LOG_INFO("StallTimeoutExpired : Node " << GetNode()->GetId() << " block " << blockHash
+                        << " is slow but no faster peer is available");
+            return;
+        }
+
+        NS_LOG_INFO("StallTimeoutExpired : Node " << GetNode()->GetId() << " reissues block " << blockHash
+                    << " from " << stalledPeer << " to " << candidates[selected]);
+
+        std::swap(announcers[0], announcers[positions[selected]]);
+
+        m_nodeStats->earlyReissues++;
+        m_downloadScheduler.RequestIssued(blockHash, candidates[selected], expectedSize);
+        m_peerMonitor.RequestSent(blockHash, candidates[selected]);
+        ArmInvTimeout(blockHash, candidates[selected], blockSize);
+        ArmStallTimeout(blockHash, candidates[selected], expectedSize);
+
+        SendBlockRequest(std::vector<std::string>(1, blockHash), announcers[0]);
+        ProcessPendingRequests();
+    }
+
+    void
+    BlockchainNode::RequestBlocks(const std::vector<std::string> &blockHashes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::map<Ipv4Address, std::vector<std::string>>     requests;
+        std::map<Ipv4Address, Address>                      addresses;
+
+        for(auto hash = blockHashes.begin(); hash != blockHashes.end(); hash++)
+        {
+            std::vector<Address>        &announcers = m_queueInv[*hash];
+            std::vector<Ipv4Address>    candidates;
+            std::vector<double>         throughputs;
+            int                         blockSize = OnlyHeadersReceived(*hash) ? m_onlyHeadersReceived[*hash].GetBlockSizeBytes() : 0;
+            int                         expectedSize = GetExpectedBlockSize(*hash);
+
+            for(auto it = announcers.begin(); it != announcers.end(); it++)
+            {
+                Ipv4Address peer = InetSocketAddress::ConvertFrom(*it).GetIpv4();
+
+                candidates.push_back(peer);
+                throughputs.push_back(m_peerMonitor.GetThroughput(peer, GetPriorThroughput(peer)));
+            }
+
+            int selected = m_downloadScheduler.SelectPeer(candidates, throughputs, expectedSize);
+
+            if(selected < 0)
+            {
+                NS_LOG_INFO("RequestBlocks : Node " << GetNode()->GetId() << " has no free peer for block " << *hash);
+                m_downloadScheduler.AddPending(*hash);
+                continue;
+            }
+
+            /*
+             * The peer we request the block from stays first in m_queueInv
+             */
+            std::swap(announcers[0], announcers[selected]);
+
+            m_downloadScheduler.RequestIssued(*hash, candidates[selected], expectedSize);
+            m_peerMonitor.RequestSent(*hash, candidates[selected]);
+            ArmInvTimeout(*hash, candidates[selected], blockSize);
+            ArmStallTimeout(*hash, candidates[selected], expectedSize);
+
+            requests[candidates[selected]].push_back(*hash);
+            addresses[candidates[selected]] = announcers[0];
+        }
+
+        for(auto it = requests.begin(); it != requests.end(); it++)
+        {
+            NS_LOG_INFO("RequestBlocks : Node " << GetNode()->GetId() << " requests " << it->second.size()
+                        << " blocks from " << it->first << ", in flight = " << m_downloadScheduler.GetInFlight(it->first));
+            SendBlockRequest(it->second, addresses[it->first]);
+        }
+    }
+
+    void
+    BlockchainNode::SendBlockRequest(const std::vector<std::string> &blockHashes, Address &peer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::vector<std::string>    missingHeaders;
+        rapidjson::Document         d;
+
+        /*
+         * No GET_HEADERS for the blocks whose headers we already have (e.g. announced with SENDHEADERS)
+         */
+        for(auto it = blockHashes.begin(); it != blockHashes.end(); it++)
+        {
+            if(!OnlyHeadersReceived(*it))
+                missingHeaders.push_back(*it);
+        }
+
+        if(!missingHeaders.empty())
+        {
+            rapidjson::Document headersRequest;
+
+            SetBlockRequest(headersRequest, missingHeaders);
+            SendMessage(INV, GET_HEADERS, headersRequest, peer);
+        }
+
+        SetBlockRequest(d, blockHashes);
+        if(m_compactBlockMode == GRAPHENE_BLOCKS)
+        {
+            rapidjson::Value value;
+
+            d["type"].SetString("graphene");
+            value = static_cast<int>(m_transaction.size());
+            d.AddMember("poolSize", value, d.GetAllocator());
+        }
+        else if(m_compactBlockMode != COMPACT_BLOCKS_OFF)
+        {
+            d["type"].SetString("compact");
+        }
+        SendMessage(INV, GET_DATA, d, peer);
+    }
+
+    void
+    BlockchainNode::SetBlockRequest(rapidjson::Document &d, const std::vector<std::string> &blockHashes)
+    {
+        rapidjson::Value        value(INV);
+        rapidjson::Value        array(rapidjson::kArrayType);
+
+        d.SetObject();
+
+        d.AddMember("message", value, d.GetAllocator());
+        value.SetString("block");
+        d.AddMember("type", value, d.GetAllocator());
+
+        for(auto it = blockHashes.begin(); it != blockHashes.end(); it++)
+        {
+            value.SetString(it->c_str(), it->size(), d.GetAllocator());
+            array.PushBack(value, d.GetAllocator());
+        }
+        d.AddMember("blocks", array, d.GetAllocator());
+    }
+
+    void
+    BlockchainNode::RecordAnnouncement(const std::string &blockHash)
+    {
+        if(m_announcementTimes.find(blockHash) == m_announcementTimes.end())
+            m_announcementTimes[blockHash] = Simulator::Now().GetSeconds();
+    }
+
+    void
+    BlockchainNode::ProcessPendingRequests(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::vector<std::string>    pending = m_downloadScheduler.TakePending();
+        std::vector<std::string>    stillNeeded;
+
+        for(auto hash = pending.begin(); hash != pending.end(); hash++)
+        {
+            size_t  invPos = hash->find("/");
+            int     height = atoi(hash->substr(0, invPos).c_str());
+            int     minerId = atoi(hash->substr(invPos+1, hash->size()).c_str());
+
+            if(m_queueInv.find(*hash) != m_queueInv.end() && !m_queueInv[*hash].empty() && !m_blockchain.HasBlock(height, minerId)
+                && !m_blockchain.IsOrphan(height, minerId) && !ReceivedButNotValidated(*hash))
+            {
+                stillNeeded.push_back(*hash);
+            }
+            else
+            {
+                m_queueInv.erase(*hash);
+            }
+        }
+
+        if(!stillNeeded.empty())
+        {
+            RequestBlocks(stillNeeded);
+        }
+    }
+
+    void
+    BlockchainNode::RemoveBlockRequest(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto timeout = m_invTimeouts.find(blockHash);
+        if(timeout != m_invTimeouts.end())
+        {
+            m_timerWheel.Cancel(timeout->second);
+            m_invTimeouts.erase(timeout);
+        }
+
+        auto stall = m_stallTimeouts.find(blockHash);
+        if(stall != m_stallTimeouts.end())
+        {
+            m_timerWheel.Cancel(stall->second);
+            m_stallTimeouts.erase(stall);
+        }
+
+        m_peerMonitor.RemoveRequest(blockHash);
+        m_downloadScheduler.RequestFinished(blockHash);
+    }
+
+    void
+    BlockchainNode::ArmStallTimeout(const std::string &blockHash, Ipv4Address peer, int expectedSizeBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * A request is stalled when it takes twice the time the peer is expected to need
+         */
+        double expectedTime = m_peerMonitor.GetSmoothedRtt(peer).GetSeconds()
+                            + (expectedSizeBytes + m_blockchainMessageHeader) / m_peerMonitor.GetThroughput(peer, GetPriorThroughput(peer));
+        double stallTime = std::max(2 * expectedTime, 1.0);
+
+        if(m_stallTimeouts.find(blockHash) != m_stallTimeouts.end())
+            m_timerWheel.Cancel(m_stallTimeouts[blockHash]);
+
+        if(Seconds(stallTime) >= m_invTimeoutMinutes)
+        {
+            m_stallTimeouts.erase(blockHash);
+            return;
+        }
+
+        m_stallTimeouts[blockHash] = m_timerWheel.Arm(Seconds(stallTime), MakeCallback(&BlockchainNode::StallTimeoutExpired, this), blockHash);
+    }
+
+    double
+    BlockchainNode::GetPriorThroughput(Ipv4Address peer)
+    {
+        double priorThroughput = m_downloadSpeed;
+
+        if(m_peersUploadSpeeds.find(peer) != m_peersUploadSpeeds.end())
+            priorThroughput = std::min(priorThroughput, m_peersUploadSpeeds[peer]*1000000/8);
+
+        return priorThroughput;
+    }
+
+    int
+    BlockchainNode::GetExpectedBlockSize(const std::string &blockHash)
+    {
+        if(OnlyHeadersReceived(blockHash))
+            return m_onlyHeadersReceived[blockHash].GetBlockSizeBytes();
+
+        return static_cast<int>(m_meanBlockSize);
+    }
+
+    void
+    BlockchainNode::ArmInvTimeout(const std::string &blockHash, Ipv4Address peer, int blockSizeBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Time timeout = m_invTimeoutMinutes;
+
+        if(m_adaptiveInvTimeouts)
+        {
+            int     expectedSize = blockSizeBytes > 0 ? blockSizeBytes : static_cast<int>(m_meanBlockSize);
+            Time    requestTime = m_peerMonitor.GetRequestTime(blockHash);
+
+            timeout = m_peerMonitor.GetTimeout(peer, expectedSize + m_blockchainMessageHeader, GetPriorThroughput(peer));
+
+            /*
+             * The timeout counts from the time of the request
+             */
+            if(requestTime.IsPositive())
+                timeout = Seconds(std::max(0.0, (requestTime + timeout - Simulator::Now()).GetSeconds()));
+        }
+
+        if(m_invTimeouts.find(blockHash) != m_invTimeouts.end())
+            m_timerWheel.Cancel(m_invTimeouts[blockHash]);
+
+        NS_LOG_INFO("ArmInvTimeout : Node " << GetNode()->GetId() << " block " << blockHash << " from " << peer
+                    << " times out in " << timeout.GetSeconds() << "s");
+        m_invTimeouts[blockHash] = m_timerWheel.Arm(timeout, MakeCallback(&BlockchainNode::InvTimeoutExpired, this), blockHash);
+    }
+
+    bool
+    BlockchainNode::ReceivedButNotValidated(std::string blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_receivedNotValidated.find(blockHash) != m_receivedNotValidated.end())
+            return true;
+        else
+            return false;
+    }
+
+    void
+    BlockchainNode::RemoveReceivedButNotvalidated(std::string blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_receivedNotValidated.find(blockHash) != m_receivedNotValidated.end())
+        {
+            m_receivedNotValidated.erase(blockHash);
+        }
+        else
+        {
+            NS_LOG_WARN("Block was not found in m_receivedNotValidated");
+        }
+    }
+
+    bool
+    BlockchainNode::OnlyHeadersReceived (std::string blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+        
+        if(m_onlyHeadersReceived.find(blockHash) != m_onlyHeadersReceived.end())
+            return true;
+        else
+            return false;
+    }
+
+    int
+    BlockchainNode::SetCompactBlock(rapidjson::Document &d, const Block &block)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Value            value;
+        rapidjson::Value            array(rapidjson::kArrayType);
+        rapidjson::Value            shortIdArray(rapidjson::kArrayType);
+        rapidjson::Value            prefilledArray(rapidjson::kArrayType);
+        std::vector<Transaction>    transactions = block.GetTransactions();
+        std::vector<int>            prefilled;
+        uint64_t                    nonce = (static_cast<uint64_t>(rand()) << 32) | static_cast<uint32_t>(rand());
+        std::ostringstream          stringStream;
+        int                         prefilledBytes = 0;
+
+        stringStream << block.GetBlockHeight() << "/" << block.GetMinerId();
+        if(m_prefilledTransactions.find(stringStream.str()) != m_prefilledTransactions.end())
+            prefilled = m_prefilledTransactions[stringStream.str()];
+
+        BlockchainCompactBlock      shortIds(block.GetBlockHeight(), block.GetMinerId(), nonce);
+
+        d.SetObject();
+
+        value = CMPCT_BLOCK;
+        d.AddMember("message", value, d.GetAllocator());
+        value.SetString("compact");
+        d.AddMember("type", value, d.GetAllocator());
+
+        AddBlockHeader(d, array, block);
+        d.AddMember("blocks", array, d.GetAllocator());
+
+        value.SetUint64(nonce);
+        d.AddMember("shortIdNonce", value, d.GetAllocator());
+
+        for(unsigned int i = 0; i < transactions.size(); i++)
+        {
+            if(std::find(prefilled.begin(), prefilled.end(), static_cast<int>(i)) != prefilled.end())
+            {
+                rapidjson::Value transInfo(rapidjson::kObjectType);
+
+                value = i;
+                transInfo.AddMember("index", value, d.GetAllocator());
+
+                value = transactions[i].GetTransNodeId();
+                transInfo.AddMember("nodeId", value, d.GetAllocator());
+
+                value = transactions[i].GetTransId();
+                transInfo.AddMember("transId", value, d.GetAllocator());
+
+                value = transactions[i].GetTransTimeStamp();
+                transInfo.AddMember("timestamp", value, d.GetAllocator());
+
+                value = transactions[i].GetTransSizeByte();
+                transInfo.AddMember("size", value, d.GetAllocator());
+
+                prefilledArray.PushBack(transInfo, d.GetAllocator());
+                prefilledBytes += transactions[i].GetTransSizeByte();
+            }
+            else
+            {
+                value.SetUint64(shortIds.GetShortId(transactions[i]));
+                shortIdArray.PushBack(value, d.GetAllocator());
+            }
+        }
+
+        /*
+         * The size of a block stands for more transactions than the simulated ones. The others are
+         * assumed to be known by every node, so they only cost their short IDs.
+         */
+        int blockTransactions = std::max(static_cast<int>(transactions.size()),
+                                        static_cast<int>((block.GetBlockSizeBytes() - m_blockHeadersSizeBytes) / m_averageTransacionSize + 0.5));
+        int messageSize = m_blockchainMessageHeader + m_blockHeadersSizeBytes + m_shortIdNonceSizeBytes + 2*m_countBytes
+                        + (blockTransactions - prefilledArray.Size())*BlockchainCompactBlock::m_shortIdSizeBytes
+                        + prefilledArray.Size()*m_transactionIndexSize + prefilledBytes;
+
+        d.AddMember("shortIds", shortIdArray, d.GetAllocator());
+        d.AddMember("prefilled", prefilledArray, d.GetAllocator());
+        value = messageSize;
+        d.AddMember("size", value, d.GetAllocator());
+
+        return messageSize;
+    }
+
+    void
+    BlockchainNode::QueueCompactBlock(const Block &block, Address &to)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document d;
+        int                 messageSize = SetCompactBlock(d, block);
+
+        rapidjson::StringBuffer packetInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+        d.Accept(writer);
+
+        NS_LOG_INFO("QueueCompactBlock : Node " << GetNode()->GetId() << " queues a compact block of " << messageSize
+                    << " Bytes (full block " << block.GetBlockSizeBytes() << " Bytes) to " << InetSocketAddress::ConvertFrom(to).GetIpv4());
+
+        m_uploadScheduler.Enqueue(InetSocketAddress::ConvertFrom(to).GetIpv4(), to, packetInfo.GetString(), messageSize, 0);
+    }
+
+    void
+    BlockchainNode::ReceivedCompactBlock(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int                 height = d["blocks"][0]["height"].GetInt();
+        int                 minerId = d["blocks"][0]["minerId"].GetInt();
+        int                 parentHeight = height - 1;
+        int                 parentMinerId = d["blocks"][0]["parentBlockMinerId"].GetInt();
+        std::ostringstream  stringStream;
+        std::string         blockHash;
+        std::string         parentBlockHash;
+
+        stringStream << height << "/" << minerId;
+        blockHash = stringStream.str();
+
+        stringStream.clear();
+        stringStream.str("");
+
+        stringStream << parentHeight << "/" << parentMinerId;
+        parentBlockHash = stringStream.str();
+
+        if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId) || ReceivedButNotValidated(blockHash)
+            || m_partialBlocks.find(blockHash) != m_partialBlocks.end())
+        {
+            NS_LOG_INFO("ReceivedCompactBlock : Blockchain node " << GetNode()->GetId() << " already has the block " << blockHash);
+
+            if(m_partialBlocks.find(blockHash) == m_partialBlocks.end() && m_invTimeouts.find(blockHash) != m_invTimeouts.end())
+            {
+                m_queueInv.erase(blockHash);
+                RemoveBlockRequest(blockHash);
+                ProcessPendingRequests();
+            }
+            return;
+        }
+
+        Block header(height, minerId, d["blocks"][0]["nonce"].GetInt(), parentMinerId, d["blocks"][0]["size"].GetInt(),
+                    d["blocks"][0]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
+        ReadHeaderExtensions(d["blocks"][0], header);
+
+        /*
+         * In high-bandwidth mode the compact block is the announcement. Its headers let the children
+         * that arrive before the end of the reconstruction wait for it as orphans.
+         */
+        RecordAnnouncement(blockHash);
+        m_onlyHeadersReceived[blockHash] = header;
+
+        if(!m_blockchain.HasBlock(parentHeight, parentMinerId) && !m_blockchain.IsOrphan(parentHeight, parentMinerId)
+            && !ReceivedButNotValidated(parentBlockHash) && !OnlyHeadersReceived(parentBlockHash))
+        {
+            NS_LOG_INFO("ReceivedCompactBlock : the parent of block " << blockHash << " is missing");
+
+            m_queueInv[parentBlockHash].push_back(from);
+            if(m_invTimeouts.find(parentBlockHash) == m_invTimeouts.end() && !m_downloadScheduler.IsPending(parentBlockHash))
+            {
+                RequestBlocks(std::vector<std::string>(1, parentBlockHash));
+            }
+        }
+
+        PartialCompactBlock         partial;
+        BlockchainCompactBlock      shortIds(height, minerId, d["shortIdNonce"].GetUint64());
+        std::vector<uint64_t>       blockShortIds;
+        std::vector<Transaction>    matched;
+        std::vector<int>            missing;
+        std::vector<int>            positions;
+        unsigned int                totalTransactions = d["shortIds"].Size() + d["prefilled"].Size();
+        std::vector<bool>           prefilled(totalTransactions, false);
+
+        partial.header = header;
+        partial.transactions.resize(totalTransactions);
+        partial.peer = from;
+        partial.receivedBytes = d["size"].GetInt();
+        partial.graphene = false;
+
+        for(unsigned int i = 0; i < d["prefilled"].Size(); i++)
+        {
+            unsigned int index = d["prefilled"][i]["index"].GetInt();
+
+            if(index >= totalTransactions || prefilled[index])
+            {
+                RequestFullBlock(blockHash, from);
+                return;
+            }
+
+            partial.transactions[index] = Transaction(d["prefilled"][i]["nodeId"].GetInt(), d["prefilled"][i]["transId"].GetInt(),
+                                                    d["prefilled"][i]["timestamp"].GetDouble());
+            partial.transactions[index].SetTransSizeByte(d["prefilled"][i]["size"].GetInt());
+            prefilled[index] = true;
+        }
+
+        for(unsigned int i = 0; i < totalTransactions; i++)
+        {
+            if(!prefilled[i])
+                positions.push_back(i);
+        }
+
+        for(unsigned int i = 0; i < d["shortIds"].Size(); i++)
+        {
+            blockShortIds.push_back(d["shortIds"][i].GetUint64());
+        }
+
+        if(!shortIds.Reconstruct(blockShortIds, m_transaction, matched, missing))
+        {
+            RequestFullBlock(blockHash, from);
+            return;
+        }
+
+        for(unsigned int i = 0; i < matched.size(); i++)
+        {
+            partial.transactions[positions[i]] = matched[i];
+        }
+
+        for(auto it = missing.begin(); it != missing.end(); it++)
+        {
+            partial.missing.push_back(positions[*it]);
+        }
+
+        m_partialBlocks[blockHash] = partial;
+
+        if(partial.missing.empty())
+        {
+            m_nodeStats->compactBlocksReconstructed++;
+            CompleteCompactBlock(blockHash);
+        }
+        else
+        {
+            NS_LOG_INFO("ReceivedCompactBlock : Node " << GetNode()->GetId() << " misses " << partial.missing.size()
+                        << " of the " << totalTransactions << " transactions of block " << blockHash);
+
+            m_nodeStats->compactBlockRoundTrips++;
+            RequestBlockTransactions(blockHash, CMPCT_BLOCK, from);
+        }
+    }
+
+    void
+    BlockchainNode::RequestBlockTransactions(const std::string &blockHash, enum Messages receivedMessage, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        PartialCompactBlock &partial = m_partialBlocks[blockHash];
+        rapidjson::Document request;
+        rapidjson::Value    value;
+        rapidjson::Value    array(rapidjson::kArrayType);
+
+        request.SetObject();
+        value = GET_BLOCK_TXN;
+        request.AddMember("message", value, request.GetAllocator());
+        value.SetString("compact");
+        request.AddMember("type", value, request.GetAllocator());
+        value.SetString(blockHash.c_str(), blockHash.size(), request.GetAllocator());
+        request.AddMember("blockHash", value, request.GetAllocator());
+
+        for(auto it = partial.missing.begin(); it != partial.missing.end(); it++)
+        {
+            value = *it;
+            array.PushBack(value, request.GetAllocator());
+        }
+        request.AddMember("indexes", array, request.GetAllocator());
+
+        SendMessage(receivedMessage, GET_BLOCK_TXN, request, from);
+    }
+
+    void
+    BlockchainNode::ReceivedBlockTransactions(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::string blockHash = d["blockHash"].GetString();
+        auto        it = m_partialBlocks.find(blockHash);
+
+        if(it == m_partialBlocks.end() || InetSocketAddress::ConvertFrom(it->second.peer).GetIpv4() != InetSocketAddress::ConvertFrom(from).GetIpv4())
+        {
+            NS_LOG_INFO("ReceivedBlockTransactions : Node " << GetNode()->GetId() << " does not wait for the transactions of block " << blockHash);
+            return;
+        }
+
+        PartialCompactBlock &partial = it->second;
+
+        partial.receivedBytes += d["size"].GetInt();
+
+        if(d["transactions"].Size() != partial.missing.size())
+        {
+            RequestFullBlock(blockHash, from);
+            return;
+        }
+
+        for(unsigned int i = 0; i < d["transactions"].Size(); i++)
+        {
+            unsigned int index = d["transactions"][i]["index"].GetInt();
+
+            if(index >= partial.transactions.size())
+            {
+                RequestFullBlock(blockHash, from);
+                return;
+            }
+
+            partial.transactions[index] = Transaction(d["transactions"][i]["nodeId"].GetInt(), d["transactions"][i]["transId"].GetInt(),
+                                                    d["transactions"][i]["timestamp"].GetDouble());
+            partial.transactions[index].SetTransSizeByte(d["transactions"][i]["size"].GetInt());
+        }
+
+        /*
+         * Our peers are likely to miss them too
+         */
+        m_prefilledTransactions[blockHash] = partial.missing;
+
+        CompleteCompactBlock(blockHash);
+    }
+
+    void
+    BlockchainNode::CompleteCompactBlock(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        PartialCompactBlock partial = m_partialBlocks[blockHash];
+        Ipv4Address         peer = InetSocketAddress::ConvertFrom(partial.peer).GetIpv4();
+
+        m_partialBlocks.erase(blockHash);
+
+        Block newBlock(partial.header.GetBlockHeight(), partial.header.GetMinerId(), partial.header.GetNonce(),
+                        partial.header.GetParentBlockMinerId(), partial.header.GetBlockSizeBytes(),
+                        partial.header.GetTimeStamp(), Simulator::Now().GetSeconds(), peer);
+        newBlock.SetTransactions(partial.transactions);
+        newBlock.SetUncles(partial.header.GetUncles());
+        newBlock.SetDifficulty(partial.header.GetDifficulty());
+
+        NS_LOG_INFO("CompleteCompactBlock : At time " << Simulator::Now().GetSeconds() << " Node " << GetNode()->GetId()
+                    << " rebuilt block " << blockHash << " from " << partial.receivedBytes << " Bytes instead of "
+                    << newBlock.GetBlockSizeBytes() + m_blockchainMessageHeader);
+
+        if(partial.graphene)
+            m_nodeStats->grapheneBytesSaved += newBlock.GetBlockSizeBytes() + m_blockchainMessageHeader - partial.receivedBytes;
+
+        m_peerMonitor.BlocksReceived(std::vector<std::string>(1, blockHash), peer, partial.receivedBytes);
+        ReceivedDownloadedBlock(newBlock);
+        ProcessPendingRequests();
+    }
+
+    void
+    BlockchainNode::RequestFullBlock(const std::string &blockHash, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document d;
+
+        NS_LOG_INFO("RequestFullBlock : Node " << GetNode()->GetId() << " cannot rebuild the compact block " << blockHash
+                    << " and requests the full block");
+
+        m_nodeStats->compactBlockFallbacks++;
+        m_partialBlocks.erase(blockHash);
+
+        SetBlockRequest(d, std::vector<std::string>(1, blockHash));
+        SendMessage(CMPCT_BLOCK, GET_DATA, d, from);
+    }
+
+    void
+    BlockchainNode::QueueGrapheneBlock(const Block &block, int poolSize, Address &to)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document         d;
+        rapidjson::Value            value;
+        rapidjson::Value            array(rapidjson::kArrayType);
+        rapidjson::Value            bloomArray(rapidjson::kArrayType);
+        rapidjson::Value            ibltArray(rapidjson::kArrayType);
+        rapidjson::Value            orderArray(rapidjson::kArrayType);
+        std::vector<Transaction>    transactions = block.GetTransactions();
+        std::vector<uint64_t>       keys;
+        std::vector<uint64_t>       sortedKeys;
+        uint64_t                    nonce = (static_cast<uint64_t>(rand()) << 32) | static_cast<uint32_t>(rand());
+        BlockchainCompactBlock      shortIds(block.GetBlockHeight(), block.GetMinerId(), nonce);
+
+        /*
+         * As for the compact blocks, the transactions that are not simulated are assumed to be in
+         * every pool: they count in the sizes of the block and of the pool of the receiver
+         */
+        int blockTransactions = std::max(static_cast<int>(transactions.size()),
+                                        static_cast<int>((block.GetBlockSizeBytes() - m_blockHeadersSizeBytes) / m_averageTransacionSize + 0.5));
+        int poolTransactions = poolSize + blockTransactions - static_cast<int>(transactions.size());
+
+        GrapheneParameters          parameters = SelectGrapheneParameters(blockTransactions, poolTransactions);
+        BlockchainBloomFilter       filter(parameters.bloomBits, parameters.bloomHashes, nonce);
+        BlockchainIblt              iblt(parameters.ibltCells, nonce);
+
+        for(auto it = transactions.begin(); it != transactions.end(); it++)
+        {
+            uint64_t key = shortIds.GetShortId(*it);
+
+            keys.push_back(key);
+            filter.Insert(key);
+            iblt.Insert(key);
+        }
+
+        /*
+         * The receiver only learns the set of the transactions, the order of the block is sent as
+         * the rank of every transaction among the sorted short IDs
+         */
+        sortedKeys = keys;
+        std::sort(sortedKeys.begin(), sortedKeys.end());
+
+        d.SetObject();
+
+        value = GRAPHENE_BLOCK;
+        d.AddMember("message", value, d.GetAllocator());
+
+        AddBlockHeader(d, array, block);
+        d.AddMember("blocks", array, d.GetAllocator());
+
+        value.SetUint64(nonce);
+        d.AddMember("shortIdNonce", value, d.GetAllocator());
+
+        value = parameters.bloomBits;
+        d.AddMember("bloomBits", value, d.GetAllocator());
+        value = parameters.bloomHashes;
+        d.AddMember("bloomHashes", value, d.GetAllocator());
+
+        for(auto it = filter.GetWords().begin(); it != filter.GetWords().end(); it++)
+        {
+            value.SetUint64(*it);
+            bloomArray.PushBack(value, d.GetAllocator());
+        }
+        d.AddMember("bloom", bloomArray, d.GetAllocator());
+
+        for(auto it = iblt.GetCells().begin(); it != iblt.GetCells().end(); it++)
+        {
+            value = it->count;
+            ibltArray.PushBack(value, d.GetAllocator());
+            value.SetUint64(it->keySum);
+            ibltArray.PushBack(value, d.GetAllocator());
+            value = it->hashSum;
+            ibltArray.PushBack(value, d.GetAllocator());
+        }
+        d.AddMember("iblt", ibltArray, d.GetAllocator());
+
+        for(auto it = keys.begin(); it != keys.end(); it++)
+        {
+            value = static_cast<int>(std::lower_bound(sortedKeys.begin(), sortedKeys.end(), *it) - sortedKeys.begin());
+            orderArray.PushBack(value, d.GetAllocator());
+        }
+        d.AddMember("order", orderArray, d.GetAllocator());
+
+        int orderBits = 0;
+
+        while((1 << orderBits) < blockTransactions)
+            orderBits++;
+
+        int messageSize = m_blockchainMessageHeader + m_blockHeadersSizeBytes + m_shortIdNonceSizeBytes + 2*m_countBytes
+                        + parameters.sizeBytes + (blockTransactions*orderBits + 7) / 8;
+
+        value = messageSize;
+        d.AddMember("size", value, d.GetAllocator());
+
+        rapidjson::StringBuffer packetInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+        d.Accept(writer);
+
+        NS_LOG_INFO("QueueGrapheneBlock : Node " << GetNode()->GetId() << " queues a Graphene block of " << messageSize
+                    << " Bytes (full block " << block.GetBlockSizeBytes() << " Bytes, Bloom filter " << parameters.bloomBits
+                    << " bits, IBLT " << parameters.ibltCells << " cells) to " << InetSocketAddress::ConvertFrom(to).GetIpv4());
+
+        m_uploadScheduler.Enqueue(InetSocketAddress::ConvertFrom(to).GetIpv4(), to, packetInfo.GetString(), messageSize, 0);
+    }
+
+    void
+    BlockchainNode::ReceivedGrapheneBlock(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int                 height = d["blocks"][0]["height"].GetInt();
+        int                 minerId = d["blocks"][0]["minerId"].GetInt();
+        int                 parentHeight = height - 1;
+        int                 parentMinerId = d["blocks"][0]["parentBlockMinerId"].GetInt();
+        std::ostringstream  stringStream;
+        std::string         blockHash;
+        std::string         parentBlockHash;
+
+        stringStream << height << "/" << minerId;
+        blockHash = stringStream.str();
+
+        stringStream.clear();
+        stringStream.str("");
+
+        stringStream << parentHeight << "/" << parentMinerId;
+        parentBlockHash = stringStream.str();
+
+        if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId) || ReceivedButNotValidated(blockHash)
+            || m_partialBlocks.find(blockHash) != m_partialBlocks.end())
+        {
+            NS_LOG_INFO("ReceivedGrapheneBlock : Blockchain node " << GetNode()->GetId() << " already has the block " << blockHash);
+            return;
+        }
+
+        Block header(height, minerId, d["blocks"][0]["nonce"].GetInt(), parentMinerId, d["blocks"][0]["size"].GetInt(),
+                    d["blocks"][0]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
+        ReadHeaderExtensions(d["blocks"][0], header);
+
+        m_onlyHeadersReceived[blockHash] = header;
+
+        if(!m_blockchain.HasBlock(parentHeight, parentMinerId) && !m_blockchain.IsOrphan(parentHeight, parentMinerId)
+            && !ReceivedButNotValidated(parentBlockHash) && !OnlyHeadersReceived(parentBlockHash))
+        {
+            NS_LOG_INFO("ReceivedGrapheneBlock : the parent of block " << blockHash << " is missing");
+
+            m_queueInv[parentBlockHash].push_back(from);
+            if(m_invTimeouts.find(parentBlockHash) == m_invTimeouts.end() && !m_downloadScheduler.IsPending(parentBlockHash))
+            {
+                RequestBlocks(std::vector<std::string>(1, parentBlockHash));
+            }
+        }
+
+        uint64_t                    nonce = d["shortIdNonce"].GetUint64();
+        unsigned int                totalTransactions = d["order"].Size();
+        BlockchainCompactBlock      shortIds(height, minerId, nonce);
+        BlockchainBloomFilter       filter(d["bloomBits"].GetUint(), d["bloomHashes"].GetUint(), nonce);
+        BlockchainIblt              iblt(d["iblt"].Size() / 3, nonce);
+        BlockchainIblt              candidatesIblt(d["iblt"].Size() / 3, nonce);
+        std::vector<uint64_t>       words;
+        std::vector<BlockchainIblt::Cell> cells;
+        std::map<uint64_t, int>     candidates;                 // short ID -> position in m_transaction, -1 if it is in the block only
+        std::vector<uint64_t>       inserted;
+        std::vector<uint64_t>       erased;
+        std::vector<uint64_t>       sortedKeys;
+        bool                        decoded = true;
+        PartialCompactBlock         partial;
+
+        for(unsigned int i = 0; i < d["bloom"].Size(); i++)
+        {
+            words.push_back(d["bloom"][i].GetUint64());
+        }
+        filter.SetWords(words);
+
+        for(unsigned int i = 0; i + 2 < d["iblt"].Size(); i += 3)
+        {
+            BlockchainIblt::Cell cell = {d["iblt"][i].GetInt(), d["iblt"][i + 1].GetUint64(), d["iblt"][i + 2].GetUint()};
+
+            cells.push_back(cell);
+        }
+        iblt.SetCells(cells);
 
-                                blockMessageSize += m_blockchainMessageHeader;
-                                
+        /*
+         * The candidates are the transactions of the pool that pass the Bloom filter. What is left of
+         * the IBLT of the block once they are removed is the block transactions we miss (inserted) and
+         * the false positives (erased).
+         */
+        for(unsigned int i = 0; i < m_transaction.size(); i++)
+        {
+            uint64_t key = shortIds.GetShortId(m_transaction[i]);
 
-                                for(unsigned int j = 0; j < d["blocks"].Size(); j++)
-                                {
-                                    blockMessageSize += d["blocks"][j]["size"].GetInt();
-                                }
+            if(!filter.Contains(key))
+                continue;
 
-                        
-                                m_nodeStats->blockReceivedBytes += blockMessageSize;
+            if(candidates.find(key) != candidates.end())
+            {
+                NS_LOG_INFO("ReceivedGrapheneBlock : two transactions of the pool have the short ID " << key);
+                decoded = false;
+                break;
+            }
 
-                                rapidjson::StringBuffer blockInfo;
-                                rapidjson::Writer<rapidjson::StringBuffer> blockWriter(blockInfo);
-                                d.Accept(blockWriter);
-                                /*
-                                if(GetNode()->GetId() == 10)
-                                {
-                                    std::cout<<"BLOCK: At time " << Simulator::Now().GetSeconds()
-                                            << " Node " << GetNode()->GetId()
-                                            << " received a block message " << blockInfo.GetString() << "\n";
-                                }
-                                */
-                                
-                                NS_LOG_INFO("BLOCK: At time " << Simulator::Now().GetSeconds()
-                                            << " Node " << GetNode()->GetId()
-                                            << " received a block message " << blockInfo.GetString());
-                                NS_LOG_INFO(m_downloadSpeed << " " 
-                                            << m_peersUploadSpeeds[InetSocketAddress::ConvertFrom(from). GetIpv4()] * 1000000/8 << " " << minSpeed);
+            candidates[key] = i;
+            candidatesIblt.Insert(key);
+        }
 
-                                std::string help = blockInfo.GetString();
+        if(decoded)
+        {
+            iblt.Subtract(candidatesIblt);
+            decoded = iblt.Decode(inserted, erased);
+        }
 
-                                if(m_receiveBlockTimes.size() == 0 || Simulator::Now().GetSeconds() > m_receiveBlockTimes.back())
-                                {
-                                    receiveTime = blockMessageSize / m_downloadSpeed;
-                                    eventTime = blockMessageSize / minSpeed;
-                                }
-                                else
-                                {
-                                    receiveTime = blockMessageSize / m_downloadSpeed + m_receiveBlockTimes.back() - Simulator::Now().GetSeconds();
-                                    eventTime = blockMessageSize / minSpeed + m_receiveBlockTimes.back() - Simulator::Now().GetSeconds();
-                                }
+        for(auto it = erased.begin(); decoded && it != erased.end(); it++)
+        {
+            if(candidates.erase(*it) == 0)
+                decoded = false;
+        }
 
-                                m_receiveBlockTimes.push_back(Simulator::Now().GetSeconds()+receiveTime);
+        for(auto it = inserted.begin(); decoded && it != inserted.end(); it++)
+        {
+            if(candidates.find(*it) != candidates.end())
+                decoded = false;
+            else
+                candidates[*it] = -1;
+        }
 
-                                Simulator::Schedule(Seconds(eventTime), &BlockchainNode::ReceivedBlockMessage, this, help, from);
-                                Simulator::Schedule(Seconds(receiveTime), &BlockchainNode::RemoveReceiveTime, this);
-                                NS_LOG_INFO("BLOCK: Node " << GetNode()->GetId() << " will receive the full block message at "
-                                            << Simulator::Now().GetSeconds() + eventTime);
-                            }
-                            
+        if(!decoded || candidates.size() != totalTransactions)
+        {
+            NS_LOG_INFO("ReceivedGrapheneBlock : Node " << GetNode()->GetId() << " could not decode the Graphene block " << blockHash);
 
-                            break;
-                        }
-                        default:
-                        {
-                            NS_LOG_INFO("Default");
-                            break;
-                        }
-                        
-                    }
+            m_nodeStats->grapheneDecodeFailures++;
+            RequestFullBlock(blockHash, from);
+            return;
+        }
 
-                    totalReceivedData.erase(0, pos + delimiter.length());
+        m_nodeStats->grapheneBlocksDecoded++;
 
-                }
+        for(auto it = candidates.begin(); it != candidates.end(); it++)
+        {
+            sortedKeys.push_back(it->first);
+        }
 
-                m_bufferedData[from] = totalReceivedData;
-                delete[] packetInfo;
+        partial.header = header;
+        partial.transactions.resize(totalTransactions);
+        partial.peer = from;
+        partial.receivedBytes = d["size"].GetInt();
+        partial.graphene = true;
 
-            }
-            else if(InetSocketAddress::IsMatchingType(from))
+        for(unsigned int i = 0; i < totalTransactions; i++)
+        {
+            unsigned int rank = d["order"][i].GetInt();
+
+            if(rank >= totalTransactions)
             {
-                NS_LOG_INFO("At time " << Simulator::Now().GetSeconds()
-                            << " s blockchain node " << GetNode()->GetId() << " received"
-                            << packet->GetSize() << " bytes from"
-                            << Inet6SocketAddress::ConvertFrom(from).GetIpv6()
-                            << " port" << Inet6SocketAddress::ConvertFrom(from).GetPort());
+                RequestFullBlock(blockHash, from);
+                return;
             }
-            m_rxTrace(packet, from);
+
+            int position = candidates[sortedKeys[rank]];
+
+            if(position >= 0)
+                partial.transactions[i] = m_transaction[position];
+            else
+                partial.missing.push_back(i);
         }
-        
-    }
 
-    void
-    BlockchainNode::HandleAccept(Ptr<Socket> socket, const Address& from)
-    {
-        NS_LOG_FUNCTION(this);
-        socket->SetRecvCallback (MakeCallback(&BlockchainNode::HandleRead, this));
+        m_partialBlocks[blockHash] = partial;
+
+        if(partial.missing.empty())
+        {
+            CompleteCompactBlock(blockHash);
+        }
+        else
+        {
+            NS_LOG_INFO("ReceivedGrapheneBlock : Node " << GetNode()->GetId() << " misses " << partial.missing.size()
+                        << " of the " << totalTransactions << " transactions of block " << blockHash);
+
+            RequestBlockTransactions(blockHash, GRAPHENE_BLOCK, from);
+        }
     }
 
     void
-    BlockchainNode::HandlePeerClose(Ptr<Socket> socket)
+    BlockchainNode::AdvertiseFullBlock(const Block &newBlock)
     {
         NS_LOG_FUNCTION(this);
+
+        std::vector<int> chunks;
+
+        for(int i = 0; i < m_chunkSwarm.GetChunkCount(newBlock.GetBlockSizeBytes()); i++)
+        {
+            chunks.push_back(i);
+        }
+
+        SendChunkInv(newBlock, chunks, newBlock.GetReceivedFromIpv4());
     }
 
     void
-    BlockchainNode::HandlePeerError(Ptr<Socket> socket)
+    BlockchainNode::SendChunkInv(const Block &header, const std::vector<int> &chunks, Ipv4Address exceptPeer)
     {
         NS_LOG_FUNCTION(this);
+
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        rapidjson::Value    array(rapidjson::kArrayType);
+        rapidjson::Value    chunkArray(rapidjson::kArrayType);
+        std::ostringstream  stringStream;
+
+        stringStream << header.GetBlockHeight() << "/" << header.GetMinerId();
+
+        d.SetObject();
+
+        value = CHUNK_INV;
+        d.AddMember("message", value, d.GetAllocator());
+        value.SetString("chunk");
+        d.AddMember("type", value, d.GetAllocator());
+
+        AddBlockHeader(d, array, header);
+        d.AddMember("blocks", array, d.GetAllocator());
+
+        for(auto it = chunks.begin(); it != chunks.end(); it++)
+        {
+            value = *it;
+            chunkArray.PushBack(value, d.GetAllocator());
+        }
+        d.AddMember("chunks", chunkArray, d.GetAllocator());
+
+        /*
+         * The chunks are advertised as a bitmap
+         */
+        value = m_blockchainMessageHeader + m_inventorySizeBytes + m_blockHeadersSizeBytes
+                + (m_chunkSwarm.GetChunkCount(header.GetBlockSizeBytes()) + 7)/8;
+        d.AddMember("size", value, d.GetAllocator());
+
+        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
+        {
+            if(*i == exceptPeer || m_chunkSwarm.PeerHasAllChunks(stringStream.str(), *i))
+                continue;
+
+            Address peer = InetSocketAddress(*i, m_blockchainPort);
+            SendMessage(NO_MESSAGE, CHUNK_INV, d, peer);
+        }
     }
 
     void
-    BlockchainNode::ReceivedBlockMessage(std::string &blockInfo, Address &from)
+    BlockchainNode::ReceivedChunkInv(rapidjson::Document &d, Address &from)
     {
         NS_LOG_FUNCTION(this);
 
-        rapidjson::Document d;
-        d.Parse(blockInfo.c_str());
+        int                 height = d["blocks"][0]["height"].GetInt();
+        int                 minerId = d["blocks"][0]["minerId"].GetInt();
+        int                 parentHeight = height - 1;
+        int                 parentMinerId = d["blocks"][0]["parentBlockMinerId"].GetInt();
+        Ipv4Address         peer = InetSocketAddress::ConvertFrom(from).GetIpv4();
+        std::vector<int>    chunks;
+        std::ostringstream  stringStream;
+        std::string         blockHash;
+        std::string         parentBlockHash;
 
-        NS_LOG_INFO("ReceivedBlockMessage : At time : " << Simulator::Now().GetSeconds()
-                    << " Node " << GetNode()->GetId() << " received a block message " << blockInfo);
-        for(unsigned int  j = 0 ; j < d["blocks"].Size(); j++)
-        {
-            int parentHeight = d["blocks"][j]["height"].GetInt() - 1;
-            int parentMinerId = d["blocks"][j]["parentBlockMinerId"].GetInt();
-            int height = d["blocks"][j]["height"].GetInt();
-            int minerId = d["blocks"][j]["minerId"].GetInt();
+        stringStream << height << "/" << minerId;
+        blockHash = stringStream.str();
 
-            EventId             timeout;
-            std::ostringstream  stringStream;
-            std::string         blockHash;
-            std::string         parentBlockHash;
+        stringStream.clear();
+        stringStream.str("");
 
-            stringStream << height << "/" << minerId;
-            blockHash = stringStream.str();
+        stringStream << parentHeight << "/" << parentMinerId;
+        parentBlockHash = stringStream.str();
 
-            if(m_onlyHeadersReceived.find(blockHash) != m_onlyHeadersReceived.end())
-            {
-                m_onlyHeadersReceived.erase(blockHash);
-            }
+        if(m_blockchain.HasBlock(height, minerId) || m_blockchain.IsOrphan(height, minerId) || ReceivedButNotValidated(blockHash))
+        {
+            NS_LOG_INFO("ReceivedChunkInv : Blockchain node " << GetNode()->GetId() << " already has the block " << blockHash);
+            return;
+        }
 
-            stringStream.clear();
-            stringStream.str("");
+        if(!m_chunkSwarm.HasBlock(blockHash))
+        {
+            Block header(height, minerId, d["blocks"][0]["nonce"].GetInt(), parentMinerId, d["blocks"][0]["size"].GetInt(),
+                        d["blocks"][0]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), peer);
+            ReadHeaderExtensions(d["blocks"][0], header);
 
-            stringStream << parentHeight << "/" << parentMinerId;
-            parentBlockHash = stringStream.str();
+            NS_LOG_INFO("ReceivedChunkInv : Node " << GetNode()->GetId() << " starts downloading the "
+                        << m_chunkSwarm.GetChunkCount(header.GetBlockSizeBytes()) << " chunks of block " << blockHash);
+
+            m_chunkSwarm.AddBlock(blockHash, header);
+            RecordAnnouncement(blockHash);
+            m_onlyHeadersReceived[blockHash] = header;
 
             if(!m_blockchain.HasBlock(parentHeight, parentMinerId) && !m_blockchain.IsOrphan(parentHeight, parentMinerId)
                 && !ReceivedButNotValidated(parentBlockHash) && !OnlyHeadersReceived(parentBlockHash))
             {
-                NS_LOG_INFO("The Block with height = " << d["blocks"][j]["height"].GetInt()
-                            << " and minerID = " << d["blocks"][j]["minerId"].GetInt()
-                            << " is an orphan, so it will be discarded\n");
-                m_queueInv.erase(blockHash);
-                Simulator::Cancel(m_invTimeouts[blockHash]);
-                m_invTimeouts.erase(blockHash);
-            }
-            else
-            {
-                std::vector<Transaction> newTransactions;
-                Block newBlock(d["blocks"][j]["height"].GetInt(), d["blocks"][j]["minerId"].GetInt(), d["blocks"][j]["nonce"].GetInt()
-                                , d["blocks"][j]["parentBlockMinerId"].GetInt(), d["blocks"][j]["size"].GetInt()
-                                , d["blocks"][j]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
-                
-                for(unsigned int i = 0 ; i < d["blocks"][j]["transactions"].Size(); i++)
+                NS_LOG_INFO("ReceivedChunkInv : the parent of block " << blockHash << " is missing");
+
+                m_queueInv[parentBlockHash].push_back(from);
+                if(m_invTimeouts.find(parentBlockHash) == m_invTimeouts.end() && !m_downloadScheduler.IsPending(parentBlockHash))
                 {
-                    int transNodeId = d["blocks"][j]["transactions"][i]["nodeId"].GetInt();
-                    int transId = d["blocks"][j]["transactions"][i]["transId"].GetInt();
-                    double timeStamp = d["blocks"][j]["transactions"][i]["timestamp"].GetDouble();
-                    Transaction newTrans(transNodeId, transId, timeStamp);
-                    newTransactions.push_back(newTrans);
-                    //std::cout<<"Node " << GetNode()->GetId() << " confirmed transaction nodeid: " << transNodeId << " transId: " <<  transId << "\n";
+                    RequestBlocks(std::vector<std::string>(1, parentBlockHash));
                 }
-                newBlock.SetTransactions(newTransactions);
-                ReceiveBlock(newBlock);
             }
         }
+
+        for(unsigned int j = 0; j < d["chunks"].Size(); j++)
+        {
+            chunks.push_back(d["chunks"][j].GetInt());
+        }
+
+        m_chunkSwarm.AddPeerChunks(blockHash, peer, from, chunks);
+        RequestChunks(blockHash);
     }
 
     void
-    BlockchainNode::ReceiveBlock(const Block &newBlock)
+    BlockchainNode::RequestChunks(const std::string &blockHash)
     {
         NS_LOG_FUNCTION(this);
-        NS_LOG_INFO("ReceiveBlock: At time " << Simulator::Now().GetSeconds()
-                    << "s blockchain node " << GetNode()->GetId() << " received");
-        std::ostringstream  stringStream;
-        std::string         blockHash = stringStream.str();
 
-        stringStream << newBlock.GetBlockHeight() << "/" << newBlock.GetMinerId();
-        blockHash = stringStream.str();
+        if(!m_chunkSwarm.HasBlock(blockHash))
+            return;
 
-        if(m_blockchain.HasBlock(newBlock) || m_blockchain.IsOrphan(newBlock) || ReceivedButNotValidated(blockHash))
-        {
-            NS_LOG_INFO("ReceiveBlock: Blockchain node " << GetNode()->GetId()
-                        << " has already added this block in the m_blockchain");
+        std::map<Ipv4Address, std::vector<int>>     requests = m_chunkSwarm.SelectRequests(blockHash);
+        int                                         blockSize = m_chunkSwarm.GetHeader(blockHash).GetBlockSizeBytes();
+        Time                                        timeout = Seconds(0);
 
-            if (m_invTimeouts.find(blockHash) != m_invTimeouts.end())
-            {
-                m_queueInv.erase(blockHash);
-                Simulator::Cancel(m_invTimeouts[blockHash]);
-                m_invTimeouts.erase(blockHash);
-            }
-        }
-        else
+        for(auto it = requests.begin(); it != requests.end(); it++)
         {
-            NS_LOG_INFO("ReceiveBlock: Blockchain node " << GetNode()->GetId()
-                        << " has not added this block in the m_blockchain");
-            
-            m_receivedNotValidated[blockHash] = newBlock;
+            rapidjson::Document d;
+            rapidjson::Value    value;
+            rapidjson::Value    array(rapidjson::kArrayType);
+            Address             address = m_chunkSwarm.GetPeerAddress(blockHash, it->first);
+            int                 requestedBytes = 0;
+            Time                peerTimeout = m_invTimeoutMinutes;
 
-            if (m_invTimeouts.find(blockHash) != m_invTimeouts.end())
+            d.SetObject();
+
+            value = GET_CHUNK;
+            d.AddMember("message", value, d.GetAllocator());
+            value.SetString("chunk");
+            d.AddMember("type", value, d.GetAllocator());
+            value.SetString(blockHash.c_str(), blockHash.size(), d.GetAllocator());
+            d.AddMember("blockHash", value, d.GetAllocator());
+
+            for(auto chunk = it->second.begin(); chunk != it->second.end(); chunk++)
             {
-                m_queueInv.erase(blockHash);
-                Simulator::Cancel(m_invTimeouts[blockHash]);
-                m_invTimeouts.erase(blockHash);
+                value = *chunk;
+                array.PushBack(value, d.GetAllocator());
+
+                requestedBytes += m_chunkSwarm.GetChunkSizeBytes(blockSize, *chunk) + m_blockchainMessageHeader;
+                m_peerMonitor.RequestSent(GetChunkHash(blockHash, *chunk), it->first);
             }
+            d.AddMember("chunks", array, d.GetAllocator());
 
-            ValidateBlock(newBlock);
+            NS_LOG_INFO("RequestChunks : Node " << GetNode()->GetId() << " requests " << it->second.size()
+                        << " chunks of block " << blockHash << " from " << it->first);
+
+            SendMessage(CHUNK_INV, GET_CHUNK, d, address);
+
+            if(m_adaptiveInvTimeouts)
+                peerTimeout = m_peerMonitor.GetTimeout(it->first, requestedBytes, GetPriorThroughput(it->first));
+
+            timeout = std::max(timeout, peerTimeout);
         }
 
+        if(!requests.empty())
+        {
+            if(m_chunkTimeouts.find(blockHash) != m_chunkTimeouts.end())
+                m_timerWheel.Cancel(m_chunkTimeouts[blockHash]);
+
+            m_chunkTimeouts[blockHash] = m_timerWheel.Arm(timeout, MakeCallback(&BlockchainNode::ChunkTimeoutExpired, this), blockHash);
+        }
     }
 
     void
-    BlockchainNode::SendBlock(std::string packetInfo, Address &from)
+    BlockchainNode::QueueChunk(const Block &block, const std::vector<Transaction> &transactions, int chunk, Address &to)
     {
         NS_LOG_FUNCTION(this);
 
-        NS_LOG_INFO("SendBlock: At time "<<  Simulator::Now().GetSeconds()
-                    << "s blockchain node " << GetNode()->GetId() << " sent "
-                    << packetInfo << " to " << InetSocketAddress::ConvertFrom(from).GetIpv4());
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        std::ostringstream  stringStream;
+        std::string         blockHash;
+        int                 messageSize = m_blockchainMessageHeader + m_inventorySizeBytes + m_countBytes
+                                        + m_chunkSwarm.GetChunkSizeBytes(block.GetBlockSizeBytes(), chunk);
 
-        SendMessage(GET_DATA, BLOCK,packetInfo, from);
-    }
+        stringStream << block.GetBlockHeight() << "/" << block.GetMinerId();
+        blockHash = stringStream.str();
 
-    void
-    BlockchainNode::ReceivedHigherBlock(const Block &newBlock)
-    {
-        NS_LOG_FUNCTION(this);
-        NS_LOG_INFO("ReceivedHigherBlock: blockchain node : " <<GetNode()->GetId() 
-                    << " added a new block in the m_blockchain with higher height");
+        d.SetObject();
+
+        value = CHUNK;
+        d.AddMember("message", value, d.GetAllocator());
+        value.SetString("chunk");
+        d.AddMember("type", value, d.GetAllocator());
+        value.SetString(blockHash.c_str(), blockHash.size(), d.GetAllocator());
+        d.AddMember("blockHash", value, d.GetAllocator());
+        value = chunk;
+        d.AddMember("chunk", value, d.GetAllocator());
+        value = messageSize;
+        d.AddMember("size", value, d.GetAllocator());
+
+        if(chunk == 0)
+        {
+            rapidjson::Value tranArray(rapidjson::kArrayType);
+
+            for(auto trans_it = transactions.begin(); trans_it < transactions.end(); trans_it++)
+            {
+                rapidjson::Value transInfo(rapidjson::kObjectType);
+
+                value = trans_it->GetTransNodeId();
+                transInfo.AddMember("nodeId", value, d.GetAllocator());
+
+                value = trans_it->GetTransId();
+                transInfo.AddMember("transId", value, d.GetAllocator());
+
+                value = trans_it->GetTransTimeStamp();
+                transInfo.AddMember("timestamp", value, d.GetAllocator());
+
+                value = trans_it->GetTransSizeByte();
+                transInfo.AddMember("size", value, d.GetAllocator());
+
+                tranArray.PushBack(transInfo, d.GetAllocator());
+            }
+            d.AddMember("transactions", tranArray, d.GetAllocator());
+        }
+
+        rapidjson::StringBuffer packetInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+        d.Accept(writer);
+
+        NS_LOG_INFO("QueueChunk : Node " << GetNode()->GetId() << " queues chunk " << chunk << " of block " << blockHash
+                    << " (" << messageSize << " Bytes) to " << InetSocketAddress::ConvertFrom(to).GetIpv4());
+
+        m_uploadScheduler.Enqueue(InetSocketAddress::ConvertFrom(to).GetIpv4(), to, packetInfo.GetString(), messageSize, 0);
     }
 
     void
-    BlockchainNode::ValidateBlock(const Block &newBlock)
+    BlockchainNode::ReceivedChunk(rapidjson::Document &d, Address &from)
     {
         NS_LOG_FUNCTION(this);
 
-        const Block *parent = m_blockchain.GetParent(newBlock);
+        std::string     blockHash = d["blockHash"].GetString();
+        int             chunk = d["chunk"].GetInt();
+        Ipv4Address     peer = InetSocketAddress::ConvertFrom(from).GetIpv4();
 
-        if(parent == nullptr)
+        m_peerMonitor.BlocksReceived(std::vector<std::string>(1, GetChunkHash(blockHash, chunk)), peer, d["size"].GetInt());
+
+        if(!m_chunkSwarm.HasBlock(blockHash))
         {
-            NS_LOG_INFO("ValidateBlock : Block is an orphan");
-            m_blockchain.AddOrphan(newBlock);
-            
+            NS_LOG_INFO("ReceivedChunk : Node " << GetNode()->GetId() << " is not downloading block " << blockHash);
+            return;
         }
-        else
-        {
-            const int averageBlockSizeBytes = 238263;   // we should modify it
-            const double averageValidationTimeSeconds = 0.174;
-            double validationTime = averageValidationTimeSeconds * newBlock.GetBlockSizeBytes() / averageBlockSizeBytes;
-            ValidateTransaction(newBlock);
 
-            //std::cout<<"validationTime : " << validationTime << "\n";
-            Simulator::Schedule (Seconds(validationTime), &BlockchainNode::AfterBlockValidation, this, newBlock);
-            NS_LOG_INFO("ValidateBlock : the block will be validated in " << validationTime << "s");
+        if(!m_chunkSwarm.ChunkReceived(blockHash, chunk, peer))
+        {
+            NS_LOG_INFO("ReceivedChunk : Node " << GetNode()->GetId() << " already has chunk " << chunk << " of block " << blockHash);
+            RequestChunks(blockHash);
+            return;
         }
 
-    }
-
-    void
-    BlockchainNode::ValidateTransaction(const Block &newBlock)
-    {
-        std::vector<Transaction>                requestTransactions;
-        std::vector<Transaction>::iterator      trans_it;
-        std::vector<Transaction>::iterator      notValTrans_it;
-        requestTransactions = newBlock.GetTransactions();
-
-        for(trans_it = requestTransactions.begin(); trans_it < requestTransactions.end(); trans_it++)
+        if(d.HasMember("transactions"))
         {
-            /*
-            std::cout<<"Node "<<GetNode()->GetId() << " is validating transaction nodeId : " 
-                    << trans_it->GetTransNodeId() << " transId: " << trans_it->GetTransId() << "\n";
-            */
-            for(notValTrans_it = m_transaction.begin(); notValTrans_it < m_transaction.end(); notValTrans_it++)
+            std::vector<Transaction> transactions;
+
+            for(unsigned int i = 0; i < d["transactions"].Size(); i++)
             {
-                if(*notValTrans_it == *trans_it)
-                {
-                    if(notValTrans_it->IsValidated() != true)
-                    {
-                        notValTrans_it->SetValidation();
-                        m_totalValidation++;
-                        m_meanValidationTime = (m_meanValidationTime*static_cast<double>(m_totalValidation-1) + (Simulator::Now().GetSeconds() - notValTrans_it->GetTransTimeStamp()))/static_cast<double>(m_totalValidation);
-                        //Send to Client node
-                        NotifyTransaction(*notValTrans_it);
-                    }
-                    break;
-                }
+                transactions.push_back(Transaction(d["transactions"][i]["nodeId"].GetInt(), d["transactions"][i]["transId"].GetInt(),
+                                                    d["transactions"][i]["timestamp"].GetDouble()));
+                transactions.back().SetTransSizeByte(d["transactions"][i]["size"].GetInt());
             }
+            m_chunkSwarm.SetTransactions(blockHash, transactions);
+        }
 
-            if(notValTrans_it == m_transaction.end())
-            {
-                trans_it->SetValidation();
-                m_transaction.push_back(*trans_it);
+        Block header = m_chunkSwarm.GetHeader(blockHash);
 
-                //m_totalValidation++;
-                //m_meanValidationTime = (m_meanValidationTime*static_cast<double>(m_totalValidation-1) + (Simulator::Now().GetSeconds() - notValTrans_it->GetTransTimeStamp()))/static_cast<double>(m_totalValidation);
-            }
+        /*
+         * The chunk is relayed before the rest of the block has arrived
+         */
+        SendChunkInv(header, std::vector<int>(1, chunk), peer);
 
-            
+        if(m_chunkSwarm.IsComplete(blockHash))
+        {
+            Block newBlock(header.GetBlockHeight(), header.GetMinerId(), header.GetNonce(), header.GetParentBlockMinerId(),
+                            header.GetBlockSizeBytes(), header.GetTimeStamp(), Simulator::Now().GetSeconds(), peer);
+            newBlock.SetTransactions(m_chunkSwarm.GetTransactions(blockHash));
+            newBlock.SetUncles(header.GetUncles());
+            newBlock.SetDifficulty(header.GetDifficulty());
+
+            m_chunkedBlocksReceived++;
+            m_meanChunkSources = (m_meanChunkSources*static_cast<double>(m_chunkedBlocksReceived-1) + m_chunkSwarm.GetSourceCount(blockHash))
+                                /static_cast<double>(m_chunkedBlocksReceived);
+
+            NS_LOG_INFO("ReceivedChunk : At time " << Simulator::Now().GetSeconds() << " Node " << GetNode()->GetId()
+                        << " received the last chunk of block " << blockHash << " from "
+                        << m_chunkSwarm.GetSourceCount(blockHash) << " peers");
+
+            ReceivedDownloadedBlock(newBlock);
+            ProcessPendingRequests();
+        }
+        else
+        {
+            RequestChunks(blockHash);
         }
     }
 
     void
-    BlockchainNode::AfterBlockValidation(const Block &newBlock)
+    BlockchainNode::ChunkTimeoutExpired(std::string blockHash)
     {
         NS_LOG_FUNCTION(this);
 
-        int height = newBlock.GetBlockHeight();
-        int minerId = newBlock.GetMinerId();
-        std::ostringstream  stringStream;
-        std::string         blockHash = stringStream.str();
+        m_chunkTimeouts.erase(blockHash);
+
+        if(!m_chunkSwarm.HasBlock(blockHash))
+            return;
 
-        stringStream << height << "/" << minerId;
-        blockHash = stringStream.str();
+        std::map<int, Ipv4Address> released = m_chunkSwarm.ReleaseRequests(blockHash);
 
-        RemoveReceivedButNotvalidated(blockHash);
+        NS_LOG_INFO("ChunkTimeoutExpired : Node " << GetNode()->GetId() << " : " << released.size()
+                    << " chunk requests of block " << blockHash << " timed out");
 
-        NS_LOG_INFO("AfterBlockValidation : at time " << Simulator::Now().GetSeconds()
-                    << "s blockchain node " << GetNode()->GetId()
-                    << " validated block ");
-        if(newBlock.GetBlockHeight() > m_blockchain.GetBlockchainHeight())
-        {
-            ReceivedHigherBlock(newBlock);
-        }
+        m_nodeStats->chunkTimeouts += released.size();
 
-        if(m_blockchain.IsOrphan(newBlock))
+        for(auto it = released.begin(); it != released.end(); it++)
         {
-            NS_LOG_INFO("AfterBlockValidation: Block was orphan");
-             m_blockchain.RemoveOrphan(newBlock);
-        }
+            m_peerMonitor.RequestTimedOut(GetChunkHash(blockHash, it->first));
 
-        m_meanBlockReceiveTime = (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks())*m_meanBlockReceiveTime
-                                + (newBlock.GetTimeReceived() - m_previousBlockReceiveTime)/(m_blockchain.GetTotalBlocks());
-        //std::cout << "m_meanBlockReceiveTime : "<<m_meanBlockReceiveTime <<"\n";
-        m_previousBlockReceiveTime = newBlock.GetTimeReceived();
-        
-        m_meanBlockPropagationTime =  (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks())*m_meanBlockPropagationTime
-                                + (newBlock.GetTimeReceived() -newBlock.GetTimeStamp())/(m_blockchain.GetTotalBlocks());
-        //std::cout << " m_meanBlockPropagationTime : "<< m_meanBlockPropagationTime <<"\n";
-        m_meanBlockSize = (m_blockchain.GetTotalBlocks() - 1)/static_cast<double>(m_blockchain.GetTotalBlocks()) * m_meanBlockSize
-                            + (newBlock.GetBlockSizeBytes())/static_cast<double>(m_blockchain.GetTotalBlocks());
-        
-        m_blockchain.AddBlock(newBlock);
-        AdvertiseNewBlock(newBlock);
-        ValidateOrphanChildren(newBlock);
-        
+            /*
+             * The last peer is kept, the block could not be downloaded at all without it
+             */
+            if(m_chunkSwarm.GetPeerCount(blockHash) > 1)
+                m_chunkSwarm.RemovePeer(blockHash, it->second);
+        }
 
+        RequestChunks(blockHash);
     }
 
     void
-    BlockchainNode::ValidateOrphanChildren(const Block &newBlock)
+    BlockchainNode::RemoveChunkDownload(const std::string &blockHash)
     {
         NS_LOG_FUNCTION(this);
 
-        std::vector<const Block *> children = m_blockchain.GetOrpharnChildrenPointer(newBlock);
-
-        if(children.size() == 0)
+        auto timeout = m_chunkTimeouts.find(blockHash);
+        if(timeout != m_chunkTimeouts.end())
         {
-            NS_LOG_INFO("ValidateOrphanChildren : Block has no orpharn children\n");
+            m_timerWheel.Cancel(timeout->second);
+            m_chunkTimeouts.erase(timeout);
         }
-        else
+
+        if(m_chunkSwarm.HasBlock(blockHash))
         {
-            NS_LOG_INFO("ValidateOrphanChildren : Block has orpharn children:");
-            std::vector<const Block *>::iterator block_it;
-            for(block_it = children.begin(); block_it < children.end(); block_it++)
+            std::map<int, Ipv4Address> released = m_chunkSwarm.ReleaseRequests(blockHash);
+
+            for(auto it = released.begin(); it != released.end(); it++)
             {
-                ValidateBlock(**block_it);
+                m_peerMonitor.RemoveRequest(GetChunkHash(blockHash, it->first));
             }
+            m_chunkSwarm.RemoveBlock(blockHash);
         }
     }
 
+    std::string
+    BlockchainNode::GetChunkHash(const std::string &blockHash, int chunk)
+    {
+        std::ostringstream stringStream;
+
+        stringStream << blockHash << ":" << chunk;
+        return stringStream.str();
+    }
+
     void
-    BlockchainNode::AdvertiseNewBlock(const Block &newBlock)
+    BlockchainNode::DisperseCodedBlock(const Block &newBlock)
     {
         NS_LOG_FUNCTION(this);
-        
-        rapidjson::Document d;
-        rapidjson::Value value;
-        rapidjson::Value array(rapidjson::kArrayType);
-        std::ostringstream stringStream;
-        std::string blockHash = stringStream.str();
-        d.SetObject();
 
-        value.SetString("blocks");
-        d.AddMember("type", value, d.GetAllocator());
+        double encodingTime = m_cpuModel.Reserve(m_cpuModel.GetErasureEncodeCost(newBlock.GetBlockSizeBytes(), m_erasureCode.GetParityShards()));
 
-        if(m_protocolType == STANDARD_PROTOCOL)
-        {
-            value = INV;
-            d.AddMember("message", value, d.GetAllocator());
+        NS_LOG_INFO("DisperseCodedBlock : Node " << GetNode()->GetId() << " encodes block " << newBlock.GetBlockHeight() << "/"
+                    << newBlock.GetMinerId() << " into " << m_erasureCode.GetTotalShards() << " chunks in " << encodingTime << "s");
 
-            stringStream << newBlock.GetBlockHeight() << "/" << newBlock.GetMinerId();
-            blockHash = stringStream.str();
-            value.SetString(blockHash.c_str(), blockHash.size(), d.GetAllocator());
-            array.PushBack(value, d.GetAllocator());
-            d.AddMember("inv", array, d.GetAllocator());
-        }
+        Simulator::Schedule(Seconds(encodingTime), &BlockchainNode::PushCodedChunks, this, newBlock);
+    }
 
-        rapidjson::StringBuffer packetInfo;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
-        d.Accept(writer);
+    void
+    BlockchainNode::PushCodedChunks(Block newBlock)
+    {
+        NS_LOG_FUNCTION(this);
 
-        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin() ; i != m_peersAddresses.end(); ++i)
-        {
-            if(*i != newBlock.GetReceivedFromIpv4())
-            {
-                const uint8_t delimiter[] = "#";
-                //std::cout<<"node : " <<GetNode()->GetId()<< " Advertise new block\n";
-                m_peersSockets[*i]->Send(reinterpret_cast<const uint8_t*>(packetInfo.GetString()), packetInfo.GetSize(), 0);
-                m_peersSockets[*i]->Send(delimiter, 1, 0);
+        int totalChunks = m_erasureCode.GetTotalShards();
+        int peers = m_peersAddresses.size();
 
-                if(m_protocolType == STANDARD_PROTOCOL)
-                {
-                    m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes;
-                }
-                NS_LOG_INFO("AdvertiseNewBlock: At time " << Simulator::Now().GetSeconds()
-                            << "s blockchain node " << GetNode()->GetId() << " advertised a new block to " << *i);
+        if(peers == 0)
+            return;
 
-            }
-        }
         /*
-        if( GetNode()->GetId() == 5){
-            std::cout<< "AdvertiseNeBlock: At time " << Simulator::Now().GetSeconds()
-                            << "s blockchain node " << GetNode()->GetId() << " advertised a new block(height) :" 
-                            << newBlock.GetBlockHeight() << " minerId : " << newBlock.GetMinerId() <<"\n";
+         * Each peer gets different chunks and forwards them in its lower Kadcast buckets,
+         * so the uplink of the producer carries (k + m)/k times the block instead of once per peer
+         */
+        std::string transactions = SerializeCodedTransactions(newBlock.GetTransactions());
+
+        for(int j = 0; j < std::max(totalChunks, peers); j++)
+        {
+            Ipv4Address     peer = m_peersAddresses[j % peers];
+            Address         address = InetSocketAddress(peer, m_blockchainPort);
+
+            QueueCodedChunk(newBlock, transactions, j % totalChunks, GetKadcastBucket(peer), address);
         }
-        */
-        
     }
 
     void
-    BlockchainNode::AdvertiseNewTransaction(const Transaction &newTrans, enum Messages megType, Ipv4Address receivedFromIpv4)
+    BlockchainNode::QueueCodedChunk(const Block &block, const std::string &transactions, int chunk, int kadcastHeight, Address &to)
     {
         NS_LOG_FUNCTION(this);
 
-        rapidjson::Document transD;
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        rapidjson::Value    array(rapidjson::kArrayType);
+        std::ostringstream  stringStream;
+        std::string         blockHash;
+        std::string         packet;
+        int                 messageSize = m_blockchainMessageHeader + m_inventorySizeBytes + m_blockHeadersSizeBytes + 2*m_countBytes
+                                        + m_erasureCode.GetShardSizeBytes(block.GetBlockSizeBytes());
 
-        int nodeId = newTrans.GetTransNodeId();
-        int transId = newTrans.GetTransId();
-        double tranTimestamp = newTrans.GetTransTimeStamp();
+        stringStream << block.GetBlockHeight() << "/" << block.GetMinerId();
+        blockHash = stringStream.str();
 
-        transD.SetObject();
+        d.SetObject();
 
-        rapidjson::Value value;
-        rapidjson::Value array(rapidjson::kArrayType);
-        rapidjson::Value transInfo(rapidjson::kObjectType);
+        value = CODED_CHUNK;
+        d.AddMember("message", value, d.GetAllocator());
+        value.SetString("coded");
+        d.AddMember("type", value, d.GetAllocator());
+        value.SetString(blockHash.c_str(), blockHash.size(), d.GetAllocator());
+        d.AddMember("blockHash", value, d.GetAllocator());
 
-        value.SetString("transaction");
-        transD.AddMember("type", value, transD.GetAllocator());
+        AddBlockHeader(d, array, block);
+        d.AddMember("blocks", array, d.GetAllocator());
 
-        value = megType;
-        transD.AddMember("message", value, transD.GetAllocator());
+        value = chunk;
+        d.AddMember("chunk", value, d.GetAllocator());
+        value = m_erasureCode.GetDataShards();
+        d.AddMember("dataChunks", value, d.GetAllocator());
+        value = kadcastHeight;
+        d.AddMember("kadcastHeight", value, d.GetAllocator());
+        value = messageSize;
+        d.AddMember("size", value, d.GetAllocator());
 
-        value = newTrans.GetTransNodeId();
-        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+        rapidjson::StringBuffer packetInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+        d.Accept(writer);
 
-        value = newTrans.GetTransId();
-        transInfo.AddMember("transId", value, transD.GetAllocator());
+        /*
+         * The transactions are the content of the block, any k chunks carry all of them. They are serialized
+         * once per block and appended as the last member of the message.
+         */
+        packet = packetInfo.GetString();
+        packet.insert(packet.size() - 1, ",\"transactions\":" + transactions);
 
-        value = newTrans.GetTransTimeStamp();
-        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+        NS_LOG_INFO("QueueCodedChunk : Node " << GetNode()->GetId() << " queues coded chunk " << chunk << " of block " << blockHash
+                    << " (" << messageSize << " Bytes, height " << kadcastHeight << ") to " << InetSocketAddress::ConvertFrom(to).GetIpv4());
 
-        value = newTrans.IsValidated();
-        transInfo.AddMember("validation", value, transD.GetAllocator());
+        m_uploadScheduler.Enqueue(InetSocketAddress::ConvertFrom(to).GetIpv4(), to, packet, messageSize, 0);
+    }
 
-        value = newTrans.GetExecution();
-        transInfo.AddMember("execution", value, transD.GetAllocator());
+    std::string
+    BlockchainNode::SerializeCodedTransactions(const std::vector<Transaction> &transactions)
+    {
+        NS_LOG_FUNCTION(this);
 
-        array.PushBack(transInfo, transD.GetAllocator());
-        transD.AddMember("transactions", array, transD.GetAllocator());
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        rapidjson::Value    tranArray(rapidjson::kArrayType);
 
-        rapidjson::StringBuffer transactionInfo;
-        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
-        transD.Accept(tranWriter);
+        for(auto trans_it = transactions.begin(); trans_it < transactions.end(); trans_it++)
+        {
+            rapidjson::Value transInfo(rapidjson::kObjectType);
 
-        //std::cout<<"Type : " << m_committerType << " nodeId : " << GetNode()->GetId() <<" broadcaste " << megType <<"\n";
+            value = trans_it->GetTransNodeId();
+            transInfo.AddMember("nodeId", value, d.GetAllocator());
 
+            value = trans_it->GetTransId();
+            transInfo.AddMember("transId", value, d.GetAllocator());
 
-        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
-        {
-            if(*i != receivedFromIpv4)
-            {
-                const uint8_t delimiter[] = "#";
+            value = trans_it->GetTransTimeStamp();
+            transInfo.AddMember("timestamp", value, d.GetAllocator());
 
-                m_peersSockets[*i]->Send(reinterpret_cast<const uint8_t*>(transactionInfo.GetString()), transactionInfo.GetSize(), 0);
-                m_peersSockets[*i]->Send(delimiter, 1, 0);
-            }
-        
+            value = trans_it->GetTransSizeByte();
+            transInfo.AddMember("size", value, d.GetAllocator());
+
+            tranArray.PushBack(transInfo, d.GetAllocator());
         }
 
-    }
+        rapidjson::StringBuffer transactionsInfo;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(transactionsInfo);
+        tranArray.Accept(writer);
 
-    bool
-    BlockchainNode::HasTransaction(int nodeId, int transId)
-    {
-        for(auto const &transaction: m_transaction)
-        {
-            if(transaction.GetTransNodeId() == nodeId && transaction.GetTransId() == transId)
-            {
-                return true;
-            }
-        }
-        return false;
+        return transactionsInfo.GetString();
     }
 
-    bool
-    BlockchainNode::HasReplyTransaction(int nodeId, int transId, int transExecution)
+    void
+    BlockchainNode::ReceivedCodedChunk(rapidjson::Document &d, Address &from)
     {
-        for(auto const &transaction: m_replyTransaction)
-        {
-            if(transaction.GetTransNodeId() == nodeId && transaction.GetTransId() == transId && transaction.GetExecution() == transExecution)
-            {
-                return true;
-            }
-        }
-        return false;
-    }
+        NS_LOG_FUNCTION(this);
 
-    bool
-    BlockchainNode::HasMessageTransaction(int nodeId, int transId)
-    {
-        for(auto const &transaction: m_msgTransaction)
-        {
-            if(transaction.GetTransNodeId() == nodeId && transaction.GetTransId() == transId)
-            {
-                return true;
-            }
-        }
-        return false;
-    }
+        std::string     blockHash = d["blockHash"].GetString();
+        int             chunk = d["chunk"].GetInt();
+        int             kadcastHeight = d["kadcastHeight"].GetInt();
+        int             height = d["blocks"][0]["height"].GetInt();
+        int             minerId = d["blocks"][0]["minerId"].GetInt();
+        int             parentMinerId = d["blocks"][0]["parentBlockMinerId"].GetInt();
+        Ipv4Address     peer = InetSocketAddress::ConvertFrom(from).GetIpv4();
+        Block           header(height, minerId, d["blocks"][0]["nonce"].GetInt(), parentMinerId, d["blocks"][0]["size"].GetInt(),
+                               d["blocks"][0]["timeStamp"].GetDouble(), Simulator::Now().GetSeconds(), peer);
+        std::string     transactions;
 
-    bool
-    BlockchainNode::HasResultTransaction(int nodeId, int transId)
-    {
-        for(auto const &transaction: m_resultTransaction)
+        ReadHeaderExtensions(d["blocks"][0], header);
+
+        auto codedIt = m_codedBlocks.find(blockHash);
+
+        if(!m_seenMessages.Insert(BlockchainSeenCache::MakeKey(CODED_CHUNK, minerId, height, chunk))
+            || (codedIt != m_codedBlocks.end() && codedIt->second.chunks.find(chunk) != codedIt->second.chunks.end()))
         {
-            if(transaction.GetTransNodeId() == nodeId && transaction.GetTransId() == transId)
-            {
-                return true;
-            }
+            NS_LOG_INFO("ReceivedCodedChunk : Node " << GetNode()->GetId() << " already has coded chunk " << chunk << " of block " << blockHash);
+            m_nodeStats->codedChunkDuplicates++;
+            return;
         }
-        return false;
-    }
 
-    bool
-    BlockchainNode::HasTransactionAndValidated(int nodeId, int transId)
-    {
-        for(auto const &transaction: m_transaction)
+        /*
+         * The chunks of a block are collected until it is rebuilt, received in full or requested with GET_DATA
+         */
+        if(codedIt == m_codedBlocks.end() && !m_blockchain.HasBlock(height, minerId) && !m_blockchain.IsOrphan(height, minerId)
+            && !ReceivedButNotValidated(blockHash) && m_invTimeouts.find(blockHash) == m_invTimeouts.end()
+            && !m_downloadScheduler.IsPending(blockHash))
         {
-            if(transaction.GetTransNodeId() == nodeId && transaction.GetTransId() == transId && transaction.IsValidated() == true)
+            CodedBlock          &coded = m_codedBlocks[blockHash];
+            int                 parentHeight = height - 1;
+            std::ostringstream  stringStream;
+            std::string         parentBlockHash;
+            Time                timeout = m_invTimeoutMinutes;
+
+            coded.header = header;
+            coded.dataChunks = d["dataChunks"].GetInt();
+            coded.rebuilt = false;
+
+            for(unsigned int i = 0; i < d["transactions"].Size(); i++)
             {
-                return true;
+                coded.transactions.push_back(Transaction(d["transactions"][i]["nodeId"].GetInt(), d["transactions"][i]["transId"].GetInt(),
+                                                        d["transactions"][i]["timestamp"].GetDouble()));
+                coded.transactions.back().SetTransSizeByte(d["transactions"][i]["size"].GetInt());
             }
-        }
-        return false;
-    }
+            coded.serializedTransactions = SerializeCodedTransactions(coded.transactions);
 
-    void
-    BlockchainNode::CreateTransaction()
-    {
-        NS_LOG_FUNCTION(this);
+            stringStream << parentHeight << "/" << parentMinerId;
+            parentBlockHash = stringStream.str();
 
-        rapidjson::Document transD;
+            NS_LOG_INFO("ReceivedCodedChunk : Node " << GetNode()->GetId() << " starts collecting the chunks of block " << blockHash);
 
-        int nodeId = GetNode()->GetId();
-        int transId = m_transactionId;
-        double tranTimestamp = Simulator::Now().GetSeconds();
-        transD.SetObject();
+            RecordAnnouncement(blockHash);
+            m_onlyHeadersReceived[blockHash] = coded.header;
 
-        Transaction newTrans(nodeId, transId, tranTimestamp);
+            if(!m_blockchain.HasBlock(parentHeight, parentMinerId) && !m_blockchain.IsOrphan(parentHeight, parentMinerId)
+                && !ReceivedButNotValidated(parentBlockHash) && !OnlyHeadersReceived(parentBlockHash))
+            {
+                NS_LOG_INFO("ReceivedCodedChunk : the parent of block " << blockHash << " is missing");
 
-        rapidjson::Value value;
-        rapidjson::Value array(rapidjson::kArrayType);
-        rapidjson::Value transInfo(rapidjson::kObjectType);
+                m_queueInv[parentBlockHash].push_back(from);
+                if(m_invTimeouts.find(parentBlockHash) == m_invTimeouts.end() && !m_downloadScheduler.IsPending(parentBlockHash))
+                {
+                    RequestBlocks(std::vector<std::string>(1, parentBlockHash));
+                }
+            }
 
-        value.SetString("transaction");
-        transD.AddMember("type", value, transD.GetAllocator());
+            if(m_adaptiveInvTimeouts)
+                timeout = m_peerMonitor.GetTimeout(peer, coded.header.GetBlockSizeBytes() + m_blockchainMessageHeader, GetPriorThroughput(peer));
 
-        value = REQUEST_TRANS;
-        transD.AddMember("message", value, transD.GetAllocator());
+            m_codedBlockTimeouts[blockHash] = m_timerWheel.Arm(timeout, MakeCallback(&BlockchainNode::CodedBlockTimeoutExpired, this), blockHash);
 
-        value = newTrans.GetTransNodeId();
-        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+            codedIt = m_codedBlocks.find(blockHash);
+        }
 
-        value = newTrans.GetTransId();
-        transInfo.AddMember("transId", value, transD.GetAllocator());
+        if(codedIt != m_codedBlocks.end())
+        {
+            codedIt->second.chunks.insert(chunk);
+            codedIt->second.sources.insert(peer);
+            transactions = codedIt->second.serializedTransactions;
+        }
+        else
+        {
+            /*
+             * The block is no longer collected, the chunk is only forwarded
+             */
+            rapidjson::StringBuffer transactionsInfo;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(transactionsInfo);
+            d["transactions"].Accept(writer);
 
-        value = newTrans.GetTransTimeStamp();
-        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+            transactions = transactionsInfo.GetString();
+        }
 
-        value = newTrans.IsValidated();
-        transInfo.AddMember("validation", value, transD.GetAllocator());
+        /*
+         * Kadcast : a new chunk is forwarded to one random peer of each bucket below the height it came with
+         */
+        std::map<int, std::vector<Ipv4Address>> buckets;
 
-        value = newTrans.GetExecution();
-        transInfo.AddMember("execution", value, transD.GetAllocator());
+        for(auto it = m_peersAddresses.begin(); it != m_peersAddresses.end(); it++)
+        {
+            int bucket = GetKadcastBucket(*it);
 
-        array.PushBack(transInfo, transD.GetAllocator());
-        transD.AddMember("transactions", array, transD.GetAllocator());
+            if(*it != peer && bucket < kadcastHeight)
+                buckets[bucket].push_back(*it);
+        }
 
-        m_transaction.push_back(newTrans);
-        //m_notValidatedTransaction.push_back(newTrans);
+        for(auto it = buckets.begin(); it != buckets.end(); it++)
+        {
+            Address address = InetSocketAddress(it->second[rand() % it->second.size()], m_blockchainPort);
+            QueueCodedChunk(header, transactions, chunk, it->first, address);
+        }
 
-        rapidjson::StringBuffer transactionInfo;
-        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
-        transD.Accept(tranWriter);
+        if(codedIt == m_codedBlocks.end())
+            return;
 
-        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
+        CodedBlock &coded = codedIt->second;
+
+        if(!coded.rebuilt && static_cast<int>(coded.chunks.size()) >= coded.dataChunks)
         {
-            const uint8_t delimiter[] = "#";
+            int missingChunks = 0;
 
-            m_peersSockets[*i]->Send(reinterpret_cast<const uint8_t*>(transactionInfo.GetString()), transactionInfo.GetSize(), 0);
-            m_peersSockets[*i]->Send(delimiter, 1, 0);
-        
-        }
-        //std::cout<< "time : "<<Simulator::Now().GetSeconds() << ", Node type: "<< m_committerType <<" - NodeId: " <<GetNode()->GetId() << " created and sent transaction\n";
-        m_transactionId++;
+            for(int i = 0; i < coded.dataChunks; i++)
+            {
+                if(coded.chunks.find(i) == coded.chunks.end())
+                    missingChunks++;
+            }
 
-        ScheduleNextTransaction();
+            coded.rebuilt = true;
 
-    }
+            double decodingTime = m_cpuModel.Reserve(m_cpuModel.GetErasureDecodeCost(coded.header.GetBlockSizeBytes(), missingChunks));
 
-    void
-    BlockchainNode::ScheduleNextTransaction()
-    {
-        NS_LOG_FUNCTION(this);
-        double tTime = rand()%m_creatingTransactionTime+1;
-        //std::cout<<"crateing time = " << tTime << "\n";
-        m_nextTransaction = Simulator::Schedule(Seconds(tTime), &BlockchainNode::CreateTransaction, this);
+            NS_LOG_INFO("ReceivedCodedChunk : At time " << Simulator::Now().GetSeconds() << " Node " << GetNode()->GetId()
+                        << " received " << coded.dataChunks << " chunks of block " << blockHash << " from " << coded.sources.size()
+                        << " peers, " << missingChunks << " data chunks are rebuilt in " << decodingTime << "s");
 
+            Simulator::Schedule(Seconds(decodingTime), &BlockchainNode::RebuildCodedBlock, this, blockHash);
+        }
     }
 
     void
-    BlockchainNode::ExecuteTransaction(const Transaction &newTrans, Ipv4Address receivedFromIpv4)
+    BlockchainNode::RebuildCodedBlock(std::string blockHash)
     {
         NS_LOG_FUNCTION(this);
 
-        rapidjson::Document transD;
+        auto it = m_codedBlocks.find(blockHash);
 
-        int nodeId = newTrans.GetTransNodeId();
-        int transId = newTrans.GetTransId();
-        double tranTimestamp = newTrans.GetTransTimeStamp();
+        if(it == m_codedBlocks.end())
+            return;
 
-        //newTrans.SetExecution();
-        transD.SetObject();
+        const Block &header = it->second.header;
 
-        rapidjson::Value value;
-        rapidjson::Value array(rapidjson::kArrayType);
-        rapidjson::Value transInfo(rapidjson::kObjectType);
+        if(m_codedBlockTimeouts.find(blockHash) != m_codedBlockTimeouts.end())
+        {
+            m_timerWheel.Cancel(m_codedBlockTimeouts[blockHash]);
+            m_codedBlockTimeouts.erase(blockHash);
+        }
 
-        value.SetString("transaction");
-        transD.AddMember("type", value, transD.GetAllocator());
+        if(m_blockchain.HasBlock(header.GetBlockHeight(), header.GetMinerId()) || m_blockchain.IsOrphan(header.GetBlockHeight(), header.GetMinerId())
+            || ReceivedButNotValidated(blockHash))
+        {
+            NS_LOG_INFO("RebuildCodedBlock : Node " << GetNode()->GetId() << " received block " << blockHash << " in full meanwhile");
+            m_codedBlocks.erase(it);
+            return;
+        }
 
-        value = REPLY_TRANS;
-        transD.AddMember("message", value, transD.GetAllocator());
+        Block newBlock(header.GetBlockHeight(), header.GetMinerId(), header.GetNonce(), header.GetParentBlockMinerId(),
+                        header.GetBlockSizeBytes(), header.GetTimeStamp(), Simulator::Now().GetSeconds(), header.GetReceivedFromIpv4());
+        newBlock.SetTransactions(it->second.transactions);
+        newBlock.SetUncles(header.GetUncles());
+        newBlock.SetDifficulty(header.GetDifficulty());
 
-        value = newTrans.GetTransNodeId();
-        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+        /*
+         * The later chunks of the block are dropped by m_seenMessages, the entry is not needed anymore
+         */
+        m_codedBlocks.erase(it);
 
-        value = newTrans.GetTransId();
-        transInfo.AddMember("transId", value, transD.GetAllocator());
+        ReceivedDownloadedBlock(newBlock);
+        ProcessPendingRequests();
+    }
 
-        value = newTrans.GetTransTimeStamp();
-        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+    void
+    BlockchainNode::CodedBlockTimeoutExpired(std::string blockHash)
+    {
+        NS_LOG_FUNCTION(this);
 
-        value = newTrans.IsValidated();
-        transInfo.AddMember("validation", value, transD.GetAllocator());
-        
-        value = newTrans.GetExecution();
-        transInfo.AddMember("execution", value, transD.GetAllocator());
+        m_codedBlockTimeouts.erase(blockHash);
 
-        array.PushBack(transInfo, transD.GetAllocator());
-        transD.AddMember("transactions", array, transD.GetAllocator());
+        auto it = m_codedBlocks.find(blockHash);
 
-        rapidjson::StringBuffer transactionInfo;
-        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
-        transD.Accept(tranWriter);
+        if(it == m_codedBlocks.end() || it->second.rebuilt)
+            return;
 
- 
-        const uint8_t delimiter[] = "#";
+        NS_LOG_INFO("CodedBlockTimeoutExpired : Node " << GetNode()->GetId() << " has " << it->second.chunks.size() << " of the "
+                    << it->second.dataChunks << " chunks of block " << blockHash);
+
+        m_nodeStats->codedBlockFallbacks++;
 
-        m_peersSockets[receivedFromIpv4]->Send(reinterpret_cast<const uint8_t*>(transactionInfo.GetString()), transactionInfo.GetSize(), 0);
-        m_peersSockets[receivedFromIpv4]->Send(delimiter, 1, 0);
-    
+        /*
+         * The announcements of the block are requested from now on. Without any, the chunks are still collected.
+         */
+        if(m_queueInv.find(blockHash) != m_queueInv.end() && m_invTimeouts.find(blockHash) == m_invTimeouts.end()
+            && !m_downloadScheduler.IsPending(blockHash))
+        {
+            RequestBlocks(std::vector<std::string>(1, blockHash));
+        }
 
+        if(m_invTimeouts.find(blockHash) != m_invTimeouts.end() || m_downloadScheduler.IsPending(blockHash))
+            m_codedBlocks.erase(it);
     }
 
-    void
-    BlockchainNode::NotifyTransaction(const Transaction &newTrans)
+    bool
+    BlockchainNode::IsCollectingCodedChunks(const std::string &blockHash)
     {
-        NS_LOG_FUNCTION(this);
+        return m_codedBlockTimeouts.find(blockHash) != m_codedBlockTimeouts.end();
+    }
 
-        rapidjson::Document transD;
+    int
+    BlockchainNode::GetKadcastBucket(Ipv4Address peer)
+    {
+        /*
+         * The overlay IDs are hashes (the MurmurHash3 finalizer) of the node ids, so every node sees the same ID for a
+         * given node. A peer is known by the address of its end of the link, resolved once to its node id.
+         */
+        std::map<Ipv4Address, uint32_t>::iterator peerId = m_kadcastPeerNodeIds.find(peer);
 
-        int nodeId = newTrans.GetTransNodeId();
-        int transId = newTrans.GetTransId();
-        double tranTimestamp = newTrans.GetTransTimeStamp();
+        if(peerId == m_kadcastPeerNodeIds.end())
+        {
+            NodeList::Iterator node;
 
-        transD.SetObject();
+            for(node = NodeList::Begin(); node != NodeList::End(); node++)
+            {
+                Ptr<Ipv4> ipv4 = (*node)->GetObject<Ipv4>();
 
-        rapidjson::Value value;
-        rapidjson::Value array(rapidjson::kArrayType);
-        rapidjson::Value transInfo(rapidjson::kObjectType);
+                if(ipv4 && ipv4->GetInterfaceForAddress(peer) >= 0)
+                    break;
+            }
 
-        value.SetString("transaction");
-        transD.AddMember("type", value, transD.GetAllocator());
+            if(node == NodeList::End())
+                NS_FATAL_ERROR("The peer " << peer << " of node " << GetNode()->GetId() << " is not the address of any node");
 
-        value = RESULT_TRANS;
-        transD.AddMember("message", value, transD.GetAllocator());
+            peerId = m_kadcastPeerNodeIds.insert(std::make_pair(peer, (*node)->GetId())).first;
+        }
 
-        value = newTrans.GetTransNodeId();
-        transInfo.AddMember("nodeId", value, transD.GetAllocator());
+        uint32_t ids[2] = {GetNode()->GetId(), peerId->second};
 
-        value = newTrans.GetTransId();
-        transInfo.AddMember("transId", value, transD.GetAllocator());
+        for(int i = 0; i < 2; i++)
+        {
+            ids[i] ^= ids[i] >> 16;
+            ids[i] *= 0x85ebca6b;
+            ids[i] ^= ids[i] >> 13;
+            ids[i] *= 0xc2b2ae35;
+            ids[i] ^= ids[i] >> 16;
+        }
 
-        value = newTrans.GetTransTimeStamp();
-        transInfo.AddMember("timestamp", value, transD.GetAllocator());
+        uint32_t distance = ids[0] ^ ids[1];
+        int      bucket = 0;
 
-        value = newTrans.IsValidated();
-        transInfo.AddMember("validation", value, transD.GetAllocator());
-        
-        value = newTrans.GetExecution();
-        transInfo.AddMember("execution", value, transD.GetAllocator());
+        while(distance >>= 1)
+            bucket++;
 
-        array.PushBack(transInfo, transD.GetAllocator());
-        transD.AddMember("transactions", array, transD.GetAllocator());
+        return bucket;
+    }
 
-        rapidjson::StringBuffer transactionInfo;
-        rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
-        transD.Accept(tranWriter);
+    uint64_t
+    BlockchainNode::GetReconciliationId(enum Messages megType, const Transaction &transaction) const
+    {
+        uint64_t words[4] = {static_cast<uint64_t>(megType), static_cast<uint64_t>(transaction.GetTransNodeId()),
+                            static_cast<uint64_t>(transaction.GetTransId()), static_cast<uint64_t>(transaction.GetExecution())};
 
-        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
-        {
-            
-            const uint8_t delimiter[] = "#";
+        /*
+         * Every node must compute the same IDs, so the key is fixed
+         */
+        return BlockchainCompactBlock::SipHash(0x0706050403020100ULL, 0x0f0e0d0c0b0a0908ULL, words, 4);
+    }
 
-            m_peersSockets[*i]->Send(reinterpret_cast<const uint8_t*>(transactionInfo.GetString()), transactionInfo.GetSize(), 0);
-            m_peersSockets[*i]->Send(delimiter, 1, 0);
-        
+    void
+    BlockchainNode::KeepRelayMessage(uint64_t id, const std::string &message, int payloadBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+
+        while(!m_relayMessageExpiries.empty() && m_relayMessageExpiries.front().first <= now)
+        {
+            m_relayMessages.erase(m_relayMessageExpiries.front().second);
+            m_relayMessageExpiries.pop_front();
         }
 
+        if(m_relayMessages.insert(std::make_pair(id, std::make_pair(message, payloadBytes))).second)
+        {
+            double window = 4 * (m_reconciliationInterval + m_trickleInterval) + m_invTimeoutMinutes.GetSeconds();
+
+            m_relayMessageExpiries.push_back(std::make_pair(now + window, id));
+        }
     }
 
+    void
+    BlockchainNode::SendTransactionMessage(const std::string &message, int payloadBytes, Ipv4Address peer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int     messageSize = m_blockchainMessageHeader + m_countBytes + payloadBytes;
 
+        /*
+         * The transaction messages share the upload link with the block transfers, under the same scheduling policy
+         */
+        m_nodeStats->transactionSentBytes += messageSize;
+        m_uploadScheduler.Enqueue(peer, InetSocketAddress(peer, m_blockchainPort), message, messageSize, 0);
+    }
 
     void
-    BlockchainNode::SendMessage(enum Messages receivedMessage, enum Messages responseMessage, rapidjson::Document &d, Ptr<Socket> outgoingSocket)
+    BlockchainNode::SendTransactionPacket(std::string message, Ipv4Address peer)
     {
         NS_LOG_FUNCTION(this);
 
         const uint8_t delimiter[] = "#";
 
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        m_peersSockets[peer]->Send(reinterpret_cast<const uint8_t*>(message.c_str()), message.size(), 0);
+        m_peersSockets[peer]->Send(delimiter, 1, 0);
+    }
 
-        d["message"].SetInt(responseMessage);
-        d.Accept(writer);
-        NS_LOG_INFO("Node " << GetNode()->GetId() << " got a "
-                    << getMessageName(receivedMessage) << " message "
-                    << " and sent a " << getMessageName(responseMessage)
-                    << " message: " << buffer.GetString() );
-        
-        outgoingSocket->Send(reinterpret_cast<const uint8_t*>(buffer.GetString()), buffer.GetSize(), 0);
-        outgoingSocket->Send(delimiter, 1, 0);
+    int
+    BlockchainNode::GetTransactionPayloadBytes(enum Messages megType, const Transaction &transaction) const
+    {
+        return megType == RESULT_TRANS ? m_inventorySizeBytes : transaction.GetTransSizeByte();
+    }
 
-        switch(d["message"].GetInt())
-        {
-            case INV:
-            {
-                m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size() * m_inventorySizeBytes;
-                break;
-            }
-            case REQUEST_TRANS:
-            {
-                break;
-            }
-            case GET_HEADERS:
-            {
-                m_nodeStats->getHeadersSentBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
-                break;
-            }
-            case HEADERS:
-            {
-                m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
-                break;
-            }
-            case GET_DATA:
-            {
-                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size() * m_inventorySizeBytes;
-                break;
-            }
-            case BLOCK:
-            {
-                for(uint16_t k = 0; k < d["blocks"].Size(); k++)
-                {
-                    m_nodeStats->blockSentBytes +=  d["blocks"][k]["size"].GetInt();
-                }
-                m_nodeStats->blockSentBytes += m_blockchainMessageHeader;
-                break;
-            }
-        }
+    int
+    BlockchainNode::GetTransactionPayloadBytes(enum Messages megType, const std::vector<Transaction> &transactions) const
+    {
+        int bytes = 0;
 
+        for(auto it = transactions.begin(); it != transactions.end(); it++)
+            bytes += GetTransactionPayloadBytes(megType, *it);
+
+        return bytes;
     }
 
-    void
-    BlockchainNode::SendMessage(enum Messages receivedMessage, enum Messages responseMessage, rapidjson::Document &d, Address &outgoingAddress)
+    int
+    BlockchainNode::GetTransactionPayloadBytes(const rapidjson::Value &transactions) const
+    {
+        int bytes = 0;
+
+        for(unsigned int j = 0; j < transactions.Size(); j++)
+            bytes += transactions[j]["size"].GetInt();
+
+        return bytes;
+    }
+
+    int
+    BlockchainNode::DrawTransactionSize(void)
     {
         NS_LOG_FUNCTION(this);
-        
-        const uint8_t delimiter[] = "#";
 
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        if(!m_transactionSizes.empty())
+            return m_transactionSizes[m_nextTransactionSize++ % m_transactionSizes.size()];
 
-        d["message"].SetInt(responseMessage);
-        d.Accept(writer);
-        NS_LOG_INFO("Node " << GetNode()->GetId() << " got a "
-                    << getMessageName(receivedMessage) << " message "
-                    << " and sent a " << getMessageName(responseMessage)
-                    << " message: " << buffer.GetString() );
-        
-        Ipv4Address outgoingIpv4Address = InetSocketAddress::ConvertFrom(outgoingAddress).GetIpv4();
-        std::map<Ipv4Address, Ptr<Socket>>::iterator it = m_peersSockets.find(outgoingIpv4Address);
+        if(m_transactionSizeSigma <= 0)
+            return static_cast<int>(m_averageTransacionSize + 0.5);
 
-        if(it == m_peersSockets.end())
-        {
-            m_peersSockets[outgoingIpv4Address] = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
-            m_peersSockets[outgoingIpv4Address]->Connect(InetSocketAddress(outgoingIpv4Address, m_blockchainPort));
-        }
+        /*
+         * Lognormal of mean m_averageTransacionSize, the normal variate comes from Box-Muller
+         */
+        double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+        double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+        double z = std::sqrt(-2 * std::log(u1)) * std::cos(2 * M_PI * u2);
+        double mu = std::log(m_averageTransacionSize) - m_transactionSizeSigma * m_transactionSizeSigma / 2;
+
+        return std::max(1, static_cast<int>(std::exp(mu + m_transactionSizeSigma * z) + 0.5));
+    }
 
-        m_peersSockets[outgoingIpv4Address]->Send(reinterpret_cast<const uint8_t*>(buffer.GetString()), buffer.GetSize(), 0);
-        m_peersSockets[outgoingIpv4Address]->Send(delimiter, 1, 0);
-        
-        switch(d["message"].GetInt())
-        {
-            case INV:
-            {
-                m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size() * m_inventorySizeBytes;
-                break;
-            }
-            case REQUEST_TRANS:
-            {
-                break;
-            }
-            case GET_HEADERS:
-            {
-                m_nodeStats->getHeadersSentBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
-                break;
-            }
-            case HEADERS:
-            {
-                m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
-                break;
-            }
-            case GET_DATA:
-            {
-                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size() * m_inventorySizeBytes;
-                break;
-            }
-            case BLOCK:
-            {
-                //std::cout<<"start add block size"<<"\n";
-                for(int k = 0; k < d["blocks"].Size(); k++)
-                {
-                    m_nodeStats->blockSentBytes +=  d["blocks"][k]["size"].GetInt();
-                }
-                m_nodeStats->blockSentBytes += m_blockchainMessageHeader;
-                //std::cout<<"finish add block size"<<"\n";
-                break;
-            }
+    void
+    BlockchainNode::RelayTransaction(const std::string &message, enum Messages megType, const Transaction &transaction, Ipv4Address peer, int ttl)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_trickleInterval > 0)
+        {
+            if(m_trickleQueue.AddTransaction(peer, megType, transaction, ttl))
+                ScheduleTrickle(peer);
+        }
+        else
+        {
+            SendTransactionMessage(message, GetTransactionPayloadBytes(megType, transaction), peer);
         }
     }
 
+    int
+    BlockchainNode::GetGossipTtl(void) const
+    {
+        return m_gossipTtl > 0 ? static_cast<int>(m_gossipTtl) : -1;
+    }
+
+    int
+    BlockchainNode::GetRelayTtl(const rapidjson::Value &transaction) const
+    {
+        return transaction.HasMember("ttl") ? transaction["ttl"].GetInt() - 1 : -1;
+    }
+
     void
-    BlockchainNode::SendMessage(enum Messages receivedMessage, enum Messages responseMessage, std::string packet, Address &outgoingAddress)
+    BlockchainNode::GossipTransaction(const std::string &message, enum Messages megType, const Transaction &transaction, Ipv4Address receivedFromIpv4, int ttl)
     {
         NS_LOG_FUNCTION(this);
-        
-        const uint8_t delimiter[] = "#";
-        rapidjson::Document d;
 
-        rapidjson::StringBuffer buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-
-        d.Parse(packet.c_str());
-        d["message"].SetInt(responseMessage);
-        d.Accept(writer);
-        NS_LOG_INFO("Node " << GetNode()->GetId() << " got a "
-                    << getMessageName(receivedMessage) << " message "
-                    << " and sent a " << getMessageName(responseMessage)
-                    << " message: " << buffer.GetString() );
-        
-        Ipv4Address outgoingIpv4Address = InetSocketAddress::ConvertFrom(outgoingAddress).GetIpv4();
-        std::map<Ipv4Address, Ptr<Socket>>::iterator it = m_peersSockets.find(outgoingIpv4Address);
+        std::vector<Ipv4Address>    candidates;
+        unsigned int                fanout = 0;
 
-        if(it == m_peersSockets.end())
+        for(std::vector<Ipv4Address>::const_iterator i = m_peersAddresses.begin(); i != m_peersAddresses.end(); ++i)
         {
-            m_peersSockets[outgoingIpv4Address] = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
-            m_peersSockets[outgoingIpv4Address]->Connect(InetSocketAddress(outgoingIpv4Address, m_blockchainPort));
+            if(*i != receivedFromIpv4)
+                candidates.push_back(*i);
         }
 
-        m_peersSockets[outgoingIpv4Address]->Send(reinterpret_cast<const uint8_t*>(buffer.GetString()), buffer.GetSize(), 0);
-        m_peersSockets[outgoingIpv4Address]->Send(delimiter, 1, 0);
-        
-        switch(d["message"].GetInt())
+        switch(m_gossipFanout)
         {
-            case INV:
-            {
-                m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size() * m_inventorySizeBytes;
-                break;
-            }
-            case REQUEST_TRANS:
-            {
-                break;
-            }
-            case GET_HEADERS:
+            case GOSSIP_FANOUT_SQRT:
             {
-                m_nodeStats->getHeadersSentBytes += m_blockchainMessageHeader + m_getHeaderSizeBytes;
-                break;
-            }
-            case HEADERS:
-            {
-                m_nodeStats->headersSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size()*m_headersSizeBytes;
+                while(fanout * fanout < candidates.size())
+                    fanout++;
                 break;
             }
-            case GET_DATA:
+            case GOSSIP_FANOUT_FIXED:
             {
-                m_nodeStats->getDataSentBytes += m_blockchainMessageHeader + m_countBytes + d["blocks"].Size() * m_inventorySizeBytes;
+                fanout = m_gossipFanoutPeers;
                 break;
             }
-            case BLOCK:
+            default:
             {
-                for(uint16_t k = 0; k < d["blocks"].Size(); k++)
-                {
-                    m_nodeStats->blockSentBytes +=  d["blocks"][k]["size"].GetInt();
-                }
-                m_nodeStats->blockSentBytes += m_blockchainMessageHeader;
+                fanout = candidates.size();
                 break;
             }
         }
 
+        if(fanout < candidates.size())
+            std::random_shuffle(candidates.begin(), candidates.end());
+        else
+            fanout = candidates.size();
+
+        /*
+         * The announced transactions are kept to answer the GET_TRANS of the peers
+         */
+        if(m_gossipMode != GOSSIP_PUSH)
+            KeepRelayMessage(GetReconciliationId(megType, transaction), message, GetTransactionPayloadBytes(megType, transaction));
+
+        for(unsigned int i = 0; i < candidates.size(); i++)
+        {
+            if(i < fanout && m_gossipMode != GOSSIP_PULL)
+                RelayTransaction(message, megType, transaction, candidates[i], ttl);
+            else if(i < fanout || m_gossipMode == GOSSIP_PUSH_PULL)
+                SendTransactionInv(megType, transaction, candidates[i]);
+        }
     }
 
     void
-    BlockchainNode::InvTimeoutExpired(std::string blockHash)
+    BlockchainNode::SendTransactionInv(enum Messages megType, const Transaction &transaction, Ipv4Address peer)
     {
         NS_LOG_FUNCTION(this);
-        
-        std::string     invDelimiter = "/";
-        size_t          invPos = blockHash.find(invDelimiter);
 
-        int height = atoi(blockHash.substr(0, invPos).c_str());
-        int minerId = atoi(blockHash.substr(invPos+1, blockHash.size()).c_str());
+        Address             address = InetSocketAddress(peer, m_blockchainPort);
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        rapidjson::Value    array(rapidjson::kArrayType);
+        rapidjson::Value    transInfo(rapidjson::kObjectType);
 
-        NS_LOG_INFO("Node " << GetNode()->GetId() << " : At time " << Simulator::Now().GetSeconds()
-                    << " the timeour for block " << blockHash << " expired");
+        d.SetObject();
 
-        /*
-        std::cout<<"Node " << GetNode()->GetId() << " : At time " << Simulator::Now().GetSeconds()
-                    << " the timeour for block " << blockHash << " expired\n"; */           
+        value = TRANS_INV;
+        d.AddMember("message", value, d.GetAllocator());
 
-        m_nodeStats->blockTimeouts++;
+        value = megType;
+        transInfo.AddMember("message", value, d.GetAllocator());
+        value = transaction.GetTransNodeId();
+        transInfo.AddMember("nodeId", value, d.GetAllocator());
+        value = transaction.GetTransId();
+        transInfo.AddMember("transId", value, d.GetAllocator());
+        value = transaction.GetExecution();
+        transInfo.AddMember("execution", value, d.GetAllocator());
+
+        array.PushBack(transInfo, d.GetAllocator());
+        d.AddMember("transactions", array, d.GetAllocator());
+
+        SendMessage(NO_MESSAGE, TRANS_INV, d, address);
+    }
 
-        m_queueInv[blockHash].erase(m_queueInv[blockHash].begin());
-        m_invTimeouts.erase(blockHash);
+    void
+    BlockchainNode::ReceivedTransactionInv(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
 
-        if(!m_queueInv[blockHash].empty() && !m_blockchain.HasBlock(height, minerId)
-            && !m_blockchain.IsOrphan(height, minerId) && !ReceivedButNotValidated(blockHash))
+        rapidjson::Document request;
+        rapidjson::Value    value;
+        rapidjson::Value    idArray(rapidjson::kArrayType);
+
+        request.SetObject();
+
+        for(unsigned int j = 0; j < d["transactions"].Size(); j++)
         {
-            rapidjson::Document     d;
-            EventId                 timeout;
-            rapidjson::Value        value(INV);
-            rapidjson::Value        array(rapidjson::kArrayType);
+            enum Messages   megType = static_cast<enum Messages>(d["transactions"][j]["message"].GetInt());
+            int             nodeId = d["transactions"][j]["nodeId"].GetInt();
+            int             transId = d["transactions"][j]["transId"].GetInt();
+            int             transExecution = d["transactions"][j]["execution"].GetInt();
+            Transaction     transaction(nodeId, transId, 0);
 
-            d.SetObject();
-        
-            d.AddMember("message", value, d.GetAllocator());
-            value.SetString("block");
-            d.AddMember("type", value, d.GetAllocator());
+            /*
+             * The clients do not handle REQUEST_TRANS and MSG_TRANS
+             */
+            if(m_committerType == CLIENT && (megType == REQUEST_TRANS || megType == MSG_TRANS))
+                continue;
 
-            value.SetString(blockHash.c_str(), blockHash.size(), d.GetAllocator());
-            array.PushBack(value, d.GetAllocator());
-            d.AddMember("blocks", array, d.GetAllocator());
+            if(m_seenMessages.Contains(BlockchainSeenCache::MakeKey(megType, nodeId, transId, megType == REPLY_TRANS ? transExecution : 0)))
+                continue;
 
-            int index = rand()%m_queueInv[blockHash].size();
-            Address temp = m_queueInv[blockHash][0];
-            m_queueInv[blockHash][0] = m_queueInv[blockHash][index];
-            m_queueInv[blockHash][index] = temp;
+            /*
+             * The requested IDs go to the seen cache too, so a transaction is pulled from one peer only
+             */
+            transaction.SetExecution(transExecution);
+            uint64_t id = GetReconciliationId(megType, transaction);
 
-            
-            SendMessage(INV, GET_HEADERS, d, *(m_queueInv[blockHash].begin()));
-            
-            SendMessage(INV, GET_DATA, d, *(m_queueInv[blockHash].begin()));
+            if(!m_seenMessages.Insert(id))
+                continue;
 
-            timeout = Simulator::Schedule(m_invTimeoutMinutes, &BlockchainNode::InvTimeoutExpired, this, blockHash);
-            m_invTimeouts[blockHash] = timeout;
+            value.SetUint64(id);
+            idArray.PushBack(value, request.GetAllocator());
         }
-        else
+
+        if(idArray.Size() == 0)
+            return;
+
+        value = GET_TRANS;
+        request.AddMember("message", value, request.GetAllocator());
+        request.AddMember("ids", idArray, request.GetAllocator());
+
+        SendMessage(TRANS_INV, GET_TRANS, request, from);
+    }
+
+    void
+    BlockchainNode::ReceivedTransactionRequest(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Ipv4Address peer = InetSocketAddress::ConvertFrom(from).GetIpv4();
+
+        for(unsigned int i = 0; i < d["ids"].Size(); i++)
         {
-            m_queueInv.erase(blockHash);
+            auto message = m_relayMessages.find(d["ids"][i].GetUint64());
+
+            if(message != m_relayMessages.end())
+            {
+                SendTransactionMessage(message->second.first, message->second.second, peer);
+                m_nodeStats->gossipPulledTransactions++;
+            }
         }
+    }
 
+    void
+    BlockchainNode::ReceivedConsensusMessage(rapidjson::Document &d, Address &)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("ReceivedConsensusMessage : Node " << GetNode()->GetId() << " is not a validator and ignores a "
+                    << getMessageName(static_cast<enum Messages>(d["message"].GetInt())) << " message");
     }
 
-    bool
-    BlockchainNode::ReceivedButNotValidated(std::string blockHash)
+    void
+    BlockchainNode::ScheduleTrickle(Ipv4Address peer)
     {
         NS_LOG_FUNCTION(this);
 
-        if(m_receivedNotValidated.find(blockHash) != m_receivedNotValidated.end())
-            return true;
-        else
-            return false;
+        m_trickleEvents[peer] = Simulator::Schedule(Seconds(m_trickleQueue.GetNextDelay()), &BlockchainNode::FlushAnnouncements, this, peer);
     }
 
     void
-    BlockchainNode::RemoveReceivedButNotvalidated(std::string blockHash)
+    BlockchainNode::FlushAnnouncements(Ipv4Address peer)
     {
         NS_LOG_FUNCTION(this);
 
-        if(m_receivedNotValidated.find(blockHash) != m_receivedNotValidated.end())
+        const uint8_t           delimiter[] = "#";
+        PendingAnnouncements    pending = m_trickleQueue.Take(peer);
+        int                     items = 0;
+        int                     messages = 0;
+
+        m_trickleEvents.erase(peer);
+
+        if(!pending.blocks.empty())
         {
-            m_receivedNotValidated.erase(blockHash);
+            rapidjson::Document d;
+            rapidjson::Value    value;
+            rapidjson::Value    array(rapidjson::kArrayType);
+
+            d.SetObject();
+
+            value.SetString("blocks");
+            d.AddMember("type", value, d.GetAllocator());
+            value = INV;
+            d.AddMember("message", value, d.GetAllocator());
+
+            for(auto it = pending.blocks.begin(); it != pending.blocks.end(); it++)
+            {
+                value.SetString(it->c_str(), it->size(), d.GetAllocator());
+                array.PushBack(value, d.GetAllocator());
+            }
+            d.AddMember("inv", array, d.GetAllocator());
+
+            rapidjson::StringBuffer packetInfo;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+            d.Accept(writer);
+
+            m_peersSockets[peer]->Send(reinterpret_cast<const uint8_t*>(packetInfo.GetString()), packetInfo.GetSize(), 0);
+            m_peersSockets[peer]->Send(delimiter, 1, 0);
+
+            m_nodeStats->invSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes;
+            m_nodeStats->announcementSentBytes += m_blockchainMessageHeader + m_countBytes + d["inv"].Size()*m_inventorySizeBytes;
+
+            items += pending.blocks.size();
+            messages++;
         }
-        else
+
+        for(auto it = pending.transactions.begin(); it != pending.transactions.end(); it++)
         {
-            NS_LOG_WARN("Block was not found in m_receivedNotValidated");
+            rapidjson::Document d;
+            rapidjson::Value    value;
+            rapidjson::Value    array(rapidjson::kArrayType);
+
+            d.SetObject();
+
+            value.SetString("transaction");
+            d.AddMember("type", value, d.GetAllocator());
+            value = it->first;
+            d.AddMember("message", value, d.GetAllocator());
+
+            for(auto trans_it = it->second.begin(); trans_it != it->second.end(); trans_it++)
+            {
+                rapidjson::Value    transInfo(rapidjson::kObjectType);
+                int                 ttl = pending.ttls[it->first][trans_it - it->second.begin()];
+
+                value = trans_it->GetTransNodeId();
+                transInfo.AddMember("nodeId", value, d.GetAllocator());
+
+                value = trans_it->GetTransId();
+                transInfo.AddMember("transId", value, d.GetAllocator());
+
+                value = trans_it->GetTransTimeStamp();
+                transInfo.AddMember("timestamp", value, d.GetAllocator());
+
+                value = trans_it->IsValidated();
+                transInfo.AddMember("validation", value, d.GetAllocator());
+
+                value = trans_it->GetExecution();
+                transInfo.AddMember("execution", value, d.GetAllocator());
+
+                value = trans_it->GetFee();
+                transInfo.AddMember("fee", value, d.GetAllocator());
+
+                value = trans_it->GetTransSizeByte();
+                transInfo.AddMember("size", value, d.GetAllocator());
+
+                if(ttl > 0)
+                {
+                    value = ttl;
+                    transInfo.AddMember("ttl", value, d.GetAllocator());
+                }
+
+                array.PushBack(transInfo, d.GetAllocator());
+            }
+            d.AddMember("transactions", array, d.GetAllocator());
+
+            rapidjson::StringBuffer transactionInfo;
+            rapidjson::Writer<rapidjson::StringBuffer> tranWriter(transactionInfo);
+            d.Accept(tranWriter);
+
+            SendTransactionMessage(transactionInfo.GetString(), GetTransactionPayloadBytes(static_cast<enum Messages>(it->first), it->second), peer);
+
+            items += it->second.size();
+            messages++;
         }
-    }
 
-    bool
-    BlockchainNode::OnlyHeadersReceived (std::string blockHash)
-    {
-        NS_LOG_FUNCTION(this);
-        
-        if(m_onlyHeadersReceived.find(blockHash) != m_onlyHeadersReceived.end())
-            return true;
-        else
-            return false;
+        NS_LOG_INFO("FlushAnnouncements : At time " << Simulator::Now().GetSeconds() << " Node " << GetNode()->GetId()
+                    << " sent " << items << " announcements in " << messages << " messages to " << peer);
+
+        m_trickleQueue.RecordFlush(peer, items, messages);
     }
 
     void
-    BlockchainNode::RemoveSendTime()
+    BlockchainNode::ReconcileTransactions(void)
     {
         NS_LOG_FUNCTION(this);
 
-        NS_LOG_INFO("RemoveSendTime : At time " << Simulator::Now().GetSeconds()
-                    << " " << m_sendBlockTimes.front() << " was removed");
+        Ipv4Address         peer = m_peersAddresses[m_nextReconciliationPeer++ % m_peersAddresses.size()];
+        Address             address = InetSocketAddress(peer, m_blockchainPort);
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        uint64_t            nonce = (static_cast<uint64_t>(rand()) << 32) | static_cast<uint32_t>(rand());
+
+        d.SetObject();
+
+        value = REQ_RECON;
+        d.AddMember("message", value, d.GetAllocator());
+        value = static_cast<int>(m_reconciliationSets[peer].size());
+        d.AddMember("setSize", value, d.GetAllocator());
+        value = m_reconciliationQ;
+        d.AddMember("q", value, d.GetAllocator());
+        value.SetUint64(nonce);
+        d.AddMember("nonce", value, d.GetAllocator());
 
-        m_sendBlockTimes.erase(m_sendBlockTimes.begin()); 
+        SendMessage(NO_MESSAGE, REQ_RECON, d, address);
+
+        m_nextReconciliation = Simulator::Schedule(Seconds(2 * m_reconciliationInterval / m_peersAddresses.size()),
+                                                &BlockchainNode::ReconcileTransactions, this);
     }
 
     void
-    BlockchainNode::RemoveCompressedBlockSendTime()
+    BlockchainNode::ReceivedReconciliationRequest(rapidjson::Document &d, Address &from)
     {
         NS_LOG_FUNCTION(this);
-        NS_LOG_INFO("RemoveCompressedBlockSendTime: At time " << Simulator::Now().GetSeconds()
-                    << " " << m_sendCompressedBlockTimes.front() << " was removed");
 
-        m_sendCompressedBlockTimes.erase(m_sendCompressedBlockTimes.begin());
+        Ipv4Address             peer = InetSocketAddress::ConvertFrom(from).GetIpv4();
+        std::set<uint64_t>      &reconciliationSet = m_reconciliationSets[peer];
+        int                     peerSetSize = d["setSize"].GetInt();
+        int                     setSize = reconciliationSet.size();
+        uint64_t                nonce = d["nonce"].GetUint64();
+        rapidjson::Document     sketch;
+        rapidjson::Value        value;
+        rapidjson::Value        cellArray(rapidjson::kArrayType);
+        int                     messageSize = m_blockchainMessageHeader + m_countBytes + m_shortIdNonceSizeBytes;
+
+        /*
+         * The capacity of the sketch is the difference expected from the set sizes and q, as in Erlay.
+         * An empty set needs no sketch : the peer sends us its whole set.
+         */
+        if(setSize > 0)
+        {
+            int             capacity = std::abs(setSize - peerSetSize) + static_cast<int>(d["q"].GetDouble() * std::min(setSize, peerSetSize)) + 1;
+            BlockchainIblt  iblt(BlockchainIblt::GetCellsForDifference(capacity), nonce);
+
+            for(auto it = reconciliationSet.begin(); it != reconciliationSet.end(); it++)
+            {
+                iblt.Insert(*it);
+            }
+
+            for(auto it = iblt.GetCells().begin(); it != iblt.GetCells().end(); it++)
+            {
+                value = it->count;
+                cellArray.PushBack(value, sketch.GetAllocator());
+                value.SetUint64(it->keySum);
+                cellArray.PushBack(value, sketch.GetAllocator());
+                value = it->hashSum;
+                cellArray.PushBack(value, sketch.GetAllocator());
+            }
+            messageSize += iblt.GetSizeBytes();
+        }
+
+        m_sketchedTransactions[peer].insert(reconciliationSet.begin(), reconciliationSet.end());
+        reconciliationSet.clear();
 
+        sketch.SetObject();
+
+        value = SKETCH;
+        sketch.AddMember("message", value, sketch.GetAllocator());
+        value = setSize;
+        sketch.AddMember("setSize", value, sketch.GetAllocator());
+        value.SetUint64(nonce);
+        sketch.AddMember("nonce", value, sketch.GetAllocator());
+        sketch.AddMember("cells", cellArray, sketch.GetAllocator());
+        value = messageSize;
+        sketch.AddMember("size", value, sketch.GetAllocator());
+
+        SendMessage(REQ_RECON, SKETCH, sketch, from);
     }
 
     void
-    BlockchainNode::RemoveReceiveTime()
+    BlockchainNode::ReceivedSketch(rapidjson::Document &d, Address &from)
     {
         NS_LOG_FUNCTION(this);
 
-        NS_LOG_INFO("RemoveReceiveTime: At time " << Simulator::Now().GetSeconds()
-                    << " " << m_receiveBlockTimes.front() << " was removed");
-        m_receiveBlockTimes.erase(m_receiveBlockTimes.begin());
+        Ipv4Address                 peer = InetSocketAddress::ConvertFrom(from).GetIpv4();
+        std::set<uint64_t>          reconciliationSet = m_reconciliationSets[peer];
+        int                         peerSetSize = d["setSize"].GetInt();
+        uint32_t                    cellCount = d["cells"].Size() / 3;
+        std::vector<uint64_t>       missing;                // the peer has them, we do not
+        std::vector<uint64_t>       unknown;                // we have them, the peer does not
+        bool                        decoded = true;
+        rapidjson::Document         difference;
+        rapidjson::Value            value;
+        rapidjson::Value            idArray(rapidjson::kArrayType);
+
+        m_reconciliationSets[peer].clear();
+        m_nodeStats->reconciliationRounds++;
+
+        if(cellCount > 0)
+        {
+            BlockchainIblt                      iblt(cellCount, d["nonce"].GetUint64());
+            BlockchainIblt                      ourIblt(cellCount, d["nonce"].GetUint64());
+            std::vector<BlockchainIblt::Cell>   cells;
+
+            for(unsigned int i = 0; i + 2 < d["cells"].Size(); i += 3)
+            {
+                BlockchainIblt::Cell cell = {d["cells"][i].GetInt(), d["cells"][i + 1].GetUint64(), d["cells"][i + 2].GetUint()};
+
+                cells.push_back(cell);
+            }
+            iblt.SetCells(cells);
+
+            for(auto it = reconciliationSet.begin(); it != reconciliationSet.end(); it++)
+            {
+                ourIblt.Insert(*it);
+            }
+
+            iblt.Subtract(ourIblt);
+            decoded = iblt.Decode(missing, unknown);
+        }
+        else
+        {
+            unknown.assign(reconciliationSet.begin(), reconciliationSet.end());
+        }
+
+        difference.SetObject();
+        value = RECON_DIFF;
+        difference.AddMember("message", value, difference.GetAllocator());
+
+        if(decoded)
+        {
+            int smallestSet = std::min(static_cast<int>(reconciliationSet.size()), peerSetSize);
+
+            /*
+             * q is the part of the smallest set that was not explained by the difference of the set sizes
+             */
+            if(smallestSet > 0)
+            {
+                int excess = missing.size() + unknown.size() - std::abs(static_cast<int>(reconciliationSet.size()) - peerSetSize);
+
+                m_reconciliationQ = std::min(2.0, std::max(0.0, static_cast<double>(excess) / smallestSet));
+            }
+
+            for(auto it = missing.begin(); it != missing.end(); it++)
+            {
+                value.SetUint64(*it);
+                idArray.PushBack(value, difference.GetAllocator());
+            }
+
+            value = false;
+        }
+        else
+        {
+            NS_LOG_INFO("ReceivedSketch : Node " << GetNode()->GetId() << " could not decode the sketch of " << peer
+                        << ", the sets are exchanged in full");
+
+            m_nodeStats->reconciliationFailures++;
+            unknown.assign(reconciliationSet.begin(), reconciliationSet.end());
+            value = true;
+        }
+        difference.AddMember("all", value, difference.GetAllocator());
+        difference.AddMember("ids", idArray, difference.GetAllocator());
+
+        for(auto it = unknown.begin(); it != unknown.end(); it++)
+        {
+            auto message = m_relayMessages.find(*it);
+
+            if(message != m_relayMessages.end())
+            {
+                SendTransactionMessage(message->second.first, message->second.second, peer);
+                m_nodeStats->reconciledTransactions++;
+            }
+        }
+
+        NS_LOG_INFO("ReceivedSketch : Node " << GetNode()->GetId() << " reconciled with " << peer << ", sent "
+                    << unknown.size() << " transactions and requests " << missing.size());
+
+        SendMessage(SKETCH, RECON_DIFF, difference, from);
     }
 
-    void 
-    BlockchainNode::RemoveCompressedBlockReceiveTime()
+    void
+    BlockchainNode::ReceivedReconciliationDifference(rapidjson::Document &d, Address &from)
     {
         NS_LOG_FUNCTION(this);
 
-        NS_LOG_INFO("RemoveCompressedBlockReceiveTime: At time " << Simulator::Now().GetSeconds()
-                    << " " << m_receiveCompressedBlockTimes.front() << " was removed");
-        m_receiveCompressedBlockTimes.erase(m_receiveCompressedBlockTimes.begin());
-    }
+        Ipv4Address             peer = InetSocketAddress::ConvertFrom(from).GetIpv4();
+        std::vector<uint64_t>   requested;
+
+        if(d["all"].GetBool())
+        {
+            requested.assign(m_sketchedTransactions[peer].begin(), m_sketchedTransactions[peer].end());
+        }
+        else
+        {
+            for(unsigned int i = 0; i < d["ids"].Size(); i++)
+            {
+                requested.push_back(d["ids"][i].GetUint64());
+            }
+        }
 
+        m_sketchedTransactions.erase(peer);
+
+        for(auto it = requested.begin(); it != requested.end(); it++)
+        {
+            auto message = m_relayMessages.find(*it);
 
+            if(message != m_relayMessages.end())
+            {
+                SendTransactionMessage(message->second.first, message->second.second, peer);
+                m_nodeStats->reconciledTransactions++;
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -2,12 +2,26 @@
 #define BLOCKCHAIN_NODE_H
 
 #include <algorithm>
+#include <deque>
 #include "ns3/application.h"
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
 #include "ns3/traced-callback.h"
 #include "ns3/address.h"
 #include "blockchain.h"
+#include "blockchain-transfer-scheduler.h"
+#include "blockchain-processor-sharing-link.h"
+#include "blockchain-cpu-model.h"
+#include "blockchain-timer-wheel.h"
+#include "blockchain-peer-monitor.h"
+#include "blockchain-download-scheduler.h"
+#include "blockchain-compact-block.h"
+#include "blockchain-chunk-swarm.h"
+#include "blockchain-erasure-code.h"
+#include "blockchain-graphene.h"
+#include "blockchain-trickle-queue.h"
+#include "blockchain-seen-cache.h"
+#include "blockchain-mempool.h"
 #include "ns3/boolean.h"
 #include "../../rapidjson/document.h"
 #include "../../rapidjson/writer.h"
@@ -32,6 +46,11 @@ namespace ns3 {
 
             std::vector<Ipv4Address> GetPeerAddress (void) const;
 
+            /*
+             * The local view of the chain, e.g. to read an observer's main chain once the simulation has run
+             */
+            const Blockchain &GetBlockchain (void) const;
+
             void SetPeersAddresses (const std::vector<Ipv4Address> &peers);
 
             void SetPeersDownloadSpeeds (const std::map<Ipv4Address, double> &peerDownloadSpeeds);
@@ -61,6 +80,20 @@ namespace ns3 {
              */
             void HandleRead (Ptr<Socket> socket);
 
+            /*
+             * Handle a message once the node's CPU has processed it
+             * param packet : the message
+             * param from : the address the message was received from
+             */
+            void ProcessMessage (std::string packet, Address from);
+
+            /*
+             * Handle a parsed message according to its type
+             * param d : rapidjson document containing the message
+             * param from : the address the message was received from
+             */
+            void HandleMessage (rapidjson::Document &d, Address &from);
+
             /*
              * Handle an incoming connection
              * param socket : the incoming connection socket
@@ -85,7 +118,7 @@ namespace ns3 {
              * param blockinfo : the block message info
              * param from : the address the connection is from
              */
-            void ReceivedBlockMessage(std::string &blockInfo, Address &from);
+            void ReceivedBlockMessage(std::string blockInfo, Address &from);
 
             /*
              * Called when a new block non-orphan block is received
@@ -106,6 +139,13 @@ namespace ns3 {
              */
             virtual void ReceivedHigherBlock(const Block &newBlock);
 
+            /*
+             * Called by m_blockchain when blocks leave the main chain. A miner puts the transactions of the
+             * displaced blocks back in its mempool, except the ones the new main chain includes.
+             * param displaced : the blocks that left the main chain
+             */
+            void Reorganized(const Block &newTip, const std::vector<const Block *> &displaced);
+
             /*
              * Validates new Blocks by calculating the necessary time interval
              * param newBlock : the new block
@@ -132,15 +172,23 @@ namespace ns3 {
             void AdvertiseNewBlock (const Block &newBlock);
 
             /*
-             * Advertises the newly validated block when blockTorrent is used
+             * Advertises all the chunks of the newly validated block when blockTorrent is used
              * param newBlock : the new block
              */
-            //void AdvertiseFullBlock (const Block &newBlock);
+            void AdvertiseFullBlock (const Block &newBlock);
 
-            void AdvertiseNewTransaction(const Transaction &newTrans, enum Messages megType, Ipv4Address receivedFromIpv4);
+            /*
+             * Relays a transaction message to the peers, except receivedFromIpv4
+             * param ttl : the hops the message may still travel, -1 if unlimited. The message is dropped at 0.
+             */
+            void AdvertiseNewTransaction(const Transaction &newTrans, enum Messages megType, Ipv4Address receivedFromIpv4, int ttl);
             
             bool HasTransaction(int nodeId, int transId);
 
+            /*
+             * The flooded transaction messages are deduplicated by m_seenMessages, in constant memory.
+             * An entry evicted from it can be relayed a second time.
+             */
             bool HasReplyTransaction(int nodeId, int transId, int transExecution);
 
             bool HasMessageTransaction(int nodeId, int transId);
@@ -189,6 +237,78 @@ namespace ns3 {
              * param blockhash : the block hash for which the timeout expired
              */
             void InvTimeoutExpired (std::string blockHash);
+
+            /*
+             * Arms (or re-arms) the timeout of a block request. The timeout is m_invTimeoutMinutes, or the one
+             * m_peerMonitor computes for the peer if m_adaptiveInvTimeouts is set
+             * param blockHash : the requested block
+             * param peer : the peer the block was requested from
+             * param blockSizeBytes : the size of the block, 0 if unknown
+             */
+            void ArmInvTimeout(const std::string &blockHash, Ipv4Address peer, int blockSizeBytes);
+
+            /*
+             * Called when a block request takes much longer than its peer is expected to need.
+             * The block is requested again from a faster announcer if one has a free slot.
+             * param blockHash : the stalled block
+             */
+            void StallTimeoutExpired (std::string blockHash);
+
+            /*
+             * Requests blocks from the peers that announced them (m_queueInv), through m_downloadScheduler.
+             * The blocks with no free announcer are kept pending until a request finishes.
+             * param blockHashes : the blocks to request
+             */
+            void RequestBlocks(const std::vector<std::string> &blockHashes);
+
+            /*
+             * Sends GET_DATA for some blocks to a peer, preceded by GET_HEADERS for the blocks whose headers are unknown
+             */
+            void SendBlockRequest(const std::vector<std::string> &blockHashes, Address &peer);
+
+            /*
+             * Fills d with a block request (message, type and blocks members)
+             */
+            void SetBlockRequest(rapidjson::Document &d, const std::vector<std::string> &blockHashes);
+
+            /*
+             * Remembers when a new block was first announced to the node (by INV or by SENDHEADERS)
+             */
+            void RecordAnnouncement(const std::string &blockHash);
+
+            /*
+             * Appends the headers of a block to the "blocks" array of a HEADERS message
+             */
+            void AddBlockHeader(rapidjson::Document &d, rapidjson::Value &array, const Block &block);
+
+            /*
+             * Writes and reads the header fields added to the messages: the "uncles" of a block, none without uncles,
+             * and its "difficulty", none at the difficulty 1 of the genesis block
+             */
+            void AddHeaderExtensions(rapidjson::Document &d, rapidjson::Value &blockInfo, const Block &block);
+            void ReadHeaderExtensions(const rapidjson::Value &blockInfo, Block &block);
+
+            /*
+             * Requests the pending blocks that are still missing
+             */
+            void ProcessPendingRequests(void);
+
+            /*
+             * Cancels the timeouts of a block request and releases its slot in m_downloadScheduler
+             */
+            void RemoveBlockRequest(const std::string &blockHash);
+
+            void ArmStallTimeout(const std::string &blockHash, Ipv4Address peer, int expectedSizeBytes);
+
+            /*
+             * The throughput assumed for a peer that has not delivered a block yet (Bytes/s)
+             */
+            double GetPriorThroughput(Ipv4Address peer);
+
+            /*
+             * The size of the block from its headers, or the mean block size if the headers are unknown
+             */
+            int GetExpectedBlockSize(const std::string &blockHash);
             
             /*
              * Checks if a block has been received but not been validated yet (if it is included in m_receivedNotValidated)
@@ -211,24 +331,274 @@ namespace ns3 {
             bool OnlyHeadersReceived (std::string blockHash);
 
             /*
-             * Remove the first element from m_sendBlockTimes, when a block is sent
+             * Fills d with the CMPCT_BLOCK message of a block: its headers, the short IDs of its transactions
+             * and the transactions prefilled for the receiver
+             * return the size of the message in Bytes
+             */
+            int SetCompactBlock(rapidjson::Document &d, const Block &block);
+
+            /*
+             * Queues the CMPCT_BLOCK message of a block on the upload link
+             */
+            void QueueCompactBlock(const Block &block, Address &to);
+
+            /*
+             * Called when a CMPCT_BLOCK message has been downloaded. The block is rebuilt from m_transaction,
+             * the missing transactions are requested with GET_BLOCK_TXN.
+             */
+            void ReceivedCompactBlock(rapidjson::Document &d, Address &from);
+
+            /*
+             * Sends the GET_BLOCK_TXN message of the transactions missing from a partial block
+             */
+            void RequestBlockTransactions(const std::string &blockHash, enum Messages receivedMessage, Address &from);
+
+            /*
+             * Called when a BLOCK_TXN message has been downloaded
+             */
+            void ReceivedBlockTransactions(rapidjson::Document &d, Address &from);
+
+            /*
+             * Hands a rebuilt compact block over to ReceivedDownloadedBlock
+             */
+            void CompleteCompactBlock(const std::string &blockHash);
+
+            /*
+             * Requests a full BLOCK from the peer when a compact block cannot be rebuilt
+             */
+            void RequestFullBlock(const std::string &blockHash, Address &from);
+
+            /*
+             * Queues the GRAPHENE_BLOCK message of a block on the upload link: its headers, a Bloom filter and
+             * an IBLT of the short IDs of its transactions, sized for the pool of the receiver
+             * param poolSize : the transactions in the pool of the receiver
+             */
+            void QueueGrapheneBlock(const Block &block, int poolSize, Address &to);
+
+            /*
+             * Called when a GRAPHENE_BLOCK message has been downloaded. The transactions of m_transaction that
+             * pass the Bloom filter are corrected with the IBLT, the missing ones are requested with GET_BLOCK_TXN.
+             * A failed decoding falls back to the full block.
+             */
+            void ReceivedGrapheneBlock(rapidjson::Document &d, Address &from);
+
+            /*
+             * Handles a downloaded block: discards it if its parent is unknown, otherwise passes it to ReceiveBlock
+             */
+            void ReceivedDownloadedBlock(const Block &newBlock);
+
+            /*
+             * return the ID of a relayed transaction message in the reconciliation sets
+             */
+            uint64_t GetReconciliationId(enum Messages megType, const Transaction &transaction) const;
+
+            /*
+             * Keeps a relayed transaction message to answer the reconciliations and GET_TRANS of the peers. It is
+             * dropped after four reconciliation and trickle intervals plus an INV timeout, when every peer had
+             * the chance to reconcile with us or to request it.
+             */
+            void KeepRelayMessage(uint64_t id, const std::string &message, int payloadBytes);
+
+            /*
+             * Queues a transaction message to a peer on m_uploadScheduler, with the block transfers
+             * param payloadBytes : the size of the transactions of the message
+             */
+            void SendTransactionMessage(const std::string &message, int payloadBytes, Ipv4Address peer);
+
+            void SendTransactionPacket(std::string message, Ipv4Address peer);
+
+            /*
+             * return the Bytes a transaction takes in a transaction message, the notifications only carry its ID
+             */
+            int GetTransactionPayloadBytes(enum Messages megType, const Transaction &transaction) const;
+            int GetTransactionPayloadBytes(enum Messages megType, const std::vector<Transaction> &transactions) const;
+
+            /*
+             * return the Bytes of the transactions of a received transaction message
+             * param transactions : the "transactions" array of the message
+             */
+            int GetTransactionPayloadBytes(const rapidjson::Value &transactions) const;
+
+            /*
+             * return the size of a new transaction, from the size trace or the lognormal sizes
+             */
+            int DrawTransactionSize(void);
+
+            /*
+             * Sends a relayed transaction to a peer, or queues it for the next trickle of the peer
+             * param ttl : the hops left to the transaction, -1 if unlimited
+             */
+            void RelayTransaction(const std::string &message, enum Messages megType, const Transaction &transaction, Ipv4Address peer, int ttl);
+
+            /*
+             * return the hops a new transaction message may travel, -1 if unlimited
+             */
+            int GetGossipTtl(void) const;
+
+            /*
+             * return the hops a received transaction may still travel once relayed, -1 if unlimited
+             * param transaction : an entry of the "transactions" array of a transaction message
+             */
+            int GetRelayTtl(const rapidjson::Value &transaction) const;
+
+            /*
+             * Sends a transaction message to the gossip fanout of the node, receivedFromIpv4 excluded.
+             * With GOSSIP_PULL the fanout peers get a TRANS_INV instead, with GOSSIP_PUSH_PULL the other peers do.
+             */
+            void GossipTransaction(const std::string &message, enum Messages megType, const Transaction &transaction, Ipv4Address receivedFromIpv4, int ttl);
+
+            /*
+             * Announces a transaction to a peer with a TRANS_INV
+             */
+            void SendTransactionInv(enum Messages megType, const Transaction &transaction, Ipv4Address peer);
+
+            /*
+             * Requests with GET_TRANS the transactions of a TRANS_INV that were neither seen nor requested yet
+             */
+            void ReceivedTransactionInv(rapidjson::Document &d, Address &from);
+
+            /*
+             * Sends the transactions requested by a GET_TRANS
+             */
+            void ReceivedTransactionRequest(rapidjson::Document &d, Address &from);
+
+            /*
+             * Handles a message of a consensus engine, the ones carrying a block once it is downloaded.
+             * The nodes that are not validators ignore them.
+             */
+            virtual void ReceivedConsensusMessage(rapidjson::Document &d, Address &from);
+
+            /*
+             * Schedules the next trickle of a peer, after an exponentially distributed delay
+             */
+            void ScheduleTrickle(Ipv4Address peer);
+
+            /*
+             * Sends the announcements queued for a peer: one INV with all the blocks and one message per
+             * transaction message type
+             */
+            void FlushAnnouncements(Ipv4Address peer);
+
+            /*
+             * Starts a reconciliation with the next peer (REQ_RECON) and schedules the next one
+             */
+            void ReconcileTransactions(void);
+
+            /*
+             * Answers a REQ_RECON with the SKETCH of the reconciliation set of the peer
+             */
+            void ReceivedReconciliationRequest(rapidjson::Document &d, Address &from);
+
+            /*
+             * Decodes a SKETCH against our reconciliation set of the peer. The transactions the peer misses
+             * are sent, the ones we miss are requested with RECON_DIFF. If the sketch cannot be decoded,
+             * both sets are exchanged in full.
+             */
+            void ReceivedSketch(rapidjson::Document &d, Address &from);
+
+            /*
+             * Sends the transactions requested by a RECON_DIFF
+             */
+            void ReceivedReconciliationDifference(rapidjson::Document &d, Address &from);
+
+            /*
+             * Sends a CHUNK_INV message to every peer except one
+             * param header : the block the chunks belong to
+             * param chunks : the advertised chunks
+             * param exceptPeer : the peer that does not need the message
+             */
+            void SendChunkInv(const Block &header, const std::vector<int> &chunks, Ipv4Address exceptPeer);
+
+            /*
+             * Handles a CHUNK_INV message: starts the download of a new block and records the chunks of the peer
+             */
+            void ReceivedChunkInv(rapidjson::Document &d, Address &from);
+
+            /*
+             * Requests the missing chunks of a block from the peers that have them
+             */
+            void RequestChunks(const std::string &blockHash);
+
+            /*
+             * Queues a CHUNK message on the upload link. The first chunk carries the transactions of the block.
+             */
+            void QueueChunk(const Block &block, const std::vector<Transaction> &transactions, int chunk, Address &to);
+
+            /*
+             * Called when a CHUNK message has been downloaded. The chunk is advertised to the peers at once,
+             * and the block is handed to ReceivedDownloadedBlock when its last chunk arrives.
+             */
+            void ReceivedChunk(rapidjson::Document &d, Address &from);
+
+            /*
+             * Called when the chunk requests of a block take too long. The peers that did not deliver
+             * are dropped and the chunks are requested again from the others.
+             */
+            void ChunkTimeoutExpired(std::string blockHash);
+
+            /*
+             * Stops the chunked download of a block
+             */
+            void RemoveChunkDownload(const std::string &blockHash);
+
+            /*
+             * return the key of a chunk request in m_peerMonitor
+             */
+            std::string GetChunkHash(const std::string &blockHash, int chunk);
+
+            /*
+             * Erasure-coded dissemination of a new block: the block is encoded into k data and m parity
+             * chunks, at the CPU cost of the encoding, and different chunks are pushed to different peers
+             */
+            void DisperseCodedBlock(const Block &newBlock);
+
+            /*
+             * Pushes the coded chunks of a block, once they are encoded. Chunk i goes to peer i, round
+             * robin, so every chunk and every peer is covered.
+             */
+            void PushCodedChunks(Block newBlock);
+
+            /*
+             * Queues a CODED_CHUNK message on the upload link
+             * param transactions : the transactions of the block, serialized once per block by SerializeCodedTransactions
+             * param kadcastHeight : the receiver forwards the chunk to one peer in each of its buckets below this height
+             */
+            void QueueCodedChunk(const Block &block, const std::string &transactions, int chunk, int kadcastHeight, Address &to);
+
+            /*
+             * return the JSON array of the transactions carried by the coded chunks of a block
+             */
+            std::string SerializeCodedTransactions(const std::vector<Transaction> &transactions);
+
+            /*
+             * Called when a CODED_CHUNK message has been downloaded. A new chunk is forwarded Kadcast-style,
+             * and the block is rebuilt once k different chunks have arrived. The chunks already seen are
+             * remembered by m_seenMessages, so the chunks of a block still arriving after it was rebuilt are
+             * dropped without keeping its entry in m_codedBlocks.
+             */
+            void ReceivedCodedChunk(rapidjson::Document &d, Address &from);
+
+            /*
+             * Hands a rebuilt block to ReceivedDownloadedBlock, after the CPU cost of the decoding
              */
-            void RemoveSendTime();
+            void RebuildCodedBlock(std::string blockHash);
 
             /*
-             * Remove the first element from m_sendCompressedBlockTimes, when a compressd-block is sent
+             * Called when k coded chunks of a block did not arrive in time: the block is requested
+             * with GET_DATA from the peers that announced it, and its chunks are no longer collected
              */
-            void RemoveCompressedBlockSendTime();
+            void CodedBlockTimeoutExpired(std::string blockHash);
 
             /*
-             * Removes the first element from m_receivedBlockTimes, when block is received
+             * return true if the node is waiting for the coded chunks of the block, its announcements are not requested then
              */
-            void RemoveReceiveTime();
+            bool IsCollectingCodedChunks(const std::string &blockHash);
 
             /*
-             * Removes the first element from m_receiveCompressedBlockTime, when a compressed-block is received
+             * return the Kadcast bucket of a peer, the position of the highest bit of the XOR distance
+             * between the overlay IDs of the node and of the peer
              */
-            void RemoveCompressedBlockReceiveTime();
+            int GetKadcastBucket(Ipv4Address peer);
 
 
 
@@ -250,8 +620,8 @@ namespace ns3 {
             bool            m_isMiner;                      //True if the node is a miner
             double          m_downloadSpeed;                // Bytes/s
             double          m_uploadSpeed;                  // Bytes/s
-            double          m_averageTransacionSize;        //The average transaction size, Needed for compressed blocks
-            int             m_transactionIndexSize;         //The transaction index size in bytes. Needed for compressed blocks
+            double          m_averageTransacionSize;        //The average transaction size, the size of the transactions of compact blocks
+            int             m_transactionIndexSize;         //The transaction index size in bytes, used by GET_BLOCK_TXN
             int             m_transactionId;
             EventId         m_nextTransaction;
             int             m_numberofEndorsers;
@@ -262,25 +632,76 @@ namespace ns3 {
             int             m_creatingTransactionTime;
 
             std::vector<Transaction>                        m_transaction;
-            std::vector<Transaction>                        m_notValidatedTransaction;
-            std::vector<Transaction>                        m_replyTransaction;
-            std::vector<Transaction>                        m_msgTransaction;
-            std::vector<Transaction>                        m_resultTransaction;
+            BlockchainMempool                               m_mempool;                          // the transactions waiting for a block, miners only
+            uint32_t                                        m_mempoolCapacity;
+            double                                          m_transactionFeeMean;               // the mean fee of the created transactions
+            double                                          m_transactionSizeSigma;             // sigma of the lognormal transaction sizes, 0 for fixed sizes
+            std::string                                     m_transactionSizeTrace;             // file of transaction sizes, empty for the lognormal sizes
+            std::vector<int>                                m_transactionSizes;                 // the sizes of m_transactionSizeTrace
+            unsigned int                                    m_nextTransactionSize;
             std::vector<Transaction>                        m_waitingEndorsers;            
             std::vector<Ipv4Address>                        m_peersAddresses;                   // The address of peers
             std::map<Ipv4Address, double>                   m_peersDownloadSpeeds;              // The peerDownloadSpeeds of channels
             std::map<Ipv4Address, double>                   m_peersUploadSpeeds;                // The peerUploadSpeeds of channels
             std::map<Ipv4Address, Ptr<Socket>>              m_peersSockets;                     // The sockets of peers
             std::map<std::string, std::vector<Address>>     m_queueInv;
-            std::map<std::string, EventId>                  m_invTimeouts;
+            std::map<std::string, BlockchainTimerWheel::TimerId> m_invTimeouts;
+            BlockchainTimerWheel                            m_timerWheel;                       // holds the timers of m_invTimeouts
+            BlockchainPeerMonitor                           m_peerMonitor;                      // RTT and throughput of the peers, for the timeouts
+            bool                                            m_adaptiveInvTimeouts;              // compute the timeouts with m_peerMonitor
+            BlockchainDownloadScheduler                     m_downloadScheduler;                // spreads the block requests over the announcers
+            uint32_t                                        m_maxInFlightPerPeer;               // the request limit of m_downloadScheduler
+            std::map<std::string, BlockchainTimerWheel::TimerId> m_stallTimeouts;               // early reissue timers of the block requests
+            std::map<std::string, double>                   m_announcementTimes;                // the time each missing block was first announced
+            double                                          m_meanAnnounceToBlockTime;          // mean time from the announcement to the reception of a block
+            long                                            m_announcedBlocksReceived;
             std::map<Address, std::string>                  m_bufferedData;                     // map holding the buffered data from previous handleRead events
             std::map<std::string, Block>                    m_receivedNotValidated;             // Vevtor holding the received but not yet validated blocks
             std::map<std::string, Block>                    m_onlyHeadersReceived;              // Vevtor holding the blocks that we know byt not received
             nodeStatistics                                  *m_nodeStats;                       // Struct holding the node stats
-            std::vector<double>                             m_sendBlockTimes;                   // contains the times of the next sendBlock events
-            std::vector<double>                             m_sendCompressedBlockTimes;         // contains the times of the next sendBlock events
-            std::vector<double>                             m_receiveBlockTimes;                // contains the times of the next sendBlock events
-            std::vector<double>                             m_receiveCompressedBlockTimes;      // contains the times of the next sendBlock events
+            enum CompactBlockMode                           m_compactBlockMode;                 // how the blocks are relayed
+            std::map<std::string, PartialCompactBlock>      m_partialBlocks;                    // compact blocks waiting for BLOCK_TXN
+            std::map<std::string, std::vector<int>>         m_prefilledTransactions;            // transactions we had to fetch, prefilled when we relay the block
+            bool                                            m_blockTorrent;                     // relay the blocks in chunks
+            uint32_t                                        m_chunkSize;                        // the size of the chunks in Bytes
+            uint32_t                                        m_maxChunkRequestsPerPeer;          // the request limit of m_chunkSwarm
+            BlockchainChunkSwarm                            m_chunkSwarm;                       // the blocks being downloaded in chunks
+            std::map<std::string, BlockchainTimerWheel::TimerId> m_chunkTimeouts;               // the timeouts of the chunk requests of each block
+            double                                          m_meanChunkSources;                 // mean number of peers the chunks of a block came from
+            long                                            m_chunkedBlocksReceived;
+            bool                                            m_erasureCoding;                    // disseminate the new blocks as coded chunks
+            uint32_t                                        m_erasureDataChunks;                // k, any k chunks rebuild a block
+            uint32_t                                        m_erasureParityChunks;              // m, the parity chunks added to a block
+            BlockchainErasureCode                           m_erasureCode;
+            std::map<std::string, CodedBlock>               m_codedBlocks;                      // the blocks whose coded chunks are being received
+            std::map<std::string, BlockchainTimerWheel::TimerId> m_codedBlockTimeouts;          // the GET_DATA fallback timers of m_codedBlocks
+            std::map<Ipv4Address, uint32_t>                 m_kadcastPeerNodeIds;               // the node ids of the peers, for their Kadcast IDs
+            double                                          m_reconciliationInterval;           // mean time between two reconciliations with a peer, 0 floods the transactions
+            uint32_t                                        m_transactionRelayFanout;           // the peers the transactions are still flooded to when reconciling
+            std::vector<Ipv4Address>                        m_floodPeers;
+            std::map<uint64_t, std::pair<std::string, int>> m_relayMessages;                   // the relayed transaction messages and their payload Bytes by reconciliation ID
+            std::deque<std::pair<double, uint64_t>>         m_relayMessageExpiries;             // the reconciliation IDs of m_relayMessages, oldest first
+            std::map<Ipv4Address, std::set<uint64_t>>       m_reconciliationSets;               // the transactions each peer may not have
+            std::map<Ipv4Address, std::set<uint64_t>>       m_sketchedTransactions;             // the transactions of the sketches sent to each peer
+            double                                          m_reconciliationQ;                  // the difference per transaction of the last reconciliations
+            unsigned int                                    m_nextReconciliationPeer;
+            EventId                                         m_nextReconciliation;
+            double                                          m_trickleInterval;                  // mean time between two announcements to a peer, 0 announces at once
+            BlockchainTrickleQueue                          m_trickleQueue;                     // the announcements waiting for the trickle of each peer
+            std::map<Ipv4Address, EventId>                  m_trickleEvents;                    // the next trickle of each peer with queued announcements
+            uint32_t                                        m_seenCacheCapacity;                // the number of flooded transaction messages remembered
+            BlockchainSeenCache                             m_seenMessages;                     // the flooded transaction messages and coded chunks already relayed
+            uint32_t                                        m_gossipTtl;                        // the hops a new transaction message may travel, 0 for unlimited
+            enum GossipFanout                               m_gossipFanout;                     // the number of peers a transaction is gossiped to
+            uint32_t                                        m_gossipFanoutPeers;                // k of GOSSIP_FANOUT_FIXED
+            enum GossipMode                                 m_gossipMode;                       // push, pull or both
+            enum ForkChoiceRule                             m_forkChoiceRule;                   // the fork choice rule of m_blockchain
+            BlockchainTransferScheduler                     m_uploadScheduler;                  // serializes the outgoing BLOCK messages
+            BlockchainProcessorSharingLink                  m_downloadLink;                     // shares the downlink among the incoming BLOCK messages
+            enum TransferSchedulerPolicy                    m_transferSchedulerPolicy;          // the policy of m_uploadScheduler
+            BlockchainCpuModel                              m_cpuModel;                         // processing cost of the messages and validations
+            enum HardwareClass                              m_hardwareClass;                    // the hardware class of m_cpuModel
+            std::string                                     m_cpuCostTable;                     // cost table file of m_cpuModel, empty for the built-in one
             enum ProtocolType                               m_protocolType;                     // protocol type
             enum CommitterType                              m_committerType;
 
@@ -292,6 +713,7 @@ namespace ns3 {
             const int       m_getHeaderSizeBytes;       //The size of the GET_HEADERS message, 72bytes
             const int       m_headersSizeBytes;         //81Bytes
             const int       m_blockHeadersSizeBytes;     //81Bytes
+            const int       m_shortIdNonceSizeBytes;    //The size of the nonce of compact blocks, 8Bytes
 
             /*
              * Traced Callback: recevied packets, source address. 
@@ -0,0 +1,477 @@
+#include "ns3/address.h"
+#include "ns3/log.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/blockchain-pbft-miner.h"
+#include <algorithm>
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainPbftMiner");
+    NS_OBJECT_ENSURE_REGISTERED(BlockchainPbftMiner);
+
+    TypeId
+    BlockchainPbftMiner::GetTypeId(void)
+    {
+        static TypeId tid = TypeId("ns3::BlockchainPbftMiner")
+            .SetParent<BlockchainValidator>()
+            .SetGroupName("Application")
+            .AddConstructor<BlockchainPbftMiner>()
+        ;
+        return tid;
+    }
+
+    BlockchainPbftMiner::BlockchainPbftMiner() : BlockchainValidator(), m_timeoutsInRow(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainPbftMiner::~BlockchainPbftMiner(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainPbftMiner::StartConsensus(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_pbft.SetReplicas(m_noMiners, m_validatorId);
+        m_pbft.SetSequence(m_blockchain.GetCurrentTopBlock()->GetBlockHeight() + 1);
+
+        ArmViewChangeTimer();
+
+        if(m_pbft.IsLeader())
+            ScheduleProposal();
+    }
+
+    void
+    BlockchainPbftMiner::StopConsensus(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Simulator::Cancel(m_viewChangeEvent);
+
+        NS_LOG_WARN("PBFT : validator " << m_validatorId << " in view " << m_pbft.GetView() << (m_pbft.IsViewChanging() ? " (view change)" : "")
+                    << " at sequence " << m_pbft.GetSequence() << ", f = " << m_pbft.GetFaults() << ", quorum = " << m_pbft.GetQuorum()
+                    << ", views moved to = " << m_pbft.GetViewChanges());
+    }
+
+    void
+    BlockchainPbftMiner::Propose(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::string digest = GetBlockHash(newBlock);
+
+        if(!m_pbft.IsLeader() || m_pbft.IsViewChanging() || !m_pbft.GetAcceptedDigest().empty()
+            || newBlock.GetBlockHeight() != m_pbft.GetSequence())
+        {
+            NS_LOG_INFO("Propose : validator " << m_validatorId << " drops the block " << digest << ", it cannot propose it in view " << m_pbft.GetView());
+            return;
+        }
+
+        rapidjson::Document d;
+
+        m_proposedBlocks[digest] = newBlock;
+        m_pbft.PrePrepare(m_pbft.GetView(), m_pbft.GetSequence(), digest);
+
+        SetConsensusMessage(d, PBFT_PRE_PREPARE, GetVoteSize() + newBlock.GetBlockSizeBytes(), 1);
+        AddVoteFields(d, m_pbft.GetView(), m_pbft.GetSequence(), digest);
+        AddProposedBlock(d, newBlock);
+        BroadcastConsensusMessage(d);
+
+        CheckProgress();
+    }
+
+    void
+    BlockchainPbftMiner::Committed(const Block &newTip)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_pbft.SetSequence(newTip.GetBlockHeight() + 1);
+
+        for(auto it = m_proposedBlocks.begin(); it != m_proposedBlocks.end();)
+        {
+            if(it->second.GetBlockHeight() <= newTip.GetBlockHeight())
+                it = m_proposedBlocks.erase(it);
+            else
+                it++;
+        }
+
+        m_timeoutsInRow = 0;
+        ArmViewChangeTimer();
+
+        if(!m_pbft.IsViewChanging() && m_pbft.IsLeader())
+            ScheduleProposal();
+
+        ProcessPendingPrePrepare();
+    }
+
+    void
+    BlockchainPbftMiner::ReceivedConsensusMessage(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_crashed)
+            return;
+
+        switch(d["message"].GetInt())
+        {
+            case PBFT_PRE_PREPARE:
+            {
+                ReceivedPrePrepare(d, from);
+                break;
+            }
+            case PBFT_PREPARE:
+            {
+                m_pbft.AddPrepare(d["view"].GetInt(), d["sequence"].GetInt(), d["digest"].GetString(), d["replica"].GetInt());
+                CheckProgress();
+                break;
+            }
+            case PBFT_COMMIT:
+            {
+                m_pbft.AddCommit(d["view"].GetInt(), d["sequence"].GetInt(), d["digest"].GetString(), d["replica"].GetInt());
+                CheckProgress();
+                break;
+            }
+            case PBFT_VIEW_CHANGE:
+            {
+                ReceivedViewChange(d, from);
+                break;
+            }
+            case PBFT_NEW_VIEW:
+            {
+                ReceivedNewView(d);
+                break;
+            }
+            default:
+            {
+                BlockchainNode::ReceivedConsensusMessage(d, from);
+                break;
+            }
+        }
+    }
+
+    void
+    BlockchainPbftMiner::AddVoteFields(rapidjson::Document &d, int view, int sequence, const std::string &digest)
+    {
+        rapidjson::Value value;
+
+        value = view;
+        d.AddMember("view", value, d.GetAllocator());
+
+        value = sequence;
+        d.AddMember("sequence", value, d.GetAllocator());
+
+        value.SetString(digest.c_str(), digest.size(), d.GetAllocator());
+        d.AddMember("digest", value, d.GetAllocator());
+    }
+
+    void
+    BlockchainPbftMiner::SendVote(enum Messages message, const std::string &digest)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document d;
+
+        SetConsensusMessage(d, message, GetVoteSize(), 1);
+        AddVoteFields(d, m_pbft.GetView(), m_pbft.GetSequence(), digest);
+        BroadcastConsensusMessage(d);
+    }
+
+    void
+    BlockchainPbftMiner::ReceivedPrePrepare(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int     view = d["view"].GetInt();
+        int     sequence = d["sequence"].GetInt();
+        Block   block = ReadProposedBlock(d, from);
+
+        if(d["replica"].GetInt() != m_pbft.GetLeader(view) || block.GetBlockHeight() != sequence
+            || sequence < m_pbft.GetSequence() || view < m_pbft.GetView())
+        {
+            NS_LOG_INFO("ReceivedPrePrepare : validator " << m_validatorId << " ignores the pre-prepare of " << GetBlockHash(block)
+                        << " in view " << view);
+            return;
+        }
+
+        /*
+         * The pre-prepares of a later sequence number, or of a view this validator has not entered yet, wait
+         */
+        m_pendingPrePrepares[sequence] = std::make_pair(view, block);
+        ProcessPendingPrePrepare();
+    }
+
+    void
+    BlockchainPbftMiner::ProcessPendingPrePrepare(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_pendingPrePrepares.erase(m_pendingPrePrepares.begin(), m_pendingPrePrepares.lower_bound(m_pbft.GetSequence()));
+
+        auto it = m_pendingPrePrepares.find(m_pbft.GetSequence());
+
+        if(it == m_pendingPrePrepares.end() || m_pbft.IsViewChanging() || it->second.first != m_pbft.GetView())
+            return;
+
+        int     view = it->second.first;
+        Block   block = it->second.second;
+
+        m_pendingPrePrepares.erase(it);
+        ValidatePrePrepare(view, block);
+    }
+
+    void
+    BlockchainPbftMiner::ValidatePrePrepare(int view, const Block &block)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(block.GetParentBlockMinerId() != m_blockchain.GetCurrentTopBlock()->GetMinerId())
+        {
+            NS_LOG_INFO("ValidatePrePrepare : the block " << GetBlockHash(block) << " does not extend the committed tip");
+            return;
+        }
+
+        m_proposedBlocks[GetBlockHash(block)] = block;
+
+        double validationTime = ReserveBlockValidation(block);
+
+        Simulator::Schedule(Seconds(validationTime), &BlockchainPbftMiner::PrePrepareValidated, this, view, block);
+    }
+
+    void
+    BlockchainPbftMiner::PrePrepareValidated(int view, Block block)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::string digest = GetBlockHash(block);
+
+        if(m_crashed || !m_pbft.PrePrepare(view, block.GetBlockHeight(), digest))
+            return;
+
+        NS_LOG_INFO("PrePrepareValidated : validator " << m_validatorId << " accepted the block " << digest << " in view " << view);
+
+        SendVote(PBFT_PREPARE, digest);
+        m_pbft.AddPrepare(view, block.GetBlockHeight(), digest, m_validatorId);
+        CheckProgress();
+    }
+
+    void
+    BlockchainPbftMiner::CheckProgress(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * The digest is copied, committing the block moves to the next sequence number
+         */
+        std::string digest = m_pbft.GetAcceptedDigest();
+
+        if(m_pbft.BecomesPrepared())
+        {
+            SendVote(PBFT_COMMIT, digest);
+            m_pbft.AddCommit(m_pbft.GetView(), m_pbft.GetSequence(), digest, m_validatorId);
+        }
+
+        if(m_pbft.BecomesCommitted())
+        {
+            Block block = m_proposedBlocks[digest];
+
+            NS_LOG_INFO("CheckProgress : validator " << m_validatorId << " commits the block " << digest << " in view " << m_pbft.GetView());
+            CommitBlock(block);
+        }
+    }
+
+    void
+    BlockchainPbftMiner::ArmViewChangeTimer(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double timeout = m_viewChangeTimeout * (1 << std::min(m_timeoutsInRow, 10)) + GetBlockInterval();
+
+        Simulator::Cancel(m_viewChangeEvent);
+        m_viewChangeEvent = Simulator::Schedule(Seconds(timeout), &BlockchainPbftMiner::ViewChangeTimeoutExpired, this);
+    }
+
+    void
+    BlockchainPbftMiner::ViewChangeTimeoutExpired(void)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("ViewChangeTimeoutExpired : validator " << m_validatorId << " suspects the leader of view " << m_pbft.GetView());
+
+        m_timeoutsInRow++;
+        m_pbft.StartViewChange();
+        MovedToView();
+    }
+
+    void
+    BlockchainPbftMiner::MovedToView(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_viewChanges++;
+        Simulator::Cancel(m_nextMiningEvent);
+
+        SendViewChange();
+        ArmViewChangeTimer();
+        TryStartView();
+    }
+
+    void
+    BlockchainPbftMiner::SendViewChange(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        std::string         digest = m_pbft.GetPreparedDigest();
+        bool                prepared = !digest.empty() && m_proposedBlocks.count(digest) > 0;
+        int                 sizeBytes = m_blockchainMessageHeader + 2*m_consensusFieldBytes + m_countBytes + m_signatureSize;
+        int                 signatures = 1;
+
+        /*
+         * The prepared block comes with its certificate, the pre-prepare and the 2f prepares
+         */
+        if(prepared)
+        {
+            sizeBytes += m_consensusFieldBytes + m_digestSizeBytes + m_pbft.GetQuorum()*(GetVoteSize() - m_blockchainMessageHeader)
+                        + m_proposedBlocks[digest].GetBlockSizeBytes();
+            signatures += m_pbft.GetQuorum();
+        }
+
+        SetConsensusMessage(d, PBFT_VIEW_CHANGE, sizeBytes, signatures);
+
+        value = m_pbft.GetView();
+        d.AddMember("view", value, d.GetAllocator());
+
+        value = m_pbft.GetSequence();
+        d.AddMember("sequence", value, d.GetAllocator());
+
+        value = prepared ? m_pbft.GetPreparedView() : -1;
+        d.AddMember("preparedView", value, d.GetAllocator());
+
+        value.SetString(prepared ? digest.c_str() : "", prepared ? digest.size() : 0, d.GetAllocator());
+        d.AddMember("preparedDigest", value, d.GetAllocator());
+
+        if(prepared)
+            AddProposedBlock(d, m_proposedBlocks[digest]);
+
+        m_pbft.AddViewChange(m_pbft.GetView(), m_pbft.GetSequence(), m_validatorId, prepared ? m_pbft.GetPreparedView() : -1, prepared ? digest : "");
+        m_viewChangeProofs[m_pbft.GetView()].push_back(std::make_pair(sizeBytes - m_blockchainMessageHeader, signatures));
+
+        BroadcastConsensusMessage(d);
+    }
+
+    void
+    BlockchainPbftMiner::ReceivedViewChange(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int         view = d["view"].GetInt();
+        int         sequence = d["sequence"].GetInt();
+        std::string digest = d["preparedDigest"].GetString();
+
+        if(view < m_pbft.GetView() || (view == m_pbft.GetView() && !m_pbft.IsViewChanging()))
+            return;
+
+        if(d.HasMember("blocks") && sequence == m_pbft.GetSequence())
+            m_proposedBlocks[digest] = ReadProposedBlock(d, from);
+
+        m_pbft.AddViewChange(view, sequence, d["replica"].GetInt(), d["preparedView"].GetInt(), digest);
+        m_viewChangeProofs[view].push_back(std::make_pair(d["size"].GetInt() - m_blockchainMessageHeader, d["signatures"].GetInt()));
+
+        int join = m_pbft.GetViewToJoin();
+
+        if(join >= 0)
+        {
+            NS_LOG_INFO("ReceivedViewChange : validator " << m_validatorId << " joins the view " << join);
+            m_pbft.JoinView(join);
+            MovedToView();
+        }
+        else
+        {
+            TryStartView();
+        }
+    }
+
+    void
+    BlockchainPbftMiner::TryStartView(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int view = m_pbft.GetView();
+
+        if(!m_pbft.CanStartView(view))
+            return;
+
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        std::string         digest = m_pbft.GetViewDigest(view);
+        int                 sizeBytes = m_blockchainMessageHeader + 2*m_consensusFieldBytes + m_countBytes + m_signatureSize;
+        int                 signatures = 1;
+        std::vector<std::pair<int, int>> &proofs = m_viewChangeProofs[view];
+
+        /*
+         * The new view carries the 2f+1 view changes it is based on
+         */
+        for(int i = 0; i < m_pbft.GetQuorum() && i < static_cast<int>(proofs.size()); i++)
+        {
+            sizeBytes += proofs[i].first;
+            signatures += proofs[i].second;
+        }
+
+        SetConsensusMessage(d, PBFT_NEW_VIEW, sizeBytes, signatures);
+
+        value = view;
+        d.AddMember("view", value, d.GetAllocator());
+
+        value = m_pbft.GetSequence();
+        d.AddMember("sequence", value, d.GetAllocator());
+
+        BroadcastConsensusMessage(d);
+
+        NS_LOG_INFO("TryStartView : validator " << m_validatorId << " starts the view " << view
+                    << (digest.empty() ? " with a new block" : " with the prepared block " + digest));
+
+        m_pbft.EnterView(view);
+        m_viewChangeProofs.erase(m_viewChangeProofs.begin(), m_viewChangeProofs.upper_bound(view));
+        ArmViewChangeTimer();
+
+        if(!digest.empty() && m_proposedBlocks.count(digest) > 0)
+        {
+            Block block = m_proposedBlocks[digest];
+
+            Propose(block);
+        }
+        else
+        {
+            ScheduleProposal();
+        }
+    }
+
+    void
+    BlockchainPbftMiner::ReceivedNewView(rapidjson::Document &d)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int view = d["view"].GetInt();
+
+        if(d["replica"].GetInt() != m_pbft.GetLeader(view) || view < m_pbft.GetView()
+            || (view == m_pbft.GetView() && !m_pbft.IsViewChanging()))
+            return;
+
+        NS_LOG_INFO("ReceivedNewView : validator " << m_validatorId << " enters the view " << view);
+
+        if(view > m_pbft.GetView())
+            m_viewChanges++;
+
+        m_pbft.EnterView(view);
+        m_viewChangeProofs.erase(m_viewChangeProofs.begin(), m_viewChangeProofs.upper_bound(view));
+        ArmViewChangeTimer();
+
+        ProcessPendingPrePrepare();
+    }
+
+}
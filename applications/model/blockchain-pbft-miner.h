@@ -0,0 +1,80 @@
+#ifndef BLOCKCHAIN_PBFT_MINER_H
+#define BLOCKCHAIN_PBFT_MINER_H
+
+#include "blockchain-validator.h"
+#include "blockchain-pbft.h"
+
+
+namespace ns3 {
+
+    /*
+     * A validator of a PBFT consensus. The leader of a view pre-prepares its blocks with their transactions, the
+     * other validators validate them, then everyone broadcasts a prepare and a commit, so a block costs O(n^2)
+     * messages and signature verifications. The leader proposes the next block when the previous one is committed,
+     * at most one every block interval.
+     * A validator that commits nothing for ViewChangeTimeout plus a block interval moves to the next view, and the
+     * timeout doubles until the next commit. Its view change carries its prepared block with the 2f+1 signatures of
+     * the prepare certificate, and the new view of the next leader carries 2f+1 view changes.
+     */
+    class BlockchainPbftMiner : public BlockchainValidator
+    {
+        public:
+
+            static TypeId GetTypeId(void);
+            BlockchainPbftMiner();
+
+            virtual ~BlockchainPbftMiner(void);
+
+        protected:
+
+            virtual void StartConsensus(void);
+            virtual void StopConsensus(void);
+            virtual void Propose(const Block &newBlock);
+            virtual void Committed(const Block &newTip);
+
+            virtual void ReceivedConsensusMessage(rapidjson::Document &d, Address &from);
+
+            void AddVoteFields(rapidjson::Document &d, int view, int sequence, const std::string &digest);
+            void SendVote(enum Messages message, const std::string &digest);
+
+            void ReceivedPrePrepare(rapidjson::Document &d, Address &from);
+
+            /*
+             * Validates the pre-prepare buffered for the current sequence number and view, if any
+             */
+            void ProcessPendingPrePrepare(void);
+            void ValidatePrePrepare(int view, const Block &block);
+            void PrePrepareValidated(int view, Block block);
+
+            /*
+             * Sends the commit once prepared, and commits the block once committed
+             */
+            void CheckProgress(void);
+
+            void ArmViewChangeTimer(void);
+            void ViewChangeTimeoutExpired(void);
+
+            /*
+             * The validator moved to a higher view, by a timeout or by joining f+1 validators
+             */
+            void MovedToView(void);
+            void SendViewChange(void);
+            void ReceivedViewChange(rapidjson::Document &d, Address &from);
+
+            /*
+             * The leader of the view starts it once it has 2f+1 view changes
+             */
+            void TryStartView(void);
+            void ReceivedNewView(rapidjson::Document &d);
+
+            BlockchainPbft                                      m_pbft;
+            std::map<std::string, Block>                        m_proposedBlocks;       // the blocks of the pre-prepares and view changes
+            std::map<int, std::pair<int, Block>>                m_pendingPrePrepares;   // sequence -> view and block, for a later sequence or view
+            std::map<int, std::vector<std::pair<int, int>>>     m_viewChangeProofs;     // view -> payload Bytes and signatures of its view changes
+            EventId                                             m_viewChangeEvent;
+            int                                                 m_timeoutsInRow;
+    };
+
+}
+
+#endif
@@ -0,0 +1,318 @@
+#include <climits>
+#include "ns3/log.h"
+#include "blockchain-pbft.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainPbft");
+
+    BlockchainPbft::BlockchainPbft(void) : m_replicas(1), m_replicaId(0), m_view(0), m_sequence(1), m_viewChanging(false),
+                                           m_prepared(false), m_committed(false), m_preparedView(-1), m_viewChangeCount(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainPbft::~BlockchainPbft(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainPbft::SetReplicas(int replicas, int replicaId)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(replicas < 1 || replicaId < 0 || replicaId >= replicas)
+            NS_FATAL_ERROR("Replica " << replicaId << " is not one of the " << replicas << " replicas");
+
+        m_replicas = replicas;
+        m_replicaId = replicaId;
+    }
+
+    int
+    BlockchainPbft::GetReplicas(void) const
+    {
+        return m_replicas;
+    }
+
+    int
+    BlockchainPbft::GetReplicaId(void) const
+    {
+        return m_replicaId;
+    }
+
+    int
+    BlockchainPbft::GetFaults(void) const
+    {
+        return (m_replicas - 1) / 3;
+    }
+
+    int
+    BlockchainPbft::GetQuorum(void) const
+    {
+        return 2 * GetFaults() + 1;
+    }
+
+    int
+    BlockchainPbft::GetView(void) const
+    {
+        return m_view;
+    }
+
+    int
+    BlockchainPbft::GetLeader(int view) const
+    {
+        return view % m_replicas;
+    }
+
+    bool
+    BlockchainPbft::IsLeader(void) const
+    {
+        return GetLeader(m_view) == m_replicaId;
+    }
+
+    bool
+    BlockchainPbft::IsViewChanging(void) const
+    {
+        return m_viewChanging;
+    }
+
+    void
+    BlockchainPbft::SetSequence(int sequence)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(sequence <= m_sequence)
+            return;
+
+        m_sequence = sequence;
+        m_acceptedDigest.clear();
+        m_prepared = false;
+        m_committed = false;
+        m_preparedView = -1;
+        m_preparedDigest.clear();
+
+        /*
+         * The votes of the committed sequence numbers are not needed anymore
+         */
+        VoteKey first(sequence, INT_MIN, "");
+
+        m_prepares.erase(m_prepares.begin(), m_prepares.lower_bound(first));
+        m_commits.erase(m_commits.begin(), m_commits.lower_bound(first));
+    }
+
+    int
+    BlockchainPbft::GetSequence(void) const
+    {
+        return m_sequence;
+    }
+
+    bool
+    BlockchainPbft::PrePrepare(int view, int sequence, const std::string &digest)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view != m_view || sequence != m_sequence || m_viewChanging || !m_acceptedDigest.empty())
+            return false;
+
+        m_acceptedDigest = digest;
+        return true;
+    }
+
+    void
+    BlockchainPbft::AddPrepare(int view, int sequence, const std::string &digest, int replica)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(sequence >= m_sequence)
+            m_prepares[VoteKey(sequence, view, digest)].insert(replica);
+    }
+
+    void
+    BlockchainPbft::AddCommit(int view, int sequence, const std::string &digest, int replica)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(sequence >= m_sequence)
+            m_commits[VoteKey(sequence, view, digest)].insert(replica);
+    }
+
+    int
+    BlockchainPbft::CountVotes(const std::map<VoteKey, std::set<int>> &votes, const std::string &digest, int excluded) const
+    {
+        auto it = votes.find(VoteKey(m_sequence, m_view, digest));
+
+        if(it == votes.end())
+            return 0;
+
+        return it->second.size() - it->second.count(excluded);
+    }
+
+    bool
+    BlockchainPbft::BecomesPrepared(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * The pre-prepare of the leader stands for its prepare
+         */
+        if(m_prepared || m_acceptedDigest.empty() || CountVotes(m_prepares, m_acceptedDigest, GetLeader(m_view)) < 2 * GetFaults())
+            return false;
+
+        m_prepared = true;
+        m_preparedView = m_view;
+        m_preparedDigest = m_acceptedDigest;
+        return true;
+    }
+
+    bool
+    BlockchainPbft::BecomesCommitted(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(!m_prepared || m_committed || CountVotes(m_commits, m_acceptedDigest, -1) < GetQuorum())
+            return false;
+
+        m_committed = true;
+        return true;
+    }
+
+    const std::string&
+    BlockchainPbft::GetAcceptedDigest(void) const
+    {
+        return m_acceptedDigest;
+    }
+
+    const std::string&
+    BlockchainPbft::GetPreparedDigest(void) const
+    {
+        return m_preparedDigest;
+    }
+
+    int
+    BlockchainPbft::GetPreparedView(void) const
+    {
+        return m_preparedView;
+    }
+
+    int
+    BlockchainPbft::StartViewChange(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        JoinView(m_view + 1);
+        return m_view;
+    }
+
+    void
+    BlockchainPbft::AddViewChange(int view, int sequence, int replica, int preparedView, const std::string &preparedDigest)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view < m_view)
+            return;
+
+        ViewChange &viewChange = m_viewChanges[view][replica];
+
+        viewChange.sequence = sequence;
+        viewChange.preparedView = preparedView;
+        viewChange.preparedDigest = preparedDigest;
+    }
+
+    int
+    BlockchainPbft::GetViewToJoin(void) const
+    {
+        std::set<int> replicas;
+        int view = -1;
+
+        for(auto it = m_viewChanges.upper_bound(m_view); it != m_viewChanges.end(); it++)
+        {
+            for(auto &replica : it->second)
+                replicas.insert(replica.first);
+
+            if(view < 0)
+                view = it->first;
+        }
+
+        return static_cast<int>(replicas.size()) > GetFaults() ? view : -1;
+    }
+
+    void
+    BlockchainPbft::JoinView(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view <= m_view)
+            return;
+
+        m_view = view;
+        m_viewChanging = true;
+        m_acceptedDigest.clear();
+        m_prepared = false;
+        m_committed = false;
+        m_viewChangeCount++;
+    }
+
+    bool
+    BlockchainPbft::CanStartView(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view != m_view || !m_viewChanging || GetLeader(view) != m_replicaId || m_startedViews.count(view) > 0)
+            return false;
+
+        auto it = m_viewChanges.find(view);
+
+        if(it == m_viewChanges.end() || static_cast<int>(it->second.size()) < GetQuorum())
+            return false;
+
+        m_startedViews.insert(view);
+        return true;
+    }
+
+    std::string
+    BlockchainPbft::GetViewDigest(int view) const
+    {
+        auto it = m_viewChanges.find(view);
+        int preparedView = -1;
+        std::string digest;
+
+        if(it == m_viewChanges.end())
+            return digest;
+
+        for(auto &replica : it->second)
+        {
+            const ViewChange &viewChange = replica.second;
+
+            if(viewChange.sequence == m_sequence && !viewChange.preparedDigest.empty() && viewChange.preparedView > preparedView)
+            {
+                preparedView = viewChange.preparedView;
+                digest = viewChange.preparedDigest;
+            }
+        }
+
+        return digest;
+    }
+
+    void
+    BlockchainPbft::EnterView(int view)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(view < m_view || (view == m_view && !m_viewChanging))
+            return;
+
+        if(view > m_view)
+            JoinView(view);
+
+        m_viewChanging = false;
+        m_viewChanges.erase(m_viewChanges.begin(), m_viewChanges.lower_bound(view));
+    }
+
+    int
+    BlockchainPbft::GetViewChanges(void) const
+    {
+        return m_viewChangeCount;
+    }
+
+}
@@ -0,0 +1,145 @@
+#ifndef BLOCKCHAIN_PBFT_H
+#define BLOCKCHAIN_PBFT_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace ns3 {
+
+    /*
+     * The agreement of a PBFT replica (Castro and Liskov) on the block of one sequence number, the height above the
+     * committed tip. Among n replicas f = (n-1)/3 may be faulty, and a quorum has 2f+1 replicas:
+     *   - the leader of view v, replica v mod n, pre-prepares a block;
+     *   - the other replicas accept it and send a prepare, a replica is prepared with 2f prepares;
+     *   - a prepared replica sends a commit, and commits the block with 2f+1 commits.
+     * A replica suspecting the leader moves to the next view and sends a view change with the block it prepared.
+     * It joins a higher view f+1 replicas moved to, and the leader of a view starts it with a new view once it has
+     * 2f+1 view changes, proposing again the block prepared in the highest view.
+     * The votes are counted in any order of arrival, the ones of an older sequence number are dropped.
+     */
+    class BlockchainPbft
+    {
+        public:
+            BlockchainPbft(void);
+            virtual ~BlockchainPbft(void);
+
+            /*
+             * param replicas : n, the number of validators
+             * param replicaId : the index of this replica among them
+             */
+            void SetReplicas(int replicas, int replicaId);
+            int GetReplicas(void) const;
+            int GetReplicaId(void) const;
+
+            int GetFaults(void) const;
+            int GetQuorum(void) const;
+
+            int GetView(void) const;
+            int GetLeader(int view) const;
+            bool IsLeader(void) const;
+
+            /*
+             * return true between the suspicion of the leader and the start of the next view
+             */
+            bool IsViewChanging(void) const;
+
+            /*
+             * Moves to the next sequence number once the previous one is committed
+             */
+            void SetSequence(int sequence);
+            int GetSequence(void) const;
+
+            /*
+             * return true if the block is accepted, the first one pre-prepared by the leader of the current view
+             */
+            bool PrePrepare(int view, int sequence, const std::string &digest);
+
+            void AddPrepare(int view, int sequence, const std::string &digest, int replica);
+            void AddCommit(int view, int sequence, const std::string &digest, int replica);
+
+            /*
+             * return true once, when the accepted block gathers its prepares (commits)
+             */
+            bool BecomesPrepared(void);
+            bool BecomesCommitted(void);
+
+            /*
+             * The block accepted in the current view, and the one prepared in the highest view, empty if none
+             */
+            const std::string& GetAcceptedDigest(void) const;
+            const std::string& GetPreparedDigest(void) const;
+            int GetPreparedView(void) const;
+
+            /*
+             * Suspects the leader and moves to the next view
+             * return the new view
+             */
+            int StartViewChange(void);
+
+            void AddViewChange(int view, int sequence, int replica, int preparedView, const std::string &preparedDigest);
+
+            /*
+             * return the smallest view above the current one among the views f+1 replicas moved to, -1 if none
+             */
+            int GetViewToJoin(void) const;
+
+            /*
+             * Moves to a higher view
+             */
+            void JoinView(int view);
+
+            /*
+             * return true once, when this replica leads the view it moved to and has 2f+1 view changes for it
+             */
+            bool CanStartView(int view);
+
+            /*
+             * return the block prepared in the highest view among the view changes of a view, empty if none
+             */
+            std::string GetViewDigest(int view) const;
+
+            /*
+             * Starts a view, announced by its leader
+             */
+            void EnterView(int view);
+
+            /*
+             * return the views this replica moved to
+             */
+            int GetViewChanges(void) const;
+
+        protected:
+
+            struct ViewChange
+            {
+                int         sequence;
+                int         preparedView;
+                std::string preparedDigest;
+            };
+
+            typedef std::tuple<int, int, std::string> VoteKey;             // sequence, view, digest
+
+            int CountVotes(const std::map<VoteKey, std::set<int>> &votes, const std::string &digest, int excluded) const;
+
+            int                                         m_replicas;
+            int                                         m_replicaId;
+            int                                         m_view;
+            int                                         m_sequence;
+            bool                                        m_viewChanging;
+            std::string                                 m_acceptedDigest;
+            bool                                        m_prepared;
+            bool                                        m_committed;
+            int                                         m_preparedView;
+            std::string                                 m_preparedDigest;
+            std::map<VoteKey, std::set<int>>            m_prepares;
+            std::map<VoteKey, std::set<int>>            m_commits;
+            std::map<int, std::map<int, ViewChange>>    m_viewChanges;      // view -> replica -> its view change
+            std::set<int>                               m_startedViews;
+            int                                         m_viewChangeCount;
+    };
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "blockchain-peer-monitor.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainPeerMonitor");
+
+    BlockchainPeerMonitor::BlockchainPeerMonitor(void) : m_minTimeout(1), m_maxTimeout(3600)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainPeerMonitor::~BlockchainPeerMonitor(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainPeerMonitor::SetTimeoutBounds(Time minTimeout, Time maxTimeout)
+    {
+        NS_LOG_FUNCTION(this);
+        m_minTimeout = minTimeout.GetSeconds();
+        m_maxTimeout = std::max(maxTimeout.GetSeconds(), m_minTimeout);
+    }
+
+    void
+    BlockchainPeerMonitor::RequestSent(const std::string &blockHash, Ipv4Address peer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Request request;
+        request.peer = peer;
+        request.time = Simulator::Now().GetSeconds();
+        request.sampled = false;
+
+        m_requests[blockHash] = request;
+    }
+
+    void
+    BlockchainPeerMonitor::HeadersReceived(const std::string &blockHash, Ipv4Address peer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_requests.find(blockHash);
+
+        if(it == m_requests.end() || it->second.peer != peer || it->second.sampled)
+            return;
+
+        PeerEstimate    &estimate = GetPeer(peer);
+        double          rtt = Simulator::Now().GetSeconds() - it->second.time;
+
+        if(!estimate.hasRtt)
+        {
+            estimate.srtt = rtt;
+            estimate.rttvar = rtt / 2;
+            estimate.hasRtt = true;
+        }
+        else
+        {
+            estimate.rttvar = 0.75 * estimate.rttvar + 0.25 * std::fabs(estimate.srtt - rtt);
+            estimate.srtt = 0.875 * estimate.srtt + 0.125 * rtt;
+        }
+
+        estimate.backoff = 1;
+        it->second.sampled = true;
+
+        NS_LOG_INFO("HeadersReceived : peer " << peer << " rtt = " << rtt << "s, srtt = " << estimate.srtt
+                    << "s, rttvar = " << estimate.rttvar << "s");
+    }
+
+    void
+    BlockchainPeerMonitor::BlocksReceived(const std::vector<std::string> &blockHashes, Ipv4Address peer, int sizeBytes)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double requestTime = -1;
+
+        for(auto hash = blockHashes.begin(); hash != blockHashes.end(); hash++)
+        {
+            auto it = m_requests.find(*hash);
+
+            if(it == m_requests.end())
+                continue;
+
+            if(it->second.peer == peer && (requestTime < 0 || it->second.time < requestTime))
+                requestTime = it->second.time;
+
+            m_requests.erase(it);
+        }
+
+        if(requestTime < 0 || sizeBytes <= 0)
+            return;
+
+        PeerEstimate    &estimate = GetPeer(peer);
+        double          elapsed = Simulator::Now().GetSeconds() - requestTime;
+        double          transferTime = elapsed - (estimate.hasRtt ? estimate.srtt : 0);
+        double          secondsPerByte = std::max(transferTime, elapsed / 2) / sizeBytes;
+
+        if(!estimate.hasThroughput)
+        {
+            estimate.secondsPerByte = secondsPerByte;
+            estimate.secondsPerByteVar = secondsPerByte / 2;
+            estimate.hasThroughput = true;
+        }
+        else
+        {
+            estimate.secondsPerByteVar = 0.75 * estimate.secondsPerByteVar + 0.25 * std::fabs(estimate.secondsPerByte - secondsPerByte);
+            estimate.secondsPerByte = 0.875 * estimate.secondsPerByte + 0.125 * secondsPerByte;
+        }
+
+        estimate.backoff = 1;
+
+        NS_LOG_INFO("BlocksReceived : peer " << peer << " delivered " << sizeBytes << " Bytes in " << elapsed
+                    << "s, throughput = " << 1 / estimate.secondsPerByte << "B/s");
+    }
+
+    void
+    BlockchainPeerMonitor::RequestTimedOut(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto it = m_requests.find(blockHash);
+
+        if(it == m_requests.end())
+            return;
+
+        PeerEstimate &estimate = GetPeer(it->second.peer);
+        estimate.backoff = std::min(2 * estimate.backoff, static_cast<int>(m_maxBackoff));
+
+        m_requests.erase(it);
+    }
+
+    void
+    BlockchainPeerMonitor::RemoveRequest(const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+        m_requests.erase(blockHash);
+    }
+
+    bool
+    BlockchainPeerMonitor::HasRequest(const std::string &blockHash) const
+    {
+        return m_requests.find(blockHash) != m_requests.end();
+    }
+
+    Ipv4Address
+    BlockchainPeerMonitor::GetRequestPeer(const std::string &blockHash) const
+    {
+        auto it = m_requests.find(blockHash);
+
+        if(it == m_requests.end())
+            return Ipv4Address();
+
+        return it->second.peer;
+    }
+
+    Time
+    BlockchainPeerMonitor::GetRequestTime(const std::string &blockHash) const
+    {
+        auto it = m_requests.find(blockHash);
+
+        if(it == m_requests.end())
+            return Seconds(-1);
+
+        return Seconds(it->second.time);
+    }
+
+    Time
+    BlockchainPeerMonitor::GetTimeout(Ipv4Address peer, int sizeBytes, double priorBytesPerSecond) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        auto    it = m_peers.find(peer);
+        double  rttTerm = 1;                                        // the initial RTO of RFC 6298
+        double  transferTerm = 0;
+        int     backoff = 1;
+
+        if(priorBytesPerSecond > 0)
+            transferTerm = sizeBytes / priorBytesPerSecond;
+
+        if(it != m_peers.end())
+        {
+            const PeerEstimate &estimate = it->second;
+
+            if(estimate.hasRtt)
+                rttTerm = estimate.srtt + 4 * estimate.rttvar;
+            if(estimate.hasThroughput)
+                transferTerm = sizeBytes * (estimate.secondsPerByte + 4 * estimate.secondsPerByteVar);
+            backoff = estimate.backoff;
+        }
+
+        return Seconds(std::min(std::max(backoff * (rttTerm + transferTerm), m_minTimeout), m_maxTimeout));
+    }
+
+    double
+    BlockchainPeerMonitor::GetThroughput(Ipv4Address peer, double priorBytesPerSecond) const
+    {
+        auto it = m_peers.find(peer);
+
+        if(it == m_peers.end() || !it->second.hasThroughput || it->second.secondsPerByte <= 0)
+            return priorBytesPerSecond;
+
+        return 1 / it->second.secondsPerByte;
+    }
+
+    Time
+    BlockchainPeerMonitor::GetSmoothedRtt(Ipv4Address peer) const
+    {
+        auto it = m_peers.find(peer);
+
+        if(it == m_peers.end() || !it->second.hasRtt)
+            return Seconds(0);
+
+        return Seconds(it->second.srtt);
+    }
+
+    BlockchainPeerMonitor::PeerEstimate &
+    BlockchainPeerMonitor::GetPeer(Ipv4Address peer)
+    {
+        auto it = m_peers.find(peer);
+
+        if(it == m_peers.end())
+        {
+            PeerEstimate estimate;
+            estimate.srtt = 0;
+            estimate.rttvar = 0;
+            estimate.secondsPerByte = 0;
+            estimate.secondsPerByteVar = 0;
+            estimate.hasRtt = false;
+            estimate.hasThroughput = false;
+            estimate.backoff = 1;
+
+            it = m_peers.insert(std::make_pair(peer, estimate)).first;
+        }
+
+        return it->second;
+    }
+
+}
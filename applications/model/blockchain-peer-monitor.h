@@ -0,0 +1,119 @@
+#ifndef BLOCKCHAIN_PEER_MONITOR_H
+#define BLOCKCHAIN_PEER_MONITOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/ipv4-address.h"
+
+namespace ns3 {
+
+    /*
+     * Measures the round trip time and the delivered throughput of every peer from the block
+     * requests of a node, and derives the request timeouts from them like the TCP retransmission
+     * timeout (RFC 6298):
+     *   timeout = SRTT + 4 * RTTVAR + size * (SPB + 4 * SPBVAR)
+     * SPB is the smoothed time per byte of the delivered blocks and SPBVAR its mean deviation.
+     * RTT samples come from the HEADERS answering a request. Throughput samples come from the BLOCK
+     * answering it, minus one SRTT. Every timeout of a peer doubles its timeouts until it answers again.
+     */
+    class BlockchainPeerMonitor
+    {
+        public:
+            BlockchainPeerMonitor(void);
+            virtual ~BlockchainPeerMonitor(void);
+
+            /*
+             * Sets the range of the computed timeouts
+             */
+            void SetTimeoutBounds(Time minTimeout, Time maxTimeout);
+
+            /*
+             * Records that the block blockHash was requested from peer now
+             */
+            void RequestSent(const std::string &blockHash, Ipv4Address peer);
+
+            /*
+             * Takes an RTT sample if the headers come from the peer the block was requested from
+             */
+            void HeadersReceived(const std::string &blockHash, Ipv4Address peer);
+
+            /*
+             * Takes a throughput sample when the blocks requested from peer have been downloaded and
+             * forgets their requests
+             * param blockHashes : the blocks of the BLOCK message
+             * param sizeBytes : the size of the BLOCK message
+             */
+            void BlocksReceived(const std::vector<std::string> &blockHashes, Ipv4Address peer, int sizeBytes);
+
+            /*
+             * Backs off the peer the block was requested from and forgets the request
+             */
+            void RequestTimedOut(const std::string &blockHash);
+
+            void RemoveRequest(const std::string &blockHash);
+
+            bool HasRequest(const std::string &blockHash) const;
+
+            /*
+             * return the peer the block was requested from, only meaningful if HasRequest(blockHash)
+             */
+            Ipv4Address GetRequestPeer(const std::string &blockHash) const;
+
+            /*
+             * return the time the block was requested, or a negative time if it was not requested
+             */
+            Time GetRequestTime(const std::string &blockHash) const;
+
+            /*
+             * The timeout of a request, bounded by SetTimeoutBounds
+             * param peer : the peer of the request
+             * param sizeBytes : the expected size of the block, 0 if it is not known yet
+             * param priorBytesPerSecond : the throughput assumed until the peer delivered a block
+             */
+            Time GetTimeout(Ipv4Address peer, int sizeBytes, double priorBytesPerSecond) const;
+
+            /*
+             * return the measured throughput of the peer in Bytes/s, or priorBytesPerSecond if it has not
+             * delivered a block yet
+             */
+            double GetThroughput(Ipv4Address peer, double priorBytesPerSecond) const;
+
+            /*
+             * return the smoothed RTT of the peer, or 0 if it is not measured yet
+             */
+            Time GetSmoothedRtt(Ipv4Address peer) const;
+
+        protected:
+
+            struct PeerEstimate
+            {
+                double      srtt;                   // seconds
+                double      rttvar;
+                double      secondsPerByte;
+                double      secondsPerByteVar;
+                bool        hasRtt;
+                bool        hasThroughput;
+                int         backoff;                // multiplier of the timeouts
+            };
+
+            struct Request
+            {
+                Ipv4Address peer;
+                double      time;
+                bool        sampled;                // only the first HEADERS answer is an RTT sample
+            };
+
+            PeerEstimate &GetPeer(Ipv4Address peer);
+
+            std::map<Ipv4Address, PeerEstimate>     m_peers;
+            std::map<std::string, Request>          m_requests;
+            double                                  m_minTimeout;       // seconds
+            double                                  m_maxTimeout;       // seconds
+            static const int                        m_maxBackoff = 64;
+    };
+
+}
+
+#endif
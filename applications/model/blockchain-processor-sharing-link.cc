@@ -0,0 +1,224 @@
+#include <algorithm>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "blockchain-processor-sharing-link.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainProcessorSharingLink");
+
+    BlockchainProcessorSharingLink::BlockchainProcessorSharingLink(void) : m_linkRate(0), m_virtualTime(0), m_nextSequence(0),
+                                                                        m_maxActiveTransfers(0), m_activeTransfersIntegral(0), m_busyTime(0)
+    {
+        NS_LOG_FUNCTION(this);
+        m_lastUpdateTime = Simulator::Now().GetSeconds();
+        m_creationTime = m_lastUpdateTime;
+    }
+
+    BlockchainProcessorSharingLink::~BlockchainProcessorSharingLink(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainProcessorSharingLink::SetLinkRate(double linkRate)
+    {
+        NS_LOG_FUNCTION(this);
+        m_linkRate = linkRate;
+    }
+
+    void
+    BlockchainProcessorSharingLink::SetCompleteCallback(Callback<void, std::string, Address&> completeCallback)
+    {
+        NS_LOG_FUNCTION(this);
+        m_completeCallback = completeCallback;
+    }
+
+    void
+    BlockchainProcessorSharingLink::AddTransfer(Ipv4Address peer, const Address &address, const std::string &packet, double sizeBytes, double peerRate)
+    {
+        NS_LOG_FUNCTION(this);
+
+        UpdateVirtualTime();
+
+        Transfer transfer;
+        transfer.finishTag = m_virtualTime + sizeBytes;
+        transfer.earliestFinish = Simulator::Now().GetSeconds() + (peerRate > 0 ? sizeBytes / peerRate : 0);
+        transfer.peer = peer;
+        transfer.address = address;
+        transfer.packet = packet;
+        transfer.sequence = m_nextSequence++;
+
+        m_transfers.push(transfer);
+        m_maxActiveTransfers = std::max(m_maxActiveTransfers, static_cast<uint32_t>(m_transfers.size()));
+
+        NS_LOG_INFO("AddTransfer: At time " << Simulator::Now().GetSeconds() << " a transfer of " << sizeBytes
+                    << " Bytes from " << peer << " started, active transfers = " << m_transfers.size());
+
+        ScheduleNextFinish();
+    }
+
+    void
+    BlockchainProcessorSharingLink::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        UpdateVirtualTime();
+        Simulator::Cancel(m_nextFinishEvent);
+
+        for(auto it = m_deliveryEvents.begin(); it != m_deliveryEvents.end(); it++)
+        {
+            Simulator::Cancel(*it);
+        }
+
+        m_deliveryEvents.clear();
+        m_transfers = std::priority_queue<Transfer, std::vector<Transfer>, TransferCompare>();
+    }
+
+    uint32_t
+    BlockchainProcessorSharingLink::GetActiveTransfers(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_transfers.size();
+    }
+
+    uint32_t
+    BlockchainProcessorSharingLink::GetMaxActiveTransfers(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_maxActiveTransfers;
+    }
+
+    double
+    BlockchainProcessorSharingLink::GetMeanActiveTransfers(void) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+        double elapsed = now - m_creationTime;
+
+        if(elapsed <= 0)
+            return 0;
+
+        return (m_activeTransfersIntegral + m_transfers.size() * (now - m_lastUpdateTime)) / elapsed;
+    }
+
+    double
+    BlockchainProcessorSharingLink::GetUtilization(void) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+        double elapsed = now - m_creationTime;
+        double busyTime = m_busyTime;
+
+        if(elapsed <= 0)
+            return 0;
+
+        if(!m_transfers.empty())
+            busyTime += now - m_lastUpdateTime;
+
+        return busyTime / elapsed;
+    }
+
+    void
+    BlockchainProcessorSharingLink::UpdateVirtualTime(void)
+    {
+        double now = Simulator::Now().GetSeconds();
+        double elapsed = now - m_lastUpdateTime;
+
+        if(!m_transfers.empty())
+        {
+            if(m_linkRate > 0)
+            {
+                m_virtualTime += elapsed * m_linkRate / m_transfers.size();
+            }
+            m_activeTransfersIntegral += m_transfers.size() * elapsed;
+            m_busyTime += elapsed;
+        }
+
+        m_lastUpdateTime = now;
+    }
+
+    void
+    BlockchainProcessorSharingLink::ScheduleNextFinish(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Simulator::Cancel(m_nextFinishEvent);
+
+        if(m_transfers.empty())
+            return;
+
+        double delay = 0;
+
+        if(m_linkRate > 0)
+        {
+            delay = std::max(0.0, (m_transfers.top().finishTag - m_virtualTime) * m_transfers.size() / m_linkRate);
+        }
+
+        m_nextFinishEvent = Simulator::Schedule(Seconds(delay), &BlockchainProcessorSharingLink::FinishTransfers, this);
+    }
+
+    void
+    BlockchainProcessorSharingLink::FinishTransfers(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        const double        timeStep = TimeStep(1).GetSeconds();    // the resolution of the event times
+        double              now = Simulator::Now().GetSeconds();
+        std::vector<Transfer>   finished;
+
+        UpdateVirtualTime();
+
+        /*
+         * The event times are rounded to the time step, so a transfer is done once less than a time step of it is left.
+         * A tolerance in Bytes would leave a transfer of a fast link unfinished, and reschedule it without delay forever.
+         */
+        while(!m_transfers.empty() && (m_linkRate <= 0
+                || (m_transfers.top().finishTag - m_virtualTime) * m_transfers.size() / m_linkRate < timeStep))
+        {
+            finished.push_back(m_transfers.top());
+            m_transfers.pop();
+        }
+
+        /*
+         * The remaining transfers get a bigger share of the link from now on
+         */
+        ScheduleNextFinish();
+
+        m_deliveryEvents.erase(std::remove_if(m_deliveryEvents.begin(), m_deliveryEvents.end(),
+                                            [](const EventId &event) { return event.IsExpired(); }),
+                                m_deliveryEvents.end());
+
+        for(auto it = finished.begin(); it != finished.end(); it++)
+        {
+            NS_LOG_INFO("FinishTransfers: At time " << now << " the transfer from " << it->peer << " left the link");
+
+            if(it->earliestFinish > now)
+            {
+                /*
+                 * The sender could not keep up with its share of the link
+                 */
+                m_deliveryEvents.push_back(Simulator::Schedule(Seconds(it->earliestFinish - now),
+                                                                &BlockchainProcessorSharingLink::DeliverTransfer, this, it->packet, it->address));
+            }
+            else
+            {
+                DeliverTransfer(it->packet, it->address);
+            }
+        }
+    }
+
+    void
+    BlockchainProcessorSharingLink::DeliverTransfer(std::string packet, Address address)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(!m_completeCallback.IsNull())
+        {
+            m_completeCallback(packet, address);
+        }
+    }
+
+}
@@ -0,0 +1,120 @@
+#ifndef BLOCKCHAIN_PROCESSOR_SHARING_LINK_H
+#define BLOCKCHAIN_PROCESSOR_SHARING_LINK_H
+
+#include <queue>
+#include <string>
+#include <vector>
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+    /*
+     * Processor-sharing model of a node's downlink: all the active transfers share the link rate equally.
+     * The link keeps a virtual time that advances at linkRate/activeTransfers, so a transfer of s bytes
+     * that starts at virtual time v finishes when the virtual time reaches v + s. The finish tags are kept
+     * in a min-heap, and only the earliest one has a pending event, which is rescheduled whenever a
+     * transfer starts or finishes.
+     */
+    class BlockchainProcessorSharingLink
+    {
+        public:
+            BlockchainProcessorSharingLink(void);
+            virtual ~BlockchainProcessorSharingLink(void);
+
+            /*
+             * Sets the capacity of the link in Bytes/s
+             */
+            void SetLinkRate(double linkRate);
+
+            /*
+             * Called when the last byte of a transfer has been received
+             */
+            void SetCompleteCallback(Callback<void, std::string, Address&> completeCallback);
+
+            /*
+             * Starts a new transfer on the link
+             * param peer : the sender of the transfer
+             * param address : the address handed to the complete callback
+             * param packet : the message carried by the transfer
+             * param sizeBytes : the size of the transfer in bytes
+             * param peerRate : the upload speed of the sender in Bytes/s (0 : no limit). The transfer
+             *                  cannot finish earlier than sizeBytes/peerRate after it started
+             */
+            void AddTransfer(Ipv4Address peer, const Address &address, const std::string &packet, double sizeBytes, double peerRate);
+
+            /*
+             * Drops every active transfer and cancels the pending events
+             */
+            void Clear(void);
+
+            uint32_t GetActiveTransfers(void) const;
+
+            uint32_t GetMaxActiveTransfers(void) const;
+
+            /*
+             * Time-weighted average of the active transfers since the link was created
+             */
+            double GetMeanActiveTransfers(void) const;
+
+            /*
+             * Fraction of time the link has had at least one active transfer since it was created
+             */
+            double GetUtilization(void) const;
+
+        protected:
+
+            struct Transfer
+            {
+                double          finishTag;              // virtual time at which the transfer finishes
+                double          earliestFinish;         // start + sizeBytes/peerRate
+                Ipv4Address     peer;
+                Address         address;
+                std::string     packet;
+                uint64_t        sequence;
+            };
+
+            struct TransferCompare
+            {
+                bool operator()(const Transfer &t1, const Transfer &t2) const
+                {
+                    if(t1.finishTag != t2.finishTag)
+                        return t1.finishTag > t2.finishTag;
+                    return t1.sequence > t2.sequence;
+                }
+            };
+
+            /*
+             * Advances the virtual time and the statistics up to the current time
+             */
+            void UpdateVirtualTime(void);
+
+            /*
+             * Reschedules m_nextFinishEvent for the transfer with the smallest finish tag
+             */
+            void ScheduleNextFinish(void);
+
+            void FinishTransfers(void);
+
+            void DeliverTransfer(std::string packet, Address address);
+
+            double                                                                  m_linkRate;         // Bytes/s
+            Callback<void, std::string, Address&>                                   m_completeCallback;
+            std::priority_queue<Transfer, std::vector<Transfer>, TransferCompare>    m_transfers;
+
+            double          m_virtualTime;
+            double          m_lastUpdateTime;
+            double          m_creationTime;
+            EventId         m_nextFinishEvent;
+            std::vector<EventId>    m_deliveryEvents;   // pending deliveries of rate limited transfers
+            uint64_t        m_nextSequence;
+            uint32_t        m_maxActiveTransfers;
+            double          m_activeTransfersIntegral;
+            double          m_busyTime;
+    };
+
+}
+
+#endif
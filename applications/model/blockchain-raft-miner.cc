@@ -0,0 +1,481 @@
+#include "ns3/address.h"
+#include "ns3/log.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/blockchain-raft-miner.h"
+#include <stdlib.h>
+#include <algorithm>
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainRaftMiner");
+    NS_OBJECT_ENSURE_REGISTERED(BlockchainRaftMiner);
+
+    TypeId
+    BlockchainRaftMiner::GetTypeId(void)
+    {
+        static TypeId tid = TypeId("ns3::BlockchainRaftMiner")
+            .SetParent<BlockchainValidator>()
+            .SetGroupName("Application")
+            .AddConstructor<BlockchainRaftMiner>()
+        ;
+        return tid;
+    }
+
+    BlockchainRaftMiner::BlockchainRaftMiner() : BlockchainValidator(), m_role(RAFT_FOLLOWER), m_term(0), m_votedFor(-1), m_leaderId(-1),
+                                                 m_hasEntry(false), m_entryValidated(false), m_leaderCommit(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainRaftMiner::~BlockchainRaftMiner(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainRaftMiner::StartConsensus(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_role = RAFT_FOLLOWER;
+        ArmElectionTimer();
+    }
+
+    void
+    BlockchainRaftMiner::StopConsensus(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Simulator::Cancel(m_electionEvent);
+        Simulator::Cancel(m_heartbeatEvent);
+
+        NS_LOG_WARN("Raft : validator " << m_validatorId << " in term " << m_term << " is "
+                    << (m_role == RAFT_LEADER ? "the leader" : m_role == RAFT_CANDIDATE ? "a candidate" : "a follower")
+                    << ", elections started = " << m_viewChanges << ", majority = " << GetMajority());
+    }
+
+    int
+    BlockchainRaftMiner::GetMajority(void) const
+    {
+        return m_noMiners/2 + 1;
+    }
+
+    int
+    BlockchainRaftMiner::GetLastIndex(void) const
+    {
+        return m_hasEntry ? m_entry.GetBlockHeight() : m_blockchain.GetCurrentTopBlock()->GetBlockHeight();
+    }
+
+    void
+    BlockchainRaftMiner::Propose(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_role != RAFT_LEADER || m_hasEntry || newBlock.GetBlockHeight() != m_blockchain.GetCurrentTopBlock()->GetBlockHeight() + 1)
+        {
+            NS_LOG_INFO("Propose : validator " << m_validatorId << " drops the block " << GetBlockHash(newBlock) << ", it cannot append it in term " << m_term);
+            return;
+        }
+
+        m_entry = newBlock;
+        m_hasEntry = true;
+        m_entryValidated = true;
+        m_acks.clear();
+        m_acks.insert(m_validatorId);
+
+        SendAppend(true);
+
+        if(static_cast<int>(m_acks.size()) >= GetMajority())
+        {
+            CommitEntry();
+            SendAppend(false);
+        }
+    }
+
+    void
+    BlockchainRaftMiner::Committed(const Block &newTip)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_hasEntry && m_entry.GetBlockHeight() <= newTip.GetBlockHeight())
+        {
+            m_hasEntry = false;
+            m_entryValidated = false;
+        }
+
+        m_futureEntries.erase(m_futureEntries.begin(), m_futureEntries.upper_bound(newTip.GetBlockHeight()));
+
+        if(m_role == RAFT_LEADER)
+        {
+            ScheduleProposal();
+        }
+        else if(!m_hasEntry && m_futureEntries.count(newTip.GetBlockHeight() + 1) > 0)
+        {
+            /*
+             * The block appended above the missing parent can be validated now
+             */
+            Block block = m_futureEntries[newTip.GetBlockHeight() + 1];
+            double validationTime = ReserveBlockValidation(block);
+
+            m_futureEntries.erase(newTip.GetBlockHeight() + 1);
+            m_entry = block;
+            m_hasEntry = true;
+            Simulator::Schedule(Seconds(validationTime), &BlockchainRaftMiner::EntryValidated, this, m_term, block);
+        }
+    }
+
+    void
+    BlockchainRaftMiner::ReceivedConsensusMessage(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_crashed)
+            return;
+
+        switch(d["message"].GetInt())
+        {
+            case RAFT_APPEND:
+            {
+                ReceivedAppend(d, from);
+                break;
+            }
+            case RAFT_ACK:
+            {
+                ReceivedAck(d);
+                break;
+            }
+            case RAFT_VOTE_REQUEST:
+            {
+                ReceivedVoteRequest(d, from);
+                break;
+            }
+            case RAFT_VOTE:
+            {
+                ReceivedVote(d);
+                break;
+            }
+            default:
+            {
+                BlockchainNode::ReceivedConsensusMessage(d, from);
+                break;
+            }
+        }
+    }
+
+    void
+    BlockchainRaftMiner::ArmElectionTimer(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double timeout = m_viewChangeTimeout * (1 + rand()/static_cast<double>(RAND_MAX));
+
+        Simulator::Cancel(m_electionEvent);
+        m_electionEvent = Simulator::Schedule(Seconds(timeout), &BlockchainRaftMiner::StartElection, this);
+    }
+
+    void
+    BlockchainRaftMiner::StartElection(void)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("StartElection : validator " << m_validatorId << " starts the election of term " << m_term + 1);
+
+        rapidjson::Document d;
+        rapidjson::Value    value;
+
+        m_term++;
+        m_role = RAFT_CANDIDATE;
+        m_votedFor = m_validatorId;
+        m_votes.clear();
+        m_votes.insert(m_validatorId);
+        m_viewChanges++;
+        Simulator::Cancel(m_nextMiningEvent);
+
+        SetConsensusMessage(d, RAFT_VOTE_REQUEST, m_blockchainMessageHeader + 3*m_consensusFieldBytes + m_countBytes, 0);
+
+        value = m_term;
+        d.AddMember("term", value, d.GetAllocator());
+
+        value = GetLastIndex();
+        d.AddMember("lastIndex", value, d.GetAllocator());
+
+        BroadcastConsensusMessage(d);
+        ArmElectionTimer();
+
+        if(static_cast<int>(m_votes.size()) >= GetMajority())
+            BecomeLeader();
+    }
+
+    void
+    BlockchainRaftMiner::ReceivedVoteRequest(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document vote;
+        rapidjson::Value    value;
+        int                 term = d["term"].GetInt();
+        int                 candidate = d["replica"].GetInt();
+
+        if(term > m_term)
+            StepDown(term);
+
+        bool granted = term == m_term && (m_votedFor < 0 || m_votedFor == candidate) && d["lastIndex"].GetInt() >= GetLastIndex();
+
+        if(granted)
+        {
+            m_votedFor = candidate;
+            ArmElectionTimer();
+        }
+
+        SetConsensusMessage(vote, RAFT_VOTE, m_blockchainMessageHeader + m_consensusFieldBytes + 1, 0);
+
+        value = m_term;
+        vote.AddMember("term", value, vote.GetAllocator());
+
+        value = granted;
+        vote.AddMember("granted", value, vote.GetAllocator());
+
+        SendConsensusMessage(vote, from);
+    }
+
+    void
+    BlockchainRaftMiner::ReceivedVote(rapidjson::Document &d)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int term = d["term"].GetInt();
+
+        if(term > m_term)
+        {
+            StepDown(term);
+            return;
+        }
+
+        if(m_role != RAFT_CANDIDATE || term != m_term || !d["granted"].GetBool())
+            return;
+
+        m_votes.insert(d["replica"].GetInt());
+
+        if(static_cast<int>(m_votes.size()) >= GetMajority())
+            BecomeLeader();
+    }
+
+    void
+    BlockchainRaftMiner::BecomeLeader(void)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("BecomeLeader : validator " << m_validatorId << " leads the term " << m_term);
+
+        m_role = RAFT_LEADER;
+        m_leaderId = m_validatorId;
+        Simulator::Cancel(m_electionEvent);
+
+        /*
+         * The block left by the previous leader is appended again in the new term
+         */
+        if(m_hasEntry && m_entryValidated)
+        {
+            m_acks.clear();
+            m_acks.insert(m_validatorId);
+            SendAppend(true);
+        }
+        else
+        {
+            m_hasEntry = false;
+            SendAppend(false);
+            ScheduleProposal();
+        }
+    }
+
+    void
+    BlockchainRaftMiner::StepDown(int term)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_role == RAFT_LEADER)
+            Simulator::Cancel(m_nextMiningEvent);
+
+        if(term > m_term)
+            m_votedFor = -1;
+
+        m_term = term;
+        m_role = RAFT_FOLLOWER;
+        Simulator::Cancel(m_heartbeatEvent);
+        ArmElectionTimer();
+    }
+
+    void
+    BlockchainRaftMiner::SendAppend(bool withEntry)
+    {
+        NS_LOG_FUNCTION(this);
+
+        rapidjson::Document d;
+        rapidjson::Value    value;
+        int                 sizeBytes = m_blockchainMessageHeader + 4*m_consensusFieldBytes + m_countBytes;
+
+        withEntry = withEntry && m_hasEntry;
+
+        if(withEntry)
+            sizeBytes += m_entry.GetBlockSizeBytes();
+
+        SetConsensusMessage(d, RAFT_APPEND, sizeBytes, 0);
+
+        value = m_term;
+        d.AddMember("term", value, d.GetAllocator());
+
+        value = m_blockchain.GetCurrentTopBlock()->GetBlockHeight();
+        d.AddMember("commit", value, d.GetAllocator());
+
+        if(withEntry)
+            AddProposedBlock(d, m_entry);
+
+        BroadcastConsensusMessage(d);
+
+        Simulator::Cancel(m_heartbeatEvent);
+        m_heartbeatEvent = Simulator::Schedule(Seconds(m_viewChangeTimeout/3), &BlockchainRaftMiner::SendHeartbeat, this);
+    }
+
+    void
+    BlockchainRaftMiner::SendHeartbeat(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_role == RAFT_LEADER)
+            SendAppend(false);
+    }
+
+    void
+    BlockchainRaftMiner::ReceivedAppend(rapidjson::Document &d, Address &from)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int term = d["term"].GetInt();
+
+        /*
+         * A stale leader learns the new term from the vote requests
+         */
+        if(term < m_term)
+            return;
+
+        if(term > m_term || m_role != RAFT_FOLLOWER)
+            StepDown(term);
+        else
+            ArmElectionTimer();
+
+        m_leaderId = d["replica"].GetInt();
+        m_leaderAddress = from;
+        m_leaderCommit = std::max(m_leaderCommit, d["commit"].GetInt());
+
+        if(d.HasMember("blocks"))
+        {
+            Block   block = ReadProposedBlock(d, from);
+            int     tipHeight = m_blockchain.GetCurrentTopBlock()->GetBlockHeight();
+
+            if(block.GetBlockHeight() == tipHeight + 1)
+            {
+                double validationTime = ReserveBlockValidation(block);
+
+                m_entry = block;
+                m_hasEntry = true;
+                m_entryValidated = false;
+                Simulator::Schedule(Seconds(validationTime), &BlockchainRaftMiner::EntryValidated, this, term, block);
+            }
+            else if(block.GetBlockHeight() > tipHeight + 1)
+            {
+                m_futureEntries[block.GetBlockHeight()] = block;
+            }
+        }
+
+        if(m_hasEntry && m_entryValidated && m_leaderCommit >= m_entry.GetBlockHeight())
+            CommitEntry();
+    }
+
+    void
+    BlockchainRaftMiner::EntryValidated(int term, Block block)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_crashed || !m_hasEntry || !(m_entry == block))
+            return;
+
+        m_entryValidated = true;
+
+        if(term == m_term && m_role == RAFT_FOLLOWER)
+            SendAck(block.GetBlockHeight(), true);
+
+        if(m_leaderCommit >= block.GetBlockHeight())
+            CommitEntry();
+    }
+
+    void
+    BlockchainRaftMiner::SendAck(int index, bool success)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_leaderId < 0)
+            return;
+
+        rapidjson::Document d;
+        rapidjson::Value    value;
+
+        SetConsensusMessage(d, RAFT_ACK, m_blockchainMessageHeader + 2*m_consensusFieldBytes + 1, 0);
+
+        value = m_term;
+        d.AddMember("term", value, d.GetAllocator());
+
+        value = index;
+        d.AddMember("index", value, d.GetAllocator());
+
+        value = success;
+        d.AddMember("success", value, d.GetAllocator());
+
+        SendConsensusMessage(d, m_leaderAddress);
+    }
+
+    void
+    BlockchainRaftMiner::ReceivedAck(rapidjson::Document &d)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int term = d["term"].GetInt();
+
+        if(term > m_term)
+        {
+            StepDown(term);
+            return;
+        }
+
+        if(m_role != RAFT_LEADER || term != m_term || !d["success"].GetBool() || !m_hasEntry
+            || d["index"].GetInt() != m_entry.GetBlockHeight())
+            return;
+
+        m_acks.insert(d["replica"].GetInt());
+
+        if(static_cast<int>(m_acks.size()) >= GetMajority())
+        {
+            CommitEntry();
+
+            /*
+             * The followers learn the commit index right away instead of with the next heartbeat
+             */
+            SendAppend(false);
+        }
+    }
+
+    void
+    BlockchainRaftMiner::CommitEntry(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Block block = m_entry;
+
+        NS_LOG_INFO("CommitEntry : validator " << m_validatorId << " commits the block " << GetBlockHash(block) << " in term " << m_term);
+
+        m_hasEntry = false;
+        m_entryValidated = false;
+        m_acks.clear();
+        CommitBlock(block);
+    }
+
+}
@@ -0,0 +1,95 @@
+#ifndef BLOCKCHAIN_RAFT_MINER_H
+#define BLOCKCHAIN_RAFT_MINER_H
+
+#include "blockchain-validator.h"
+#include <set>
+
+
+namespace ns3 {
+
+    /*
+     * A replica of a Raft ordering service, the crash fault tolerant baseline of BlockchainPbftMiner.
+     * The leader of a term appends its blocks to the followers, which validate them and acknowledge them, and
+     * commits a block with the acknowledgements of a majority. The commit index reaches the followers with the next
+     * append, sent right after the commit, so a block costs O(n) unsigned messages.
+     * A follower that hears nothing from the leader for ViewChangeTimeout to 2*ViewChangeTimeout starts an election,
+     * the leader sends heartbeats every third of ViewChangeTimeout. The log holds at most one block above the
+     * committed tip, the followers missing blocks get them from the announcements of the blockchain.
+     */
+    class BlockchainRaftMiner : public BlockchainValidator
+    {
+        public:
+
+            static TypeId GetTypeId(void);
+            BlockchainRaftMiner();
+
+            virtual ~BlockchainRaftMiner(void);
+
+        protected:
+
+            enum RaftRole
+            {
+                RAFT_FOLLOWER,
+                RAFT_CANDIDATE,
+                RAFT_LEADER
+            };
+
+            virtual void StartConsensus(void);
+            virtual void StopConsensus(void);
+            virtual void Propose(const Block &newBlock);
+            virtual void Committed(const Block &newTip);
+
+            virtual void ReceivedConsensusMessage(rapidjson::Document &d, Address &from);
+
+            int GetMajority(void) const;
+
+            /*
+             * return the height of the last block of the log
+             */
+            int GetLastIndex(void) const;
+
+            void ArmElectionTimer(void);
+            void StartElection(void);
+            void ReceivedVoteRequest(rapidjson::Document &d, Address &from);
+            void ReceivedVote(rapidjson::Document &d);
+            void BecomeLeader(void);
+
+            /*
+             * Moves to a higher term as a follower
+             */
+            void StepDown(int term);
+
+            /*
+             * Sends the uncommitted block if any, or a heartbeat with the commit index
+             */
+            void SendAppend(bool withEntry);
+            void SendHeartbeat(void);
+            void ReceivedAppend(rapidjson::Document &d, Address &from);
+            void EntryValidated(int term, Block block);
+            void SendAck(int index, bool success);
+            void ReceivedAck(rapidjson::Document &d);
+
+            /*
+             * Commits the block of the log once the leader committed it
+             */
+            void CommitEntry(void);
+
+            enum RaftRole               m_role;
+            int                         m_term;
+            int                         m_votedFor;             // -1 if none in this term
+            int                         m_leaderId;
+            Address                     m_leaderAddress;
+            std::set<int>               m_votes;
+            std::set<int>               m_acks;
+            Block                       m_entry;                // the block above the committed tip
+            bool                        m_hasEntry;
+            bool                        m_entryValidated;
+            int                         m_leaderCommit;         // the highest commit index of the leader
+            std::map<int, Block>        m_futureEntries;        // blocks appended above a missing parent
+            EventId                     m_electionEvent;
+            EventId                     m_heartbeatEvent;
+    };
+
+}
+
+#endif
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include "ns3/log.h"
+#include "blockchain-seen-cache.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainSeenCache");
+
+    /*
+     * splitmix64 finalizer
+     */
+    static inline uint64_t
+    Mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    BlockchainSeenCache::BlockchainSeenCache(void) : m_hits(0), m_evictions(0), m_filterRejects(0)
+    {
+        NS_LOG_FUNCTION(this);
+        SetCapacity(65536);
+    }
+
+    BlockchainSeenCache::~BlockchainSeenCache(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainSeenCache::SetCapacity(uint32_t keys)
+    {
+        NS_LOG_FUNCTION(this);
+
+        uint32_t sets = 1;
+
+        while(sets * m_ways < keys)
+            sets <<= 1;
+
+        m_keys.assign(sets * m_ways, 0);
+        m_referenced.assign(sets, 0);
+        m_hands.assign(sets, 0);
+
+        /*
+         * Two counters per key keep the false positives of the filter around 1/3 when the cache is full
+         */
+        m_filter.assign(2 * sets * m_ways, 0);
+        m_setMask = sets - 1;
+        m_filterMask = 2 * sets * m_ways - 1;
+    }
+
+    uint32_t
+    BlockchainSeenCache::GetCapacity(void) const
+    {
+        return m_keys.size();
+    }
+
+    bool
+    BlockchainSeenCache::Contains(uint64_t key)
+    {
+        if(m_filter[GetFilterIndex(key)] == 0)
+        {
+            m_filterRejects++;
+            return false;
+        }
+
+        uint32_t    set = key & m_setMask;
+        uint64_t    *ways = &m_keys[set * m_ways];
+
+        for(int way = 0; way < m_ways; way++)
+        {
+            if(ways[way] == key)
+            {
+                m_referenced[set] |= 1 << way;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool
+    BlockchainSeenCache::Insert(uint64_t key)
+    {
+        if(Contains(key))
+        {
+            m_hits++;
+            return false;
+        }
+
+        uint32_t    set = key & m_setMask;
+        uint64_t    *ways = &m_keys[set * m_ways];
+        int         way = 0;
+
+        while(way < m_ways && ways[way] != 0)
+            way++;
+
+        if(way == m_ways)
+        {
+            /*
+             * CLOCK : the first key not seen again since the last pass of the hand is evicted
+             */
+            while(m_referenced[set] & (1 << m_hands[set]))
+            {
+                m_referenced[set] &= ~(1 << m_hands[set]);
+                m_hands[set] = (m_hands[set] + 1) % m_ways;
+            }
+
+            way = m_hands[set];
+            m_hands[set] = (m_hands[set] + 1) % m_ways;
+
+            uint8_t &counter = m_filter[GetFilterIndex(ways[way])];
+
+            if(counter < 255)
+                counter--;
+            m_evictions++;
+        }
+
+        ways[way] = key;
+        m_referenced[set] &= ~(1 << way);
+
+        uint8_t &counter = m_filter[GetFilterIndex(key)];
+
+        if(counter < 255)
+            counter++;
+
+        return true;
+    }
+
+    long
+    BlockchainSeenCache::GetHits(void) const
+    {
+        return m_hits;
+    }
+
+    long
+    BlockchainSeenCache::GetEvictions(void) const
+    {
+        return m_evictions;
+    }
+
+    long
+    BlockchainSeenCache::GetFilterRejects(void) const
+    {
+        return m_filterRejects;
+    }
+
+    void
+    BlockchainSeenCache::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::fill(m_keys.begin(), m_keys.end(), 0);
+        std::fill(m_referenced.begin(), m_referenced.end(), 0);
+        std::fill(m_hands.begin(), m_hands.end(), 0);
+        std::fill(m_filter.begin(), m_filter.end(), 0);
+    }
+
+    uint64_t
+    BlockchainSeenCache::MakeKey(int messageType, int nodeId, int transId, int execution)
+    {
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(nodeId)) << 32) | static_cast<uint32_t>(transId);
+
+        key = Mix(key ^ (static_cast<uint64_t>(messageType) << 59));
+        key = Mix(key ^ static_cast<uint32_t>(execution));
+
+        return key != 0 ? key : 1;
+    }
+
+    uint32_t
+    BlockchainSeenCache::GetFilterIndex(uint64_t key) const
+    {
+        return (key >> 32) & m_filterMask;
+    }
+
+}
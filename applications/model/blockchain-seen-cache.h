@@ -0,0 +1,72 @@
+#ifndef BLOCKCHAIN_SEEN_CACHE_H
+#define BLOCKCHAIN_SEEN_CACHE_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+    /*
+     * Fixed-capacity set of the flooded messages a node has already seen.
+     * The keys are 64-bit hashes of the messages, kept in 8-way sets of one cache line each.
+     * A full set evicts with CLOCK: the hand skips, and clears, the keys seen again since it
+     * last passed them. A counting filter in front of the sets answers most of the lookups of new
+     * messages without touching the sets. Lookups and insertions are O(1), and the memory does
+     * not grow with the number of messages.
+     */
+    class BlockchainSeenCache
+    {
+        public:
+            BlockchainSeenCache(void);
+            virtual ~BlockchainSeenCache(void);
+
+            /*
+             * Sets the number of keys the cache holds, rounded up to a power of two, and empties it
+             */
+            void SetCapacity(uint32_t keys);
+            uint32_t GetCapacity(void) const;
+
+            /*
+             * return true : if the key is in the cache
+             */
+            bool Contains(uint64_t key);
+
+            /*
+             * Adds a key, evicting another one if its set is full
+             * return false : if the key was already in the cache
+             */
+            bool Insert(uint64_t key);
+
+            long GetHits(void) const;
+            long GetEvictions(void) const;
+            long GetFilterRejects(void) const;
+
+            void Clear(void);
+
+            /*
+             * return the key of a transaction message
+             * param messageType : REQUEST_TRANS, REPLY_TRANS, MSG_TRANS or RESULT_TRANS
+             * param execution : the endorser of a REPLY_TRANS, 0 for the others
+             */
+            static uint64_t MakeKey(int messageType, int nodeId, int transId, int execution);
+
+            static const int m_ways = 8;
+
+        protected:
+
+            uint32_t GetFilterIndex(uint64_t key) const;
+
+            std::vector<uint64_t>   m_keys;             // m_ways keys per set, 0 for an empty way
+            std::vector<uint8_t>    m_referenced;       // the CLOCK bits of each set, one per way
+            std::vector<uint8_t>    m_hands;            // the CLOCK hand of each set
+            std::vector<uint8_t>    m_filter;           // saturating counters of the keys in the cache
+            uint32_t                m_setMask;
+            uint32_t                m_filterMask;
+            long                    m_hits;
+            long                    m_evictions;
+            long                    m_filterRejects;
+    };
+
+}
+
+#endif
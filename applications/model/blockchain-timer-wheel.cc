@@ -0,0 +1,281 @@
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "blockchain-timer-wheel.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainTimerWheel");
+
+    BlockchainTimerWheel::BlockchainTimerWheel(void) : m_tick(MilliSeconds(100)), m_currentTick(0), m_pendingTimers(0),
+                                                    m_armedTimers(0), m_firedTimers(0), m_cancelledTimers(0)
+    {
+        NS_LOG_FUNCTION(this);
+
+        for(int i = 0; i < m_levels * m_slots; i++)
+        {
+            m_slotHeads[i] = -1;
+        }
+    }
+
+    BlockchainTimerWheel::~BlockchainTimerWheel(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainTimerWheel::SetTickResolution(Time tick)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_ASSERT_MSG(m_pendingTimers == 0, "The tick resolution cannot change while timers are armed");
+        NS_ASSERT_MSG(tick.GetNanoSeconds() > 0, "The tick resolution must be positive");
+        m_tick = tick;
+    }
+
+    BlockchainTimerWheel::TimerId
+    BlockchainTimerWheel::Arm(Time delay, Callback<void, std::string> callback, const std::string &argument)
+    {
+        NS_LOG_FUNCTION(this);
+
+        int64_t tickNs = m_tick.GetNanoSeconds();
+        int64_t deadline = Simulator::Now().GetNanoSeconds() + std::max(delay.GetNanoSeconds(), static_cast<int64_t>(0));
+        uint64_t expiry = (deadline + tickNs - 1) / tickNs;
+        int index;
+
+        if(m_pendingTimers == 0 && !m_tickEvent.IsRunning())
+        {
+            /*
+             * The wheel is empty, so it can jump to the current time
+             */
+            m_currentTick = Simulator::Now().GetNanoSeconds() / tickNs;
+            m_tickEvent = Simulator::Schedule(NanoSeconds((m_currentTick + 1) * tickNs - Simulator::Now().GetNanoSeconds()),
+                                            &BlockchainTimerWheel::Tick, this);
+        }
+
+        if(m_freeTimers.empty())
+        {
+            Timer timer;
+            timer.generation = 1;
+            m_timers.push_back(timer);
+            index = m_timers.size() - 1;
+        }
+        else
+        {
+            index = m_freeTimers.back();
+            m_freeTimers.pop_back();
+        }
+
+        Timer &timer = m_timers[index];
+        timer.expiry = std::max(expiry, m_currentTick + 1);
+        timer.callback = callback;
+        timer.argument = argument;
+        Insert(index);
+
+        m_pendingTimers++;
+        m_armedTimers++;
+
+        return (static_cast<uint64_t>(timer.generation) << 32) | static_cast<uint32_t>(index);
+    }
+
+    bool
+    BlockchainTimerWheel::Cancel(TimerId id)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(!IsPending(id))
+            return false;
+
+        int index = static_cast<uint32_t>(id);
+
+        Unlink(index);
+        Release(index);
+        m_cancelledTimers++;
+
+        return true;
+    }
+
+    bool
+    BlockchainTimerWheel::IsPending(TimerId id) const
+    {
+        uint32_t index = static_cast<uint32_t>(id);
+        uint32_t generation = static_cast<uint32_t>(id >> 32);
+
+        return index < m_timers.size() && m_timers[index].generation == generation && m_timers[index].slot >= 0;
+    }
+
+    void
+    BlockchainTimerWheel::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        for(unsigned int i = 0; i < m_timers.size(); i++)
+        {
+            if(m_timers[i].slot >= 0)
+            {
+                Unlink(i);
+                Release(i);
+                m_cancelledTimers++;
+            }
+        }
+
+        Simulator::Cancel(m_tickEvent);
+    }
+
+    uint32_t
+    BlockchainTimerWheel::GetPendingTimers(void) const
+    {
+        return m_pendingTimers;
+    }
+
+    long
+    BlockchainTimerWheel::GetArmedTimers(void) const
+    {
+        return m_armedTimers;
+    }
+
+    long
+    BlockchainTimerWheel::GetFiredTimers(void) const
+    {
+        return m_firedTimers;
+    }
+
+    long
+    BlockchainTimerWheel::GetCancelledTimers(void) const
+    {
+        return m_cancelledTimers;
+    }
+
+    void
+    BlockchainTimerWheel::Insert(int index)
+    {
+        Timer       &timer = m_timers[index];
+        uint64_t    delta = timer.expiry - m_currentTick;
+        int         level = 0;
+
+        while(level < m_levels - 1 && delta >= (static_cast<uint64_t>(1) << (m_slotBits * (level + 1))))
+        {
+            level++;
+        }
+
+        uint64_t    position = timer.expiry;
+
+        if(delta >= (static_cast<uint64_t>(1) << (m_slotBits * m_levels)))
+        {
+            /*
+             * Beyond the range of the wheel: park it in the farthest slot, it will be cascaded again
+             */
+            position = m_currentTick + (static_cast<uint64_t>(1) << (m_slotBits * m_levels)) - 1;
+        }
+
+        int         slot = level * m_slots + static_cast<int>((position >> (m_slotBits * level)) & (m_slots - 1));
+
+        timer.slot = slot;
+        timer.prev = -1;
+        timer.next = m_slotHeads[slot];
+
+        if(m_slotHeads[slot] >= 0)
+        {
+            m_timers[m_slotHeads[slot]].prev = index;
+        }
+        m_slotHeads[slot] = index;
+    }
+
+    void
+    BlockchainTimerWheel::Unlink(int index)
+    {
+        Timer &timer = m_timers[index];
+
+        if(timer.prev >= 0)
+            m_timers[timer.prev].next = timer.next;
+        else
+            m_slotHeads[timer.slot] = timer.next;
+
+        if(timer.next >= 0)
+            m_timers[timer.next].prev = timer.prev;
+
+        timer.prev = -1;
+        timer.next = -1;
+        timer.slot = -1;
+    }
+
+    void
+    BlockchainTimerWheel::Release(int index)
+    {
+        Timer &timer = m_timers[index];
+
+        timer.generation++;
+        timer.callback = Callback<void, std::string>();
+        timer.argument.clear();
+        m_freeTimers.push_back(index);
+        m_pendingTimers--;
+    }
+
+    void
+    BlockchainTimerWheel::Tick(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        std::vector<int>    moved;
+        std::vector<TimerId> expired;
+
+        m_currentTick++;
+
+        /*
+         * Cascade the upper levels whose slot starts at this tick
+         */
+        for(int level = 1; level < m_levels; level++)
+        {
+            if((m_currentTick & ((static_cast<uint64_t>(1) << (m_slotBits * level)) - 1)) != 0)
+                break;
+
+            int slot = level * m_slots + static_cast<int>((m_currentTick >> (m_slotBits * level)) & (m_slots - 1));
+
+            moved.clear();
+            for(int index = m_slotHeads[slot]; index >= 0; index = m_timers[index].next)
+            {
+                moved.push_back(index);
+            }
+
+            for(auto it = moved.begin(); it != moved.end(); it++)
+            {
+                Unlink(*it);
+                Insert(*it);
+            }
+        }
+
+        int slot = static_cast<int>(m_currentTick & (m_slots - 1));
+
+        for(int index = m_slotHeads[slot]; index >= 0; index = m_timers[index].next)
+        {
+            if(m_timers[index].expiry <= m_currentTick)
+            {
+                expired.push_back((static_cast<uint64_t>(m_timers[index].generation) << 32) | static_cast<uint32_t>(index));
+            }
+        }
+
+        /*
+         * The callbacks may arm or cancel timers, so every timer is checked again before it fires
+         */
+        for(auto it = expired.begin(); it != expired.end(); it++)
+        {
+            if(!IsPending(*it))
+                continue;
+
+            int                             index = static_cast<uint32_t>(*it);
+            Callback<void, std::string>     callback = m_timers[index].callback;
+            std::string                     argument = m_timers[index].argument;
+
+            Unlink(index);
+            Release(index);
+            m_firedTimers++;
+
+            callback(argument);
+        }
+
+        if(m_pendingTimers > 0 && !m_tickEvent.IsRunning())
+        {
+            m_tickEvent = Simulator::Schedule(m_tick, &BlockchainTimerWheel::Tick, this);
+        }
+    }
+
+}
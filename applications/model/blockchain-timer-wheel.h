@@ -0,0 +1,108 @@
+#ifndef BLOCKCHAIN_TIMER_WHEEL_H
+#define BLOCKCHAIN_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+    /*
+     * Hierarchical timer wheel for the block request timeouts of a node.
+     * The timers live in 4 levels of 64 slots. Level l covers 64^(l+1) ticks, and every 64 ticks the
+     * next slot of the upper level is cascaded down. Arm and Cancel are O(1). The wheel keeps one
+     * simulator event per tick, and only while timers are pending.
+     * Timers fire on the first tick boundary at or after their deadline.
+     */
+    class BlockchainTimerWheel
+    {
+        public:
+            /*
+             * Identifies an armed timer: (generation << 32) | pool index. 0 is never a valid timer.
+             */
+            typedef uint64_t TimerId;
+
+            BlockchainTimerWheel(void);
+            virtual ~BlockchainTimerWheel(void);
+
+            /*
+             * Sets the tick duration, only allowed while no timer is armed
+             */
+            void SetTickResolution(Time tick);
+
+            /*
+             * Arms a timer
+             * param delay : the time until the timer fires
+             * param callback : the function called when the timer fires
+             * param argument : the argument given to the callback
+             * return the id of the timer
+             */
+            TimerId Arm(Time delay, Callback<void, std::string> callback, const std::string &argument);
+
+            /*
+             * Cancels a timer. Cancelling an expired or already cancelled timer does nothing.
+             * return true : if the timer was pending
+             */
+            bool Cancel(TimerId id);
+
+            bool IsPending(TimerId id) const;
+
+            /*
+             * Cancels every timer and the tick event
+             */
+            void Clear(void);
+
+            uint32_t GetPendingTimers(void) const;
+            long GetArmedTimers(void) const;
+            long GetFiredTimers(void) const;
+            long GetCancelledTimers(void) const;
+
+        protected:
+
+            static const int        m_levels = 4;
+            static const int        m_slotBits = 6;
+            static const int        m_slots = 1 << m_slotBits;
+
+            struct Timer
+            {
+                uint64_t                        expiry;         // the tick at which the timer fires
+                uint32_t                        generation;     // bumped every time the entry is released
+                int                             prev;           // intrusive list of the slot, -1 : none
+                int                             next;
+                int                             slot;           // level * m_slots + slot index, -1 : free
+                Callback<void, std::string>     callback;
+                std::string                     argument;
+            };
+
+            /*
+             * Links the timer into the slot matching its expiry relative to m_currentTick
+             */
+            void Insert(int index);
+
+            void Unlink(int index);
+
+            void Release(int index);
+
+            /*
+             * Advances the wheel by one tick, cascades the upper levels and fires the expired timers
+             */
+            void Tick(void);
+
+            std::vector<Timer>      m_timers;                       // timer pool
+            std::vector<int>        m_freeTimers;                   // free entries of m_timers
+            int                     m_slotHeads[m_levels * m_slots];
+            Time                    m_tick;
+            uint64_t                m_currentTick;
+            EventId                 m_tickEvent;
+            uint32_t                m_pendingTimers;
+            long                    m_armedTimers;
+            long                    m_firedTimers;
+            long                    m_cancelledTimers;
+    };
+
+}
+
+#endif
@@ -0,0 +1,310 @@
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+#include "blockchain-transfer-scheduler.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainTransferScheduler");
+
+    BlockchainTransferScheduler::BlockchainTransferScheduler(void) : m_policy(FIFO_SCHEDULER), m_linkRate(0), m_busy(false),
+                                                                    m_currentStartTime(0), m_nextSequence(0), m_queueDepth(0),
+                                                                    m_maxQueueDepth(0), m_queueDepthIntegral(0), m_busyTime(0),
+                                                                    m_totalTransfers(0)
+    {
+        NS_LOG_FUNCTION(this);
+        m_lastUpdateTime = Simulator::Now().GetSeconds();
+        m_creationTime = m_lastUpdateTime;
+    }
+
+    BlockchainTransferScheduler::~BlockchainTransferScheduler(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    enum TransferSchedulerPolicy
+    BlockchainTransferScheduler::GetPolicy(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_policy;
+    }
+
+    void
+    BlockchainTransferScheduler::SetPolicy(enum TransferSchedulerPolicy policy)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_ASSERT_MSG(m_queueDepth == 0, "The scheduling policy cannot change while transfers are queued");
+        m_policy = policy;
+    }
+
+    void
+    BlockchainTransferScheduler::SetLinkRate(double linkRate)
+    {
+        NS_LOG_FUNCTION(this);
+        m_linkRate = linkRate;
+    }
+
+    void
+    BlockchainTransferScheduler::SetStartCallback(Callback<void, std::string, Address&> startCallback)
+    {
+        NS_LOG_FUNCTION(this);
+        m_startCallback = startCallback;
+    }
+
+    void
+    BlockchainTransferScheduler::SetCompleteCallback(Callback<void, std::string, Address&> completeCallback)
+    {
+        NS_LOG_FUNCTION(this);
+        m_completeCallback = completeCallback;
+    }
+
+    void
+    BlockchainTransferScheduler::Enqueue(Ipv4Address peer, const Address &address, const std::string &packet, double sizeBytes, double peerRate)
+    {
+        NS_LOG_FUNCTION(this);
+
+        Transfer transfer;
+        transfer.peer = peer;
+        transfer.address = address;
+        transfer.packet = packet;
+        transfer.sizeBytes = sizeBytes;
+        transfer.peerRate = peerRate;
+        transfer.sequence = m_nextSequence++;
+
+        UpdateQueueDepth();
+
+        switch(m_policy)
+        {
+            case FIFO_SCHEDULER:
+            {
+                m_fifoQueue.push_back(transfer);
+                break;
+            }
+            case ROUND_ROBIN_SCHEDULER:
+            {
+                std::deque<Transfer> &peerQueue = m_peerQueues[peer];
+                if(peerQueue.empty())
+                {
+                    m_activePeers.push_back(peer);
+                }
+                peerQueue.push_back(transfer);
+                break;
+            }
+            case SMALLEST_FIRST_SCHEDULER:
+            {
+                m_sizeQueue.push(transfer);
+                break;
+            }
+        }
+
+        m_queueDepth++;
+        m_maxQueueDepth = std::max(m_maxQueueDepth, m_queueDepth);
+
+        NS_LOG_INFO("Enqueue: At time " << Simulator::Now().GetSeconds() << " a transfer of " << sizeBytes
+                    << " Bytes to/from " << peer << " was queued, queue depth = " << m_queueDepth);
+
+        if(!m_busy)
+        {
+            StartNextTransfer();
+        }
+    }
+
+    void
+    BlockchainTransferScheduler::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        UpdateQueueDepth();
+        if(m_busy)
+        {
+            m_busyTime += Simulator::Now().GetSeconds() - m_currentStartTime;
+        }
+
+        Simulator::Cancel(m_completionEvent);
+        m_fifoQueue.clear();
+        m_peerQueues.clear();
+        m_activePeers.clear();
+        m_sizeQueue = std::priority_queue<Transfer, std::vector<Transfer>, TransferCompare>();
+        m_queueDepth = 0;
+        m_busy = false;
+    }
+
+    bool
+    BlockchainTransferScheduler::IsBusy(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_busy;
+    }
+
+    uint32_t
+    BlockchainTransferScheduler::GetQueueDepth(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_queueDepth;
+    }
+
+    uint32_t
+    BlockchainTransferScheduler::GetMaxQueueDepth(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_maxQueueDepth;
+    }
+
+    double
+    BlockchainTransferScheduler::GetMeanQueueDepth(void) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+        double elapsed = now - m_creationTime;
+
+        if(elapsed <= 0)
+            return 0;
+
+        return (m_queueDepthIntegral + m_queueDepth * (now - m_lastUpdateTime)) / elapsed;
+    }
+
+    double
+    BlockchainTransferScheduler::GetUtilization(void) const
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+        double elapsed = now - m_creationTime;
+        double busyTime = m_busyTime;
+
+        if(elapsed <= 0)
+            return 0;
+
+        if(m_busy)
+            busyTime += now - m_currentStartTime;
+
+        return busyTime / elapsed;
+    }
+
+    long
+    BlockchainTransferScheduler::GetTotalTransfers(void) const
+    {
+        NS_LOG_FUNCTION(this);
+        return m_totalTransfers;
+    }
+
+    void
+    BlockchainTransferScheduler::StartNextTransfer(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        UpdateQueueDepth();
+
+        if(!PopNextTransfer(m_current))
+        {
+            m_busy = false;
+            return;
+        }
+
+        m_queueDepth--;
+        m_busy = true;
+        m_currentStartTime = Simulator::Now().GetSeconds();
+
+        double rate = m_linkRate;
+        if(m_current.peerRate > 0 && (rate <= 0 || m_current.peerRate < rate))
+        {
+            rate = m_current.peerRate;
+        }
+
+        double transferTime = rate > 0 ? m_current.sizeBytes / rate : 0;
+
+        NS_LOG_INFO("StartNextTransfer: At time " << m_currentStartTime << " the transfer of " << m_current.sizeBytes
+                    << " Bytes to/from " << m_current.peer << " got the link for " << transferTime << "s");
+
+        m_completionEvent = Simulator::Schedule(Seconds(transferTime), &BlockchainTransferScheduler::CompleteTransfer, this);
+
+        if(!m_startCallback.IsNull())
+        {
+            m_startCallback(m_current.packet, m_current.address);
+        }
+    }
+
+    void
+    BlockchainTransferScheduler::CompleteTransfer(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_busyTime += Simulator::Now().GetSeconds() - m_currentStartTime;
+        m_totalTransfers++;
+        m_busy = false;
+
+        /*
+         * The completed transfer is copied out before the callback, which may enqueue new transfers
+         */
+        Transfer completed = m_current;
+
+        if(!m_completeCallback.IsNull())
+        {
+            m_completeCallback(completed.packet, completed.address);
+        }
+
+        if(!m_busy)
+        {
+            StartNextTransfer();
+        }
+    }
+
+    bool
+    BlockchainTransferScheduler::PopNextTransfer(Transfer &transfer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        switch(m_policy)
+        {
+            case FIFO_SCHEDULER:
+            {
+                if(m_fifoQueue.empty())
+                    return false;
+
+                transfer = m_fifoQueue.front();
+                m_fifoQueue.pop_front();
+                return true;
+            }
+            case ROUND_ROBIN_SCHEDULER:
+            {
+                if(m_activePeers.empty())
+                    return false;
+
+                Ipv4Address peer = m_activePeers.front();
+                std::deque<Transfer> &peerQueue = m_peerQueues[peer];
+
+                m_activePeers.pop_front();
+                transfer = peerQueue.front();
+                peerQueue.pop_front();
+
+                if(!peerQueue.empty())
+                {
+                    m_activePeers.push_back(peer);
+                }
+                return true;
+            }
+            case SMALLEST_FIRST_SCHEDULER:
+            {
+                if(m_sizeQueue.empty())
+                    return false;
+
+                transfer = m_sizeQueue.top();
+                m_sizeQueue.pop();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void
+    BlockchainTransferScheduler::UpdateQueueDepth(void)
+    {
+        double now = Simulator::Now().GetSeconds();
+
+        m_queueDepthIntegral += m_queueDepth * (now - m_lastUpdateTime);
+        m_lastUpdateTime = now;
+    }
+
+}
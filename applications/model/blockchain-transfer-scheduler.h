@@ -0,0 +1,148 @@
+#ifndef BLOCKCHAIN_TRANSFER_SCHEDULER_H
+#define BLOCKCHAIN_TRANSFER_SCHEDULER_H
+
+#include <deque>
+#include <map>
+#include <queue>
+#include <string>
+#include <vector>
+#include "ns3/address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/event-id.h"
+#include "ns3/callback.h"
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * Serializes the block transfers of one direction (upload or download) of a node's link.
+     * Only one transfer occupies the link at a time. The next one is picked according to the
+     * scheduling policy, and every transfer costs exactly one completion event.
+     */
+    class BlockchainTransferScheduler
+    {
+        public:
+            BlockchainTransferScheduler(void);
+            virtual ~BlockchainTransferScheduler(void);
+
+            enum TransferSchedulerPolicy GetPolicy(void) const;
+            void SetPolicy(enum TransferSchedulerPolicy policy);
+
+            /*
+             * Sets the capacity of the link in Bytes/s
+             */
+            void SetLinkRate(double linkRate);
+
+            /*
+             * Called when a transfer gets the link, e.g. to put the message on the socket
+             */
+            void SetStartCallback(Callback<void, std::string, Address&> startCallback);
+
+            /*
+             * Called when the last byte of a transfer has crossed the link
+             */
+            void SetCompleteCallback(Callback<void, std::string, Address&> completeCallback);
+
+            /*
+             * Queues a new transfer and starts it immediately if the link is idle
+             * param peer : the peer on the other end of the link, used for per-peer fairness
+             * param address : the address handed to the callbacks
+             * param packet : the message carried by the transfer
+             * param sizeBytes : the size of the transfer in bytes
+             * param peerRate : the rate limit of the other end in Bytes/s (0 : no limit)
+             */
+            void Enqueue(Ipv4Address peer, const Address &address, const std::string &packet, double sizeBytes, double peerRate);
+
+            /*
+             * Drops every queued transfer and cancels the pending completion event
+             */
+            void Clear(void);
+
+            bool IsBusy(void) const;
+
+            /*
+             * The number of transfers waiting for the link (the active one is not included)
+             */
+            uint32_t GetQueueDepth(void) const;
+
+            uint32_t GetMaxQueueDepth(void) const;
+
+            /*
+             * Time-weighted average of the queue depth since the scheduler was created
+             */
+            double GetMeanQueueDepth(void) const;
+
+            /*
+             * Fraction of time the link has been busy since the scheduler was created
+             */
+            double GetUtilization(void) const;
+
+            long GetTotalTransfers(void) const;
+
+        protected:
+
+            struct Transfer
+            {
+                Ipv4Address     peer;
+                Address         address;
+                std::string     packet;
+                double          sizeBytes;
+                double          peerRate;
+                uint64_t        sequence;
+            };
+
+            /*
+             * Orders the SMALLEST_FIRST heap, ties are broken by arrival order
+             */
+            struct TransferCompare
+            {
+                bool operator()(const Transfer &t1, const Transfer &t2) const
+                {
+                    if(t1.sizeBytes != t2.sizeBytes)
+                        return t1.sizeBytes > t2.sizeBytes;
+                    return t1.sequence > t2.sequence;
+                }
+            };
+
+            void StartNextTransfer(void);
+
+            void CompleteTransfer(void);
+
+            /*
+             * Removes the next transfer according to the policy
+             * return false : if there is nothing queued
+             */
+            bool PopNextTransfer(Transfer &transfer);
+
+            /*
+             * Accumulates the queue depth integral up to the current time
+             */
+            void UpdateQueueDepth(void);
+
+            enum TransferSchedulerPolicy                            m_policy;
+            double                                                  m_linkRate;             // Bytes/s
+            Callback<void, std::string, Address&>                   m_startCallback;
+            Callback<void, std::string, Address&>                   m_completeCallback;
+
+            std::deque<Transfer>                                    m_fifoQueue;            // FIFO_SCHEDULER
+            std::map<Ipv4Address, std::deque<Transfer>>             m_peerQueues;           // ROUND_ROBIN_SCHEDULER
+            std::deque<Ipv4Address>                                 m_activePeers;          // peers with queued transfers, in service order
+            std::priority_queue<Transfer, std::vector<Transfer>, TransferCompare>    m_sizeQueue;    // SMALLEST_FIRST_SCHEDULER
+
+            bool            m_busy;
+            Transfer        m_current;                  // the transfer occupying the link
+            double          m_currentStartTime;
+            EventId         m_completionEvent;
+            uint64_t        m_nextSequence;
+            uint32_t        m_queueDepth;
+            uint32_t        m_maxQueueDepth;
+            double          m_queueDepthIntegral;
+            double          m_lastUpdateTime;
+            double          m_creationTime;
+            double          m_busyTime;
+            long            m_totalTransfers;
+    };
+
+}
+
+#endif
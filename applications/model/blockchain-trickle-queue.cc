@@ -0,0 +1,197 @@
+#include <math.h>
+#include <stdlib.h>
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "blockchain-trickle-queue.h"
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainTrickleQueue");
+
+    const double BlockchainTrickleQueue::m_intervalBinSeconds = 0.01;
+
+    BlockchainTrickleQueue::BlockchainTrickleQueue(void) : m_meanInterval(0), m_flushes(0), m_messages(0), m_items(0),
+                                                        m_intervalSamples(0), m_intervalSum(0)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainTrickleQueue::~BlockchainTrickleQueue(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainTrickleQueue::SetMeanInterval(double seconds)
+    {
+        NS_LOG_FUNCTION(this);
+        m_meanInterval = seconds;
+    }
+
+    double
+    BlockchainTrickleQueue::GetMeanInterval(void) const
+    {
+        return m_meanInterval;
+    }
+
+    double
+    BlockchainTrickleQueue::GetNextDelay(void) const
+    {
+        double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+        return -m_meanInterval * log(u);
+    }
+
+    bool
+    BlockchainTrickleQueue::AddBlock(Ipv4Address peer, const std::string &blockHash)
+    {
+        NS_LOG_FUNCTION(this);
+
+        PendingAnnouncements    &pending = m_pending[peer];
+        bool                    wasEmpty = pending.blocks.empty() && pending.transactions.empty();
+
+        if(std::find(pending.blocks.begin(), pending.blocks.end(), blockHash) == pending.blocks.end())
+            pending.blocks.push_back(blockHash);
+
+        return wasEmpty;
+    }
+
+    bool
+    BlockchainTrickleQueue::AddTransaction(Ipv4Address peer, int messageType, const Transaction &transaction, int ttl)
+    {
+        NS_LOG_FUNCTION(this);
+
+        PendingAnnouncements    &pending = m_pending[peer];
+        bool                    wasEmpty = pending.blocks.empty() && pending.transactions.empty();
+
+        pending.transactions[messageType].push_back(transaction);
+        pending.ttls[messageType].push_back(ttl);
+
+        return wasEmpty;
+    }
+
+    PendingAnnouncements
+    BlockchainTrickleQueue::Take(Ipv4Address peer)
+    {
+        NS_LOG_FUNCTION(this);
+
+        PendingAnnouncements pending;
+
+        auto it = m_pending.find(peer);
+
+        if(it != m_pending.end())
+        {
+            pending = it->second;
+            m_pending.erase(it);
+        }
+
+        return pending;
+    }
+
+    void
+    BlockchainTrickleQueue::RecordFlush(Ipv4Address peer, int items, int messages)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double now = Simulator::Now().GetSeconds();
+
+        m_flushes++;
+        m_messages += messages;
+        m_items += items;
+        m_batchSizes[items]++;
+
+        auto it = m_lastFlush.find(peer);
+
+        if(it != m_lastFlush.end())
+        {
+            m_intervals[static_cast<long>((now - it->second) / m_intervalBinSeconds)]++;
+            m_intervalSum += now - it->second;
+            m_intervalSamples++;
+        }
+        m_lastFlush[peer] = now;
+    }
+
+    long
+    BlockchainTrickleQueue::GetFlushes(void) const
+    {
+        return m_flushes;
+    }
+
+    long
+    BlockchainTrickleQueue::GetMessages(void) const
+    {
+        return m_messages;
+    }
+
+    long
+    BlockchainTrickleQueue::GetItems(void) const
+    {
+        return m_items;
+    }
+
+    double
+    BlockchainTrickleQueue::GetMeanBatchSize(void) const
+    {
+        return m_flushes > 0 ? static_cast<double>(m_items) / m_flushes : 0;
+    }
+
+    double
+    BlockchainTrickleQueue::GetMeanFlushInterval(void) const
+    {
+        return m_intervalSamples > 0 ? m_intervalSum / m_intervalSamples : 0;
+    }
+
+    int
+    BlockchainTrickleQueue::GetBatchSizePercentile(double p) const
+    {
+        long seen = 0;
+
+        for(auto it = m_batchSizes.begin(); it != m_batchSizes.end(); it++)
+        {
+            seen += it->second;
+            if(seen >= p * m_flushes)
+                return it->first;
+        }
+
+        return 0;
+    }
+
+    double
+    BlockchainTrickleQueue::GetIntervalPercentile(double p) const
+    {
+        long seen = 0;
+
+        for(auto it = m_intervals.begin(); it != m_intervals.end(); it++)
+        {
+            seen += it->second;
+            if(seen >= p * m_intervalSamples)
+                return (it->first + 1) * m_intervalBinSeconds;
+        }
+
+        return 0;
+    }
+
+    std::string
+    BlockchainTrickleQueue::GetBatchSizeHistogram(void) const
+    {
+        std::ostringstream stringStream;
+
+        for(auto it = m_batchSizes.begin(); it != m_batchSizes.end(); it++)
+        {
+            stringStream << (it == m_batchSizes.begin() ? "" : " ") << it->first << ":" << it->second;
+        }
+
+        return stringStream.str();
+    }
+
+    void
+    BlockchainTrickleQueue::Clear(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_pending.clear();
+        m_lastFlush.clear();
+    }
+
+}
@@ -0,0 +1,102 @@
+#ifndef BLOCKCHAIN_TRICKLE_QUEUE_H
+#define BLOCKCHAIN_TRICKLE_QUEUE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/ipv4-address.h"
+#include "blockchain.h"
+
+namespace ns3 {
+
+    /*
+     * The announcements waiting for the next trickle of a peer
+     */
+    struct PendingAnnouncements
+    {
+        std::vector<std::string>                    blocks;             // the block hashes of the next INV
+        std::map<int, std::vector<Transaction>>     transactions;       // the transactions by message type
+        std::map<int, std::vector<int>>             ttls;               // the hops left to each of them, -1 if unlimited
+    };
+
+    /*
+     * Per-peer announcement queues flushed on Poisson timers, as the INV trickling of Bitcoin Core.
+     * Everything queued for a peer between two of its timers leaves in one INV and one message per
+     * transaction message type. The queue records the distributions of the batch sizes and of the
+     * intervals between two flushes to the same peer.
+     */
+    class BlockchainTrickleQueue
+    {
+        public:
+            BlockchainTrickleQueue(void);
+            virtual ~BlockchainTrickleQueue(void);
+
+            /*
+             * param seconds : the mean time between two flushes to a peer
+             */
+            void SetMeanInterval(double seconds);
+            double GetMeanInterval(void) const;
+
+            /*
+             * return an exponentially distributed delay until the next flush
+             */
+            double GetNextDelay(void) const;
+
+            /*
+             * Queues an announcement
+             * return true : if the queue of the peer was empty, a flush must then be scheduled
+             */
+            bool AddBlock(Ipv4Address peer, const std::string &blockHash);
+            bool AddTransaction(Ipv4Address peer, int messageType, const Transaction &transaction, int ttl);
+
+            /*
+             * Empties the queue of a peer
+             */
+            PendingAnnouncements Take(Ipv4Address peer);
+
+            /*
+             * Records a flush to a peer
+             * param items : the announcements it carried
+             * param messages : the messages it took
+             */
+            void RecordFlush(Ipv4Address peer, int items, int messages);
+
+            long GetFlushes(void) const;
+            long GetMessages(void) const;
+            long GetItems(void) const;
+
+            double GetMeanBatchSize(void) const;
+            double GetMeanFlushInterval(void) const;
+
+            /*
+             * return the smallest batch size (or interval, with a 10ms resolution) above the fraction p of the flushes
+             */
+            int GetBatchSizePercentile(double p) const;
+            double GetIntervalPercentile(double p) const;
+
+            /*
+             * return the batch size histogram as "size:flushes ..."
+             */
+            std::string GetBatchSizeHistogram(void) const;
+
+            void Clear(void);
+
+        protected:
+
+            static const double m_intervalBinSeconds;
+
+            double                                      m_meanInterval;
+            std::map<Ipv4Address, PendingAnnouncements> m_pending;
+            std::map<Ipv4Address, double>               m_lastFlush;        // the time of the last flush to each peer
+            std::map<int, long>                         m_batchSizes;       // batch size -> flushes
+            std::map<long, long>                        m_intervals;        // interval in bins of m_intervalBinSeconds -> flushes
+            long                                        m_flushes;
+            long                                        m_messages;
+            long                                        m_items;
+            long                                        m_intervalSamples;
+            double                                      m_intervalSum;
+    };
+
+}
+
+#endif
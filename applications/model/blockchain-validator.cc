@@ -0,0 +1,349 @@
+#include "ns3/address.h"
+#include "ns3/log.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/node.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/blockchain-validator.h"
+#include <algorithm>
+
+namespace ns3 {
+
+    NS_LOG_COMPONENT_DEFINE("BlockchainValidator");
+    NS_OBJECT_ENSURE_REGISTERED(BlockchainValidator);
+
+    TypeId
+    BlockchainValidator::GetTypeId(void)
+    {
+        static TypeId tid = TypeId("ns3::BlockchainValidator")
+            .SetParent<BlockchainMiner>()
+            .SetGroupName("Application")
+            .AddAttribute("ValidatorId",
+                            "The index of the validator among the NumberOfMiners validators",
+                            UintegerValue(0),
+                            MakeUintegerAccessor(&BlockchainValidator::m_validatorId),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ViewChangeTimeout",
+                            "The base timeout of a view change or an election (in seconds)",
+                            DoubleValue(2),
+                            MakeDoubleAccessor(&BlockchainValidator::m_viewChangeTimeout),
+                            MakeDoubleChecker<double>())
+            .AddAttribute("SignatureSize",
+                            "The size of a signature of the consensus messages (in Bytes)",
+                            UintegerValue(64),
+                            MakeUintegerAccessor(&BlockchainValidator::m_signatureSize),
+                            MakeUintegerChecker<uint32_t>())
+            .AddAttribute("CrashTime",
+                            "The time the validator stops taking part in the consensus (in seconds, negative : never)",
+                            DoubleValue(-1),
+                            MakeDoubleAccessor(&BlockchainValidator::m_crashTime),
+                            MakeDoubleChecker<double>())
+        ;
+        return tid;
+    }
+
+    BlockchainValidator::BlockchainValidator() : BlockchainMiner(), m_crashed(false), m_lastProposalTime(0), m_committedBlocks(0),
+                                                 m_meanCommitLatency(0), m_viewChanges(0), m_digestSizeBytes(32), m_consensusFieldBytes(8)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    BlockchainValidator::~BlockchainValidator(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainValidator::StartApplication()
+    {
+        NS_LOG_FUNCTION(this);
+
+        /*
+         * The blocks come from the consensus, neither from the mining oracle nor from a mining timer
+         */
+        BlockchainNode::StartApplication();
+
+        if(m_validatorId >= m_noMiners)
+            NS_FATAL_ERROR("Validator " << m_validatorId << " is not one of the " << m_noMiners << " validators");
+
+        if(static_cast<int>(m_peersAddresses.size()) < m_noMiners - 1)
+            NS_FATAL_ERROR("Validator " << m_validatorId << " is connected to " << m_peersAddresses.size()
+                            << " peers, it needs the " << m_noMiners - 1 << " other validators");
+
+        m_validators.assign(m_peersAddresses.begin(), m_peersAddresses.begin() + m_noMiners - 1);
+
+        m_nodeStats->hashRate = 0;
+        m_nodeStats->miner = 1;
+        m_nodeStats->miningStrategy = HONEST_MINING;
+
+        m_miningStrategy.Reset(*m_blockchain.GetCurrentTopBlock());
+        m_previousBlockGenerationTime = Simulator::Now().GetSeconds();
+        m_lastProposalTime = Simulator::Now().GetSeconds() - GetBlockInterval();
+
+        if(m_crashTime >= 0)
+            m_crashEvent = Simulator::Schedule(Seconds(m_crashTime), &BlockchainValidator::Crash, this);
+
+        NS_LOG_WARN("Validator " << m_validatorId << " (node " << GetNode()->GetId() << ") among " << m_noMiners
+                    << " validators, block interval = " << GetBlockInterval() << "s");
+
+        StartConsensus();
+    }
+
+    void
+    BlockchainValidator::StopApplication()
+    {
+        NS_LOG_FUNCTION(this);
+
+        BlockchainNode::StopApplication();
+        Simulator::Cancel(m_nextMiningEvent);
+        Simulator::Cancel(m_crashEvent);
+        StopConsensus();
+
+        NS_LOG_WARN("Validator " << m_validatorId << " (node " << GetNode()->GetId() << ") proposed " << m_minerGeneratedBlocks
+                    << " blocks, committed " << m_committedBlocks << " blocks with mean commit latency = " << m_meanCommitLatency
+                    << "s, view changes = " << m_viewChanges << ", consensus messages sent = " << m_nodeStats->consensusMessagesSent
+                    << " (" << m_nodeStats->consensusSentBytes << " Bytes), signatures verified = " << m_nodeStats->consensusSignaturesVerified
+                    << (m_crashed ? ", crashed" : ""));
+
+        m_nodeStats->minerGeneratedBlocks = m_minerGeneratedBlocks;
+        m_nodeStats->minerAverageBlockGenInterval = m_minerAverageBlockGenInterval;
+        m_nodeStats->minerAverageBlockSize = m_minerAverageBlockSize;
+        m_nodeStats->meanNumberofTransactions = m_meanNumberofTransactions;
+        m_nodeStats->meanBlockFill = m_meanBlockFill;
+        m_nodeStats->minedBlocksInMainChain = m_blockchain.GetMinedBlocksInMainChain(GetNode()->GetId());
+        m_nodeStats->consensusCommittedBlocks = m_committedBlocks;
+        m_nodeStats->meanCommitLatency = m_meanCommitLatency;
+        m_nodeStats->viewChanges = m_viewChanges;
+    }
+
+    void
+    BlockchainValidator::ScheduleNextMiningEvent(void)
+    {
+        NS_LOG_FUNCTION(this);
+    }
+
+    void
+    BlockchainValidator::ScheduleProposal(void)
+    {
+        NS_LOG_FUNCTION(this);
+
+        double delay = std::max(0.0, m_lastProposalTime + GetBlockInterval() - Simulator::Now().GetSeconds());
+
+        Simulator::Cancel(m_nextMiningEvent);
+        m_nextMiningEvent = Simulator::Schedule(Seconds(delay), &BlockchainValidator::MineBlock, this);
+    }
+
+    void
+    BlockchainValidator::PublishBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+
+        m_lastProposalTime = Simulator::Now().GetSeconds();
+
+        if(m_crashed)
+            return;
+
+        NS_LOG_INFO("PublishBlock : validator " << m_validatorId << " proposes the block " << GetBlockHash(newBlock));
+        Propose(newBlock);
+    }
+
+    void
+    BlockchainValidator::ReceivedHigherBlock(const Block &newBlock)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_INFO("ReceivedHigherBlock : validator " << m_validatorId << " committed the block " << GetBlockHash(newBlock));
+
+        if(m_crashed)
+            return;
+
+        /*
+         * The block is copied first, the engine may add blocks to the blockchain
+         */
+        Block newTip = newBlock;
+        double latency = Simulator::Now().GetSeconds() - newTip.GetTimeStamp();
+
+        m_meanCommitLatency = (m_meanCommitLatency*m_committedBlocks + latency)/(m_committedBlocks + 1);
+        m_committedBlocks++;
+
+        Committed(newTip);
+    }
+
+    void
+    BlockchainValidator::Crash(void)
+    {
+        NS_LOG_FUNCTION(this);
+        NS_LOG_WARN("At time " << Simulator::Now().GetSeconds() << " s validator " << m_validatorId << " crashed");
+
+        m_crashed = true;
+        Simulator::Cancel(m_nextMiningEvent);
+        StopConsensus();
+    }
+
+    void
+    BlockchainValidator::SetConsensusMessage(rapidjson::Document &d, enum Messages message, int sizeBytes, int signatures)
+    {
+        rapidjson::Value value;
+
+        d.SetObject();
+
+        value = message;
+        d.AddMember("message", value, d.GetAllocator());
+
+        value = m_validatorId;
+        d.AddMember("replica", value, d.GetAllocator());
+
+        value = sizeBytes;
+        d.AddMember("size", value, d.GetAllocator());
+
+        if(signatures > 0)
+        {
+            value = signatures;
+            d.AddMember("signatures", value, d.GetAllocator());
+        }
+    }
+
+    void
+    BlockchainValidator::AddProposedBlock(rapidjson::Document &d, const Block &block)
+    {
+        rapidjson::Value                    value;
+        rapidjson::Value                    array(rapidjson::kArrayType);
+        rapidjson::Value                    tranArray(rapidjson::kArrayType);
+        std::vector<Transaction>            transactions = block.GetTransactions();
+
+        AddBlockHeader(d, array, block);
+
+        for(auto trans_it = transactions.begin(); trans_it < transactions.end(); trans_it++)
+        {
+            rapidjson::Value transInfo(rapidjson::kObjectType);
+
+            value = trans_it->GetTransNodeId();
+            transInfo.AddMember("nodeId", value, d.GetAllocator());
+
+            value = trans_it->GetTransId();
+            transInfo.AddMember("transId", value, d.GetAllocator());
+
+            value = trans_it->GetTransTimeStamp();
+            transInfo.AddMember("timestamp", value, d.GetAllocator());
+
+            value = trans_it->GetTransSizeByte();
+            transInfo.AddMember("size", value, d.GetAllocator());
+
+            tranArray.PushBack(transInfo, d.GetAllocator());
+        }
+
+        array[0].AddMember("transactions", tranArray, d.GetAllocator());
+        d.AddMember("blocks", array, d.GetAllocator());
+    }
+
+    Block
+    BlockchainValidator::ReadProposedBlock(rapidjson::Document &d, Address &from)
+    {
+        const rapidjson::Value      &blockInfo = d["blocks"][0];
+        std::vector<Transaction>    transactions;
+
+        Block block(blockInfo["height"].GetInt(), blockInfo["minerId"].GetInt(), blockInfo["nonce"].GetInt(),
+                    blockInfo["parentBlockMinerId"].GetInt(), blockInfo["size"].GetInt(), blockInfo["timeStamp"].GetDouble(),
+                    Simulator::Now().GetSeconds(), InetSocketAddress::ConvertFrom(from).GetIpv4());
+        ReadHeaderExtensions(blockInfo, block);
+
+        for(unsigned int i = 0; i < blockInfo["transactions"].Size(); i++)
+        {
+            Transaction newTrans(blockInfo["transactions"][i]["nodeId"].GetInt(), blockInfo["transactions"][i]["transId"].GetInt(),
+                                blockInfo["transactions"][i]["timestamp"].GetDouble());
+
+            newTrans.SetTransSizeByte(blockInfo["transactions"][i]["size"].GetInt());
+            transactions.push_back(newTrans);
+        }
+        block.SetTransactions(transactions);
+
+        return block;
+    }
+
+    void
+    BlockchainValidator::SendConsensusMessage(rapidjson::Document &d, Address &to)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(d.HasMember("blocks"))
+        {
+            rapidjson::StringBuffer packetInfo;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(packetInfo);
+            d.Accept(writer);
+
+            m_nodeStats->consensusMessagesSent++;
+            m_nodeStats->consensusSentBytes += d["size"].GetInt();
+            m_uploadScheduler.Enqueue(InetSocketAddress::ConvertFrom(to).GetIpv4(), to, packetInfo.GetString(), d["size"].GetInt(), 0);
+        }
+        else
+        {
+            enum Messages message = static_cast<enum Messages>(d["message"].GetInt());
+
+            SendMessage(NO_MESSAGE, message, d, to);
+        }
+    }
+
+    void
+    BlockchainValidator::BroadcastConsensusMessage(rapidjson::Document &d)
+    {
+        NS_LOG_FUNCTION(this);
+
+        for(auto it = m_validators.begin(); it != m_validators.end(); it++)
+        {
+            Address to = InetSocketAddress(*it, m_blockchainPort);
+
+            SendConsensusMessage(d, to);
+        }
+    }
+
+    double
+    BlockchainValidator::ReserveBlockValidation(const Block &block)
+    {
+        return m_cpuModel.Reserve(m_cpuModel.GetBlockValidationCost(block.GetBlockSizeBytes(), block.GetTransactions().size()));
+    }
+
+    void
+    BlockchainValidator::CommitBlock(const Block &block)
+    {
+        NS_LOG_FUNCTION(this);
+
+        if(m_blockchain.HasBlock(block))
+            return;
+
+        if(m_blockchain.GetParent(block) == nullptr)
+        {
+            NS_LOG_INFO("CommitBlock : the parent of the block " << GetBlockHash(block) << " is missing");
+
+            if(!m_blockchain.IsOrphan(block))
+                m_blockchain.AddOrphan(block);
+
+            return;
+        }
+
+        ValidateTransaction(block);
+        AfterBlockValidation(block);
+    }
+
+    std::string
+    BlockchainValidator::GetBlockHash(const Block &block) const
+    {
+        std::ostringstream stringStream;
+
+        stringStream << block.GetBlockHeight() << "/" << block.GetMinerId();
+        return stringStream.str();
+    }
+
+    int
+    BlockchainValidator::GetVoteSize(void) const
+    {
+        return m_blockchainMessageHeader + 2*m_consensusFieldBytes + m_digestSizeBytes + m_countBytes + m_signatureSize;
+    }
+
+    double
+    BlockchainValidator::GetBlockInterval(void) const
+    {
+        return m_fixedBlockTimeGeneration > 0 ? m_fixedBlockTimeGeneration : m_averageBlockGenIntervalSeconds;
+    }
+
+}
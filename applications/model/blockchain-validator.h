@@ -0,0 +1,122 @@
+#ifndef BLOCKCHAIN_VALIDATOR_H
+#define BLOCKCHAIN_VALIDATOR_H
+
+#include "blockchain-miner.h"
+#include "../../rapidjson/document.h"
+#include "../../rapidjson/writer.h"
+#include "../../rapidjson/stringbuffer.h"
+
+
+namespace ns3 {
+
+    /*
+     * A miner whose blocks are ordered by a consensus among the NumberOfMiners miners instead of proof of work.
+     * The validators are the miners of BlockchainTopologyHelper, which are fully meshed and listed first among the
+     * peers, so the other validators are the first NumberOfMiners-1 peers. The blocks are built by MineBlock every
+     * AverageBlockGenIntervalSeconds at most, proposed by the engine, and once committed they go through
+     * AfterBlockValidation like the blocks of the peers, which announces them to the nodes.
+     * The consensus messages are sized, and their signatures verified on the CPU of the receiver.
+     */
+    class BlockchainValidator : public BlockchainMiner
+    {
+        public:
+
+            static TypeId GetTypeId(void);
+            BlockchainValidator();
+
+            virtual ~BlockchainValidator(void);
+
+        protected:
+
+            virtual void StartApplication(void);
+            virtual void StopApplication(void);
+
+            /*
+             * The engine schedules the blocks with ScheduleProposal
+             */
+            virtual void ScheduleNextMiningEvent(void);
+
+            /*
+             * Proposes a block built by MineBlock instead of announcing it
+             */
+            virtual void PublishBlock(const Block &newBlock);
+
+            /*
+             * The tip moved, by a commit of the engine or a block committed by the others
+             */
+            virtual void ReceivedHigherBlock(const Block &newBlock);
+
+            /*
+             * The engine interface
+             */
+            virtual void StartConsensus(void) = 0;
+            virtual void StopConsensus(void) = 0;
+            virtual void Propose(const Block &newBlock) = 0;
+            virtual void Committed(const Block &newTip) = 0;
+
+            /*
+             * Builds the next block at the end of the block interval of the previous proposal
+             */
+            void ScheduleProposal(void);
+
+            /*
+             * The validator stops taking part in the consensus, it keeps relaying the blocks
+             */
+            void Crash(void);
+
+            /*
+             * Fills the fields every consensus message carries
+             * param sizeBytes : the size of the message on the wire
+             * param signatures : the signatures the receiver verifies
+             */
+            void SetConsensusMessage(rapidjson::Document &d, enum Messages message, int sizeBytes, int signatures);
+
+            /*
+             * Adds the block, with its transactions, to a consensus message
+             */
+            void AddProposedBlock(rapidjson::Document &d, const Block &block);
+            Block ReadProposedBlock(rapidjson::Document &d, Address &from);
+
+            /*
+             * The messages carrying a block wait for the upload link like the other block messages
+             */
+            void SendConsensusMessage(rapidjson::Document &d, Address &to);
+            void BroadcastConsensusMessage(rapidjson::Document &d);
+
+            /*
+             * return the time to validate a proposed block on the CPU of the validator
+             */
+            double ReserveBlockValidation(const Block &block);
+
+            /*
+             * Adds a committed block to the blockchain, the blocks of a missing parent wait for it as orphans
+             */
+            void CommitBlock(const Block &block);
+
+            std::string GetBlockHash(const Block &block) const;
+
+            /*
+             * return the size of a vote : view or term, sequence number, block digest, replica and signature
+             */
+            int GetVoteSize(void) const;
+
+            double GetBlockInterval(void) const;
+
+            int                         m_validatorId;              // the index of the validator, 0..NumberOfMiners-1
+            double                      m_viewChangeTimeout;        // the base timeout of a view change or an election, in seconds
+            int                         m_signatureSize;            // in Bytes
+            double                      m_crashTime;                // the time the validator crashes, never if negative
+            bool                        m_crashed;
+            EventId                     m_crashEvent;
+            std::vector<Ipv4Address>    m_validators;               // the other validators
+            double                      m_lastProposalTime;
+            int                         m_committedBlocks;
+            double                      m_meanCommitLatency;        // mean time from the proposal of a block to its commit
+            int                         m_viewChanges;              // the view changes or elections
+            const int                   m_digestSizeBytes;          // 32 Bytes
+            const int                   m_consensusFieldBytes;      // the view, term or sequence fields, 8 Bytes
+    };
+
+}
+
+#endif
@@ -1,3 +1,4 @@
+#include <sstream>
 #include "ns3/application.h"
 #include "ns3/event-id.h"
 #include "ns3/ptr.h"
@@ -22,11 +23,11 @@ namespace ns3{
         m_timeStamp = timeStamp;
         m_validatation = false;
         m_execution = 0;
+        m_fee = 0;
     }
     
-    Transaction::Transaction()
+    Transaction::Transaction() : Transaction(0, 0, 0)
     {
-        Transaction(0, 0, 0);
     }
     
     Transaction::~Transaction()
@@ -105,6 +106,17 @@ namespace ns3{
         m_execution = endoerserId;
     }
 
+    double
+    Transaction::GetFee(void) const
+    {
+        return m_fee;
+    }
+
+    void
+    Transaction::SetFee(double fee)
+    {
+        m_fee = fee;
+    }
 
     Transaction&
     Transaction::operator= (const Transaction &tranSource)
@@ -114,7 +126,8 @@ namespace ns3{
         m_transSizeByte = tranSource.m_transSizeByte;
         m_timeStamp = tranSource.m_timeStamp;
         m_validatation = tranSource.m_validatation;
-        m_validatation = tranSource.m_execution;
+        m_execution = tranSource.m_execution;
+        m_fee = tranSource.m_fee;
 
         return *this;
     }
@@ -145,6 +158,7 @@ namespace ns3{
         m_timeReceived = timeReceived;
         m_receivedFromIpv4 = receivedFromIpv4;
         m_totalTransactions = 0;
+        m_difficulty = 1;
 
     }
 
@@ -164,6 +178,8 @@ namespace ns3{
         m_timeReceived = blockSource.m_timeReceived;
         m_receivedFromIpv4 = blockSource.m_receivedFromIpv4;
         m_transactions = blockSource.m_transactions;
+        m_uncles = blockSource.m_uncles;
+        m_difficulty = blockSource.m_difficulty;
         m_totalTransactions = 0;
         
     }
@@ -274,6 +290,53 @@ namespace ns3{
         m_transactions = transactions;
     }
 
+    double
+    Block::GetDifficulty(void) const
+    {
+        return m_difficulty;
+    }
+
+    void
+    Block::SetDifficulty(double difficulty)
+    {
+        m_difficulty = difficulty;
+    }
+
+    std::vector<std::pair<int, int>>
+    Block::GetUncles(void) const
+    {
+        return m_uncles;
+    }
+
+    void
+    Block::SetUncles(const std::vector<std::pair<int, int>> &uncles)
+    {
+        m_uncles = uncles;
+    }
+
+    void
+    Block::AddUncle(int height, int minerId)
+    {
+        m_uncles.push_back(std::make_pair(height, minerId));
+    }
+
+    int
+    Block::GetTotalUncles(void) const
+    {
+        return m_uncles.size();
+    }
+
+    bool
+    Block::HasUncle(int height, int minerId) const
+    {
+        for(auto it = m_uncles.begin(); it != m_uncles.end(); it++)
+        {
+            if(it->first == height && it->second == minerId)
+                return true;
+        }
+        return false;
+    }
+
     bool
     Block::IsParent(const Block &block) const
     {
@@ -376,6 +439,9 @@ namespace ns3{
         m_timeStamp = blockSource.m_timeStamp;
         m_timeReceived = blockSource.m_timeReceived;
         m_receivedFromIpv4 = blockSource.m_receivedFromIpv4;
+        m_transactions = blockSource.m_transactions;
+        m_uncles = blockSource.m_uncles;
+        m_difficulty = blockSource.m_difficulty;
 
         return *this;
     }
@@ -399,6 +465,13 @@ namespace ns3{
     Blockchain::Blockchain(void)
     {
         m_totalBlocks = 0;
+        m_mainChainBlocks = 0;
+        m_longestFork = 0;
+        m_forkedHeights = 0;
+        m_reorgs = 0;
+        m_maxReorgDepth = 0;
+        m_includedUncles = 0;
+        m_forkChoiceRule = LONGEST_CHAIN;
         Block genesisBlock(0,0,0,0,0,0,0, Ipv4Address("0.0.0.0"));
         AddBlock(genesisBlock);
     }
@@ -422,7 +495,7 @@ namespace ns3{
     bool
     Blockchain::HasBlock(const Block &newBlock) const
     {
-        if(newBlock.GetBlockHeight() > GetCurrentTopBlock()->GetBlockHeight())
+        if(newBlock.GetBlockHeight() > GetMaxHeight())
         {
             // We didn't receive the new block which have a new block height.
             return false;
@@ -444,7 +517,7 @@ namespace ns3{
     bool
     Blockchain::HasBlock(int height, int minerId) const
     {
-        if(height > GetCurrentTopBlock()->GetBlockHeight())
+        if(height > GetMaxHeight())
         {
             // We didn't receive the new block which have a new block height.
             return false;
@@ -467,7 +540,7 @@ namespace ns3{
     {
         std::vector<Block>::iterator block_it;
 
-        if(height <= GetBlockchainHeight() && height >= 0)
+        if(height <= GetMaxHeight() && height >= 0)
         {
             for(block_it = m_blocks[height].begin(); block_it < m_blocks[height].end(); block_it++)
             {
@@ -536,7 +609,7 @@ namespace ns3{
         std::vector<Block>::iterator block_it;
         int childrenHeight = block.GetBlockHeight() + 1;
 
-        if(childrenHeight > GetBlockchainHeight())
+        if(childrenHeight > GetMaxHeight())
         {
             return children;
         }
@@ -574,7 +647,7 @@ namespace ns3{
         std::vector<Block>::iterator block_it;
         int parentHeight = block.GetBlockHeight() - 1;
 
-        if(parentHeight > GetBlockchainHeight() || parentHeight < 0)
+        if(parentHeight > GetMaxHeight() || parentHeight < 0)
             return nullptr;
         
         for(block_it = m_blocks[parentHeight].begin(); block_it < m_blocks[parentHeight].end(); block_it++)
@@ -590,7 +663,53 @@ namespace ns3{
     const Block*
     Blockchain::GetCurrentTopBlock(void) const
     {
-        return &m_blocks[m_blocks.size()-1][0];
+        return &m_blocks[m_mainChain.size() - 1][m_mainChain.back()];
+    }
+
+    const Block*
+    Blockchain::GetMainChainBlock(int height) const
+    {
+        if(height < 0 || height >= static_cast<int>(m_mainChain.size()) || m_mainChain[height] < 0)
+            return nullptr;
+
+        return &m_blocks[height][m_mainChain[height]];
+    }
+
+    double
+    Blockchain::GetMainChainInterval(int fromHeight) const
+    {
+        const Block *first = GetMainChainBlock(fromHeight);
+        const Block *tip = GetCurrentTopBlock();
+
+        if(first == nullptr || tip->GetBlockHeight() <= fromHeight)
+            return 0;
+
+        return (tip->GetTimeStamp() - first->GetTimeStamp()) / (tip->GetBlockHeight() - fromHeight);
+    }
+
+    std::string
+    Blockchain::GetDifficultyTrace(int step) const
+    {
+        std::ostringstream stringStream;
+        int tipHeight = GetCurrentTopBlock()->GetBlockHeight();
+
+        for(int height = 0; height <= tipHeight; height++)
+        {
+            const Block *block = GetMainChainBlock(height);
+
+            if(block == nullptr || (height % step != 0 && height != tipHeight))
+                continue;
+
+            stringStream << (height == 0 ? "" : " ") << height << ":" << block->GetTimeStamp() << ":" << block->GetDifficulty();
+        }
+
+        return stringStream.str();
+    }
+
+    int
+    Blockchain::GetMaxHeight(void) const
+    {
+        return static_cast<int>(m_blocks.size()) - 1;
     }
 
     void
@@ -602,9 +721,9 @@ namespace ns3{
            std::vector<Block> newHeight(1, newBlock);
            m_blocks.push_back(newHeight);
         }
-        else if(newBlock.GetBlockHeight() > GetCurrentTopBlock()->GetBlockHeight())
+        else if(newBlock.GetBlockHeight() > GetMaxHeight())
         {
-           int dummyRows = newBlock.GetBlockHeight() - GetCurrentTopBlock()->GetBlockHeight()-1;
+           int dummyRows = newBlock.GetBlockHeight() - GetMaxHeight() - 1;
 
            for(int i = 0 ; i < dummyRows; i++)
            {
@@ -620,6 +739,359 @@ namespace ns3{
             m_blocks[newBlock.GetBlockHeight()].push_back(newBlock);
         }
         m_totalBlocks++;
+
+        m_forkChoice.resize(m_blocks.size());
+        UpdateForkChoice(newBlock.GetBlockHeight(), m_blocks[newBlock.GetBlockHeight()].size() - 1);
+    }
+
+    void
+    Blockchain::SetForkChoiceRule(enum ForkChoiceRule forkChoiceRule)
+    {
+        m_forkChoiceRule = forkChoiceRule;
+    }
+
+    enum ForkChoiceRule
+    Blockchain::GetForkChoiceRule(void) const
+    {
+        return m_forkChoiceRule;
+    }
+
+    void
+    Blockchain::SetReorgCallback(Callback<void, const Block &, const std::vector<const Block *> &> reorg)
+    {
+        m_reorgCallback = reorg;
+    }
+
+    bool
+    Blockchain::IsInMainChain(int height, int index) const
+    {
+        return height >= 0 && height < static_cast<int>(m_mainChain.size()) && m_mainChain[height] == index;
+    }
+
+    void
+    Blockchain::UpdateForkChoice(int height, int index)
+    {
+        ForkChoiceEntry entry = {-1, m_blocks[height][index].GetDifficulty(), 0};
+        int             tipHeight = static_cast<int>(m_mainChain.size()) - 1;
+        int             newTipHeight = tipHeight;
+        int             newTipIndex = tipHeight >= 0 ? m_mainChain.back() : -1;
+
+        m_forkChoice[height].push_back(entry);
+
+        if(m_blocks[height].size() == 2)
+            m_forkedHeights++;
+
+        if(height == 0)
+        {
+            m_mainChain.assign(1, index);
+            m_mainChainBlocks = 1;
+            return;
+        }
+
+        for(unsigned int i = 0; i < m_blocks[height - 1].size(); i++)
+        {
+            if(m_blocks[height - 1][i].GetMinerId() == m_blocks[height][index].GetParentBlockMinerId())
+                m_forkChoice[height][index].parent = i;
+        }
+
+        int parent = m_forkChoice[height][index].parent;
+
+        if(parent >= 0 && m_forkChoiceRule == GHOST)
+        {
+            /*
+             * GHOST : the weight of a block is the work of its subtree. At the first main chain ancestor
+             * of the new block, the main chain moves to the new branch if it became heavier.
+             */
+            int h = height - 1;
+            int i = parent;
+            int child = index;
+            bool forkPointFound = false;
+
+            while(i >= 0)
+            {
+                m_forkChoice[h][i].weight += m_blocks[height][index].GetDifficulty();
+
+                if(!forkPointFound && IsInMainChain(h, i))
+                {
+                    forkPointFound = true;
+
+                    if(h == tipHeight || m_forkChoice[h + 1][child].weight > m_forkChoice[h + 1][m_mainChain[h + 1]].weight)
+                    {
+                        newTipHeight = h + 1;
+                        newTipIndex = child;
+                    }
+                }
+
+                child = i;
+                i = m_forkChoice[h][i].parent;
+                h--;
+            }
+
+            /*
+             * The tip is the end of the heaviest path from the new branch
+             */
+            while(newTipHeight != tipHeight || newTipIndex != m_mainChain.back())
+            {
+                int heaviest = -1;
+
+                if(newTipHeight + 1 >= static_cast<int>(m_forkChoice.size()))
+                    break;
+
+                for(unsigned int c = 0; c < m_forkChoice[newTipHeight + 1].size(); c++)
+                {
+                    if(m_forkChoice[newTipHeight + 1][c].parent == newTipIndex
+                        && (heaviest < 0 || m_forkChoice[newTipHeight + 1][c].weight > m_forkChoice[newTipHeight + 1][heaviest].weight))
+                    {
+                        heaviest = c;
+                    }
+                }
+
+                if(heaviest < 0)
+                    break;
+
+                newTipHeight++;
+                newTipIndex = heaviest;
+            }
+        }
+        else if(parent >= 0)
+        {
+            /*
+             * Longest chain : the weight of a block is the work of its chain, so a chain of lower difficulty blocks
+             * does not win by its length. The first block seen wins the ties.
+             */
+            m_forkChoice[height][index].weight = m_forkChoice[height - 1][parent].weight + m_blocks[height][index].GetDifficulty();
+
+            if(m_forkChoice[height][index].weight > m_forkChoice[tipHeight][m_mainChain.back()].weight)
+            {
+                newTipHeight = height;
+                newTipIndex = index;
+            }
+        }
+
+        if(newTipHeight == tipHeight + 1 && m_forkChoice[newTipHeight][newTipIndex].parent == m_mainChain.back())
+        {
+            m_mainChain.push_back(newTipIndex);
+            EnterMainChain(newTipHeight, newTipIndex);
+        }
+        else if(newTipHeight != tipHeight || newTipIndex != m_mainChain.back())
+        {
+            Reorganize(newTipHeight, newTipIndex);
+        }
+
+        /*
+         * A block out of the main chain starts or extends a fork
+         */
+        if(!IsInMainChain(height, index))
+        {
+            int forkLength = parent < 0 || IsInMainChain(height - 1, parent) ? 1 : m_forkChoice[height - 1][parent].forkLength + 1;
+
+            m_forkChoice[height][index].forkLength = forkLength;
+            m_longestFork = std::max(m_longestFork, forkLength);
+            m_staleBlocks[height].push_back(index);
+        }
+    }
+
+    void
+    Blockchain::Reorganize(int tipHeight, int tipIndex)
+    {
+        std::vector<std::pair<int, int>>    displaced;
+        int                                 h = tipHeight;
+        int                                 i = tipIndex;
+
+        for(int height = static_cast<int>(m_mainChain.size()) - 1; height > tipHeight; height--)
+        {
+            if(m_mainChain[height] >= 0)
+                displaced.push_back(std::make_pair(height, m_mainChain[height]));
+        }
+
+        m_mainChain.resize(tipHeight + 1, -1);
+
+        /*
+         * Walk back to the common ancestor only
+         */
+        while(h >= 0 && i >= 0 && m_mainChain[h] != i)
+        {
+            if(m_mainChain[h] >= 0)
+                displaced.push_back(std::make_pair(h, m_mainChain[h]));
+
+            m_mainChain[h] = i;
+            EnterMainChain(h, i);
+            m_forkChoice[h][i].forkLength = 0;
+
+            i = m_forkChoice[h][i].parent;
+            h--;
+        }
+
+        /*
+         * h is now the height of the common ancestor, the displaced blocks form a fork
+         */
+        for(auto it = displaced.begin(); it != displaced.end(); it++)
+        {
+            LeaveMainChain(it->first, it->second);
+            m_forkChoice[it->first][it->second].forkLength = it->first - h;
+            m_longestFork = std::max(m_longestFork, it->first - h);
+        }
+
+        if(!displaced.empty())
+        {
+            m_reorgs++;
+            m_maxReorgDepth = std::max(m_maxReorgDepth, static_cast<int>(displaced.size()));
+
+            if(!m_reorgCallback.IsNull())
+            {
+                std::vector<const Block *> displacedBlocks;
+
+                for(auto it = displaced.begin(); it != displaced.end(); it++)
+                    displacedBlocks.push_back(&m_blocks[it->first][it->second]);
+
+                m_reorgCallback(m_blocks[tipHeight][tipIndex], displacedBlocks);
+            }
+        }
+    }
+
+    void
+    Blockchain::EnterMainChain(int height, int index)
+    {
+        std::vector<int> &stale = m_staleBlocks[height];
+
+        m_mainChainBlocks++;
+        m_minerMainChainBlocks[m_blocks[height][index].GetMinerId()]++;
+        CountUncles(m_blocks[height][index], 1);
+
+        stale.erase(std::remove(stale.begin(), stale.end(), index), stale.end());
+        if(stale.empty())
+            m_staleBlocks.erase(height);
+    }
+
+    void
+    Blockchain::LeaveMainChain(int height, int index)
+    {
+        m_mainChainBlocks--;
+        m_minerMainChainBlocks[m_blocks[height][index].GetMinerId()]--;
+        CountUncles(m_blocks[height][index], -1);
+
+        m_staleBlocks[height].push_back(index);
+    }
+
+    void
+    Blockchain::CountUncles(const Block &block, int sign)
+    {
+        std::vector<std::pair<int, int>> uncles = block.GetUncles();
+
+        for(auto it = uncles.begin(); it != uncles.end(); it++)
+        {
+            m_includedUncles += sign;
+            m_minerIncludedUncles[it->second] += sign;
+            m_minerUncleRewards[it->second] += sign * (8 - (block.GetBlockHeight() - it->first)) / 8.0;
+            m_minerUncleRewards[block.GetMinerId()] += sign / 32.0;
+        }
+    }
+
+    std::vector<const Block *>
+    Blockchain::GetUncleCandidates(int maxUncles, int maxDepth) const
+    {
+        std::vector<const Block *>  candidates;
+        int                         height = m_mainChain.size();
+
+        /*
+         * The index only holds the stale blocks, so the heights below the new block are visited from the top
+         */
+        auto it = m_staleBlocks.lower_bound(height);
+
+        while(it != m_staleBlocks.begin() && static_cast<int>(candidates.size()) < maxUncles)
+        {
+            it--;
+
+            if(it->first < height - maxDepth)
+                break;
+
+            for(auto index = it->second.begin(); index != it->second.end() && static_cast<int>(candidates.size()) < maxUncles; index++)
+            {
+                const Block &uncle = m_blocks[it->first][*index];
+                int         parent = m_forkChoice[it->first][*index].parent;
+                bool        referenced = false;
+
+                if(parent < 0 || !IsInMainChain(it->first - 1, parent))
+                    continue;
+
+                for(int h = it->first + 1; h < height && !referenced; h++)
+                {
+                    if(m_mainChain[h] >= 0 && m_blocks[h][m_mainChain[h]].HasUncle(it->first, uncle.GetMinerId()))
+                        referenced = true;
+                }
+
+                if(!referenced)
+                    candidates.push_back(&uncle);
+            }
+        }
+
+        return candidates;
+    }
+
+    int
+    Blockchain::GetIncludedUncles(void) const
+    {
+        return m_includedUncles;
+    }
+
+    int
+    Blockchain::GetMinerIncludedUncles(int minerId) const
+    {
+        auto it = m_minerIncludedUncles.find(minerId);
+
+        return it != m_minerIncludedUncles.end() ? it->second : 0;
+    }
+
+    double
+    Blockchain::GetMinerUncleRewards(int minerId) const
+    {
+        auto it = m_minerUncleRewards.find(minerId);
+
+        return it != m_minerUncleRewards.end() ? it->second : 0;
+    }
+
+    int
+    Blockchain::GetBlocksInForks(void) const
+    {
+        return m_totalBlocks - m_mainChainBlocks;
+    }
+
+    int
+    Blockchain::GetLongestForkSize(void) const
+    {
+        return m_longestFork;
+    }
+
+    int
+    Blockchain::GetForkedHeights(void) const
+    {
+        return m_forkedHeights;
+    }
+
+    int
+    Blockchain::GetBranches(int height) const
+    {
+        return height >= 0 && height < static_cast<int>(m_blocks.size()) ? m_blocks[height].size() : 0;
+    }
+
+    int
+    Blockchain::GetMinedBlocksInMainChain(int minerId) const
+    {
+        auto it = m_minerMainChainBlocks.find(minerId);
+
+        return it != m_minerMainChainBlocks.end() ? it->second : 0;
+    }
+
+    int
+    Blockchain::GetReorgs(void) const
+    {
+        return m_reorgs;
+    }
+
+    int
+    Blockchain::GetMaxReorgDepth(void) const
+    {
+        return m_maxReorgDepth;
     }
 
     void
@@ -667,6 +1139,31 @@ namespace ns3{
             case REPLY_TRANS: return "REPLY_TRANS";
             case MSG_TRANS: return "MSG_TRANS";
             case RESULT_TRANS: return "RESULT_TRANS";
+            case CMPCT_BLOCK: return "CMPCT_BLOCK";
+            case GET_BLOCK_TXN: return "GET_BLOCK_TXN";
+            case BLOCK_TXN: return "BLOCK_TXN";
+            case CHUNK_INV: return "CHUNK_INV";
+            case GET_CHUNK: return "GET_CHUNK";
+            case CHUNK: return "CHUNK";
+            case CODED_CHUNK: return "CODED_CHUNK";
+            case GRAPHENE_BLOCK: return "GRAPHENE_BLOCK";
+            case REQ_RECON: return "REQ_RECON";
+            case SKETCH: return "SKETCH";
+            case RECON_DIFF: return "RECON_DIFF";
+            case TRANS_INV: return "TRANS_INV";
+            case GET_TRANS: return "GET_TRANS";
+            case PBFT_PRE_PREPARE: return "PBFT_PRE_PREPARE";
+            case PBFT_PREPARE: return "PBFT_PREPARE";
+            case PBFT_COMMIT: return "PBFT_COMMIT";
+            case PBFT_VIEW_CHANGE: return "PBFT_VIEW_CHANGE";
+            case PBFT_NEW_VIEW: return "PBFT_NEW_VIEW";
+            case RAFT_APPEND: return "RAFT_APPEND";
+            case RAFT_ACK: return "RAFT_ACK";
+            case RAFT_VOTE_REQUEST: return "RAFT_VOTE_REQUEST";
+            case RAFT_VOTE: return "RAFT_VOTE";
+            case HOTSTUFF_PROPOSAL: return "HOTSTUFF_PROPOSAL";
+            case HOTSTUFF_VOTE: return "HOTSTUFF_VOTE";
+            case HOTSTUFF_NEW_VIEW: return "HOTSTUFF_NEW_VIEW";
         }
 
         return 0;
@@ -678,6 +1175,9 @@ namespace ns3{
         {
             case NORMAL_MINER: return "ETHEREUM";
             case HYPERLEDGER_MINER: return "HYPERLEDGER";
+            case PBFT_MINER: return "PBFT";
+            case RAFT_MINER: return "RAFT";
+            case HOTSTUFF_MINER: return "HOTSTUFF";
         }
 
         return 0;
@@ -694,6 +1194,96 @@ namespace ns3{
          return 0;
     }
 
+    const char* getCompactBlockMode(enum CompactBlockMode m)
+    {
+        switch(m)
+        {
+            case COMPACT_BLOCKS_OFF: return "COMPACT_BLOCKS_OFF";
+            case LOW_BANDWIDTH_COMPACT: return "LOW_BANDWIDTH_COMPACT";
+            case HIGH_BANDWIDTH_COMPACT: return "HIGH_BANDWIDTH_COMPACT";
+            case GRAPHENE_BLOCKS: return "GRAPHENE_BLOCKS";
+        }
+        return 0;
+    }
+
+    const char* getTransferSchedulerPolicy(enum TransferSchedulerPolicy m)
+    {
+        switch(m)
+        {
+            case FIFO_SCHEDULER: return "FIFO_SCHEDULER";
+            case ROUND_ROBIN_SCHEDULER: return "ROUND_ROBIN_SCHEDULER";
+            case SMALLEST_FIRST_SCHEDULER: return "SMALLEST_FIRST_SCHEDULER";
+        }
+        return 0;
+    }
+
+    const char* getHardwareClass(enum HardwareClass m)
+    {
+        switch(m)
+        {
+            case IDEAL_HARDWARE: return "IDEAL_HARDWARE";
+            case LOW_END_HARDWARE: return "LOW_END_HARDWARE";
+            case STANDARD_HARDWARE: return "STANDARD_HARDWARE";
+            case HIGH_END_HARDWARE: return "HIGH_END_HARDWARE";
+        }
+        return 0;
+    }
+
+    const char* getGossipFanout(enum GossipFanout m)
+    {
+        switch(m)
+        {
+            case GOSSIP_FANOUT_ALL: return "GOSSIP_FANOUT_ALL";
+            case GOSSIP_FANOUT_SQRT: return "GOSSIP_FANOUT_SQRT";
+            case GOSSIP_FANOUT_FIXED: return "GOSSIP_FANOUT_FIXED";
+        }
+        return 0;
+    }
+
+    const char* getForkChoiceRule(enum ForkChoiceRule m)
+    {
+        switch(m)
+        {
+            case LONGEST_CHAIN: return "LONGEST_CHAIN";
+            case GHOST: return "GHOST";
+        }
+        return 0;
+    }
+
+    const char* getMiningStrategy(enum MiningStrategy m)
+    {
+        switch(m)
+        {
+            case HONEST_MINING: return "HONEST_MINING";
+            case SELFISH_MINING: return "SELFISH_MINING";
+            case STUBBORN_MINING: return "STUBBORN_MINING";
+            case WITHHOLDING_MINING: return "WITHHOLDING_MINING";
+        }
+        return 0;
+    }
+
+    const char* getDifficultyAdjustment(enum DifficultyAdjustment m)
+    {
+        switch(m)
+        {
+            case FIXED_DIFFICULTY: return "FIXED_DIFFICULTY";
+            case EPOCH_RETARGET: return "EPOCH_RETARGET";
+            case PER_BLOCK_ADJUSTMENT: return "PER_BLOCK_ADJUSTMENT";
+        }
+        return 0;
+    }
+
+    const char* getGossipMode(enum GossipMode m)
+    {
+        switch(m)
+        {
+            case GOSSIP_PUSH: return "GOSSIP_PUSH";
+            case GOSSIP_PULL: return "GOSSIP_PULL";
+            case GOSSIP_PUSH_PULL: return "GOSSIP_PUSH_PULL";
+        }
+        return 0;
+    }
+
     const char* getCommitterType(enum CommitterType m)
     {
         switch(m)
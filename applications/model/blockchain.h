@@ -4,7 +4,9 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <string>
 #include "ns3/address.h"
+#include "ns3/callback.h"
 
 namespace ns3 {
 
@@ -20,12 +22,40 @@ namespace ns3 {
         REPLY_TRANS,    //7
         MSG_TRANS,      //8
         RESULT_TRANS,   //9
+        CMPCT_BLOCK,    //10
+        GET_BLOCK_TXN,  //11
+        BLOCK_TXN,      //12
+        CHUNK_INV,      //13
+        GET_CHUNK,      //14
+        CHUNK,          //15
+        CODED_CHUNK,    //16
+        GRAPHENE_BLOCK, //17
+        REQ_RECON,      //18
+        SKETCH,         //19
+        RECON_DIFF,     //20
+        TRANS_INV,      //21
+        GET_TRANS,      //22
+        PBFT_PRE_PREPARE,   //23
+        PBFT_PREPARE,       //24
+        PBFT_COMMIT,        //25
+        PBFT_VIEW_CHANGE,   //26
+        PBFT_NEW_VIEW,      //27
+        RAFT_APPEND,        //28
+        RAFT_ACK,           //29
+        RAFT_VOTE_REQUEST,  //30
+        RAFT_VOTE,          //31
+        HOTSTUFF_PROPOSAL,  //32
+        HOTSTUFF_VOTE,      //33
+        HOTSTUFF_NEW_VIEW,  //34
     };
 
     enum MinerType
     {
         NORMAL_MINER,
         HYPERLEDGER_MINER,
+        PBFT_MINER,             // a validator of a PBFT consensus among the miners
+        RAFT_MINER,             // a replica of a Raft ordering service among the miners
+        HOTSTUFF_MINER,         // a validator of a chained HotStuff consensus among the miners
     };
 
     enum CommitterType
@@ -42,6 +72,64 @@ namespace ns3 {
         SENDHEADERS
     };
 
+    enum CompactBlockMode
+    {
+        COMPACT_BLOCKS_OFF,         //0 default, full blocks
+        LOW_BANDWIDTH_COMPACT,      //1 compact blocks on request
+        HIGH_BANDWIDTH_COMPACT,     //2 compact blocks pushed unsolicited
+        GRAPHENE_BLOCKS             //3 Bloom filter + IBLT of the transactions on request
+    };
+
+    enum TransferSchedulerPolicy
+    {
+        FIFO_SCHEDULER,             //0 default
+        ROUND_ROBIN_SCHEDULER,      //1 per-peer round-robin
+        SMALLEST_FIRST_SCHEDULER    //2
+    };
+
+    enum HardwareClass
+    {
+        IDEAL_HARDWARE,         //0 no processing cost
+        LOW_END_HARDWARE,       //1
+        STANDARD_HARDWARE,      //2 default
+        HIGH_END_HARDWARE       //3
+    };
+
+    enum GossipFanout
+    {
+        GOSSIP_FANOUT_ALL,          //0 default, every peer
+        GOSSIP_FANOUT_SQRT,         //1 sqrt(peers) random peers
+        GOSSIP_FANOUT_FIXED         //2 k random peers
+    };
+
+    enum GossipMode
+    {
+        GOSSIP_PUSH,                //0 default, the transactions are sent to the fanout peers
+        GOSSIP_PULL,                //1 the fanout peers get a TRANS_INV and pull the transactions with GET_TRANS
+        GOSSIP_PUSH_PULL            //2 pushed to the fanout peers, TRANS_INV to the other peers
+    };
+
+    enum ForkChoiceRule
+    {
+        LONGEST_CHAIN,              //0 default, the chain with the most work (the most blocks at a fixed difficulty)
+        GHOST                       //1 the heaviest subtree at every fork (Ethereum)
+    };
+
+    enum MiningStrategy
+    {
+        HONEST_MINING,              //0 default, the blocks are published at once on the public tip
+        SELFISH_MINING,             //1 a private chain released to match or override the public chain (Eyal and Sirer)
+        STUBBORN_MINING,            //2 selfish, but never overrides, keeps its lead in the ties and trails the public chain
+        WITHHOLDING_MINING          //3 every block is published after a delay, or when the public chain catches up with it
+    };
+
+    enum DifficultyAdjustment
+    {
+        FIXED_DIFFICULTY,           //0 default, the difficulty of the genesis block is kept
+        EPOCH_RETARGET,             //1 scaled by the mean interval of the last epoch every RetargetInterval blocks (Bitcoin)
+        PER_BLOCK_ADJUSTMENT        //2 nudged by 1/2048 at every block from the interval of its parent (Ethereum Homestead)
+    };
+
     enum Cryptocurrency
     {
         ETHEREUM,
@@ -93,6 +181,86 @@ namespace ns3 {
         double  meanLatency;
         int     nodeType;
         double  meanNumberofTransactions;
+        double  uploadMeanQueueDepth;
+        int     uploadMaxQueueDepth;
+        double  uploadUtilization;
+        double  downloadMeanActiveTransfers;
+        int     downloadMaxActiveTransfers;
+        double  downloadUtilization;
+        double  cpuUtilization;
+        double  cpuMeanQueueDelay;
+        int     cpuMaxQueueLength;
+        long    invTimersArmed;
+        long    invTimersFired;
+        long    invTimersCancelled;
+        long    blockRefetches;
+        long    earlyReissues;
+        int     maxInFlightRequests;
+        int     maxParallelDownloadPeers;
+        long    announcementSentBytes;
+        long    announcementReceivedBytes;
+        double  meanAnnounceToBlockTime;
+        long    compactBlockSentBytes;
+        long    compactBlockReceivedBytes;
+        long    compactBlocksReconstructed;
+        long    compactBlockRoundTrips;
+        long    compactBlockFallbacks;
+        long    chunkSentBytes;
+        long    chunkReceivedBytes;
+        long    chunkTimeouts;
+        double  meanChunkSources;
+        long    codedChunkSentBytes;
+        long    codedChunkReceivedBytes;
+        long    codedChunkDuplicates;
+        long    codedBlockFallbacks;
+        long    grapheneSentBytes;
+        long    grapheneReceivedBytes;
+        long    grapheneBlocksDecoded;
+        long    grapheneDecodeFailures;
+        long    grapheneBytesSaved;
+        long    transactionSentBytes;
+        long    reconciliationSentBytes;
+        long    reconciliationRounds;
+        long    reconciliationFailures;
+        long    reconciledTransactions;
+        long    announcementMessages;
+        long    announcementItems;
+        double  meanAnnouncementBatch;
+        int     p90AnnouncementBatch;
+        double  meanTrickleInterval;
+        double  p90TrickleInterval;
+        long    seenCacheHits;
+        long    seenCacheEvictions;
+        int     transactionsCreated;
+        long    transactionsReceived;
+        long    gossipTtlExpired;
+        long    gossipPullSentBytes;
+        long    gossipPulledTransactions;
+        int     mempoolSize;
+        int     mempoolMaxSize;
+        long    mempoolEvictions;
+        long    mempoolRejections;
+        double  meanBlockFill;
+        double  meanTransactionSize;
+        int     reorgs;
+        int     maxReorgDepth;
+        int     includedUncles;
+        int     minerIncludedUncles;
+        double  minerUncleRewards;
+        int     miningStrategy;
+        int     minerWithheldBlocks;
+        int     minerAbandonedBlocks;
+        double  difficulty;
+        double  mainChainInterval;
+        double  steadyChainInterval;
+        long    consensusMessagesSent;
+        long    consensusMessagesReceived;
+        long    consensusSentBytes;
+        long    consensusReceivedBytes;
+        long    consensusSignaturesVerified;
+        int     consensusCommittedBlocks;
+        double  meanCommitLatency;
+        int     viewChanges;
       
     
     } nodeStatistics;
@@ -106,6 +274,14 @@ namespace ns3 {
     const char* getMinerType(enum MinerType m);
     const char* getCommitterType(enum CommitterType m);
     const char* getProtocolType(enum ProtocolType m);
+    const char* getCompactBlockMode(enum CompactBlockMode m);
+    const char* getTransferSchedulerPolicy(enum TransferSchedulerPolicy m);
+    const char* getHardwareClass(enum HardwareClass m);
+    const char* getGossipFanout(enum GossipFanout m);
+    const char* getGossipMode(enum GossipMode m);
+    const char* getForkChoiceRule(enum ForkChoiceRule m);
+    const char* getMiningStrategy(enum MiningStrategy m);
+    const char* getDifficultyAdjustment(enum DifficultyAdjustment m);
     const char* getCryptocurrency(enum Cryptocurrency m);
     const char* getBlockchainRegion(enum BlockchainRegion m);
     enum BlockchainRegion getBlockchainEnum(uint32_t n);
@@ -136,6 +312,9 @@ namespace ns3 {
             int GetExecution(void) const;
             void SetExecution(int endoerserId);
 
+            double GetFee(void) const;
+            void SetFee(double fee);
+
             Transaction& operator = (const Transaction &tranSource);     //Assignment Constructor
 
             friend bool operator == (const Transaction &tran1, const Transaction &tran2);
@@ -148,6 +327,7 @@ namespace ns3 {
             double m_timeStamp;
             bool m_validatation; 
             int m_execution;
+            double m_fee;               // paid to the miner including it, orders the mempool
 
     };
 
@@ -180,12 +360,29 @@ namespace ns3 {
             void SetTimeStamp(double timeStamp);
 
             double GetTimeReceived(void) const;
+
+            /*
+             * The difficulty relative to the genesis block, a miner finds blocks at the rate
+             * hashRate / (AverageBlockGenIntervalSeconds * difficulty)
+             */
+            double GetDifficulty(void) const;
+            void SetDifficulty(double difficulty);
             
             Ipv4Address GetReceivedFromIpv4(void) const;
             void SetReceivedFromIpv4(Ipv4Address receivedFromIpv4);
 
             std::vector<Transaction> GetTransactions(void) const;
             void SetTransactions(const std::vector<Transaction> &transactions);
+
+            /*
+             * The uncles are the (height, minerId) of the stale blocks referenced by this block
+             */
+            std::vector<std::pair<int, int>> GetUncles(void) const;
+            void SetUncles(const std::vector<std::pair<int, int>> &uncles);
+            void AddUncle(int height, int minerId);
+            int GetTotalUncles(void) const;
+            bool HasUncle(int height, int minerId) const;
+
             /*
             * Checks if the block provided as the argument is the parent of this block object
             */
@@ -224,8 +421,16 @@ namespace ns3 {
             double      m_timeReceived;              //the time that the block was received from the node
             Ipv4Address m_receivedFromIpv4;       //the ipv4 of the node which sent the block to the receiving node
             std::vector<Transaction> m_transactions;
+            std::vector<std::pair<int, int>> m_uncles;  //the (height, minerId) of the uncles referenced by the block
+            double      m_difficulty;                //the difficulty the block was mined at
     };
 
+    typedef struct{
+        int     parent;                 // the index of the parent in the blocks of the previous height, -1 if unknown
+        double  weight;                 // the work, the sum of the difficulties, of the chain (LONGEST_CHAIN) or of the subtree (GHOST)
+        int     forkLength;             // 0 in the main chain
+    } ForkChoiceEntry;
+
     class Blockchain : public Block
     {
         public:
@@ -263,8 +468,39 @@ namespace ns3 {
 
             const Block* GetParent(const Block &block);
 
+            /*
+             * return the tip of the main chain chosen by the fork choice rule, in O(1)
+             */
             const Block* GetCurrentTopBlock(void) const;
 
+            /*
+             * return the main chain block at a height, nullptr above the tip
+             */
+            const Block* GetMainChainBlock(int height) const;
+
+            /*
+             * return the mean interval between the main chain blocks from a height to the tip, 0 without blocks
+             */
+            double GetMainChainInterval(int fromHeight) const;
+
+            /*
+             * return the difficulty of the main chain blocks every step heights and at the tip (height:time:difficulty)
+             */
+            std::string GetDifficultyTrace(int step) const;
+
+            /*
+             * return the greatest height of a block, the main chain may end below it with GHOST
+             */
+            int GetMaxHeight(void) const;
+
+            void SetForkChoiceRule(enum ForkChoiceRule forkChoiceRule);
+            enum ForkChoiceRule GetForkChoiceRule(void) const;
+
+            /*
+             * The callback gets the new tip and the blocks that left the main chain
+             */
+            void SetReorgCallback(Callback<void, const Block &, const std::vector<const Block *> &> reorg);
+
             void AddBlock(const Block& newBlock);
 
             void AddOrphan(const Block& newBlock);
@@ -273,17 +509,84 @@ namespace ns3 {
 
             //void PrintOrphans(void);
 
-            //void GetBlocksInForks(void);
+            /*
+             * The fork statistics are kept up to date by AddBlock. The main chain ends at GetCurrentTopBlock.
+             */
+            int GetBlocksInForks(void) const;
+
+            int GetLongestForkSize(void) const;
+
+            int GetForkedHeights(void) const;
+
+            int GetBranches(int height) const;
+
+            int GetMinedBlocksInMainChain(int minerId) const;
+
+            int GetReorgs(void) const;
+
+            int GetMaxReorgDepth(void) const;
 
-            //int GetLongestForkSize(void);
+            /*
+             * Returns up to maxUncles stale blocks a new block on top of the main chain can reference:
+             * at most maxDepth heights below it, with a parent in the main chain, and not referenced
+             * by a main chain block yet. The most recent ones come first.
+             */
+            std::vector<const Block *> GetUncleCandidates(int maxUncles, int maxDepth) const;
+
+            /*
+             * The uncles referenced by the main chain blocks, and the uncle rewards of a miner in block rewards:
+             * (8 - distance)/8 for each of its stale blocks referenced and 1/32 for each uncle its blocks reference
+             */
+            int GetIncludedUncles(void) const;
+
+            int GetMinerIncludedUncles(int minerId) const;
+
+            double GetMinerUncleRewards(int minerId) const;
 
             //friend std:: ostream& operator << (std:ostream &out, Blockchain &blockchain);
 
         protected:
+
+            bool IsInMainChain(int height, int index) const;
+
+            /*
+             * Updates the weights, the main chain and the forks with the block m_blocks[height][index]
+             */
+            void UpdateForkChoice(int height, int index);
+
+            /*
+             * Moves the main chain to the tip m_blocks[tipHeight][tipIndex]
+             */
+            void Reorganize(int tipHeight, int tipIndex);
+
+            /*
+             * Move the block m_blocks[height][index] in or out of the main chain, with its uncles and the stale index
+             */
+            void EnterMainChain(int height, int index);
+            void LeaveMainChain(int height, int index);
+
+            /*
+             * Counts the uncles of a main chain block, sign is -1 when it leaves the main chain
+             */
+            void CountUncles(const Block &block, int sign);
         
             int                             m_totalBlocks;
             std::vector<std::vector<Block>> m_blocks;
             std::vector<Block>              m_orphans;                 
+            std::vector<std::vector<ForkChoiceEntry>> m_forkChoice;     // the fork choice state of each block of m_blocks
+            enum ForkChoiceRule             m_forkChoiceRule;
+            std::vector<int>                m_mainChain;                // the index of the main chain block at each height, -1 if unknown
+            int                             m_mainChainBlocks;
+            std::map<int, int>              m_minerMainChainBlocks;     // the main chain blocks of each miner
+            int                             m_longestFork;
+            int                             m_forkedHeights;            // the heights with more than one block
+            int                             m_reorgs;
+            int                             m_maxReorgDepth;
+            Callback<void, const Block &, const std::vector<const Block *> &> m_reorgCallback;
+            std::map<int, std::vector<int>> m_staleBlocks;              // the indices of the blocks out of the main chain, by height
+            int                             m_includedUncles;
+            std::map<int, int>              m_minerIncludedUncles;      // the stale blocks of each miner referenced by the main chain
+            std::map<int, double>           m_minerUncleRewards;        // the uncle and nephew rewards of each miner
     };
 
 }
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/blockchain-processor-sharing-link.h"
+
+namespace ns3 {
+
+    /*
+     * Many transfers of random sizes on a link whose rate is not a round number : the event times are rounded to
+     * the time step, and every transfer must still leave the link, at the time processor sharing gives it
+     */
+    class BlockchainProcessorSharingLinkTestCase : public TestCase
+    {
+        public:
+            BlockchainProcessorSharingLinkTestCase(void);
+            virtual ~BlockchainProcessorSharingLinkTestCase(void);
+
+        private:
+            virtual void DoRun(void);
+
+            void TransferDone(std::string, Address &);
+
+            std::vector<double>     m_finishTimes;
+    };
+
+    BlockchainProcessorSharingLinkTestCase::BlockchainProcessorSharingLinkTestCase(void)
+        : TestCase("Transfers on a link with a non-round rate all finish")
+    {
+    }
+
+    BlockchainProcessorSharingLinkTestCase::~BlockchainProcessorSharingLinkTestCase(void)
+    {
+    }
+
+    void
+    BlockchainProcessorSharingLinkTestCase::TransferDone(std::string, Address &)
+    {
+        m_finishTimes.push_back(Simulator::Now().GetSeconds());
+    }
+
+    void
+    BlockchainProcessorSharingLinkTestCase::DoRun(void)
+    {
+        const double                            linkRate = 1234567;
+        const int                               transfers = 50;
+        BlockchainProcessorSharingLink          link;
+        std::mt19937                            generator(1);
+        std::uniform_real_distribution<double>  size(1000, 500000);
+        std::vector<double>                     sizes;
+        double                                  totalBytes = 0;
+
+        link.SetLinkRate(linkRate);
+        link.SetCompleteCallback(MakeCallback(&BlockchainProcessorSharingLinkTestCase::TransferDone, this));
+
+        for(int i = 0; i < transfers; i++)
+        {
+            sizes.push_back(size(generator));
+            totalBytes += sizes.back();
+            link.AddTransfer(Ipv4Address(static_cast<uint32_t>(i + 1)), Address(), "transfer", sizes.back(), 0);
+        }
+
+        Simulator::Stop(Seconds(2 * totalBytes / linkRate));
+        Simulator::Run();
+        Simulator::Destroy();
+
+        NS_TEST_ASSERT_MSG_EQ(m_finishTimes.size(), static_cast<size_t>(transfers), "Every transfer leaves the link");
+
+        /*
+         * The transfers started together, the i-th smallest one finishes once every transfer received its size
+         */
+        std::sort(sizes.begin(), sizes.end());
+
+        double servedBytes = 0;
+
+        for(int i = 0; i < transfers; i++)
+        {
+            servedBytes += (sizes[i] - (i > 0 ? sizes[i - 1] : 0)) * (transfers - i);
+            NS_TEST_ASSERT_MSG_EQ_TOL(m_finishTimes[i], servedBytes / linkRate, 1e-6, "The transfer " << i << " finishes at its processor sharing time");
+        }
+
+        NS_TEST_ASSERT_MSG_EQ_TOL(m_finishTimes.back(), totalBytes / linkRate, 1e-6, "The link is work conserving");
+    }
+
+    class BlockchainProcessorSharingLinkTestSuite : public TestSuite
+    {
+        public:
+            BlockchainProcessorSharingLinkTestSuite(void);
+    };
+
+    BlockchainProcessorSharingLinkTestSuite::BlockchainProcessorSharingLinkTestSuite(void)
+        : TestSuite("blockchain-processor-sharing-link", UNIT)
+    {
+        AddTestCase(new BlockchainProcessorSharingLinkTestCase, TestCase::QUICK);
+    }
+
+    static BlockchainProcessorSharingLinkTestSuite g_blockchainProcessorSharingLinkTestSuite;
+
+}
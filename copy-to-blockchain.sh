@@ -9,6 +9,51 @@ cp $NS3_FOLDER/src/applications/model/blockchain-miner.h $PROJECT_FOLDER/applica
 cp $NS3_FOLDER/src/applications/model/blockchain-miner.cc $PROJECT_FOLDER/applications/model/
 cp $NS3_FOLDER/src/applications/model/blockchain-node.h $PROJECT_FOLDER/applications/model/
 cp $NS3_FOLDER/src/applications/model/blockchain-node.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-transfer-scheduler.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-transfer-scheduler.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-processor-sharing-link.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-processor-sharing-link.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/test/blockchain-processor-sharing-link-test-suite.cc $PROJECT_FOLDER/applications/test/
+cp $NS3_FOLDER/src/applications/model/blockchain-cpu-model.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-cpu-model.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-timer-wheel.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-timer-wheel.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-peer-monitor.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-peer-monitor.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-download-scheduler.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-download-scheduler.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-compact-block.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-compact-block.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-chunk-swarm.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-chunk-swarm.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-erasure-code.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-erasure-code.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-graphene.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-graphene.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-trickle-queue.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-trickle-queue.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-seen-cache.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-seen-cache.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-mining-oracle.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-mining-oracle.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-mempool.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-mempool.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-mining-strategy.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-mining-strategy.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-difficulty.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-difficulty.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-pbft.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-pbft.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-validator.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-validator.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-pbft-miner.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-pbft-miner.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-raft-miner.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-raft-miner.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-hotstuff.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-hotstuff.cc $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-hotstuff-miner.h $PROJECT_FOLDER/applications/model/
+cp $NS3_FOLDER/src/applications/model/blockchain-hotstuff-miner.cc $PROJECT_FOLDER/applications/model/
 cp $NS3_FOLDER/src/applications/helper/blockchain-miner-helper.h $PROJECT_FOLDER/applications/helper/
 cp $NS3_FOLDER/src/applications/helper/blockchain-miner-helper.cc $PROJECT_FOLDER/applications/helper/
 cp $NS3_FOLDER/src/applications/helper/blockchain-node-helper.h $PROJECT_FOLDER/applications/helper/
@@ -18,4 +63,8 @@ cp $NS3_FOLDER/src/applications/helper/blockchain-topology-helper.cc $PROJECT_FO
 cp $NS3_FOLDER/src/internet/helper/ipv4-address-helper-custom.h $PROJECT_FOLDER/internet/helper/
 cp $NS3_FOLDER/src/internet/helper/ipv4-address-helper-custom.cc $PROJECT_FOLDER/internet/helper/
 cp $NS3_FOLDER/scratch/blockchain_test3.cc $PROJECT_FOLDER/scratch
+cp $NS3_FOLDER/scratch/blockchain_cpu_calibration.cc $PROJECT_FOLDER/scratch
+cp $NS3_FOLDER/scratch/blockchain_selfish_mining.cc $PROJECT_FOLDER/scratch
+cp $NS3_FOLDER/scratch/blockchain_difficulty.cc $PROJECT_FOLDER/scratch
+cp $NS3_FOLDER/scratch/blockchain_consensus.cc $PROJECT_FOLDER/scratch
 
@@ -0,0 +1,274 @@
+/*
+ * Compares the commit latency and the message complexity of the PBFT, Raft and chained HotStuff validators as the
+ * validator set grows, with the validators in a single region or spread over all the regions.
+ *
+ * The validators are the miners of the topology, fully meshed, and the other nodes follow the committed blocks.
+ * Every engine, validator count and region layout is simulated in its own process, and prints one line of the report:
+ * the mean latency of the links between the validators from the region latencies of BlockchainTopologyHelper, the
+ * blocks committed, their mean commit latency over the validators, the committed blocks per minute, and the consensus
+ * messages, Bytes and signature verifications of all the validators per committed block. With --crashLeader the first
+ * leader, validator 0, crashes after a third of the run, so the report also shows the cost of a view change or an
+ * election.
+ *
+ * Usage : ./waf --run "blockchain_consensus --validators=4,16,32,64,100 --noBlocks=200 --blockIntervalSeconds=2 --crashLeader=1"
+ *         ./waf --run "blockchain_consensus --engines=HOTSTUFF,PBFT --layouts=single,global --noBlocks=400 --blockIntervalSeconds=0.5"
+ */
+#include <algorithm>
+#include <sstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+void RunScenario(enum MinerType engine, int noValidators, bool global, int noFollowers, int targetNumberOfBlocks,
+                double averageBlockGenIntervalSeconds, double viewChangeTimeout, bool crashLeader);
+
+NS_LOG_COMPONENT_DEFINE("Blockchain_consensus");
+
+int main(int argc, char *argv[])
+{
+    const enum MinerType allEngines[] = {PBFT_MINER, RAFT_MINER, HOTSTUFF_MINER};
+    std::string engineNames = "PBFT,RAFT,HOTSTUFF";
+    std::string validators = "4,16,32,64,100";
+    std::string layouts = "global";
+    int noFollowers = 16;
+    int targetNumberOfBlocks = 200;
+    double averageBlockGenIntervalSeconds = 2;
+    double viewChangeTimeout = 2;
+    bool crashLeader = false;
+    std::vector<enum MinerType> engines;
+    std::vector<int> validatorCounts;
+    std::vector<bool> globalLayouts;
+
+    CommandLine cmd;
+    cmd.AddValue("engines", "The comma separated consensus engines : PBFT, RAFT or HOTSTUFF", engineNames);
+    cmd.AddValue("validators", "The comma separated validator counts", validators);
+    cmd.AddValue("layouts", "The comma separated region layouts of the validators : single or global", layouts);
+    cmd.AddValue("nodes", "The number of nodes following the validators", noFollowers);
+    cmd.AddValue("noBlocks", "The number of block intervals the simulation lasts", targetNumberOfBlocks);
+    cmd.AddValue("blockIntervalSeconds", "The shortest interval between two proposals in seconds", averageBlockGenIntervalSeconds);
+    cmd.AddValue("viewChangeTimeout", "The base timeout of the view changes and elections in seconds", viewChangeTimeout);
+    cmd.AddValue("crashLeader", "Crash the first leader after a third of the run", crashLeader);
+    cmd.Parse(argc, argv);
+
+    std::istringstream names(engineNames);
+    std::istringstream counts(validators);
+    std::istringstream layoutNames(layouts);
+    std::string item;
+
+    while(std::getline(names, item, ','))
+    {
+        unsigned int i = 0;
+
+        while(i < sizeof(allEngines) / sizeof(allEngines[0]) && item != getMinerType(allEngines[i]))
+            i++;
+
+        if(i == sizeof(allEngines) / sizeof(allEngines[0]))
+        {
+            std::cout << "Unknown engine " << item << ", use PBFT, RAFT or HOTSTUFF\n";
+            return 1;
+        }
+        engines.push_back(allEngines[i]);
+    }
+
+    while(std::getline(counts, item, ','))
+        validatorCounts.push_back(atoi(item.c_str()));
+
+    while(std::getline(layoutNames, item, ','))
+    {
+        if(item != "single" && item != "global")
+        {
+            std::cout << "Unknown layout " << item << ", use single or global\n";
+            return 1;
+        }
+        globalLayouts.push_back(item == "global");
+    }
+
+    if(engines.empty() || validatorCounts.empty() || *std::min_element(validatorCounts.begin(), validatorCounts.end()) < 1
+        || globalLayouts.empty() || noFollowers < 1 || averageBlockGenIntervalSeconds <= 0 || viewChangeTimeout <= 0)
+    {
+        std::cout << "Give at least one engine, one validator, one layout, one follower, a positive block interval and a positive timeout\n";
+        return 1;
+    }
+
+    std::cout << "engine validators layout meanValidatorLatency(ms) committedBlocks meanCommitLatency(s) blocks/min "
+              << "messages/block Bytes/block signatures/block viewChanges\n";
+
+    for(unsigned int l = 0; l < globalLayouts.size(); l++)
+    {
+        for(unsigned int v = 0; v < validatorCounts.size(); v++)
+        {
+            for(unsigned int i = 0; i < engines.size(); i++)
+            {
+                /*
+                 * The simulator is process-wide, every run gets a fresh process
+                 */
+                pid_t pid = fork();
+
+                if(pid == 0)
+                {
+                    RunScenario(engines[i], validatorCounts[v], globalLayouts[l], noFollowers, targetNumberOfBlocks,
+                                averageBlockGenIntervalSeconds, viewChangeTimeout, crashLeader);
+                    std::cout.flush();
+                    _exit(0);
+                }
+                else if(pid < 0)
+                {
+                    std::cout << "Cannot start the run of " << getMinerType(engines[i]) << " with " << validatorCounts[v] << " validators\n";
+                    return 1;
+                }
+
+                waitpid(pid, NULL, 0);
+            }
+        }
+    }
+
+    return 0;
+}
+
+void RunScenario(enum MinerType engine, int noValidators, bool global, int noFollowers, int targetNumberOfBlocks,
+                double averageBlockGenIntervalSeconds, double viewChangeTimeout, bool crashLeader)
+{
+    const uint16_t blockchainPort = 8333;
+    const enum BlockchainRegion regions[] = {NORTH_AMERICA, EUROPE, KOREA, JAPAN, SOUTH_AMERICA, AUSTRALIA};
+    int totalNoNodes = noValidators + noFollowers;
+    enum BlockchainRegion *minersRegions = new enum BlockchainRegion[noValidators];
+    nodeStatistics *stats = new nodeStatistics[totalNoNodes];
+    double stop = targetNumberOfBlocks * averageBlockGenIntervalSeconds / 60;
+
+    std::map<uint32_t, std::vector<Ipv4Address>> nodesConnections;
+    std::map<uint32_t, std::map<Ipv4Address, double>> peersDownloadSpeeds;
+    std::map<uint32_t, std::map<Ipv4Address, double>> peersUploadSpeeds;
+    std::map<uint32_t, nodeInternetSpeed> nodesInternetSpeeds;
+    std::vector<uint32_t> miners;
+
+    Time::SetResolution(Time::NS);
+
+    for(int i = 0; i < noValidators; i++)
+        minersRegions[i] = global ? regions[i % (sizeof(regions) / sizeof(regions[0]))] : regions[0];
+
+    BlockchainTopologyHelper blockchainTopologyHelper (1, totalNoNodes, noValidators, minersRegions,
+                                                        ETHEREUM, -1, -1, 5, 0);
+
+    /*
+     * The validators are fully meshed, so their links follow the region latencies
+     */
+    double meanValidatorLatency = 0;
+    int validatorLinks = 0;
+
+    for(int i = 0; i < noValidators; i++)
+    {
+        for(int j = i + 1; j < noValidators; j++)
+        {
+            meanValidatorLatency += blockchainTopologyHelper.GetRegionLatency(minersRegions[i], minersRegions[j]);
+            validatorLinks++;
+        }
+    }
+
+    if(validatorLinks > 0)
+        meanValidatorLatency /= validatorLinks;
+
+    InternetStackHelper stack;
+    blockchainTopologyHelper.InstallStack(stack);
+    blockchainTopologyHelper.AssignIpv4Addresses(Ipv4AddressHelperCustom("1.0.0.0", "255.255.255.0", false));
+    nodesConnections = blockchainTopologyHelper.GetNodesConnectionsIps();
+    miners = blockchainTopologyHelper.GetMiners();
+    peersUploadSpeeds = blockchainTopologyHelper.GetPeersUploadSpeeds();
+    peersDownloadSpeeds = blockchainTopologyHelper.GetPeersDownloadSpeeds();
+    nodesInternetSpeeds = blockchainTopologyHelper.GetNodesInternetSpeeds();
+
+    BlockchainMinerHelper blockchainMinerHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), blockchainPort),
+                                                nodesConnections[miners[0]], noValidators, peersDownloadSpeeds[0], peersUploadSpeeds[0],
+                                                nodesInternetSpeeds[0], stats, 1.0 / noValidators, averageBlockGenIntervalSeconds);
+    ApplicationContainer blockchainValidators;
+
+    /*
+     * The miner type comes first, the validator attributes only exist for the validators
+     */
+    blockchainMinerHelper.SetMinerType(engine);
+    blockchainMinerHelper.SetAttribute("ViewChangeTimeout", DoubleValue(viewChangeTimeout));
+
+    for(unsigned int i = 0; i < miners.size(); i++)
+    {
+        blockchainMinerHelper.SetAttribute("ValidatorId", UintegerValue(i));
+        blockchainMinerHelper.SetAttribute("CrashTime", DoubleValue(crashLeader && i == 0 ? stop * 60 / 3 : -1));
+        blockchainMinerHelper.SetPeersAddresses(nodesConnections[miners[i]]);
+        blockchainMinerHelper.SetPeersDownloadSpeeds(peersDownloadSpeeds[miners[i]]);
+        blockchainMinerHelper.SetPeersUploadSpeeds(peersUploadSpeeds[miners[i]]);
+        blockchainMinerHelper.SetNodeInternetSpeeds(nodesInternetSpeeds[miners[i]]);
+        blockchainMinerHelper.SetNodeStats(&stats[miners[i]]);
+
+        blockchainValidators.Add(blockchainMinerHelper.Install(blockchainTopologyHelper.GetNode(miners[i])));
+    }
+
+    blockchainValidators.Start(Seconds(0));
+    blockchainValidators.Stop(Minutes(stop));
+
+    BlockchainNodeHelper blockchainNodeHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), blockchainPort),
+                                                nodesConnections[0], peersDownloadSpeeds[0], peersUploadSpeeds[0], nodesInternetSpeeds[0], stats);
+    ApplicationContainer blockchainNodes;
+
+    for(auto &node : nodesConnections)
+    {
+        if(std::find(miners.begin(), miners.end(), node.first) == miners.end())
+        {
+            blockchainNodeHelper.SetPeersAddresses(node.second);
+            blockchainNodeHelper.SetPeersDownloadSpeeds(peersDownloadSpeeds[node.first]);
+            blockchainNodeHelper.SetPeersUploadSpeeds(peersUploadSpeeds[node.first]);
+            blockchainNodeHelper.SetNodeInternetSpeeds(nodesInternetSpeeds[node.first]);
+            blockchainNodeHelper.SetNodeStats(&stats[node.first]);
+
+            blockchainNodes.Add(blockchainNodeHelper.Install(blockchainTopologyHelper.GetNode(node.first)));
+        }
+    }
+
+    blockchainNodes.Start(Seconds(0));
+    blockchainNodes.Stop(Minutes(stop));
+
+    Simulator::Stop(Minutes(stop + 0.1));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    /*
+     * The costs are summed over the validators, the latency averaged over the ones that committed
+     */
+    int committedBlocks = 0;
+    int committingValidators = 0;
+    int viewChanges = 0;
+    double meanCommitLatency = 0;
+    long messages = 0;
+    long sentBytes = 0;
+    long signatures = 0;
+
+    for(unsigned int i = 0; i < miners.size(); i++)
+    {
+        nodeStatistics &validator = stats[miners[i]];
+
+        committedBlocks = std::max(committedBlocks, validator.consensusCommittedBlocks);
+        viewChanges = std::max(viewChanges, validator.viewChanges);
+        messages += validator.consensusMessagesSent;
+        sentBytes += validator.consensusSentBytes;
+        signatures += validator.consensusSignaturesVerified;
+
+        if(validator.consensusCommittedBlocks > 0)
+        {
+            meanCommitLatency = (meanCommitLatency*committingValidators + validator.meanCommitLatency) / (committingValidators + 1);
+            committingValidators++;
+        }
+    }
+
+    int perBlock = std::max(1, committedBlocks);
+
+    std::cout << getMinerType(engine) << " " << noValidators << " " << (global ? "global" : "single") << " " << meanValidatorLatency << " "
+                << committedBlocks << " " << meanCommitLatency << " " << committedBlocks / stop << " "
+                << static_cast<double>(messages) / perBlock << " " << static_cast<double>(sentBytes) / perBlock << " "
+                << static_cast<double>(signatures) / perBlock << " " << viewChanges << "\n";
+
+    delete[] minersRegions;
+    delete[] stats;
+}
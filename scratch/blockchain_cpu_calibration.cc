@@ -0,0 +1,443 @@
+/*
+ * Measures the CPU costs used by BlockchainCpuModel on the host and writes them as a cost table:
+ *   - the rapidjson codec cost of every message type, fitted as base + perByte * size
+ *   - the SHA-256 cost per byte, used for the block validation cost per byte
+ *   - the signature verification cost per transaction
+ *   - the Reed-Solomon multiply-add cost per byte of the erasure-coded block dissemination
+ *
+ * There is no elliptic curve library in the tree, so a secp256k1 signature verification is estimated
+ * from the measured cost of a 256-bit field multiplication modulo the secp256k1 prime.
+ * A verification with Shamir's trick takes about 256 doublings, 128 additions and one inversion,
+ * i.e. ~3800 field multiplications. Use --signatureSeconds to give a measured value instead.
+ * Combining a share of a threshold signature is one scalar multiplication by its Lagrange coefficient, ~3200 field
+ * multiplications.
+ *
+ * Usage : ./waf --run "blockchain_cpu_calibration --output=cpu-cost-table.txt"
+ *         then set BlockchainNode::CpuCostTable (and BlockchainMiner's) to the generated file.
+ */
+#include <fstream>
+#include <time.h>
+#include <sys/time.h>
+#include <stdint.h>
+#include <string.h>
+#include "ns3/core-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+double get_wall_time();
+void CreateMessage(rapidjson::Document &d, enum Messages message, int entries);
+double MeasureCodec(enum Messages message, int entries, int iterations, int *sizeBytes);
+double MeasureSha256PerByte(int iterations);
+double MeasureFieldMultiplication(int iterations);
+double MeasureErasureCoding(int iterations);
+void Sha256(const uint8_t *data, size_t length, uint8_t digest[32]);
+
+NS_LOG_COMPONENT_DEFINE("Blockchain_cpu_calibration");
+
+int main(int argc, char *argv[])
+{
+    std::string output = "cpu-cost-table.txt";
+    int iterations = 2000;
+    double signatureSeconds = -1;
+    const int fieldMultiplicationsPerVerification = 3800;
+    const int fieldMultiplicationsPerShare = 3200;
+    const enum Messages messages[] = {INV, REQUEST_TRANS, GET_HEADERS, HEADERS, GET_DATA, BLOCK, REPLY_TRANS, MSG_TRANS, RESULT_TRANS};
+
+    CommandLine cmd;
+    cmd.AddValue("output", "The generated cost table", output);
+    cmd.AddValue("iterations", "The repetitions of every measurement", iterations);
+    cmd.AddValue("signatureSeconds", "A measured signature verification time, instead of the estimate", signatureSeconds);
+    cmd.Parse(argc, argv);
+
+    std::ofstream costTable(output.c_str());
+
+    if(!costTable.is_open())
+    {
+        std::cout << "Cannot write " << output << "\n";
+        return 1;
+    }
+
+    costTable << "# BlockchainCpuModel cost table, generated by blockchain_cpu_calibration\n";
+    costTable.precision(6);
+    costTable << std::scientific;
+
+    for(unsigned int i = 0; i < sizeof(messages)/sizeof(messages[0]); i++)
+    {
+        int smallSize;
+        int largeSize;
+        double smallTime = MeasureCodec(messages[i], 1, iterations, &smallSize);
+        double largeTime = MeasureCodec(messages[i], 64, iterations / 8 + 1, &largeSize);
+        double perByte = std::max(0.0, (largeTime - smallTime) / (largeSize - smallSize));
+        double base = std::max(0.0, smallTime - perByte * smallSize);
+
+        std::cout << getMessageName(messages[i]) << " : " << smallSize << " Bytes in " << smallTime << "s, "
+                    << largeSize << " Bytes in " << largeTime << "s\n";
+        costTable << "message " << getMessageName(messages[i]) << " " << base << " " << perByte << "\n";
+    }
+
+    double sha256PerByte = MeasureSha256PerByte(iterations);
+    double fieldMultiplication = MeasureFieldMultiplication(iterations * 100);
+    double erasureCodingPerByte = MeasureErasureCoding(iterations);
+
+    if(signatureSeconds < 0)
+    {
+        signatureSeconds = fieldMultiplication * fieldMultiplicationsPerVerification;
+    }
+
+    std::cout << "SHA-256 : " << sha256PerByte << "s/Byte\n";
+    std::cout << "Field multiplication : " << fieldMultiplication << "s\n";
+    std::cout << "Signature verification : " << signatureSeconds << "s\n";
+    std::cout << "Signature share aggregation : " << fieldMultiplication * fieldMultiplicationsPerShare << "s\n";
+    std::cout << "Reed-Solomon multiply-add (" << BlockchainErasureCode::GetKernelName() << ") : " << erasureCodingPerByte << "s/Byte\n";
+
+    /*
+     * A block is hashed twice (transaction ids and merkle tree)
+     */
+    costTable << "transactionValidation " << signatureSeconds << "\n";
+    costTable << "blockValidationPerByte " << 2 * sha256PerByte << "\n";
+    costTable << "erasureCodingPerByte " << erasureCodingPerByte << "\n";
+    costTable << "signatureVerification " << signatureSeconds << "\n";
+    costTable << "signatureAggregation " << fieldMultiplication * fieldMultiplicationsPerShare << "\n";
+
+    std::cout << "The cost table was written to " << output << "\n";
+    return 0;
+}
+
+double get_wall_time()
+{
+    struct timeval time;
+    if(gettimeofday(&time, NULL))
+    {
+        return 0;
+    }
+    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+}
+
+void CreateMessage(rapidjson::Document &d, enum Messages message, int entries)
+{
+    rapidjson::Value value;
+    rapidjson::Value array(rapidjson::kArrayType);
+
+    d.SetObject();
+    value = message;
+    d.AddMember("message", value, d.GetAllocator());
+
+    for(int i = 0; i < entries; i++)
+    {
+        std::ostringstream  stringStream;
+        stringStream << 1000 + i << "/" << i % 16;
+        std::string         blockHash = stringStream.str();
+
+        switch(message)
+        {
+            case INV:
+            case GET_HEADERS:
+            case GET_DATA:
+            {
+                value.SetString(blockHash.c_str(), blockHash.size(), d.GetAllocator());
+                array.PushBack(value, d.GetAllocator());
+                break;
+            }
+            case HEADERS:
+            case BLOCK:
+            {
+                rapidjson::Value blockInfo(rapidjson::kObjectType);
+                rapidjson::Value transactions(rapidjson::kArrayType);
+
+                value = 1000 + i;
+                blockInfo.AddMember("height", value, d.GetAllocator());
+                value = i % 16;
+                blockInfo.AddMember("minerId", value, d.GetAllocator());
+                value = rand();
+                blockInfo.AddMember("nonce", value, d.GetAllocator());
+                value = (i + 1) % 16;
+                blockInfo.AddMember("parentBlockMinerId", value, d.GetAllocator());
+                value = 23000;
+                blockInfo.AddMember("size", value, d.GetAllocator());
+                value = 1.5 * i;
+                blockInfo.AddMember("timeStamp", value, d.GetAllocator());
+                value = 1.5 * i + 0.2;
+                blockInfo.AddMember("timeReceived", value, d.GetAllocator());
+
+                if(message == BLOCK)
+                {
+                    for(int j = 0; j < 10; j++)
+                    {
+                        rapidjson::Value transInfo(rapidjson::kObjectType);
+                        value = j;
+                        transInfo.AddMember("nodeId", value, d.GetAllocator());
+                        value = i * 10 + j;
+                        transInfo.AddMember("transId", value, d.GetAllocator());
+                        value = 0.5 * i;
+                        transInfo.AddMember("timestamp", value, d.GetAllocator());
+                        transactions.PushBack(transInfo, d.GetAllocator());
+                    }
+                    blockInfo.AddMember("transactions", transactions, d.GetAllocator());
+                }
+
+                array.PushBack(blockInfo, d.GetAllocator());
+                break;
+            }
+            default:
+            {
+                rapidjson::Value transInfo(rapidjson::kObjectType);
+                value = i % 16;
+                transInfo.AddMember("nodeId", value, d.GetAllocator());
+                value = i;
+                transInfo.AddMember("transId", value, d.GetAllocator());
+                value = 0.5 * i;
+                transInfo.AddMember("timestamp", value, d.GetAllocator());
+                value = false;
+                transInfo.AddMember("validation", value, d.GetAllocator());
+                value = i % 6;
+                transInfo.AddMember("execution", value, d.GetAllocator());
+                array.PushBack(transInfo, d.GetAllocator());
+                break;
+            }
+        }
+    }
+
+    switch(message)
+    {
+        case INV:
+            d.AddMember("inv", array, d.GetAllocator());
+            break;
+        case GET_HEADERS:
+        case GET_DATA:
+        case HEADERS:
+        case BLOCK:
+            d.AddMember("blocks", array, d.GetAllocator());
+            break;
+        default:
+            d.AddMember("transactions", array, d.GetAllocator());
+            break;
+    }
+}
+
+/*
+ * Average time to parse a message, read every field and encode the response, as BlockchainNode does
+ */
+double MeasureCodec(enum Messages message, int entries, int iterations, int *sizeBytes)
+{
+    rapidjson::Document d;
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+    CreateMessage(d, message, entries);
+    d.Accept(writer);
+
+    std::string packet = buffer.GetString();
+    *sizeBytes = packet.size();
+
+    double start = get_wall_time();
+    long checksum = 0;
+
+    for(int i = 0; i < iterations; i++)
+    {
+        rapidjson::Document parsed;
+        rapidjson::StringBuffer response;
+        rapidjson::Writer<rapidjson::StringBuffer> responseWriter(response);
+
+        parsed.Parse(packet.c_str());
+        checksum += parsed["message"].GetInt();
+        parsed.Accept(responseWriter);
+        checksum += response.GetSize();
+    }
+
+    double elapsed = get_wall_time() - start;
+    NS_LOG_INFO("checksum " << checksum);
+
+    return elapsed / iterations;
+}
+
+double MeasureSha256PerByte(int iterations)
+{
+    const size_t    length = 64 * 1024;
+    uint8_t         *data = new uint8_t[length];
+    uint8_t         digest[32];
+    double          start;
+    double          elapsed;
+
+    for(size_t i = 0; i < length; i++)
+    {
+        data[i] = i * 31;
+    }
+
+    start = get_wall_time();
+    for(int i = 0; i < iterations / 10 + 1; i++)
+    {
+        Sha256(data, length, digest);
+        data[0] = digest[0];
+    }
+    elapsed = get_wall_time() - start;
+
+    delete[] data;
+    return elapsed / ((iterations / 10 + 1) * static_cast<double>(length));
+}
+
+/*
+ * 256-bit multiplication modulo p = 2^256 - 0x1000003D1 (secp256k1), with 4 64-bit limbs
+ */
+static void FieldMultiply(const uint64_t a[4], const uint64_t b[4], uint64_t r[4])
+{
+    typedef unsigned __int128 uint128_t;
+    const uint64_t  c = 0x1000003D1ULL;
+    uint64_t        t[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    uint128_t       carry;
+
+    for(int i = 0; i < 4; i++)
+    {
+        carry = 0;
+        for(int j = 0; j < 4; j++)
+        {
+            carry += static_cast<uint128_t>(a[i]) * b[j] + t[i + j];
+            t[i + j] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        t[i + 4] = static_cast<uint64_t>(carry);
+    }
+
+    /*
+     * 2^256 = c (mod p), so the high half is folded twice
+     */
+    carry = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        carry += static_cast<uint128_t>(t[i + 4]) * c + t[i];
+        r[i] = static_cast<uint64_t>(carry);
+        carry >>= 64;
+    }
+
+    uint128_t fold = carry * c;
+    for(int i = 0; i < 4 && fold; i++)
+    {
+        fold += r[i];
+        r[i] = static_cast<uint64_t>(fold);
+        fold >>= 64;
+    }
+}
+
+double MeasureFieldMultiplication(int iterations)
+{
+    uint64_t a[4] = {0x59F2815B16F81798ULL, 0x029BFCDB2DCE28D9ULL, 0x55A06295CE870B07ULL, 0x79BE667EF9DCBBACULL};
+    uint64_t b[4] = {0x9C47D08FFB10D4B8ULL, 0xFD17B448A6855419ULL, 0x5DA4FBFC0E1108A8ULL, 0x483ADA7726A3C465ULL};
+    double start = get_wall_time();
+
+    for(int i = 0; i < iterations; i++)
+    {
+        FieldMultiply(a, b, a);
+    }
+
+    double elapsed = get_wall_time() - start;
+    NS_LOG_INFO("checksum " << a[0]);
+
+    return elapsed / iterations;
+}
+
+/*
+ * Time of the GF(2^8) multiply-add of one byte, measured by encoding 16 data chunks of 16 KBytes
+ * into 16 parity chunks
+ */
+double MeasureErasureCoding(int iterations)
+{
+    const int                           chunks = 16;
+    const size_t                        chunkSize = 16 * 1024;
+    BlockchainErasureCode               code;
+    std::vector<std::vector<uint8_t>>   shards(chunks, std::vector<uint8_t>(chunkSize));
+    double                              start;
+    double                              elapsed;
+
+    code.SetShards(chunks, chunks);
+
+    for(int i = 0; i < chunks; i++)
+    {
+        for(size_t j = 0; j < chunkSize; j++)
+        {
+            shards[i][j] = i * 31 + j * 7;
+        }
+    }
+
+    start = get_wall_time();
+    for(int i = 0; i < iterations / 100 + 1; i++)
+    {
+        code.Encode(shards);
+        shards[0][0] = shards[chunks][0];
+        shards.resize(chunks);
+    }
+    elapsed = get_wall_time() - start;
+
+    return elapsed / ((iterations / 100 + 1) * static_cast<double>(chunks) * chunks * chunkSize);
+}
+
+void Sha256(const uint8_t *data, size_t length, uint8_t digest[32])
+{
+    static const uint32_t k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+    uint32_t h[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    size_t paddedLength = ((length + 9 + 63) / 64) * 64;
+    uint8_t block[64];
+
+    #define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+    for(size_t offset = 0; offset < paddedLength; offset += 64)
+    {
+        uint32_t w[64];
+
+        for(int i = 0; i < 64; i++)
+        {
+            size_t index = offset + i;
+
+            if(index < length)
+                block[i] = data[index];
+            else if(index == length)
+                block[i] = 0x80;
+            else if(index >= paddedLength - 8)
+                block[i] = static_cast<uint8_t>((static_cast<uint64_t>(length) * 8) >> (8 * (paddedLength - 1 - index)));
+            else
+                block[i] = 0;
+        }
+
+        for(int i = 0; i < 16; i++)
+        {
+            w[i] = (static_cast<uint32_t>(block[4*i]) << 24) | (static_cast<uint32_t>(block[4*i + 1]) << 16)
+                    | (static_cast<uint32_t>(block[4*i + 2]) << 8) | static_cast<uint32_t>(block[4*i + 3]);
+        }
+        for(int i = 16; i < 64; i++)
+        {
+            uint32_t s0 = ROTR(w[i-15], 7) ^ ROTR(w[i-15], 18) ^ (w[i-15] >> 3);
+            uint32_t s1 = ROTR(w[i-2], 17) ^ ROTR(w[i-2], 19) ^ (w[i-2] >> 10);
+            w[i] = w[i-16] + s0 + w[i-7] + s1;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+
+        for(int i = 0; i < 64; i++)
+        {
+            uint32_t t1 = hh + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            hh = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+    }
+
+    #undef ROTR
+
+    for(int i = 0; i < 8; i++)
+    {
+        digest[4*i] = h[i] >> 24;
+        digest[4*i + 1] = h[i] >> 16;
+        digest[4*i + 2] = h[i] >> 8;
+        digest[4*i + 3] = h[i];
+    }
+}
@@ -0,0 +1,214 @@
+/*
+ * Measures how the difficulty adjustments hold the block interval when the hash rate of the network changes.
+ *
+ * Every miner multiplies its hash rate by --hashRateFactor after --changeBlocks target intervals, so without an
+ * adjustment the blocks come that much faster or slower for the rest of the run. Every adjustment is simulated in
+ * its own process, and prints one line of the report, seen by a node that does not mine: the blocks of the main
+ * chain, their mean interval, the steady interval and block rate (the second half of the main chain, after the change
+ * when it comes early enough), the difficulty at the tip, and the stale rate.
+ *
+ * The proof-of-work blocks come from BlockchainMiningOracle, so the scenario uses Ethereum's block intervals, with
+ * the longest chain rule. With --trace=prefix, the difficulty trajectory of the main chain of the first miner is
+ * written to prefix-<adjustment>.txt.
+ *
+ * Usage : ./waf --run "blockchain_difficulty --noBlocks=4000 --hashRateFactor=4 --retargetInterval=200 --trace=difficulty"
+ */
+#include <algorithm>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+void RunScenario(enum DifficultyAdjustment adjustment, int totalNoNodes, int noMiners, int targetNumberOfBlocks,
+                double averageBlockGenIntervalSeconds, int changeBlocks, double hashRateFactor, int retargetInterval,
+                const std::string &trace);
+void ScaleHashRates(ApplicationContainer miners, double factor);
+
+NS_LOG_COMPONENT_DEFINE("Blockchain_difficulty");
+
+int main(int argc, char *argv[])
+{
+    const enum DifficultyAdjustment adjustments[] = {FIXED_DIFFICULTY, EPOCH_RETARGET, PER_BLOCK_ADJUSTMENT};
+    int totalNoNodes = 32;
+    int noMiners = 8;
+    int targetNumberOfBlocks = 4000;
+    double averageBlockGenIntervalSeconds = 15;
+    int changeBlocks = 1000;
+    double hashRateFactor = 4;
+    int retargetInterval = 200;
+    std::string trace = "";
+
+    CommandLine cmd;
+    cmd.AddValue("nodes", "The total number of nodes in the network", totalNoNodes);
+    cmd.AddValue("miners", "The total number of miners in the network", noMiners);
+    cmd.AddValue("noBlocks", "The number of target block intervals the simulation lasts", targetNumberOfBlocks);
+    cmd.AddValue("blockIntervalSeconds", "The target block interval in seconds", averageBlockGenIntervalSeconds);
+    cmd.AddValue("changeBlocks", "The number of target block intervals before the hash rate changes", changeBlocks);
+    cmd.AddValue("hashRateFactor", "The factor the hash rate of every miner is multiplied by", hashRateFactor);
+    cmd.AddValue("retargetInterval", "The blocks of an epoch of EPOCH_RETARGET", retargetInterval);
+    cmd.AddValue("trace", "The prefix of the difficulty trajectory files, none if empty", trace);
+    cmd.Parse(argc, argv);
+
+    if(noMiners < 1 || totalNoNodes <= noMiners || hashRateFactor <= 0 || retargetInterval < 2)
+    {
+        std::cout << "Give at least one miner, one node that does not mine, a positive factor and epochs of 2 blocks\n";
+        return 1;
+    }
+
+    std::cout << "adjustment mainChainBlocks meanInterval(s) steadyInterval(s) steadyBlocks/min difficulty staleRate(%)\n";
+
+    for(unsigned int i = 0; i < sizeof(adjustments) / sizeof(adjustments[0]); i++)
+    {
+        /*
+         * The simulator and the mining oracle are process-wide, every run gets a fresh process
+         */
+        pid_t pid = fork();
+
+        if(pid == 0)
+        {
+            RunScenario(adjustments[i], totalNoNodes, noMiners, targetNumberOfBlocks, averageBlockGenIntervalSeconds,
+                        changeBlocks, hashRateFactor, retargetInterval, trace);
+            std::cout.flush();
+            _exit(0);
+        }
+        else if(pid < 0)
+        {
+            std::cout << "Cannot start the run of " << getDifficultyAdjustment(adjustments[i]) << "\n";
+            return 1;
+        }
+
+        waitpid(pid, NULL, 0);
+    }
+
+    return 0;
+}
+
+void RunScenario(enum DifficultyAdjustment adjustment, int totalNoNodes, int noMiners, int targetNumberOfBlocks,
+                double averageBlockGenIntervalSeconds, int changeBlocks, double hashRateFactor, int retargetInterval,
+                const std::string &trace)
+{
+    const uint16_t blockchainPort = 8333;
+    const enum BlockchainRegion regions[] = {NORTH_AMERICA, EUROPE, KOREA, JAPAN, SOUTH_AMERICA, AUSTRALIA};
+    double *minersHash = new double[noMiners];
+    enum BlockchainRegion *minersRegions = new enum BlockchainRegion[noMiners];
+    nodeStatistics *stats = new nodeStatistics[totalNoNodes];
+    double stop = targetNumberOfBlocks * averageBlockGenIntervalSeconds / 60;
+    double changeTime = changeBlocks * averageBlockGenIntervalSeconds;
+
+    std::map<uint32_t, std::vector<Ipv4Address>> nodesConnections;
+    std::map<uint32_t, std::map<Ipv4Address, double>> peersDownloadSpeeds;
+    std::map<uint32_t, std::map<Ipv4Address, double>> peersUploadSpeeds;
+    std::map<uint32_t, nodeInternetSpeed> nodesInternetSpeeds;
+    std::vector<uint32_t> miners;
+
+    Time::SetResolution(Time::NS);
+
+    for(int i = 0; i < noMiners; i++)
+    {
+        minersHash[i] = 1.0 / noMiners;
+        minersRegions[i] = regions[i % (sizeof(regions) / sizeof(regions[0]))];
+    }
+
+    BlockchainTopologyHelper blockchainTopologyHelper (1, totalNoNodes, noMiners, minersRegions,
+                                                        ETHEREUM, -1, -1, 5, 0);
+
+    InternetStackHelper stack;
+    blockchainTopologyHelper.InstallStack(stack);
+    blockchainTopologyHelper.AssignIpv4Addresses(Ipv4AddressHelperCustom("1.0.0.0", "255.255.255.0", false));
+    nodesConnections = blockchainTopologyHelper.GetNodesConnectionsIps();
+    miners = blockchainTopologyHelper.GetMiners();
+    peersUploadSpeeds = blockchainTopologyHelper.GetPeersUploadSpeeds();
+    peersDownloadSpeeds = blockchainTopologyHelper.GetPeersDownloadSpeeds();
+    nodesInternetSpeeds = blockchainTopologyHelper.GetNodesInternetSpeeds();
+
+    BlockchainMinerHelper blockchainMinerHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), blockchainPort),
+                                                nodesConnections[miners[0]], noMiners, peersDownloadSpeeds[0], peersUploadSpeeds[0],
+                                                nodesInternetSpeeds[0], stats, minersHash[0], averageBlockGenIntervalSeconds);
+    ApplicationContainer blockchainMiners;
+
+    blockchainMinerHelper.SetAttribute("Cryptocurrency", UintegerValue(ETHEREUM));
+    blockchainMinerHelper.SetAttribute("ForkChoiceRule", UintegerValue(LONGEST_CHAIN));
+    blockchainMinerHelper.SetAttribute("MaxUncles", UintegerValue(0));
+    blockchainMinerHelper.SetAttribute("InvTimeoutMinutes", TimeValue(Minutes(2 * averageBlockGenIntervalSeconds / 60)));
+    blockchainMinerHelper.SetAttribute("DifficultyAdjustment", UintegerValue(adjustment));
+    blockchainMinerHelper.SetAttribute("RetargetInterval", UintegerValue(retargetInterval));
+
+    for(unsigned int i = 0; i < miners.size(); i++)
+    {
+        std::string traceFile = trace.empty() || i > 0 ? "" : trace + "-" + getDifficultyAdjustment(adjustment) + ".txt";
+
+        blockchainMinerHelper.SetAttribute("HashRate", DoubleValue(minersHash[i]));
+        blockchainMinerHelper.SetAttribute("DifficultyTraceFile", StringValue(traceFile));
+        blockchainMinerHelper.SetPeersAddresses(nodesConnections[miners[i]]);
+        blockchainMinerHelper.SetPeersDownloadSpeeds(peersDownloadSpeeds[miners[i]]);
+        blockchainMinerHelper.SetPeersUploadSpeeds(peersUploadSpeeds[miners[i]]);
+        blockchainMinerHelper.SetNodeInternetSpeeds(nodesInternetSpeeds[miners[i]]);
+        blockchainMinerHelper.SetNodeStats(&stats[miners[i]]);
+
+        blockchainMiners.Add(blockchainMinerHelper.Install(blockchainTopologyHelper.GetNode(miners[i])));
+    }
+
+    blockchainMiners.Start(Seconds(0));
+    blockchainMiners.Stop(Minutes(stop));
+
+    BlockchainNodeHelper blockchainNodeHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), blockchainPort),
+                                                nodesConnections[0], peersDownloadSpeeds[0], peersUploadSpeeds[0], nodesInternetSpeeds[0], stats);
+    ApplicationContainer blockchainNodes;
+    int observer = -1;
+
+    blockchainNodeHelper.SetAttribute("ForkChoiceRule", UintegerValue(LONGEST_CHAIN));
+    blockchainNodeHelper.SetAttribute("InvTimeoutMinutes", TimeValue(Minutes(4 * averageBlockGenIntervalSeconds / 60)));
+
+    for(auto &node : nodesConnections)
+    {
+        if(std::find(miners.begin(), miners.end(), node.first) == miners.end())
+        {
+            blockchainNodeHelper.SetPeersAddresses(node.second);
+            blockchainNodeHelper.SetPeersDownloadSpeeds(peersDownloadSpeeds[node.first]);
+            blockchainNodeHelper.SetPeersUploadSpeeds(peersUploadSpeeds[node.first]);
+            blockchainNodeHelper.SetNodeInternetSpeeds(nodesInternetSpeeds[node.first]);
+            blockchainNodeHelper.SetNodeStats(&stats[node.first]);
+
+            blockchainNodes.Add(blockchainNodeHelper.Install(blockchainTopologyHelper.GetNode(node.first)));
+
+            if(observer < 0)
+                observer = node.first;
+        }
+    }
+
+    blockchainNodes.Start(Seconds(0));
+    blockchainNodes.Stop(Minutes(stop));
+
+    Simulator::Schedule(Seconds(changeTime), &ScaleHashRates, blockchainMiners, hashRateFactor);
+
+    Simulator::Stop(Minutes(stop + 0.1));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    nodeStatistics &seen = stats[observer];
+
+    std::cout << getDifficultyAdjustment(adjustment) << " " << seen.totalBlocks - 1 - seen.blocksInForks << " " << seen.mainChainInterval
+                << " " << seen.steadyChainInterval << " " << (seen.steadyChainInterval > 0 ? 60 / seen.steadyChainInterval : 0) << " "
+                << seen.difficulty << " " << (seen.totalBlocks > 1 ? 100. * seen.blocksInForks / (seen.totalBlocks - 1) : 0) << "\n";
+
+    delete[] minersHash;
+    delete[] minersRegions;
+    delete[] stats;
+}
+
+void ScaleHashRates(ApplicationContainer miners, double factor)
+{
+    for(unsigned int i = 0; i < miners.GetN(); i++)
+    {
+        Ptr<BlockchainMiner> miner = DynamicCast<BlockchainMiner>(miners.Get(i));
+
+        miner->SetHashRate(miner->GetHashRate() * factor);
+    }
+
+    NS_LOG_WARN("At time " << Simulator::Now().GetSeconds() << " s the hash rate of every miner was multiplied by " << factor);
+}
@@ -0,0 +1,269 @@
+/*
+ * Measures the revenue share of a strategic miner across a sweep of its hash rate.
+ *
+ * Miner 0 uses each mining strategy in turn (HONEST_MINING as the baseline), the other miners are honest and share
+ * the rest of the hash rate equally. Every (strategy, hash rate) pair is simulated in its own process, and prints
+ * one line of the report: the blocks the miner mined, the ones in the main chain of an honest node, its revenue
+ * share (its share of that main chain), the revenue share over the hash rate, and the stale rate seen by the same
+ * honest node.
+ *
+ * The proof-of-work blocks come from BlockchainMiningOracle, so the scenario uses Ethereum's block intervals,
+ * with the longest chain rule and without uncles unless --ghost or --uncles are given.
+ *
+ * Usage : ./waf --run "blockchain_selfish_mining --hashRates=0.1,0.2,0.3,0.4 --strategies=SELFISH_MINING,STUBBORN_MINING"
+ */
+#include <algorithm>
+#include <sstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+void RunScenario(enum MiningStrategy strategy, double hashRate, int totalNoNodes, int noMiners, int targetNumberOfBlocks,
+                double averageBlockGenIntervalSeconds, bool ghost, bool uncles, int trailStubbornness, double withholdingTime);
+std::vector<double> ParseHashRates(const std::string &hashRates);
+std::vector<enum MiningStrategy> ParseStrategies(const std::string &strategies);
+
+NS_LOG_COMPONENT_DEFINE("Blockchain_selfish_mining");
+
+int main(int argc, char *argv[])
+{
+    std::string hashRates = "0.1,0.2,0.25,0.3,0.35,0.4,0.45";
+    std::string strategies = "HONEST_MINING,SELFISH_MINING,STUBBORN_MINING,WITHHOLDING_MINING";
+    int totalNoNodes = 32;
+    int noMiners = 8;
+    int targetNumberOfBlocks = 500;
+    double averageBlockGenIntervalSeconds = 15;
+    bool ghost = false;
+    bool uncles = false;
+    int trailStubbornness = 0;
+    double withholdingTime = 10;
+
+    CommandLine cmd;
+    cmd.AddValue("hashRates", "The hash rates of the strategic miner, separated by commas", hashRates);
+    cmd.AddValue("strategies", "The mining strategies of the strategic miner, separated by commas", strategies);
+    cmd.AddValue("nodes", "The total number of nodes in the network", totalNoNodes);
+    cmd.AddValue("miners", "The total number of miners in the network", noMiners);
+    cmd.AddValue("noBlocks", "The number of generated blocks", targetNumberOfBlocks);
+    cmd.AddValue("blockIntervalSeconds", "The average block generation interval in seconds", averageBlockGenIntervalSeconds);
+    cmd.AddValue("ghost", "Use the GHOST fork choice rule instead of the longest chain", ghost);
+    cmd.AddValue("uncles", "Let the Ethereum blocks reference uncles", uncles);
+    cmd.AddValue("trail", "The trail stubbornness of STUBBORN_MINING", trailStubbornness);
+    cmd.AddValue("withholdingTime", "The seconds WITHHOLDING_MINING keeps its blocks", withholdingTime);
+    cmd.Parse(argc, argv);
+
+    std::vector<double> sweep = ParseHashRates(hashRates);
+    std::vector<enum MiningStrategy> miningStrategies = ParseStrategies(strategies);
+
+    if(sweep.empty() || miningStrategies.empty() || noMiners < 2 || totalNoNodes < noMiners)
+    {
+        std::cout << "Give at least one hash rate and one strategy, two miners and as many nodes as miners\n";
+        return 1;
+    }
+
+    std::cout << "strategy hashRate minedBlocks mainChainBlocks revenueShare(%) revenueShare/hashRate staleRate(%)\n";
+
+    for(auto strategy = miningStrategies.begin(); strategy != miningStrategies.end(); strategy++)
+    {
+        for(auto hashRate = sweep.begin(); hashRate != sweep.end(); hashRate++)
+        {
+            /*
+             * The simulator and the mining oracle are process-wide, every run gets a fresh process
+             */
+            pid_t pid = fork();
+
+            if(pid == 0)
+            {
+                RunScenario(*strategy, *hashRate, totalNoNodes, noMiners, targetNumberOfBlocks, averageBlockGenIntervalSeconds,
+                            ghost, uncles, trailStubbornness, withholdingTime);
+                std::cout.flush();
+                _exit(0);
+            }
+            else if(pid < 0)
+            {
+                std::cout << "Cannot start the run of " << getMiningStrategy(*strategy) << " with hash rate " << *hashRate << "\n";
+                return 1;
+            }
+
+            waitpid(pid, NULL, 0);
+        }
+    }
+
+    return 0;
+}
+
+void RunScenario(enum MiningStrategy strategy, double hashRate, int totalNoNodes, int noMiners, int targetNumberOfBlocks,
+                double averageBlockGenIntervalSeconds, bool ghost, bool uncles, int trailStubbornness, double withholdingTime)
+{
+    const uint16_t blockchainPort = 8333;
+    const enum BlockchainRegion regions[] = {NORTH_AMERICA, EUROPE, KOREA, JAPAN, SOUTH_AMERICA, AUSTRALIA};
+    double *minersHash = new double[noMiners];
+    enum BlockchainRegion *minersRegions = new enum BlockchainRegion[noMiners];
+    nodeStatistics *stats = new nodeStatistics[totalNoNodes];
+    double stop = targetNumberOfBlocks * averageBlockGenIntervalSeconds / 60;
+    enum ForkChoiceRule forkChoiceRule = ghost ? GHOST : LONGEST_CHAIN;
+
+    std::map<uint32_t, std::vector<Ipv4Address>> nodesConnections;
+    std::map<uint32_t, std::map<Ipv4Address, double>> peersDownloadSpeeds;
+    std::map<uint32_t, std::map<Ipv4Address, double>> peersUploadSpeeds;
+    std::map<uint32_t, nodeInternetSpeed> nodesInternetSpeeds;
+    std::vector<uint32_t> miners;
+
+    Time::SetResolution(Time::NS);
+
+    for(int i = 0; i < noMiners; i++)
+    {
+        minersHash[i] = i == 0 ? hashRate : (1 - hashRate) / (noMiners - 1);
+        minersRegions[i] = regions[i % (sizeof(regions) / sizeof(regions[0]))];
+    }
+
+    BlockchainTopologyHelper blockchainTopologyHelper (1, totalNoNodes, noMiners, minersRegions,
+                                                        ETHEREUM, -1, -1, 5, 0);
+
+    InternetStackHelper stack;
+    blockchainTopologyHelper.InstallStack(stack);
+    blockchainTopologyHelper.AssignIpv4Addresses(Ipv4AddressHelperCustom("1.0.0.0", "255.255.255.0", false));
+    nodesConnections = blockchainTopologyHelper.GetNodesConnectionsIps();
+    miners = blockchainTopologyHelper.GetMiners();
+    peersUploadSpeeds = blockchainTopologyHelper.GetPeersUploadSpeeds();
+    peersDownloadSpeeds = blockchainTopologyHelper.GetPeersDownloadSpeeds();
+    nodesInternetSpeeds = blockchainTopologyHelper.GetNodesInternetSpeeds();
+
+    BlockchainMinerHelper blockchainMinerHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), blockchainPort),
+                                                nodesConnections[miners[0]], noMiners, peersDownloadSpeeds[0], peersUploadSpeeds[0],
+                                                nodesInternetSpeeds[0], stats, minersHash[0], averageBlockGenIntervalSeconds);
+    ApplicationContainer blockchainMiners;
+
+    blockchainMinerHelper.SetAttribute("Cryptocurrency", UintegerValue(ETHEREUM));
+    blockchainMinerHelper.SetAttribute("ForkChoiceRule", UintegerValue(forkChoiceRule));
+    blockchainMinerHelper.SetAttribute("MaxUncles", UintegerValue(uncles ? 2 : 0));
+    blockchainMinerHelper.SetAttribute("InvTimeoutMinutes", TimeValue(Minutes(2 * averageBlockGenIntervalSeconds / 60)));
+    blockchainMinerHelper.SetAttribute("TrailStubbornness", UintegerValue(trailStubbornness));
+    blockchainMinerHelper.SetAttribute("WithholdingTime", DoubleValue(withholdingTime));
+
+    for(unsigned int i = 0; i < miners.size(); i++)
+    {
+        blockchainMinerHelper.SetAttribute("HashRate", DoubleValue(minersHash[i]));
+        blockchainMinerHelper.SetAttribute("MiningStrategy", UintegerValue(i == 0 ? strategy : HONEST_MINING));
+        blockchainMinerHelper.SetPeersAddresses(nodesConnections[miners[i]]);
+        blockchainMinerHelper.SetPeersDownloadSpeeds(peersDownloadSpeeds[miners[i]]);
+        blockchainMinerHelper.SetPeersUploadSpeeds(peersUploadSpeeds[miners[i]]);
+        blockchainMinerHelper.SetNodeInternetSpeeds(nodesInternetSpeeds[miners[i]]);
+        blockchainMinerHelper.SetNodeStats(&stats[miners[i]]);
+
+        blockchainMiners.Add(blockchainMinerHelper.Install(blockchainTopologyHelper.GetNode(miners[i])));
+    }
+
+    blockchainMiners.Start(Seconds(0));
+    blockchainMiners.Stop(Minutes(stop));
+
+    BlockchainNodeHelper blockchainNodeHelper("ns3::TcpSocketFactory", InetSocketAddress(Ipv4Address::GetAny(), blockchainPort),
+                                                nodesConnections[0], peersDownloadSpeeds[0], peersUploadSpeeds[0], nodesInternetSpeeds[0], stats);
+    ApplicationContainer blockchainNodes;
+    int honestNode = -1;
+    Ptr<BlockchainNode> observerApp = DynamicCast<BlockchainNode>(blockchainMiners.Get(1));
+
+    blockchainNodeHelper.SetAttribute("ForkChoiceRule", UintegerValue(forkChoiceRule));
+    blockchainNodeHelper.SetAttribute("InvTimeoutMinutes", TimeValue(Minutes(4 * averageBlockGenIntervalSeconds / 60)));
+
+    for(auto &node : nodesConnections)
+    {
+        if(std::find(miners.begin(), miners.end(), node.first) == miners.end())
+        {
+            blockchainNodeHelper.SetPeersAddresses(node.second);
+            blockchainNodeHelper.SetPeersDownloadSpeeds(peersDownloadSpeeds[node.first]);
+            blockchainNodeHelper.SetPeersUploadSpeeds(peersUploadSpeeds[node.first]);
+            blockchainNodeHelper.SetNodeInternetSpeeds(nodesInternetSpeeds[node.first]);
+            blockchainNodeHelper.SetNodeStats(&stats[node.first]);
+
+            blockchainNodes.Add(blockchainNodeHelper.Install(blockchainTopologyHelper.GetNode(node.first)));
+
+            if(honestNode < 0)
+            {
+                honestNode = node.first;
+                observerApp = DynamicCast<BlockchainNode>(blockchainNodes.Get(blockchainNodes.GetN() - 1));
+            }
+        }
+    }
+
+    blockchainNodes.Start(Seconds(0));
+    blockchainNodes.Stop(Minutes(stop));
+
+    Simulator::Stop(Minutes(stop + 0.1));
+    Simulator::Run();
+
+    /*
+     * The main chain is the one of an honest node, or of an honest miner without plain nodes. Both the blocks of
+     * the strategic miner and the length of the chain are counted in it, the blocks the strategic miner kept
+     * private until the end never reached it.
+     */
+    nodeStatistics &attacker = stats[miners[0]];
+    nodeStatistics &observer = stats[honestNode >= 0 ? honestNode : miners[1]];
+    int attackerBlocks = observerApp->GetBlockchain().GetMinedBlocksInMainChain(miners[0]);
+    int mainChainBlocks = std::max(1, observer.totalBlocks - 1 - observer.blocksInForks);
+    double revenueShare = 100. * attackerBlocks / mainChainBlocks;
+
+    Simulator::Destroy();
+
+    std::cout << getMiningStrategy(strategy) << " " << hashRate << " " << attacker.minerGeneratedBlocks << " "
+                << attackerBlocks << " " << revenueShare << " " << revenueShare / (100 * hashRate) << " "
+                << (observer.totalBlocks > 1 ? 100. * observer.blocksInForks / (observer.totalBlocks - 1) : 0) << "\n";
+
+    if(strategy != HONEST_MINING)
+    {
+        std::cout << "    withheld " << attacker.minerWithheldBlocks << " blocks, abandoned " << attacker.minerAbandonedBlocks << "\n";
+    }
+
+    delete[] minersHash;
+    delete[] minersRegions;
+    delete[] stats;
+}
+
+std::vector<double> ParseHashRates(const std::string &hashRates)
+{
+    std::vector<double> sweep;
+    std::stringstream   stream(hashRates);
+    std::string         item;
+
+    while(std::getline(stream, item, ','))
+    {
+        double hashRate = atof(item.c_str());
+
+        if(hashRate > 0 && hashRate < 1)
+            sweep.push_back(hashRate);
+        else
+            std::cout << "Ignoring the hash rate " << item << "\n";
+    }
+    return sweep;
+}
+
+std::vector<enum MiningStrategy> ParseStrategies(const std::string &strategies)
+{
+    const enum MiningStrategy   all[] = {HONEST_MINING, SELFISH_MINING, STUBBORN_MINING, WITHHOLDING_MINING};
+    std::vector<enum MiningStrategy> miningStrategies;
+    std::stringstream   stream(strategies);
+    std::string         item;
+
+    while(std::getline(stream, item, ','))
+    {
+        bool found = false;
+
+        for(unsigned int i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+        {
+            if(item == getMiningStrategy(all[i]))
+            {
+                miningStrategies.push_back(all[i]);
+                found = true;
+            }
+        }
+
+        if(!found)
+            std::cout << "Ignoring the unknown strategy " << item << "\n";
+    }
+    return miningStrategies;
+}
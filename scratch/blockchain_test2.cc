@@ -181,6 +181,8 @@ int main(int argc, char *argv[])
 
     ApplicationContainer blockchainMiners;
     int count = 0;
+    blockchainMinerHelper.SetAttribute("Cryptocurrency", UintegerValue(cryptocurrency));
+    blockchainMinerHelper.SetAttribute("ForkChoiceRule", UintegerValue(cryptocurrency == ETHEREUM ? GHOST : LONGEST_CHAIN));
     if(testScalability == true)
     {
         blockchainMinerHelper.SetAttribute("FixedBlockIntervalGeneration", DoubleValue(averageBlockGenIntervalSeconds));
@@ -237,6 +239,7 @@ int main(int argc, char *argv[])
                                                 nodesConnections[0], peersDownloadSpeeds[0], peersUploadSpeeds[0], nodesInternetSpeeds[0], stats);
 
     ApplicationContainer blockchainNodes;
+    blockchainNodeHelper.SetAttribute("ForkChoiceRule", UintegerValue(cryptocurrency == ETHEREUM ? GHOST : LONGEST_CHAIN));
 
     int adoptedEndorser = noEndorsers;
     int adoptedClient = noClient;
@@ -534,7 +537,9 @@ void PrintStatsForEachNode(nodeStatistics *stats, int totalNodes)
                     << "%) with average block generation time = " << stats[it].minerAverageBlockGenInterval
                     << "s or " << static_cast<int>(stats[it].minerAverageBlockGenInterval) / secPerMin << "min and " 
                     << stats[it].minerAverageBlockGenInterval - static_cast<int>(stats[it].minerAverageBlockGenInterval) / secPerMin * secPerMin << "s"
-                    << " and average size " << stats[it].minerAverageBlockSize << " Bytes\n";
+                    << " and average size " << stats[it].minerAverageBlockSize << " Bytes, "
+                    << stats[it].minedBlocksInMainChain << " in the main chain ("
+                    << 100. * stats[it].minedBlocksInMainChain / std::max(1, stats[it].totalBlocks - 1 - stats[it].blocksInForks) << "% of it)\n";
         }
     }
 
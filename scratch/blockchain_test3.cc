@@ -19,7 +19,8 @@ using namespace ns3;
 double get_wall_time();
 int GetNodeIdByIpv4 (Ipv4InterfaceContainer container, Ipv4Address addr);
 void PrintStatsForEachNode(nodeStatistics *stats, int totalNodes);
-void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double finish, double averageBlockGenIntervalSeconds);
+void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double finish, double averageBlockGenIntervalSeconds,
+                     double reconciliationInterval, uint32_t seenCacheCapacity);
 void PrintBlockchainRegionStats(uint32_t *blockchainNodeRegions, uint32_t totalNodes);
 
 NS_LOG_COMPONENT_DEFINE("Blockchain_test3");
@@ -30,8 +31,31 @@ int main(int argc, char *argv[])
     
     bool nullmsg = false;
     bool testScalability = false;
+    bool sendHeaders = false;
+    int compactBlocks = 0;
+    bool blockTorrent = false;
+    int chunkSize = 100000;
+    bool erasureCoding = false;
+    int dataChunks = 8;
+    int parityChunks = 8;
+    double reconciliationInterval = 0;
+    int relayFanout = 8;
+    double trickleInterval = 0;
+    uint32_t seenCacheCapacity = 65536;
+    int gossipTtl = 0;
+    int gossipFanout = 0;
+    int gossipFanoutPeers = 4;
+    int gossipMode = 0;
+    double transactionFeeMean = 1;
+    double transactionSizeMean = 522.4;
+    double transactionSizeSigma = 0;
+    std::string transactionSizeTrace = "";
+    uint32_t mempoolCapacity = 0;
+    uint32_t maxBlockSize = 1000000;
+    uint32_t maxBlockTransactions = 0;
     long blockSize = -1;
     int invTimeoutMins = -1;
+    bool adaptiveInvTimeouts = false;
     enum Cryptocurrency cryptocurrency = HYPERLEDGER;
     double tStart = get_wall_time();
     double tStartSimulation;
@@ -95,10 +119,33 @@ int main(int argc, char *argv[])
     cmd.AddValue("maxConnections", "The maxConnectionsPerNode of the grid", maxConnectionsPerNode);
     cmd.AddValue("blockIntervalSeconds", "The average block generation interval in seconds", averageBlockGenIntervalSeconds);
     cmd.AddValue("invTimeoutMins", "The inv block timeout(default = 1)", invTimeoutMins);
+    cmd.AddValue("adaptiveInvTimeouts", "Derive the block request timeouts from the measured RTT and throughput of the peers", adaptiveInvTimeouts);
     cmd.AddValue("test", "Test the scalability of the simulation", testScalability);
     cmd.AddValue("endorsers", "The total number of endorsers in the networks", noEndorsers);
     cmd.AddValue("clients", "The total number of clients in the networks", noClient);
     cmd.AddValue("creatingTime", "The time for generating transaction", creatingTime);
+    cmd.AddValue("sendHeaders", "Announce the new blocks with HEADERS (SENDHEADERS) instead of INV", sendHeaders);
+    cmd.AddValue("compactBlocks", "Relay compact blocks: 0 off, 1 low-bandwidth, 2 high-bandwidth, 3 Graphene", compactBlocks);
+    cmd.AddValue("blockTorrent", "Relay the blocks in chunks fetched from several peers at once", blockTorrent);
+    cmd.AddValue("chunkSize", "The size of the block chunks in Bytes", chunkSize);
+    cmd.AddValue("erasureCoding", "Disseminate the new blocks as erasure-coded chunks forwarded Kadcast-style", erasureCoding);
+    cmd.AddValue("dataChunks", "The number of data chunks of an erasure-coded block", dataChunks);
+    cmd.AddValue("parityChunks", "The number of parity chunks of an erasure-coded block", parityChunks);
+    cmd.AddValue("reconciliationInterval", "Reconcile the transactions with every peer every so many seconds (Erlay), 0 floods them", reconciliationInterval);
+    cmd.AddValue("relayFanout", "The number of peers the transactions are still flooded to when they are reconciled", relayFanout);
+    cmd.AddValue("trickleInterval", "Batch the announcements to every peer on a Poisson timer of this mean in seconds, 0 announces at once", trickleInterval);
+    cmd.AddValue("seenCacheCapacity", "The number of flooded transaction messages every node remembers to drop their duplicates", seenCacheCapacity);
+    cmd.AddValue("gossipTtl", "The hops a transaction message may travel, 0 for unlimited", gossipTtl);
+    cmd.AddValue("gossipFanout", "The peers a transaction is gossiped to: 0 all, 1 sqrt(peers), 2 gossipFanoutPeers", gossipFanout);
+    cmd.AddValue("gossipFanoutPeers", "The number of peers of the fixed gossip fanout", gossipFanoutPeers);
+    cmd.AddValue("gossipMode", "Gossip the transactions: 0 push, 1 pull (TRANS_INV then GET_TRANS), 2 push to the fanout and TRANS_INV to the other peers", gossipMode);
+    cmd.AddValue("transactionSizeMean", "The mean size of the created transactions in Bytes", transactionSizeMean);
+    cmd.AddValue("transactionSizeSigma", "The sigma of the lognormal transaction sizes, 0 for fixed sizes", transactionSizeSigma);
+    cmd.AddValue("transactionSizeTrace", "A file of transaction sizes in Bytes replayed by the clients", transactionSizeTrace);
+    cmd.AddValue("transactionFeeMean", "The mean fee of the created transactions, 0 for no fee", transactionFeeMean);
+    cmd.AddValue("mempoolCapacity", "The most transactions waiting in the mempool of a miner, 0 for unlimited", mempoolCapacity);
+    cmd.AddValue("maxBlockSize", "The most Bytes of a block", maxBlockSize);
+    cmd.AddValue("maxBlockTransactions", "The most transactions of a block, 0 for unlimited", maxBlockTransactions);
 
     cmd.Parse(argc, argv);
 
@@ -185,6 +232,34 @@ int main(int argc, char *argv[])
 
     ApplicationContainer blockchainMiners;
     int count = 0;
+    blockchainMinerHelper.SetAttribute("Cryptocurrency", UintegerValue(cryptocurrency));
+    blockchainMinerHelper.SetAttribute("ForkChoiceRule", UintegerValue(cryptocurrency == ETHEREUM ? GHOST : LONGEST_CHAIN));
+    if(sendHeaders == true)
+    {
+        blockchainMinerHelper.SetProtocolType(SENDHEADERS);
+    }
+    blockchainMinerHelper.SetAttribute("CompactBlockMode", UintegerValue(compactBlocks));
+    blockchainMinerHelper.SetAttribute("AdaptiveInvTimeouts", BooleanValue(adaptiveInvTimeouts));
+    blockchainMinerHelper.SetAttribute("BlockTorrent", BooleanValue(blockTorrent));
+    blockchainMinerHelper.SetAttribute("ChunkSize", UintegerValue(chunkSize));
+    blockchainMinerHelper.SetAttribute("ErasureCoding", BooleanValue(erasureCoding));
+    blockchainMinerHelper.SetAttribute("ErasureDataChunks", UintegerValue(dataChunks));
+    blockchainMinerHelper.SetAttribute("ErasureParityChunks", UintegerValue(parityChunks));
+    blockchainMinerHelper.SetAttribute("ReconciliationInterval", DoubleValue(reconciliationInterval));
+    blockchainMinerHelper.SetAttribute("TransactionRelayFanout", UintegerValue(relayFanout));
+    blockchainMinerHelper.SetAttribute("TrickleInterval", DoubleValue(trickleInterval));
+    blockchainMinerHelper.SetAttribute("SeenCacheCapacity", UintegerValue(seenCacheCapacity));
+    blockchainMinerHelper.SetAttribute("GossipTtl", UintegerValue(gossipTtl));
+    blockchainMinerHelper.SetAttribute("GossipFanout", UintegerValue(gossipFanout));
+    blockchainMinerHelper.SetAttribute("GossipFanoutPeers", UintegerValue(gossipFanoutPeers));
+    blockchainMinerHelper.SetAttribute("GossipMode", UintegerValue(gossipMode));
+    blockchainMinerHelper.SetAttribute("TransactionSizeMean", DoubleValue(transactionSizeMean));
+    blockchainMinerHelper.SetAttribute("TransactionSizeSigma", DoubleValue(transactionSizeSigma));
+    blockchainMinerHelper.SetAttribute("TransactionSizeTrace", StringValue(transactionSizeTrace));
+    blockchainMinerHelper.SetAttribute("TransactionFeeMean", DoubleValue(transactionFeeMean));
+    blockchainMinerHelper.SetAttribute("MempoolCapacity", UintegerValue(mempoolCapacity));
+    blockchainMinerHelper.SetAttribute("MaxBlockSize", UintegerValue(maxBlockSize));
+    blockchainMinerHelper.SetAttribute("MaxBlockTransactions", UintegerValue(maxBlockTransactions));
     if(testScalability == true)
     {
         blockchainMinerHelper.SetAttribute("FixedBlockIntervalGeneration", DoubleValue(averageBlockGenIntervalSeconds));
@@ -241,6 +316,31 @@ int main(int argc, char *argv[])
                                                 nodesConnections[0], peersDownloadSpeeds[0], peersUploadSpeeds[0], nodesInternetSpeeds[0], stats);
 
     ApplicationContainer blockchainNodes;
+    blockchainNodeHelper.SetAttribute("ForkChoiceRule", UintegerValue(cryptocurrency == ETHEREUM ? GHOST : LONGEST_CHAIN));
+    if(sendHeaders == true)
+    {
+        blockchainNodeHelper.SetProtocolType(SENDHEADERS);
+    }
+    blockchainNodeHelper.SetAttribute("CompactBlockMode", UintegerValue(compactBlocks));
+    blockchainNodeHelper.SetAttribute("AdaptiveInvTimeouts", BooleanValue(adaptiveInvTimeouts));
+    blockchainNodeHelper.SetAttribute("BlockTorrent", BooleanValue(blockTorrent));
+    blockchainNodeHelper.SetAttribute("ChunkSize", UintegerValue(chunkSize));
+    blockchainNodeHelper.SetAttribute("ErasureCoding", BooleanValue(erasureCoding));
+    blockchainNodeHelper.SetAttribute("ErasureDataChunks", UintegerValue(dataChunks));
+    blockchainNodeHelper.SetAttribute("ErasureParityChunks", UintegerValue(parityChunks));
+    blockchainNodeHelper.SetAttribute("ReconciliationInterval", DoubleValue(reconciliationInterval));
+    blockchainNodeHelper.SetAttribute("TransactionRelayFanout", UintegerValue(relayFanout));
+    blockchainNodeHelper.SetAttribute("TrickleInterval", DoubleValue(trickleInterval));
+    blockchainNodeHelper.SetAttribute("SeenCacheCapacity", UintegerValue(seenCacheCapacity));
+    blockchainNodeHelper.SetAttribute("GossipTtl", UintegerValue(gossipTtl));
+    blockchainNodeHelper.SetAttribute("GossipFanout", UintegerValue(gossipFanout));
+    blockchainNodeHelper.SetAttribute("GossipFanoutPeers", UintegerValue(gossipFanoutPeers));
+    blockchainNodeHelper.SetAttribute("GossipMode", UintegerValue(gossipMode));
+    blockchainNodeHelper.SetAttribute("TransactionSizeMean", DoubleValue(transactionSizeMean));
+    blockchainNodeHelper.SetAttribute("TransactionSizeSigma", DoubleValue(transactionSizeSigma));
+    blockchainNodeHelper.SetAttribute("TransactionSizeTrace", StringValue(transactionSizeTrace));
+    blockchainNodeHelper.SetAttribute("TransactionFeeMean", DoubleValue(transactionFeeMean));
+    blockchainNodeHelper.SetAttribute("MempoolCapacity", UintegerValue(mempoolCapacity));
 
     int adoptedEndorser = noEndorsers;
     int adoptedClient = noClient;
@@ -350,15 +450,31 @@ int main(int argc, char *argv[])
 
     #ifdef MPI_TEST
 
-        int blocklen[32] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+        int blocklen[112] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+                            1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
                             1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
                             1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
                             1, 1};
-        MPI_Aint    disp[32];
-        MPI_Datatype    dtypes[32] = {MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_INT, MPI_INT, MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE,
+        MPI_Aint    disp[112];
+        MPI_Datatype    dtypes[112] = {MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_INT, MPI_INT, MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE,
                                         MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG,
                                         MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_LONG, MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE,
-                                        MPI_INT, MPI_DOUBLE};
+                                        MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE,
+                                        MPI_INT, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_INT, MPI_INT, MPI_LONG, MPI_LONG,
+                                        MPI_DOUBLE, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_DOUBLE,
+                                        MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG,
+                                        MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_DOUBLE, MPI_INT, MPI_DOUBLE, MPI_DOUBLE,
+                                        MPI_LONG, MPI_LONG, MPI_INT, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_INT, MPI_INT, MPI_LONG,
+                                        MPI_LONG, MPI_DOUBLE, MPI_DOUBLE, MPI_INT, MPI_INT, MPI_INT, MPI_INT, MPI_DOUBLE, MPI_INT, MPI_INT,
+                                        MPI_INT, MPI_DOUBLE, MPI_DOUBLE, MPI_DOUBLE, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_LONG, MPI_INT,
+                                        MPI_DOUBLE, MPI_INT};
         MPI_Datatype    mpi_nodeStatisticsType;
 
         disp[0]= offsetof(nodeStatistics, nodeId);
@@ -393,8 +509,88 @@ int main(int argc, char *argv[])
         disp[29]= offsetof(nodeStatistics, meanLatency);
         disp[30]= offsetof(nodeStatistics, nodeType);
         disp[31]= offsetof(nodeStatistics, meanNumberofTransactions);
-
-        MPI_Type_create_struct(32, blocklen, disp, dtypes, &mpi_nodeStatisticsType);
+        disp[32]= offsetof(nodeStatistics, uploadMeanQueueDepth);
+        disp[33]= offsetof(nodeStatistics, uploadMaxQueueDepth);
+        disp[34]= offsetof(nodeStatistics, uploadUtilization);
+        disp[35]= offsetof(nodeStatistics, downloadMeanActiveTransfers);
+        disp[36]= offsetof(nodeStatistics, downloadMaxActiveTransfers);
+        disp[37]= offsetof(nodeStatistics, downloadUtilization);
+        disp[38]= offsetof(nodeStatistics, cpuUtilization);
+        disp[39]= offsetof(nodeStatistics, cpuMeanQueueDelay);
+        disp[40]= offsetof(nodeStatistics, cpuMaxQueueLength);
+        disp[41]= offsetof(nodeStatistics, invTimersArmed);
+        disp[42]= offsetof(nodeStatistics, invTimersFired);
+        disp[43]= offsetof(nodeStatistics, invTimersCancelled);
+        disp[44]= offsetof(nodeStatistics, blockRefetches);
+        disp[45]= offsetof(nodeStatistics, earlyReissues);
+        disp[46]= offsetof(nodeStatistics, maxInFlightRequests);
+        disp[47]= offsetof(nodeStatistics, maxParallelDownloadPeers);
+        disp[48]= offsetof(nodeStatistics, announcementSentBytes);
+        disp[49]= offsetof(nodeStatistics, announcementReceivedBytes);
+        disp[50]= offsetof(nodeStatistics, meanAnnounceToBlockTime);
+        disp[51]= offsetof(nodeStatistics, compactBlockSentBytes);
+        disp[52]= offsetof(nodeStatistics, compactBlockReceivedBytes);
+        disp[53]= offsetof(nodeStatistics, compactBlocksReconstructed);
+        disp[54]= offsetof(nodeStatistics, compactBlockRoundTrips);
+        disp[55]= offsetof(nodeStatistics, compactBlockFallbacks);
+        disp[56]= offsetof(nodeStatistics, chunkSentBytes);
+        disp[57]= offsetof(nodeStatistics, chunkReceivedBytes);
+        disp[58]= offsetof(nodeStatistics, chunkTimeouts);
+        disp[59]= offsetof(nodeStatistics, meanChunkSources);
+        disp[60]= offsetof(nodeStatistics, codedChunkSentBytes);
+        disp[61]= offsetof(nodeStatistics, codedChunkReceivedBytes);
+        disp[62]= offsetof(nodeStatistics, codedChunkDuplicates);
+        disp[63]= offsetof(nodeStatistics, codedBlockFallbacks);
+        disp[64]= offsetof(nodeStatistics, grapheneSentBytes);
+        disp[65]= offsetof(nodeStatistics, grapheneReceivedBytes);
+        disp[66]= offsetof(nodeStatistics, grapheneBlocksDecoded);
+        disp[67]= offsetof(nodeStatistics, grapheneDecodeFailures);
+        disp[68]= offsetof(nodeStatistics, grapheneBytesSaved);
+        disp[69]= offsetof(nodeStatistics, transactionSentBytes);
+        disp[70]= offsetof(nodeStatistics, reconciliationSentBytes);
+        disp[71]= offsetof(nodeStatistics, reconciliationRounds);
+        disp[72]= offsetof(nodeStatistics, reconciliationFailures);
+        disp[73]= offsetof(nodeStatistics, reconciledTransactions);
+        disp[74]= offsetof(nodeStatistics, announcementMessages);
+        disp[75]= offsetof(nodeStatistics, announcementItems);
+        disp[76]= offsetof(nodeStatistics, meanAnnouncementBatch);
+        disp[77]= offsetof(nodeStatistics, p90AnnouncementBatch);
+        disp[78]= offsetof(nodeStatistics, meanTrickleInterval);
+        disp[79]= offsetof(nodeStatistics, p90TrickleInterval);
+        disp[80]= offsetof(nodeStatistics, seenCacheHits);
+        disp[81]= offsetof(nodeStatistics, seenCacheEvictions);
+        disp[82]= offsetof(nodeStatistics, transactionsCreated);
+        disp[83]= offsetof(nodeStatistics, transactionsReceived);
+        disp[84]= offsetof(nodeStatistics, gossipTtlExpired);
+        disp[85]= offsetof(nodeStatistics, gossipPullSentBytes);
+        disp[86]= offsetof(nodeStatistics, gossipPulledTransactions);
+        disp[87]= offsetof(nodeStatistics, mempoolSize);
+        disp[88]= offsetof(nodeStatistics, mempoolMaxSize);
+        disp[89]= offsetof(nodeStatistics, mempoolEvictions);
+        disp[90]= offsetof(nodeStatistics, mempoolRejections);
+        disp[91]= offsetof(nodeStatistics, meanBlockFill);
+        disp[92]= offsetof(nodeStatistics, meanTransactionSize);
+        disp[93]= offsetof(nodeStatistics, reorgs);
+        disp[94]= offsetof(nodeStatistics, maxReorgDepth);
+        disp[95]= offsetof(nodeStatistics, includedUncles);
+        disp[96]= offsetof(nodeStatistics, minerIncludedUncles);
+        disp[97]= offsetof(nodeStatistics, minerUncleRewards);
+        disp[98]= offsetof(nodeStatistics, miningStrategy);
+        disp[99]= offsetof(nodeStatistics, minerWithheldBlocks);
+        disp[100]= offsetof(nodeStatistics, minerAbandonedBlocks);
+        disp[101]= offsetof(nodeStatistics, difficulty);
+        disp[102]= offsetof(nodeStatistics, mainChainInterval);
+        disp[103]= offsetof(nodeStatistics, steadyChainInterval);
+        disp[104]= offsetof(nodeStatistics, consensusMessagesSent);
+        disp[105]= offsetof(nodeStatistics, consensusMessagesReceived);
+        disp[106]= offsetof(nodeStatistics, consensusSentBytes);
+        disp[107]= offsetof(nodeStatistics, consensusReceivedBytes);
+        disp[108]= offsetof(nodeStatistics, consensusSignaturesVerified);
+        disp[109]= offsetof(nodeStatistics, consensusCommittedBlocks);
+        disp[110]= offsetof(nodeStatistics, meanCommitLatency);
+        disp[111]= offsetof(nodeStatistics, viewChanges);
+
+        MPI_Type_create_struct(112, blocklen, disp, dtypes, &mpi_nodeStatisticsType);
         MPI_Type_commit(&mpi_nodeStatisticsType);
 
         if(systemId != 0 && systemCount > 1)
@@ -451,6 +647,86 @@ int main(int argc, char *argv[])
                 stats[recv.nodeId].meanLatency =recv.meanLatency;
                 stats[recv.nodeId].nodeType =recv.nodeType;
                 stats[recv.nodeId].meanNumberofTransactions = recv.meanNumberofTransactions;
+                stats[recv.nodeId].uploadMeanQueueDepth = recv.uploadMeanQueueDepth;
+                stats[recv.nodeId].uploadMaxQueueDepth = recv.uploadMaxQueueDepth;
+                stats[recv.nodeId].uploadUtilization = recv.uploadUtilization;
+                stats[recv.nodeId].downloadMeanActiveTransfers = recv.downloadMeanActiveTransfers;
+                stats[recv.nodeId].downloadMaxActiveTransfers = recv.downloadMaxActiveTransfers;
+                stats[recv.nodeId].downloadUtilization = recv.downloadUtilization;
+                stats[recv.nodeId].cpuUtilization = recv.cpuUtilization;
+                stats[recv.nodeId].cpuMeanQueueDelay = recv.cpuMeanQueueDelay;
+                stats[recv.nodeId].cpuMaxQueueLength = recv.cpuMaxQueueLength;
+                stats[recv.nodeId].invTimersArmed = recv.invTimersArmed;
+                stats[recv.nodeId].invTimersFired = recv.invTimersFired;
+                stats[recv.nodeId].invTimersCancelled = recv.invTimersCancelled;
+                stats[recv.nodeId].blockRefetches = recv.blockRefetches;
+                stats[recv.nodeId].earlyReissues = recv.earlyReissues;
+                stats[recv.nodeId].maxInFlightRequests = recv.maxInFlightRequests;
+                stats[recv.nodeId].maxParallelDownloadPeers = recv.maxParallelDownloadPeers;
+                stats[recv.nodeId].announcementSentBytes = recv.announcementSentBytes;
+                stats[recv.nodeId].announcementReceivedBytes = recv.announcementReceivedBytes;
+                stats[recv.nodeId].meanAnnounceToBlockTime = recv.meanAnnounceToBlockTime;
+                stats[recv.nodeId].compactBlockSentBytes = recv.compactBlockSentBytes;
+                stats[recv.nodeId].compactBlockReceivedBytes = recv.compactBlockReceivedBytes;
+                stats[recv.nodeId].compactBlocksReconstructed = recv.compactBlocksReconstructed;
+                stats[recv.nodeId].compactBlockRoundTrips = recv.compactBlockRoundTrips;
+                stats[recv.nodeId].compactBlockFallbacks = recv.compactBlockFallbacks;
+                stats[recv.nodeId].chunkSentBytes = recv.chunkSentBytes;
+                stats[recv.nodeId].chunkReceivedBytes = recv.chunkReceivedBytes;
+                stats[recv.nodeId].chunkTimeouts = recv.chunkTimeouts;
+                stats[recv.nodeId].meanChunkSources = recv.meanChunkSources;
+                stats[recv.nodeId].codedChunkSentBytes = recv.codedChunkSentBytes;
+                stats[recv.nodeId].codedChunkReceivedBytes = recv.codedChunkReceivedBytes;
+                stats[recv.nodeId].codedChunkDuplicates = recv.codedChunkDuplicates;
+                stats[recv.nodeId].codedBlockFallbacks = recv.codedBlockFallbacks;
+                stats[recv.nodeId].grapheneSentBytes = recv.grapheneSentBytes;
+                stats[recv.nodeId].grapheneReceivedBytes = recv.grapheneReceivedBytes;
+                stats[recv.nodeId].grapheneBlocksDecoded = recv.grapheneBlocksDecoded;
+                stats[recv.nodeId].grapheneDecodeFailures = recv.grapheneDecodeFailures;
+                stats[recv.nodeId].grapheneBytesSaved = recv.grapheneBytesSaved;
+                stats[recv.nodeId].transactionSentBytes = recv.transactionSentBytes;
+                stats[recv.nodeId].reconciliationSentBytes = recv.reconciliationSentBytes;
+                stats[recv.nodeId].reconciliationRounds = recv.reconciliationRounds;
+                stats[recv.nodeId].reconciliationFailures = recv.reconciliationFailures;
+                stats[recv.nodeId].reconciledTransactions = recv.reconciledTransactions;
+                stats[recv.nodeId].announcementMessages = recv.announcementMessages;
+                stats[recv.nodeId].announcementItems = recv.announcementItems;
+                stats[recv.nodeId].meanAnnouncementBatch = recv.meanAnnouncementBatch;
+                stats[recv.nodeId].p90AnnouncementBatch = recv.p90AnnouncementBatch;
+                stats[recv.nodeId].meanTrickleInterval = recv.meanTrickleInterval;
+                stats[recv.nodeId].p90TrickleInterval = recv.p90TrickleInterval;
+                stats[recv.nodeId].seenCacheHits = recv.seenCacheHits;
+                stats[recv.nodeId].seenCacheEvictions = recv.seenCacheEvictions;
+                stats[recv.nodeId].transactionsCreated = recv.transactionsCreated;
+                stats[recv.nodeId].transactionsReceived = recv.transactionsReceived;
+                stats[recv.nodeId].gossipTtlExpired = recv.gossipTtlExpired;
+                stats[recv.nodeId].gossipPullSentBytes = recv.gossipPullSentBytes;
+                stats[recv.nodeId].gossipPulledTransactions = recv.gossipPulledTransactions;
+                stats[recv.nodeId].mempoolSize = recv.mempoolSize;
+                stats[recv.nodeId].mempoolMaxSize = recv.mempoolMaxSize;
+                stats[recv.nodeId].mempoolEvictions = recv.mempoolEvictions;
+                stats[recv.nodeId].mempoolRejections = recv.mempoolRejections;
+                stats[recv.nodeId].meanBlockFill = recv.meanBlockFill;
+                stats[recv.nodeId].meanTransactionSize = recv.meanTransactionSize;
+                stats[recv.nodeId].reorgs = recv.reorgs;
+                stats[recv.nodeId].maxReorgDepth = recv.maxReorgDepth;
+                stats[recv.nodeId].includedUncles = recv.includedUncles;
+                stats[recv.nodeId].minerIncludedUncles = recv.minerIncludedUncles;
+                stats[recv.nodeId].minerUncleRewards = recv.minerUncleRewards;
+                stats[recv.nodeId].miningStrategy = recv.miningStrategy;
+                stats[recv.nodeId].minerWithheldBlocks = recv.minerWithheldBlocks;
+                stats[recv.nodeId].minerAbandonedBlocks = recv.minerAbandonedBlocks;
+                stats[recv.nodeId].difficulty = recv.difficulty;
+                stats[recv.nodeId].mainChainInterval = recv.mainChainInterval;
+                stats[recv.nodeId].steadyChainInterval = recv.steadyChainInterval;
+                stats[recv.nodeId].consensusMessagesSent = recv.consensusMessagesSent;
+                stats[recv.nodeId].consensusMessagesReceived = recv.consensusMessagesReceived;
+                stats[recv.nodeId].consensusSentBytes = recv.consensusSentBytes;
+                stats[recv.nodeId].consensusReceivedBytes = recv.consensusReceivedBytes;
+                stats[recv.nodeId].consensusSignaturesVerified = recv.consensusSignaturesVerified;
+                stats[recv.nodeId].consensusCommittedBlocks = recv.consensusCommittedBlocks;
+                stats[recv.nodeId].meanCommitLatency = recv.meanCommitLatency;
+                stats[recv.nodeId].viewChanges = recv.viewChanges;
                 count++;
             }
         }
@@ -460,12 +736,16 @@ int main(int argc, char *argv[])
     {
         tFinish = get_wall_time();
 
-        PrintTotalStats(stats, totalNoNodes, tStartSimulation, tFinish, averageBlockGenIntervalMinuates);
+        PrintTotalStats(stats, totalNoNodes, tStartSimulation, tFinish, averageBlockGenIntervalMinuates, reconciliationInterval,
+                        seenCacheCapacity);
         std::cout<<"\nThe simulation run for " << tFinish - tStart << "s simulating"
                     << stop << " mins, Performed " << "Setup time = " << tStartSimulation - tStart << "s\n"
                     << "It consisted of " << totalNoNodes << "nodes (" << noMiners << "miners) with minConnectionPerNode= "
                     << minConnectionsPerNode << " and maxConnectionsperNode = " << maxConnectionsPerNode 
-                    << " .\n the averageBlockGenIntervalSeconds was " << averageBlockGenIntervalSeconds << "sec.\n";
+                    << " .\n the averageBlockGenIntervalSeconds was " << averageBlockGenIntervalSeconds << "sec.\n"
+                    << "The blocks were announced with " << (sendHeaders ? "SENDHEADERS" : "STANDARD_PROTOCOL")
+                    << " and relayed with " << (blockTorrent ? "blockTorrent" : getCompactBlockMode(static_cast<enum CompactBlockMode>(compactBlocks)))
+                    << (erasureCoding ? ", new blocks erasure-coded" : "") << ".\n";
 
     }
 
@@ -539,13 +819,23 @@ void PrintStatsForEachNode(nodeStatistics *stats, int totalNodes)
                     << "%) with average block generation time = " << stats[it].minerAverageBlockGenInterval
                     << "s or " << static_cast<int>(stats[it].minerAverageBlockGenInterval) / secPerMin << "min and " 
                     << stats[it].minerAverageBlockGenInterval - static_cast<int>(stats[it].minerAverageBlockGenInterval) / secPerMin * secPerMin << "s"
-                    << " and average size " << stats[it].minerAverageBlockSize << " Bytes\n";
+                    << " and average size " << stats[it].minerAverageBlockSize << " Bytes, "
+                    << stats[it].minedBlocksInMainChain << " in the main chain ("
+                    << 100. * stats[it].minedBlocksInMainChain / std::max(1, stats[it].totalBlocks - 1 - stats[it].blocksInForks) << "% of it), "
+                    << stats[it].minerIncludedUncles << " referenced as uncles (uncle rewards = " << stats[it].minerUncleRewards << " blocks)\n";
+
+            if(stats[it].miningStrategy != HONEST_MINING)
+            {
+                std::cout << "    " << getMiningStrategy(static_cast<enum MiningStrategy>(stats[it].miningStrategy)) << " : withheld "
+                            << stats[it].minerWithheldBlocks << " blocks, abandoned " << stats[it].minerAbandonedBlocks << "\n";
+            }
         }
     }
 
 }
 
-void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double finish, double averageBlockGenIntervalMinutes)
+void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double finish, double averageBlockGenIntervalMinutes,
+                     double reconciliationInterval, uint32_t seenCacheCapacity)
 {
     const int  secPerMin = 60;
     double     meanBlockReceiveTime = 0;
@@ -575,6 +865,82 @@ void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double
     double     meanOrderingTime = 0;
     double     meanLatency = 0;
     double     meanNumberofTransactions = 0;
+    double     uploadMeanQueueDepth = 0;
+    double     uploadUtilization = 0;
+    double     downloadMeanActiveTransfers = 0;
+    double     downloadUtilization = 0;
+    int        uploadMaxQueueDepth = 0;
+    int        downloadMaxActiveTransfers = 0;
+    double     cpuUtilization = 0;
+    double     maxCpuUtilization = 0;
+    double     cpuMeanQueueDelay = 0;
+    int        cpuMaxQueueLength = 0;
+    long       invTimersArmed = 0;
+    long       invTimersFired = 0;
+    long       invTimersCancelled = 0;
+    long       blockRefetches = 0;
+    long       earlyReissues = 0;
+    int        maxInFlightRequests = 0;
+    int        maxParallelDownloadPeers = 0;
+    long       announcementSentBytes = 0;
+    long       announcementReceivedBytes = 0;
+    double     meanAnnounceToBlockTime = 0;
+    long       compactBlockSentBytes = 0;
+    long       compactBlockReceivedBytes = 0;
+    long       compactBlocksReconstructed = 0;
+    long       compactBlockRoundTrips = 0;
+    long       compactBlockFallbacks = 0;
+    long       chunkSentBytes = 0;
+    long       chunkReceivedBytes = 0;
+    long       chunkTimeouts = 0;
+    double     meanChunkSources = 0;
+    long       codedChunkSentBytes = 0;
+    long       codedChunkReceivedBytes = 0;
+    long       codedChunkDuplicates = 0;
+    long       codedBlockFallbacks = 0;
+    long       grapheneSentBytes = 0;
+    long       grapheneReceivedBytes = 0;
+    long       grapheneBlocksDecoded = 0;
+    long       grapheneDecodeFailures = 0;
+    long       grapheneBytesSaved = 0;
+    long       transactionSentBytes = 0;
+    long       reconciliationSentBytes = 0;
+    long       reconciliationRounds = 0;
+    long       reconciliationFailures = 0;
+    long       reconciledTransactions = 0;
+    long       announcementMessages = 0;
+    long       announcementItems = 0;
+    double     meanAnnouncementBatch = 0;
+    int        p90AnnouncementBatch = 0;
+    double     meanTrickleInterval = 0;
+    double     p90TrickleInterval = 0;
+    long       seenCacheHits = 0;
+    long       seenCacheEvictions = 0;
+    long       transactionsCreated = 0;
+    long       transactionsReceived = 0;
+    long       gossipTtlExpired = 0;
+    long       gossipPullSentBytes = 0;
+    long       gossipPulledTransactions = 0;
+    int        gossipReceivers = 0;
+    long       mempoolSize = 0;
+    int        mempoolMaxSize = 0;
+    long       mempoolEvictions = 0;
+    long       mempoolRejections = 0;
+    double     meanBlockFill = 0;
+    double     meanTransactionSize = 0;
+    long       reorgs = 0;
+    int        maxReorgDepth = 0;
+    double     includedUncles = 0;
+    double     difficulty = 0;
+    double     mainChainInterval = 0;
+    double     steadyChainInterval = 0;
+    long       consensusMessagesSent = 0;
+    long       consensusSentBytes = 0;
+    long       consensusSignaturesVerified = 0;
+    int        consensusCommittedBlocks = 0;
+    double     meanCommitLatency = 0;
+    int        committingValidators = 0;
+    int        viewChanges = 0;
 
     int        nodeType = 0;
     uint32_t   nodes = 0;
@@ -607,6 +973,87 @@ void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double
         blockSentBytes = blockSentBytes*it/static_cast<double>(it + 1) + stats[it].blockSentBytes/static_cast<double>(it + 1);
         longestFork = longestFork*it/static_cast<double>(it + 1) + stats[it].longestFork/static_cast<double>(it + 1);
         blocksInForks = blocksInForks*it/static_cast<double>(it + 1) + stats[it].blocksInForks/static_cast<double>(it + 1);
+        uploadMeanQueueDepth = uploadMeanQueueDepth*it/static_cast<double>(it + 1) + stats[it].uploadMeanQueueDepth/static_cast<double>(it + 1);
+        uploadUtilization = uploadUtilization*it/static_cast<double>(it + 1) + stats[it].uploadUtilization/static_cast<double>(it + 1);
+        downloadMeanActiveTransfers = downloadMeanActiveTransfers*it/static_cast<double>(it + 1) + stats[it].downloadMeanActiveTransfers/static_cast<double>(it + 1);
+        downloadUtilization = downloadUtilization*it/static_cast<double>(it + 1) + stats[it].downloadUtilization/static_cast<double>(it + 1);
+        uploadMaxQueueDepth = std::max(uploadMaxQueueDepth, stats[it].uploadMaxQueueDepth);
+        downloadMaxActiveTransfers = std::max(downloadMaxActiveTransfers, stats[it].downloadMaxActiveTransfers);
+        cpuUtilization = cpuUtilization*it/static_cast<double>(it + 1) + stats[it].cpuUtilization/static_cast<double>(it + 1);
+        cpuMeanQueueDelay = cpuMeanQueueDelay*it/static_cast<double>(it + 1) + stats[it].cpuMeanQueueDelay/static_cast<double>(it + 1);
+        maxCpuUtilization = std::max(maxCpuUtilization, stats[it].cpuUtilization);
+        cpuMaxQueueLength = std::max(cpuMaxQueueLength, stats[it].cpuMaxQueueLength);
+        invTimersArmed += stats[it].invTimersArmed;
+        invTimersFired += stats[it].invTimersFired;
+        invTimersCancelled += stats[it].invTimersCancelled;
+        blockRefetches += stats[it].blockRefetches;
+        earlyReissues += stats[it].earlyReissues;
+        maxInFlightRequests = std::max(maxInFlightRequests, stats[it].maxInFlightRequests);
+        maxParallelDownloadPeers = std::max(maxParallelDownloadPeers, stats[it].maxParallelDownloadPeers);
+        announcementSentBytes = announcementSentBytes*it/static_cast<double>(it + 1) + stats[it].announcementSentBytes/static_cast<double>(it + 1);
+        announcementReceivedBytes = announcementReceivedBytes*it/static_cast<double>(it + 1) + stats[it].announcementReceivedBytes/static_cast<double>(it + 1);
+        meanAnnounceToBlockTime = meanAnnounceToBlockTime*it/static_cast<double>(it + 1) + stats[it].meanAnnounceToBlockTime/static_cast<double>(it + 1);
+        compactBlockSentBytes = compactBlockSentBytes*it/static_cast<double>(it + 1) + stats[it].compactBlockSentBytes/static_cast<double>(it + 1);
+        compactBlockReceivedBytes = compactBlockReceivedBytes*it/static_cast<double>(it + 1) + stats[it].compactBlockReceivedBytes/static_cast<double>(it + 1);
+        compactBlocksReconstructed += stats[it].compactBlocksReconstructed;
+        compactBlockRoundTrips += stats[it].compactBlockRoundTrips;
+        compactBlockFallbacks += stats[it].compactBlockFallbacks;
+        chunkSentBytes = chunkSentBytes*it/static_cast<double>(it + 1) + stats[it].chunkSentBytes/static_cast<double>(it + 1);
+        chunkReceivedBytes = chunkReceivedBytes*it/static_cast<double>(it + 1) + stats[it].chunkReceivedBytes/static_cast<double>(it + 1);
+        chunkTimeouts += stats[it].chunkTimeouts;
+        meanChunkSources = meanChunkSources*it/static_cast<double>(it + 1) + stats[it].meanChunkSources/static_cast<double>(it + 1);
+        codedChunkSentBytes = codedChunkSentBytes*it/static_cast<double>(it + 1) + stats[it].codedChunkSentBytes/static_cast<double>(it + 1);
+        codedChunkReceivedBytes = codedChunkReceivedBytes*it/static_cast<double>(it + 1) + stats[it].codedChunkReceivedBytes/static_cast<double>(it + 1);
+        codedChunkDuplicates += stats[it].codedChunkDuplicates;
+        codedBlockFallbacks += stats[it].codedBlockFallbacks;
+        grapheneSentBytes = grapheneSentBytes*it/static_cast<double>(it + 1) + stats[it].grapheneSentBytes/static_cast<double>(it + 1);
+        grapheneReceivedBytes = grapheneReceivedBytes*it/static_cast<double>(it + 1) + stats[it].grapheneReceivedBytes/static_cast<double>(it + 1);
+        grapheneBlocksDecoded += stats[it].grapheneBlocksDecoded;
+        grapheneDecodeFailures += stats[it].grapheneDecodeFailures;
+        grapheneBytesSaved += stats[it].grapheneBytesSaved;
+        transactionSentBytes = transactionSentBytes*it/static_cast<double>(it + 1) + stats[it].transactionSentBytes/static_cast<double>(it + 1);
+        reconciliationSentBytes = reconciliationSentBytes*it/static_cast<double>(it + 1) + stats[it].reconciliationSentBytes/static_cast<double>(it + 1);
+        reconciliationRounds += stats[it].reconciliationRounds;
+        reconciliationFailures += stats[it].reconciliationFailures;
+        reconciledTransactions += stats[it].reconciledTransactions;
+        announcementMessages += stats[it].announcementMessages;
+        announcementItems += stats[it].announcementItems;
+        meanAnnouncementBatch = (meanAnnouncementBatch*it + stats[it].meanAnnouncementBatch)/static_cast<double>(it + 1);
+        p90AnnouncementBatch = std::max(p90AnnouncementBatch, stats[it].p90AnnouncementBatch);
+        meanTrickleInterval = (meanTrickleInterval*it + stats[it].meanTrickleInterval)/static_cast<double>(it + 1);
+        p90TrickleInterval = std::max(p90TrickleInterval, stats[it].p90TrickleInterval);
+        seenCacheHits += stats[it].seenCacheHits;
+        seenCacheEvictions += stats[it].seenCacheEvictions;
+        transactionsCreated += stats[it].transactionsCreated;
+        transactionsReceived += stats[it].transactionsReceived;
+        gossipTtlExpired += stats[it].gossipTtlExpired;
+        gossipPullSentBytes = gossipPullSentBytes*it/static_cast<double>(it + 1) + stats[it].gossipPullSentBytes/static_cast<double>(it + 1);
+        gossipPulledTransactions += stats[it].gossipPulledTransactions;
+        if(stats[it].nodeType != 2)
+            gossipReceivers++;
+        mempoolSize += stats[it].mempoolSize;
+        mempoolMaxSize = std::max(mempoolMaxSize, stats[it].mempoolMaxSize);
+        mempoolEvictions += stats[it].mempoolEvictions;
+        mempoolRejections += stats[it].mempoolRejections;
+        reorgs += stats[it].reorgs;
+        maxReorgDepth = std::max(maxReorgDepth, stats[it].maxReorgDepth);
+        includedUncles = includedUncles*it/static_cast<double>(it + 1) + stats[it].includedUncles/static_cast<double>(it + 1);
+        difficulty = difficulty*it/static_cast<double>(it + 1) + stats[it].difficulty/static_cast<double>(it + 1);
+        mainChainInterval = mainChainInterval*it/static_cast<double>(it + 1) + stats[it].mainChainInterval/static_cast<double>(it + 1);
+        steadyChainInterval = steadyChainInterval*it/static_cast<double>(it + 1) + stats[it].steadyChainInterval/static_cast<double>(it + 1);
+        consensusMessagesSent += stats[it].consensusMessagesSent;
+        consensusSentBytes += stats[it].consensusSentBytes;
+        consensusSignaturesVerified += stats[it].consensusSignaturesVerified;
+        consensusCommittedBlocks = std::max(consensusCommittedBlocks, stats[it].consensusCommittedBlocks);
+        viewChanges = std::max(viewChanges, stats[it].viewChanges);
+        if(stats[it].consensusCommittedBlocks > 0)
+        {
+            meanCommitLatency = meanCommitLatency*committingValidators/static_cast<double>(committingValidators + 1)
+                                + stats[it].meanCommitLatency/static_cast<double>(committingValidators + 1);
+            committingValidators++;
+        }
+        if(transactionsCreated > 0)
+            meanTransactionSize += (stats[it].meanTransactionSize - meanTransactionSize) * stats[it].transactionsCreated / transactionsCreated;
         
         propagationTimes.push_back(stats[it].meanBlockPropagationTime);
 
@@ -632,6 +1079,7 @@ void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double
             meanMinersBlockPropagationTime = meanMinersBlockPropagationTime*miners/static_cast<double>(miners + 1) + stats[it].meanBlockPropagationTime/static_cast<double>(miners + 1);
             minersPropagationTimes.push_back(stats[it].meanBlockPropagationTime);
             meanNumberofTransactions = (meanNumberofTransactions*static_cast<double>(miners) + stats[it].meanNumberofTransactions)/static_cast<double>(miners + 1);
+            meanBlockFill = (meanBlockFill*static_cast<double>(miners) + stats[it].meanBlockFill)/static_cast<double>(miners + 1);
             miners++;
         }
 
@@ -683,6 +1131,23 @@ void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double
     std::cout << "Miners Median Block Propagation Time = " << minersMedian << "s\n";
     std::cout << "Mean Block Size = " << meanBlockSize << " Bytes\n";
     std::cout << "Total Blocks = " << totalBlocks << "\n";
+    std::cout << "The size of the longest fork was " << longestFork << " blocks\n";
+    std::cout << "There were in total " << blocksInForks << " blocks in forks (stale rate = "
+                << (totalBlocks > 1 ? 100. * blocksInForks / (totalBlocks - 1) : 0) << "%)\n";
+    std::cout << "Reorganizations : " << static_cast<double>(reorgs) / totalNodes << " per node, deepest = " << maxReorgDepth << " blocks\n";
+    std::cout << "Uncles : " << includedUncles << " referenced by the main chain (uncle rate = "
+                << (totalBlocks - 1 - blocksInForks > 0 ? 100. * includedUncles / (totalBlocks - 1 - blocksInForks) : 0)
+                << "%), " << blocksInForks - includedUncles << " stale blocks left out\n";
+    std::cout << "Difficulty : " << difficulty << " at the tip, main chain interval = " << mainChainInterval
+                << "s, steady interval (second half) = " << steadyChainInterval << "s\n";
+    if(consensusCommittedBlocks > 0)
+    {
+        std::cout << "Consensus : " << consensusCommittedBlocks << " blocks committed with mean commit latency = " << meanCommitLatency
+                    << "s, " << static_cast<double>(consensusMessagesSent) / consensusCommittedBlocks << " messages ("
+                    << static_cast<double>(consensusSentBytes) / consensusCommittedBlocks << " Bytes) and "
+                    << static_cast<double>(consensusSignaturesVerified) / consensusCommittedBlocks << " signature verifications per block, "
+                    << viewChanges << " view changes\n";
+    }
     std::cout << "The average received INV messages were " << invReceivedBytes << " Bytes (" 
                 << 100. * invReceivedBytes / averageBandwidthPerNode << "%)\n";
     std::cout << "The average received GET_HEADERS messages were " << getHeadersReceivedBytes << " Bytes (" 
@@ -722,6 +1187,47 @@ void PrintTotalStats(nodeStatistics *stats, int totalNodes, double start, double
     std::cout << "meanValidationTime =" << meanValidationTime <<"s \n";
     std::cout << "meanLatency =" << meanLatency <<"s \n";
     std::cout << "Ths average transactions in a block =" << meanNumberofTransactions <<"\n";
+    std::cout << "Upload queue : mean depth = " << uploadMeanQueueDepth << ", max depth = " << uploadMaxQueueDepth
+                << ", utilization = " << 100. * uploadUtilization << "%\n";
+    std::cout << "Download link : mean active transfers = " << downloadMeanActiveTransfers << ", max active transfers = " << downloadMaxActiveTransfers
+                << ", utilization = " << 100. * downloadUtilization << "%\n";
+    std::cout << "CPU : mean utilization = " << 100. * cpuUtilization << "%, max utilization = " << 100. * maxCpuUtilization
+                << "%, mean queue delay = " << cpuMeanQueueDelay << "s, max queue length = " << cpuMaxQueueLength << "\n";
+    std::cout << "Inv timers : armed = " << invTimersArmed << ", fired = " << invTimersFired
+                << ", cancelled = " << invTimersCancelled << "\n";
+    std::cout << "Timeout-triggered block refetches = " << blockRefetches << ", early reissues of stalled requests = " << earlyReissues << "\n";
+    std::cout << "Block downloads : max in flight = " << maxInFlightRequests << ", max parallel peers = " << maxParallelDownloadPeers << "\n";
+    std::cout << "Announcements : sent/node = " << announcementSentBytes
+                << " Bytes, received/node = " << announcementReceivedBytes << " Bytes, mean announcement to block time = " << meanAnnounceToBlockTime << "s\n";
+    std::cout << "Compact blocks : sent/node = " << compactBlockSentBytes << " Bytes, received/node = " << compactBlockReceivedBytes
+                << " Bytes, rebuilt from the mempool = " << compactBlocksReconstructed << ", with GET_BLOCK_TXN = " << compactBlockRoundTrips
+                << ", full block fallbacks = " << compactBlockFallbacks << "\n";
+    std::cout << "Chunks : sent/node = " << chunkSentBytes << " Bytes, received/node = " << chunkReceivedBytes
+                << " Bytes, request timeouts = " << chunkTimeouts << ", mean sources per block = " << meanChunkSources << "\n";
+    std::cout << "Coded chunks : sent/node = " << codedChunkSentBytes << " Bytes, received/node = " << codedChunkReceivedBytes
+                << " Bytes, duplicates = " << codedChunkDuplicates << ", GET_DATA fallbacks = " << codedBlockFallbacks << "\n";
+    std::cout << "Graphene blocks : sent/node = " << grapheneSentBytes << " Bytes, received/node = " << grapheneReceivedBytes
+                << " Bytes, decoded = " << grapheneBlocksDecoded << ", decode failure rate = "
+                << (grapheneBlocksDecoded + grapheneDecodeFailures > 0 ? 100.0*grapheneDecodeFailures/(grapheneBlocksDecoded + grapheneDecodeFailures) : 0)
+                << "%, bytes saved = " << grapheneBytesSaved << " Bytes\n";
+    std::cout << "Transaction relay (" << (reconciliationInterval > 0 ? "reconciled" : "flooded") << ") : transactions sent/node = "
+                << transactionSentBytes << " Bytes, reconciliations sent/node = " << reconciliationSentBytes << " Bytes, reconciliations = "
+                << reconciliationRounds << ", failed = " << reconciliationFailures << ", transactions sent after a reconciliation = "
+                << reconciledTransactions << ", meanLatency = " << meanLatency << "s\n";
+    std::cout << "Trickling : " << announcementItems << " announcements in " << announcementMessages << " messages ("
+                << (announcementMessages > 0 ? static_cast<double>(announcementItems) / announcementMessages : 0)
+                << " per message), mean batch = " << meanAnnouncementBatch << ", highest p90 batch = " << p90AnnouncementBatch
+                << ", mean interval = " << meanTrickleInterval << "s, highest p90 interval = " << p90TrickleInterval << "s\n";
+    std::cout << "Seen cache (" << seenCacheCapacity << " entries/node) : duplicate transaction messages dropped = " << seenCacheHits
+                << ", evictions = " << seenCacheEvictions << "\n";
+    std::cout << "Gossip : coverage of the transaction requests = "
+                << (transactionsCreated*gossipReceivers > 0 ? 100.0*transactionsReceived/(transactionsCreated*gossipReceivers) : 0)
+                << "%, bandwidth/node = " << transactionSentBytes + gossipPullSentBytes << " Bytes (TRANS_INV + GET_TRANS = " << gossipPullSentBytes
+                << " Bytes), transactions pulled = " << gossipPulledTransactions << ", TTL expired = " << gossipTtlExpired << "\n";
+    std::cout << "Mempool : backlog at the end = " << mempoolSize << " transactions, largest backlog = " << mempoolMaxSize
+                << ", evictions = " << mempoolEvictions << ", rejections = " << mempoolRejections
+                << ", mean block fill = " << 100*meanBlockFill << "%\n";
+    std::cout << "Transactions : mean size = " << meanTransactionSize << " Bytes\n";
     
     
     std::cout << "\nBlock Propagation Times = [";